@@ -43,11 +43,22 @@ Licensed under the Apache License, Version 2.0 (the "License");
 #define HT_SUBSCRIBE_BUFF_SIZE  40                         /**</ Maximum buffer size to received from MQTT subscribe. */
 
 /* Configurações do CoreHub */
+/* Limites, timeout do alarme e setpoint do AC: padrões da imagem embutida (HT_CoreHub_Config.c) */
 #define HT_COREHUB_TEMP_LIMIT_UPPER    28.0f              /**</ Limite superior de temperatura (°C) */
 #define HT_COREHUB_TEMP_LIMIT_LOWER    24.0f              /**</ Limite inferior de temperatura (°C) */
 #define HT_COREHUB_ALARM_TIMEOUT_MS    60000              /**</ Timeout do alarme (60 segundos) */
 #define HT_COREHUB_STATUS_INTERVAL_MS  10000              /**</ Intervalo para status (10 segundos) */
 #define HT_COREHUB_AC_TEMP_SETPOINT    22                 /**</ Temperatura de setpoint do AC (°C) */
+#define HT_COREHUB_NETSTATS_INTERVAL_MS 300000            /**</ Intervalo de publicação das estatísticas de socket (5 min) */
+#define HT_COREHUB_NETSTATS_TOPIC      "hana/corehub/status/net" /**</ Tópico das estatísticas de socket */
+#define HT_COREHUB_HEALTH_INTERVAL_MS  300000            /**</ Intervalo de publicação do status de RAM (5 min) */
+#define HT_COREHUB_HEALTH_TOPIC        "hana/corehub/status/health" /**</ Tópico do status de RAM (retido) */
+#define HT_COREHUB_TOPIC_MAX_LEN       64                /**</ Maior tópico montado "hana/<ambiente>/<sufixo>" (buffer temporário) */
+#define HT_COREHUB_HISTORY_MAX_POINTS  500               /**</ Pontos por pedido em "hana/<ambiente>/history/get", limita o tempo de rádio */
+#define HT_COREHUB_HISTORY_CHUNK       448               /**</ Bytes de pontos por publicação em "hana/<ambiente>/history" (cabe no buffer MQTT) */
+#define HT_COREHUB_FSM_STEP_MS         1000              /**</ Espera entre passos da FSM fora do ocioso (1 passo/s) */
+#define HT_COREHUB_WAIT_MIN_MS         10                /**</ Menor bloqueio do loop MQTT no socket */
+#define HT_COREHUB_WAIT_MAX_MS         300000            /**</ Maior bloqueio do loop MQTT no socket sem prazos pendentes */
 
 /* Configurações de Conexão Inteligente */
 #define HT_COREHUB_SENSECLIMA_INTERVAL_MS  10000          /**</ Intervalo para resgate de dados SenseClima (10s) */
@@ -67,7 +78,7 @@ Licensed under the Apache License, Version 2.0 (the "License");
 
 #define HT_COREHUB_QUEUE_SIZE              10              /**</ Tamanho da fila de mensagens */
 
-#define NUM_AMBIENTES 3
+#define NUM_AMBIENTES 3                                   /**</ Máximo de ambientes; a lista vem da imagem de configuração */
 
 /* Estados da FSM do CoreHub */
 typedef enum {
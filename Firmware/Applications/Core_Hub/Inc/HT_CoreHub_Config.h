@@ -0,0 +1,133 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file HT_CoreHub_Config.h
+ * \brief Fleet configuration image: ambiente list, broker, client ID,
+ *        thresholds, APN and band. The image is a versioned binary in its
+ *        own flash region (FLASH_CFG_REGION_OFFSET), made on the host by
+ *        Debug/Scripts/corehub_config.py. The firmware reads it in place
+ *        through XIP as a const struct with string offsets: nothing is
+ *        parsed or copied at boot. Without a valid image the built-in
+ *        defaults below are used, stored the same way in .rodata.
+ * \author HT Micron Advanced R&D,
+ *         Hêndrick Bataglin Gonçalves, Christian Roberto Lehmen,  Matheus da Silva Zorzeto, Felipe Kalinski Ferreira,
+ *         Leandro Borges, Mauricio Carlotto Ribeiro, Henrique Kuhn, Cleber Haack, Eduardo Mendel
+ *         Gleiser Alvarez Arrojo
+ *
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#ifndef __HT_COREHUB_CONFIG_H__
+#define __HT_COREHUB_CONFIG_H__
+
+#include "stdint.h"
+#include "mem_map.h"
+
+/* Defines  ------------------------------------------------------------------*/
+
+#define HT_CONFIG_MAGIC                 0x47464348      /**</ "HCFG" */
+#define HT_CONFIG_VERSION               1               /**</ Bump when HT_ConfigImage changes, corehub_config.py checks it. */
+#define HT_CONFIG_MAX_AMBIENTES         8               /**</ Name slots in the image, the firmware uses up to NUM_AMBIENTES. */
+#define HT_CONFIG_XIP_ADDR              (FLASH_XIP_ADDR + FLASH_CFG_REGION_OFFSET)
+
+/* Built-in values, used when the region holds no valid image */
+#define HT_CONFIG_DEFAULT_BROKER        "131.255.82.115"
+#define HT_CONFIG_DEFAULT_CLIENT_ID     "corehub01"
+#define HT_CONFIG_DEFAULT_APN           "iot.datatem.com.br"
+#define HT_CONFIG_DEFAULT_BAND          28
+
+/* Typedefs  ------------------------------------------------------------------*/
+
+/**
+ * \struct HT_ConfigImage
+ * \brief Start of the image. Strings are NUL terminated and stored after
+ *        the struct, each field holding its offset from the image start.
+ *        Little endian, no padding (checked at compile time).
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;                               /**</ sizeof(HT_ConfigImage) when written. */
+    uint32_t size;                                      /**</ Image bytes, strings included. */
+    uint32_t crc;                                       /**</ CRC-32 (zlib) of the image with crc = 0. */
+    uint32_t alarm_timeout_ms;                          /**</ Door open with light on before the buzzer. */
+    uint16_t ambiente_count;
+    uint16_t ambiente[HT_CONFIG_MAX_AMBIENTES];         /**</ Ambiente names, topic segment "hana/<name>/...". */
+    uint16_t broker;                                    /**</ Broker address. */
+    uint16_t broker_port;
+    uint16_t client_id;
+    uint16_t username;
+    uint16_t password;
+    uint16_t apn;
+    uint8_t band;                                       /**</ NB-IoT band. */
+    uint8_t reserved0;
+    int16_t temp_upper;                                 /**</ AC on above this (hundredths of °C). */
+    int16_t temp_lower;                                 /**</ AC off below this (hundredths of °C). */
+    int16_t ac_setpoint;                                /**</ AC setpoint (°C). */
+    uint16_t reserved1;
+} HT_ConfigImage;
+
+/* Functions ------------------------------------------------------------------*/
+
+/*!******************************************************************
+ * \fn void HT_Config_Init(void)
+ * \brief Check the image in the flash region (magic, version, size and
+ *        CRC) and select it, or the built-in one. Call once at boot
+ *        before any other HT_Config_xxx.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Config_Init(void);
+
+/*!******************************************************************
+ * \fn const HT_ConfigImage *HT_Config_Get(void)
+ * \brief Selected image, in flash.
+ *
+ * \retval const HT_ConfigImage*                Never NULL.
+ *******************************************************************/
+const HT_ConfigImage *HT_Config_Get(void);
+
+/*!******************************************************************
+ * \fn const char *HT_Config_String(uint16_t offset)
+ * \brief String of the selected image, in flash.
+ *
+ * \param[in] uint16_t offset                   String field of HT_ConfigImage.
+ *
+ * \retval const char*                          Never NULL.
+ *******************************************************************/
+const char *HT_Config_String(uint16_t offset);
+
+/*!******************************************************************
+ * \fn uint8_t HT_Config_FromFlash(void)
+ * \brief Whether the flash image was selected.
+ *
+ * \retval uint8_t                              1 flash, 0 built-in.
+ *******************************************************************/
+uint8_t HT_Config_FromFlash(void);
+
+#endif /* __HT_COREHUB_CONFIG_H__ */
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -0,0 +1,127 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file HT_CoreHub_Health.h
+ * \brief RAM health telemetry: per-task stack high-water marks, FreeRTOS heap
+ *        low-water mark, newlib sbrk usage and allocation failures.
+ * \author HT Micron Advanced R&D,
+ *         Hêndrick Bataglin Gonçalves, Christian Roberto Lehmen,  Matheus da Silva Zorzeto, Felipe Kalinski Ferreira,
+ *         Leandro Borges, Mauricio Carlotto Ribeiro, Henrique Kuhn, Cleber Haack, Eduardo Mendel
+ *         Gleiser Alvarez Arrojo
+ *
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#ifndef __HT_COREHUB_HEALTH_H__
+#define __HT_COREHUB_HEALTH_H__
+
+#include "stdint.h"
+#include "stddef.h"
+#include "FreeRTOS.h"
+
+/* Defines  ------------------------------------------------------------------*/
+
+#define HT_HEALTH_MAX_TASKS             32              /**</ Per-task entries; with more tasks alive only task_count is reported. */
+#define HT_HEALTH_TASK_NAME_LEN         configMAX_TASK_NAME_LEN
+
+/* Typedefs  ------------------------------------------------------------------*/
+
+/**
+ * \struct HT_HealthTask_t
+ * \brief Stack usage of one task.
+ */
+typedef struct {
+    char name[HT_HEALTH_TASK_NAME_LEN];                 /**</ Task name, truncated and NUL terminated. */
+    uint32_t stack_free_min;                            /**</ Least free stack ever seen, in bytes (uxTaskGetStackHighWaterMark). */
+} HT_HealthTask_t;
+
+/**
+ * \struct HT_HealthReport_t
+ * \brief Snapshot of the RAM counters, all kept since boot.
+ */
+typedef struct {
+    uint32_t uptime_s;                                  /**</ Seconds since the scheduler started. */
+    uint32_t heap_size;                                 /**</ FreeRTOS heap size (gTotalHeapSize). */
+    uint32_t heap_free;                                 /**</ FreeRTOS heap free now. */
+    uint32_t heap_free_min;                             /**</ FreeRTOS heap minimum-ever-free. */
+    uint32_t heap_alloc_failures;                       /**</ pvPortMalloc() calls that returned NULL. */
+    uint32_t malloc_failures;                           /**</ malloc() calls that returned NULL. */
+    uint32_t sbrk_used;                                 /**</ Bytes newlib took through _sbrk. */
+    uint32_t sbrk_peak;                                 /**</ Most bytes newlib ever held through _sbrk. */
+    uint32_t sbrk_failures;                             /**</ _sbrk requests refused. */
+    uint32_t ps_events_dropped;                         /**</ PS URC events lost on a full queue (main.c). */
+    uint32_t state_writes;                              /**</ State snapshots written to flash (HT_CoreHub_State.c). */
+    uint32_t state_write_failures;                      /**</ State snapshot writes littlefs refused. */
+    uint32_t state_coalesced;                           /**</ State changes folded into a pending write. */
+    uint32_t fs_erase_max;                              /**</ Most erased littlefs block. */
+    uint32_t fs_erase_total;                            /**</ littlefs block erases. */
+    uint8_t fs_erase_valid;                             /**</ 0 when the littlefs monitor is compiled out, the erase counts are then reported as null. */
+    uint32_t ts_samples;                                /**</ Sensor events appended to the series (HT_CoreHub_Series.c). */
+    uint32_t ts_encoded_bytes;                          /**</ Series bytes handed to littlefs. */
+    uint32_t ts_appends;                                /**</ Series buffers written. */
+    uint32_t ts_flash_bytes;                            /**</ Series data bytes programmed with the block copies of a commit, over ts_encoded_bytes is the write amplification. */
+    uint32_t ts_write_errors;                           /**</ Series appends littlefs refused. */
+    uint32_t ts_commits;                                /**</ Series segment commits. */
+    uint32_t ts_flush_commits;                          /**</ Of ts_commits, those forced by a hibernate. */
+    uint32_t task_count;                                /**</ Tasks alive, may exceed HT_HEALTH_MAX_TASKS. */
+    uint32_t task_reported;                             /**</ Valid entries in tasks[]. */
+    HT_HealthTask_t tasks[HT_HEALTH_MAX_TASKS];         /**</ Per-task stack usage. */
+} HT_HealthReport_t;
+
+/* Functions ------------------------------------------------------------------*/
+
+/*!******************************************************************
+ * \fn void HT_Health_Collect(HT_HealthReport_t *report)
+ * \brief Take a snapshot of every counter. Walks the task list with the
+ *        scheduler suspended, so call it from task context only and not
+ *        too often (a few times per minute at most).
+ *
+ * \param[out] HT_HealthReport_t *report        Destination.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Health_Collect(HT_HealthReport_t *report);
+
+/*!******************************************************************
+ * \fn int HT_Health_Format(const HT_HealthReport_t *report, char *buf, size_t size)
+ * \brief Serialize a snapshot as a compact JSON status:
+ *        {"up":s,"hp":[size,free,min],"af":[heap,malloc,sbrk],
+ *         "sb":[used,peak],"pq":dropped,"fs":[writes,failures,coalesced,
+ *         erase_max|null,erase_total|null],"ts":[samples,encoded,appends,flash_bytes,
+ *         errors,commits,flush_commits],"tn":count,"st":{"name":bytes,...}}
+ *        Tasks that don't fit in buf are left out of "st".
+ *
+ * \param[in]  const HT_HealthReport_t *report  Snapshot.
+ * \param[out] char *buf                        Destination.
+ * \param[in]  size_t size                      Size of buf.
+ *
+ * \retval int                                  Length written, or -1 if the fixed part doesn't fit.
+ *******************************************************************/
+int HT_Health_Format(const HT_HealthReport_t *report, char *buf, size_t size);
+
+#endif /* __HT_COREHUB_HEALTH_H__ */
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
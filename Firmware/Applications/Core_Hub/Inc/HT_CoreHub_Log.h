@@ -0,0 +1,222 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file HT_CoreHub_Log.h
+ * \brief Tokenized diagnostics for Core_Hub and HT_MQTT_Api.
+ *        Every call site is a unilog record (UNILOG_COREHUB module, one sub ID
+ *        from UNILOG_COREHUB_Tag in debug_log.h) carrying only the ID and the
+ *        raw 32-bit arguments. The format string never reaches the image; it is
+ *        recovered on the host by Debug/Scripts/corehub_log.py, which reads it
+ *        back from the call site.
+ *
+ *        Rules for call sites:
+ *        - arguments are 32-bit integers, argc must match the format;
+ *        - floats are logged as scaled integers (see HT_LOG_DECI);
+ *        - %s is only allowed in HT_LOG_STR (one string per record);
+ *        - new sub IDs go at the end of UNILOG_COREHUB_Tag so old captures
+ *          keep decoding;
+ *        - the level is the literal P_xxx token. Levels below the module level
+ *          (HT_LOG_MODULE_LEVEL) or below HT_LOG_LEVEL_MIN are removed by the
+ *          preprocessor; the rest are checked against a runtime ceiling.
+ *
+ * \author HT Micron Advanced R&D,
+ *         Hêndrick Bataglin Gonçalves, Christian Roberto Lehmen,  Matheus da Silva Zorzeto, Felipe Kalinski Ferreira,
+ *         Leandro Borges, Mauricio Carlotto Ribeiro, Henrique Kuhn, Cleber Haack, Eduardo Mendel
+ *
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#ifndef __HT_COREHUB_LOG_H__
+#define __HT_COREHUB_LOG_H__
+
+#include "stdio.h"
+#include "stdint.h"
+#include "debug_log.h"
+#include "debug_trace.h"
+
+/* Defines  ------------------------------------------------------------------*/
+
+#ifndef HT_LOG_TOKENIZED
+#define HT_LOG_TOKENIZED   1                           /**</ 1: unilog binary records, 0: plain printf text (bring-up without the log tool). */
+#endif
+
+/* Compile-time levels, same order as debugTraceLevelType (P_DEBUG..P_ERROR) */
+#define HT_LOG_LEVEL_DEBUG      0
+#define HT_LOG_LEVEL_INFO       1
+#define HT_LOG_LEVEL_VALUE      2
+#define HT_LOG_LEVEL_SIG        3
+#define HT_LOG_LEVEL_WARNING    4
+#define HT_LOG_LEVEL_ERROR      5
+#define HT_LOG_LEVEL_NONE       6
+
+#ifndef HT_LOG_LEVEL_MIN
+#define HT_LOG_LEVEL_MIN        HT_LOG_LEVEL_DEBUG     /**</ Build-wide floor, HT_LOG_RELEASE=y in the Makefile raises it. */
+#endif
+
+#ifndef HT_LOG_LEVEL_FSM
+#define HT_LOG_LEVEL_FSM        HT_LOG_LEVEL_INFO      /**</ HT_CoreHubFsm.c */
+#endif
+
+#ifndef HT_LOG_LEVEL_MQTT_API
+#define HT_LOG_LEVEL_MQTT_API   HT_LOG_LEVEL_INFO      /**</ HT_MQTT_Api.c */
+#endif
+
+#ifndef HT_LOG_LEVEL_MAIN
+#define HT_LOG_LEVEL_MAIN       HT_LOG_LEVEL_INFO      /**</ main.c */
+#endif
+
+/* Each source defines its own level before the first include, e.g.
+   #define HT_LOG_MODULE_LEVEL HT_LOG_LEVEL_FSM */
+#ifndef HT_LOG_MODULE_LEVEL
+#define HT_LOG_MODULE_LEVEL     HT_LOG_LEVEL_INFO
+#endif
+
+/* Float to tenths, e.g. 27.46 -> 275 */
+#define HT_LOG_DECI(x)     ((int32_t)((x) * 10.0f + (((x) < 0.0f) ? -0.5f : 0.5f)))
+
+/* Runtime ceiling, only levels at or above it are emitted (see HT_Log_SetLevel) */
+extern volatile uint8_t ht_log_level;
+
+#if HT_LOG_TOKENIZED == 1
+
+#define HT_LOG_EMIT(subID, level, argc, format, ...) \
+        do { \
+            if((level) >= ht_log_level) { \
+                HT_TRACE(UNILOG_COREHUB, subID, level, argc, format, ##__VA_ARGS__); \
+            } \
+        } while(0)
+
+#define HT_LOG_STR_EMIT(subID, level, format, string) \
+        do { \
+            if((level) >= ht_log_level) { \
+                HT_STRING(UNILOG_COREHUB, subID, level, format, (const uint8_t *)(string)); \
+            } \
+        } while(0)
+
+#else
+
+#define HT_LOG_EMIT(subID, level, argc, format, ...) \
+        do { \
+            if((level) >= ht_log_level) { \
+                printf(format "\n", ##__VA_ARGS__); \
+            } \
+        } while(0)
+
+#define HT_LOG_STR_EMIT(subID, level, format, string) \
+        do { \
+            if((level) >= ht_log_level) { \
+                printf(format "\n", (const char *)(string)); \
+            } \
+        } while(0)
+
+#endif
+
+#define HT_LOG_DROP(...)   do { } while(0)
+
+/* A disabled level expands to nothing: no format string, no argument evaluation */
+#if (HT_LOG_MODULE_LEVEL <= HT_LOG_LEVEL_DEBUG) && (HT_LOG_LEVEL_MIN <= HT_LOG_LEVEL_DEBUG)
+#define HT_LOG_IF_P_DEBUG           HT_LOG_EMIT
+#define HT_LOG_STR_IF_P_DEBUG       HT_LOG_STR_EMIT
+#else
+#define HT_LOG_IF_P_DEBUG           HT_LOG_DROP
+#define HT_LOG_STR_IF_P_DEBUG       HT_LOG_DROP
+#endif
+
+#if (HT_LOG_MODULE_LEVEL <= HT_LOG_LEVEL_INFO) && (HT_LOG_LEVEL_MIN <= HT_LOG_LEVEL_INFO)
+#define HT_LOG_IF_P_INFO            HT_LOG_EMIT
+#define HT_LOG_STR_IF_P_INFO        HT_LOG_STR_EMIT
+#else
+#define HT_LOG_IF_P_INFO            HT_LOG_DROP
+#define HT_LOG_STR_IF_P_INFO        HT_LOG_DROP
+#endif
+
+#if (HT_LOG_MODULE_LEVEL <= HT_LOG_LEVEL_VALUE) && (HT_LOG_LEVEL_MIN <= HT_LOG_LEVEL_VALUE)
+#define HT_LOG_IF_P_VALUE           HT_LOG_EMIT
+#define HT_LOG_STR_IF_P_VALUE       HT_LOG_STR_EMIT
+#else
+#define HT_LOG_IF_P_VALUE           HT_LOG_DROP
+#define HT_LOG_STR_IF_P_VALUE       HT_LOG_DROP
+#endif
+
+#if (HT_LOG_MODULE_LEVEL <= HT_LOG_LEVEL_SIG) && (HT_LOG_LEVEL_MIN <= HT_LOG_LEVEL_SIG)
+#define HT_LOG_IF_P_SIG             HT_LOG_EMIT
+#define HT_LOG_STR_IF_P_SIG         HT_LOG_STR_EMIT
+#else
+#define HT_LOG_IF_P_SIG             HT_LOG_DROP
+#define HT_LOG_STR_IF_P_SIG         HT_LOG_DROP
+#endif
+
+#if (HT_LOG_MODULE_LEVEL <= HT_LOG_LEVEL_WARNING) && (HT_LOG_LEVEL_MIN <= HT_LOG_LEVEL_WARNING)
+#define HT_LOG_IF_P_WARNING         HT_LOG_EMIT
+#define HT_LOG_STR_IF_P_WARNING     HT_LOG_STR_EMIT
+#else
+#define HT_LOG_IF_P_WARNING         HT_LOG_DROP
+#define HT_LOG_STR_IF_P_WARNING     HT_LOG_DROP
+#endif
+
+#if (HT_LOG_MODULE_LEVEL <= HT_LOG_LEVEL_ERROR) && (HT_LOG_LEVEL_MIN <= HT_LOG_LEVEL_ERROR)
+#define HT_LOG_IF_P_ERROR           HT_LOG_EMIT
+#define HT_LOG_STR_IF_P_ERROR       HT_LOG_STR_EMIT
+#else
+#define HT_LOG_IF_P_ERROR           HT_LOG_DROP
+#define HT_LOG_STR_IF_P_ERROR       HT_LOG_DROP
+#endif
+
+/* level must be written as the literal P_xxx token, it selects the macro above */
+#define HT_LOG(subID, level, argc, format, ...) \
+        HT_LOG_IF_##level(subID, level, argc, format, ##__VA_ARGS__)
+
+#define HT_LOG_STR(subID, level, format, string) \
+        HT_LOG_STR_IF_##level(subID, level, format, string)
+
+/* Functions ------------------------------------------------------------------*/
+
+/*!******************************************************************
+ * \fn void HT_Log_SetLevel(uint8_t level)
+ * \brief Sets the runtime ceiling. Levels compiled out stay out, this only
+ *        silences levels that were compiled in.
+ *
+ * \param[in] uint8_t level                    Lowest level emitted (P_DEBUG..P_ERROR, P_ERROR + 1 mutes all).
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+void HT_Log_SetLevel(uint8_t level);
+
+/*!******************************************************************
+ * \fn uint8_t HT_Log_GetLevel(void)
+ * \brief Gets the runtime ceiling.
+ *
+ * \param[in] none
+ * \param[out] none
+ *
+ * \retval Lowest level currently emitted.
+ *******************************************************************/
+uint8_t HT_Log_GetLevel(void);
+
+#endif /* __HT_COREHUB_LOG_H__ */
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -0,0 +1,224 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file HT_CoreHub_Series.h
+ * \brief On-device time series of every temperature, humidity, door and
+ *        light event, on littlefs. Three tiers (raw, 1 min, 15 min) are each
+ *        a ring of append-only segment files of one erase block. Entries are
+ *        delta encoded (varint time and value deltas, reset at every segment
+ *        so the oldest segment can be dropped alone) and collected in a RAM
+ *        buffer per tier, so flash sees one append per buffer, not per sample.
+ *        The current segment of a tier stays open and is committed at its
+ *        end, on HT_Series_Flush(), before a query and every
+ *        HT_SERIES_COMMIT_MS: a commit followed by more appends costs
+ *        littlefs a copy of the segment block, and what was not committed is
+ *        lost on a reset.
+ *        MQTT task only.
+ * \author HT Micron Advanced R&D,
+ *         Hêndrick Bataglin Gonçalves, Christian Roberto Lehmen,  Matheus da Silva Zorzeto, Felipe Kalinski Ferreira,
+ *         Leandro Borges, Mauricio Carlotto Ribeiro, Henrique Kuhn, Cleber Haack, Eduardo Mendel
+ *         Gleiser Alvarez Arrojo
+ *
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#ifndef __HT_COREHUB_SERIES_H__
+#define __HT_COREHUB_SERIES_H__
+
+#include "stdint.h"
+
+/* Defines  ------------------------------------------------------------------*/
+
+#define HT_SERIES_SEGMENT_SIZE          4096            /**</ Segment file size, one littlefs block. */
+#define HT_SERIES_RAW_SEGMENTS          24              /**</ Raw tier ring (96 KB, ~9 h at one sample per 10 s per sensor). */
+#define HT_SERIES_1MIN_SEGMENTS         24              /**</ 1 min tier ring (96 KB, ~1.5 days). */
+#define HT_SERIES_15MIN_SEGMENTS        8               /**</ 15 min tier ring (32 KB, ~2 weeks). 56 of the 84 blocks of the fs region. */
+#define HT_SERIES_RAW_BUFFER            256             /**</ RAM write buffer of the raw tier. */
+#define HT_SERIES_AGG_BUFFER            128             /**</ RAM write buffer of each aggregate tier. */
+#define HT_SERIES_COMMIT_MS             3600000         /**</ An entry is committed to flash within this time (1 h), each commit copies up to a block per tier. */
+#define HT_SERIES_READ_CHUNK            128             /**</ Query read buffer, the only RAM a query needs besides the decoder. */
+
+/* Typedefs  ------------------------------------------------------------------*/
+
+/**
+ * \enum HT_SeriesTier
+ * \brief Resolution of a series.
+ */
+typedef enum {
+    HT_SERIES_RAW = 0,                                  /**</ Every event. */
+    HT_SERIES_1MIN,                                     /**</ Min/max/mean/count per minute. */
+    HT_SERIES_15MIN,                                    /**</ Min/max/mean/count per 15 minutes. */
+    HT_SERIES_TIERS
+} HT_SeriesTier;
+
+/**
+ * \enum HT_SeriesChannel
+ * \brief Sensor of an ambiente.
+ */
+typedef enum {
+    HT_SERIES_TEMPERATURE = 0,                          /**</ Hundredths of °C. */
+    HT_SERIES_HUMIDITY,                                 /**</ Hundredths of %. */
+    HT_SERIES_DOOR,                                     /**</ 0 = CLOSED, 100 = OPEN (the mean is the share of OPEN events). */
+    HT_SERIES_LIGHT,                                    /**</ 0 = OFF, 100 = ON. */
+    HT_SERIES_CHANNELS
+} HT_SeriesChannel;
+
+/**
+ * \struct HT_SeriesPoint
+ * \brief One decoded entry. Raw entries have count 1 and min = max = mean.
+ */
+typedef struct {
+    uint32_t time;                                      /**</ System time (s), bucket start on the aggregate tiers. */
+    uint8_t ambiente;                                   /**</ Ambiente index. */
+    uint8_t channel;                                    /**</ HT_SeriesChannel. */
+    uint16_t count;                                     /**</ Events in the bucket. */
+    int16_t mean;
+    int16_t min;
+    int16_t max;
+} HT_SeriesPoint;
+
+/**
+ * \struct HT_SeriesStats
+ * \brief Append and flash counters since boot, kept here because the
+ *        littlefs write monitor is compiled out of the prebuilt liblfs.a.
+ *        Write amplification is flash_bytes / encoded_bytes, compression is
+ *        encoded_bytes / (samples * sizeof(HT_SeriesPoint)).
+ */
+typedef struct {
+    uint32_t samples;                                   /**</ Events appended. */
+    uint32_t entries[HT_SERIES_TIERS];                  /**</ Entries encoded per tier. */
+    uint32_t encoded_bytes;                             /**</ Bytes handed to littlefs, segment headers included. */
+    uint32_t appends;                                   /**</ Buffers handed to littlefs (one write to the open segment each). */
+    uint32_t segments;                                  /**</ Segments started. */
+    uint32_t write_errors;                              /**</ Appends littlefs refused (the buffer is dropped). */
+    uint32_t commits;                                   /**</ Segment files closed, each makes its writes durable. */
+    uint32_t flush_commits;                             /**</ Of commits, those HT_Series_Flush() made ahead of a hibernate. */
+    uint32_t block_copies;                              /**</ Committed segment blocks littlefs copied to append to them again. */
+    uint32_t flash_bytes;                               /**</ Data bytes programmed: encoded_bytes plus the copies, metadata not counted. */
+} HT_SeriesStats;
+
+/* Return non-zero to stop the query */
+typedef int (*HT_SeriesVisitFn)(const HT_SeriesPoint *point, void *ctx);
+
+/* Functions ------------------------------------------------------------------*/
+
+/*!******************************************************************
+ * \fn void HT_Series_Init(void)
+ * \brief Find the segments on flash and continue the newest one of each
+ *        tier. Call once before the first append.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Series_Init(void);
+
+/*!******************************************************************
+ * \fn void HT_Series_Append(int ambiente_idx, HT_SeriesChannel channel, int16_t value)
+ * \brief Record one event now: a raw entry, and the value goes into the
+ *        running 1 min and 15 min buckets. RAM only until a buffer fills,
+ *        then written to the open segment but not committed.
+ *
+ * \param[in] int ambiente_idx                  Ambiente index.
+ * \param[in] HT_SeriesChannel channel          Sensor.
+ * \param[in] int16_t value                     Value in the channel unit.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Series_Append(int ambiente_idx, HT_SeriesChannel channel, int16_t value);
+
+/*!******************************************************************
+ * \fn void HT_Series_Poll(void)
+ * \brief Close the buckets whose period ended and commit the tiers
+ *        holding entries older than HT_SERIES_COMMIT_MS.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Series_Poll(void);
+
+/*!******************************************************************
+ * \fn void HT_Series_Flush(void)
+ * \brief Commit everything not on flash yet, open buckets included (a
+ *        bucket cut this way is stored in two entries, HT_Series_Query()
+ *        joins them). Before a reboot or sleep2/hibernate.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Series_Flush(void);
+
+/*!******************************************************************
+ * \fn uint8_t HT_Series_FlushDue(uint32_t within_ms)
+ * \brief Whether the RAM buffers go to flash within within_ms anyway: a
+ *        tier reaches HT_SERIES_COMMIT_MS or its buffer has no room for
+ *        another entry. Before that, a flush for hibernate would add a
+ *        commit and a block copy per tier of its own.
+ *
+ * \param[in] uint32_t within_ms                Time ahead (ms).
+ *
+ * \retval uint8_t                              1 when a commit or write is due.
+ *******************************************************************/
+uint8_t HT_Series_FlushDue(uint32_t within_ms);
+
+/*!******************************************************************
+ * \fn uint8_t HT_Series_Pending(void)
+ * \brief Whether anything is not committed yet (buffers, open segments
+ *        or open buckets).
+ *
+ * \retval uint8_t                              1 when HT_Series_Flush() has work.
+ *******************************************************************/
+uint8_t HT_Series_Pending(void);
+
+/*!******************************************************************
+ * \fn int HT_Series_Query(HT_SeriesTier tier, uint32_t from, uint32_t to, HT_SeriesVisitFn visit, void *ctx)
+ * \brief Visit the entries of a tier with from <= time <= to, oldest
+ *        segment first, buffered entries included. Reads one chunk at a
+ *        time. Segments that start after "to" are skipped unread. Commits
+ *        the tier first when its segment is open. On the aggregate tiers
+ *        the entries of one bucket (split by HT_Series_Flush()) come as
+ *        one point, and points are in time order per stream only: each
+ *        is held until the stream's next bucket shows up.
+ *
+ * \param[in] HT_SeriesTier tier                Tier.
+ * \param[in] uint32_t from                     First time (s).
+ * \param[in] uint32_t to                       Last time (s).
+ * \param[in] HT_SeriesVisitFn visit            Called per entry.
+ * \param[in] void *ctx                         Passed to visit.
+ *
+ * \retval int                                  Points visited, -1 on a bad tier.
+ *******************************************************************/
+int HT_Series_Query(HT_SeriesTier tier, uint32_t from, uint32_t to, HT_SeriesVisitFn visit, void *ctx);
+
+/*!******************************************************************
+ * \fn void HT_Series_GetStats(HT_SeriesStats *stats)
+ * \brief Append, commit and flash byte counters.
+ *
+ * \param[out] HT_SeriesStats *stats            Destination.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Series_GetStats(HT_SeriesStats *stats);
+
+#endif /* __HT_COREHUB_SERIES_H__ */
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -0,0 +1,136 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file HT_CoreHub_Sleep.h
+ * \brief Work-scoped sleep vote of the CoreHub. The vote is held only while
+ *        a packet is being processed, a publish is in flight, the session is
+ *        being set up or the next deadline is too close to be worth a sleep;
+ *        between events the platform is free to enter tickless sleep, down to
+ *        the depth reported to the CheckUsrdefSlpStatus() hook.
+ * \author HT Micron Advanced R&D,
+ *         Hêndrick Bataglin Gonçalves, Christian Roberto Lehmen,  Matheus da Silva Zorzeto, Felipe Kalinski Ferreira,
+ *         Leandro Borges, Mauricio Carlotto Ribeiro, Henrique Kuhn, Cleber Haack, Eduardo Mendel
+ *         Gleiser Alvarez Arrojo
+ *
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#ifndef __HT_COREHUB_SLEEP_H__
+#define __HT_COREHUB_SLEEP_H__
+
+#include "stdint.h"
+#include "slpman_qcx212.h"
+
+/* Defines  ------------------------------------------------------------------*/
+
+#define HT_SLEEP_VOTE_NAME              "EP_MQTT"       /**</ Platform vote handle name. */
+#define HT_SLEEP_VOTE_STATE             SLP_SLP1_STATE  /**</ State voted against while work is held (WFI stays allowed). */
+#define HT_SLEEP_MAX_DEPTH              SLP_SLP1_STATE  /**</ Default deepest state with no work held: the MQTT session and FSM live in RAM. */
+#define HT_SLEEP_DEADLINE_GUARD_MS      20              /**</ Deadlines closer than this are waited for in idle, not in sleep. */
+
+/* Typedefs  ------------------------------------------------------------------*/
+
+/**
+ * \enum HT_SleepHold
+ * \brief Reasons to keep the platform awake, combined as a bit mask.
+ */
+typedef enum {
+    HT_SLEEP_HOLD_PACKET   = (1 << 0),                  /**</ Downlink packet being processed by the FSM. */
+    HT_SLEEP_HOLD_PUBLISH  = (1 << 1),                  /**</ Publish in flight. */
+    HT_SLEEP_HOLD_SESSION  = (1 << 2),                  /**</ Connect and subscribe in progress. */
+    HT_SLEEP_HOLD_DEADLINE = (1 << 3)                   /**</ Next deadline within HT_SLEEP_DEADLINE_GUARD_MS. */
+} HT_SleepHold;
+
+/* Functions ------------------------------------------------------------------*/
+
+/*!******************************************************************
+ * \fn void HT_Sleep_Init(void)
+ * \brief Apply for the platform vote handle. Sleep stays enabled until
+ *        the first hold.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Sleep_Init(void);
+
+/*!******************************************************************
+ * \fn void HT_Sleep_Hold(uint32_t reasons)
+ * \brief Add reasons to stay awake. The vote is cast when the first
+ *        reason is added. MQTT task only.
+ *
+ * \param[in] uint32_t reasons                  HT_SleepHold bits.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Sleep_Hold(uint32_t reasons);
+
+/*!******************************************************************
+ * \fn void HT_Sleep_Release(uint32_t reasons)
+ * \brief Remove reasons to stay awake. The vote is withdrawn when the
+ *        last reason is removed. MQTT task only.
+ *
+ * \param[in] uint32_t reasons                  HT_SleepHold bits.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Sleep_Release(uint32_t reasons);
+
+/*!******************************************************************
+ * \fn void HT_Sleep_SetDeadline(uint32_t ms)
+ * \brief Record when the task needs the CPU again, right before it
+ *        blocks. Holds HT_SLEEP_HOLD_DEADLINE if that is too soon for
+ *        a sleep, releases it otherwise.
+ *
+ * \param[in] uint32_t ms                       Time to the next deadline.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Sleep_SetDeadline(uint32_t ms);
+
+/*!******************************************************************
+ * \fn void HT_Sleep_SetMaxDepth(slpManSlpState_t depth)
+ * \brief Deepest state allowed with no work held. Raised past
+ *        HT_SLEEP_MAX_DEPTH only while nothing that lives in RAM alone
+ *        would be lost by a reboot from sleep2/hibernate.
+ *
+ * \param[in] slpManSlpState_t depth            Sleep depth limit.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Sleep_SetMaxDepth(slpManSlpState_t depth);
+
+/*!******************************************************************
+ * \fn slpManSlpState_t HT_Sleep_MaxDepth(void)
+ * \brief Deepest state the CoreHub allows right now, for the user
+ *        sleep depth hook: idle while work is held or a deadline is
+ *        close, the HT_Sleep_SetMaxDepth() limit otherwise. Called from the idle task.
+ *
+ * \retval slpManSlpState_t                     Sleep depth limit.
+ *******************************************************************/
+slpManSlpState_t HT_Sleep_MaxDepth(void);
+
+#endif /* __HT_COREHUB_SLEEP_H__ */
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -0,0 +1,147 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file HT_CoreHub_State.h
+ * \brief Flash snapshot of the per-ambiente decision state (door, light,
+ *        AC, buzzer, alarm) so a reboot resumes with the same decisions
+ *        instead of rediscovering them from retained traffic. The record is
+ *        versioned and CRC protected, kept in one littlefs file. Changes are
+ *        coalesced in RAM: flash sees at most one write per
+ *        HT_STATE_WRITE_INTERVAL_MS.
+ * \author HT Micron Advanced R&D,
+ *         Hêndrick Bataglin Gonçalves, Christian Roberto Lehmen,  Matheus da Silva Zorzeto, Felipe Kalinski Ferreira,
+ *         Leandro Borges, Mauricio Carlotto Ribeiro, Henrique Kuhn, Cleber Haack, Eduardo Mendel
+ *         Gleiser Alvarez Arrojo
+ *
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#ifndef __HT_COREHUB_STATE_H__
+#define __HT_COREHUB_STATE_H__
+
+#include "stdint.h"
+
+/* Defines  ------------------------------------------------------------------*/
+
+#define HT_STATE_FILE                   "corehub.st"    /**</ littlefs file holding the snapshot. */
+#define HT_STATE_VERSION                1               /**</ Bump when HT_StateAmbiente changes, older records are ignored. */
+#define HT_STATE_MAX_AMBIENTES          8               /**</ Ambientes a record can hold. */
+#define HT_STATE_NAME_LEN               16              /**</ Ambiente name kept to match records after a reorder. */
+#define HT_STATE_WRITE_INTERVAL_MS      600000          /**</ At most one flash write per interval (10 min). */
+#define HT_STATE_LFS_BLOCKS             (344064 / 4096) /**</ littlefs region ("fs" in Debug/format.json) in erase blocks. */
+
+/* Typedefs  ------------------------------------------------------------------*/
+
+/**
+ * \struct HT_StateAmbiente
+ * \brief Decision state of one ambiente as stored in flash.
+ */
+typedef struct {
+    float temperature;                                  /**</ Last temperature (°C), restored but not a reason to write. */
+    uint8_t door_state;                                 /**</ 0=CLOSED, 1=OPEN. */
+    uint8_t light_state;                                /**</ 0=OFF, 1=ON. */
+    uint8_t ac_state;                                   /**</ 0=OFF, 1=ON. */
+    uint8_t buzzer_state;                               /**</ 0=OFF, 1=ON. */
+    uint8_t alarm_active;                               /**</ 0=INACTIVE, 1=ACTIVE. */
+    uint8_t reserved[3];
+    uint32_t alarm_elapsed;                             /**</ Seconds into the alarm timer when last updated. */
+} HT_StateAmbiente;
+
+/**
+ * \struct HT_StateStats
+ * \brief Snapshot and flash wear counters, kept since boot.
+ */
+typedef struct {
+    uint32_t writes;                                    /**</ Records written to flash. */
+    uint32_t write_failures;                            /**</ Writes littlefs refused. */
+    uint32_t coalesced;                                 /**</ Changes folded into a pending write. */
+    uint32_t erase_max;                                 /**</ Most erased block of the fs region (LFS_GetBlockEraseCountResult). */
+    uint32_t erase_total;                               /**</ Block erases of the fs region. */
+    uint8_t erase_valid;                                /**</ 0 when the port's monitor is compiled out (erase_xxx are then 0 and meaningless). */
+} HT_StateStats;
+
+/* Functions ------------------------------------------------------------------*/
+
+/*!******************************************************************
+ * \fn uint8_t HT_State_Restore(int ambiente_idx, const char *name, HT_StateAmbiente *amb)
+ * \brief Decision state saved for an ambiente. The file is read and
+ *        checked (magic, version, CRC) on the first call.
+ *
+ * \param[in]  int ambiente_idx                 Ambiente index.
+ * \param[in]  const char *name                 Ambiente name, must match the saved one.
+ * \param[out] HT_StateAmbiente *amb            Saved state.
+ *
+ * \retval uint8_t                              1 = Restored, 0 = No valid state (amb untouched)
+ *******************************************************************/
+uint8_t HT_State_Restore(int ambiente_idx, const char *name, HT_StateAmbiente *amb);
+
+/*!******************************************************************
+ * \fn void HT_State_Update(int ambiente_idx, const HT_StateAmbiente *amb)
+ * \brief Latest state of an ambiente. Only a change of a decision
+ *        field (door, light, AC, buzzer, alarm) schedules a write, RAM
+ *        only: the flash is touched by HT_State_Poll().
+ *
+ * \param[in] int ambiente_idx                  Ambiente index.
+ * \param[in] const HT_StateAmbiente *amb       Current state.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_State_Update(int ambiente_idx, const HT_StateAmbiente *amb);
+
+/*!******************************************************************
+ * \fn void HT_State_Poll(void)
+ * \brief Write the pending record once the write interval since the
+ *        last write has passed. The first change after a quiet interval
+ *        is written at once.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_State_Poll(void);
+
+/*!******************************************************************
+ * \fn uint32_t HT_State_NextPollMs(void)
+ * \brief Time until HT_State_Poll() has a write to do.
+ *
+ * \retval uint32_t                             Milliseconds, 0 if due now, UINT32_MAX if nothing is pending.
+ *******************************************************************/
+uint32_t HT_State_NextPollMs(void);
+
+/*!******************************************************************
+ * \fn void HT_State_GetStats(HT_StateStats *stats)
+ * \brief Write counters and the erase counts of the littlefs region.
+ *        The prebuilt liblfs.a ships LFS_GetBlockEraseCountResult() as a
+ *        stub that returns 0 and fills nothing, so the counts are only
+ *        marked valid when they add up to something.
+ *
+ * \param[out] HT_StateStats *stats             Destination.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_State_GetStats(HT_StateStats *stats);
+
+#endif /* __HT_COREHUB_STATE_H__ */
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
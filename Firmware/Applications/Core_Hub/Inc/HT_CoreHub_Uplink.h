@@ -0,0 +1,177 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file HT_CoreHub_Uplink.h
+ * \brief Uplink scheduler: holds non-urgent publishes and sends them in one
+ *        burst while the radio is already awake (right after another
+ *        uplink or a downlink, or just before the MQTT keepalive PINGREQ
+ *        would wake it), bounded by a hold time derived from the eDRX/PSM
+ *        timers. A burst resets only the client's last_sent timer: the
+ *        PINGREQ is postponed when last_sent was the earlier deadline and
+ *        still goes out, in the same wake, when last_received was.
+ *        Urgent publishes go out at once and open a window for the held ones.
+ * \author HT Micron Advanced R&D,
+ *         Hêndrick Bataglin Gonçalves, Christian Roberto Lehmen,  Matheus da Silva Zorzeto, Felipe Kalinski Ferreira,
+ *         Leandro Borges, Mauricio Carlotto Ribeiro, Henrique Kuhn, Cleber Haack, Eduardo Mendel
+ *         Gleiser Alvarez Arrojo
+ *
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#ifndef __HT_COREHUB_UPLINK_H__
+#define __HT_COREHUB_UPLINK_H__
+
+#include "stdint.h"
+#include "stddef.h"
+#include "MQTTClient.h"
+
+/* Defines  ------------------------------------------------------------------*/
+
+#define HT_UPLINK_SLOTS                 8           /**</ Held publishes, one per key (newer values replace older ones). */
+#define HT_UPLINK_PAYLOAD_MAX           16          /**</ Largest payload that can be held, longer ones are sent at once. */
+#define HT_UPLINK_RADIO_TAIL_MS         5000        /**</ Radio assumed still connected this long after the last uplink/downlink. */
+#define HT_UPLINK_KEEPALIVE_LEAD_MS     3000        /**</ Flush this long before the keepalive PINGREQ would wake the radio. */
+#define HT_UPLINK_HOLD_DEFAULT_MS       30000       /**</ Longest hold without eDRX/PSM information. */
+#define HT_UPLINK_HOLD_MIN_MS           10000       /**</ Lower clamp of the timer-derived hold. */
+#define HT_UPLINK_HOLD_MAX_MS           120000      /**</ Upper clamp of the timer-derived hold. */
+
+/* Typedefs  ------------------------------------------------------------------*/
+
+/**
+ * \enum HT_UplinkClass
+ * \brief How soon a publish must reach the broker.
+ */
+typedef enum {
+    HT_UPLINK_URGENT = 0,                               /**</ Alarm/actuator command, sent immediately. */
+    HT_UPLINK_DEFERRED                                  /**</ Status or refinement, held for the next radio window. */
+} HT_UplinkClass;
+
+/* Sends one publish, key is opaque to the scheduler. Returns 0 on success. */
+typedef int (*HT_UplinkSendFn)(uint16_t key, const uint8_t *payload, uint32_t len);
+
+/* Called at the end of every burst so periodic reports can ride along. */
+typedef void (*HT_UplinkFlushHook)(void);
+
+/**
+ * \struct HT_UplinkStats_t
+ * \brief Scheduler counters, kept since boot.
+ */
+typedef struct {
+    uint32_t urgent;                                    /**</ Publishes sent immediately. */
+    uint32_t deferred;                                  /**</ Publishes accepted for holding. */
+    uint32_t coalesced;                                 /**</ Held publishes replaced by a newer value for the same key. */
+    uint32_t overflow;                                  /**</ Deferred publishes sent at once (no slot or payload too long). */
+    uint32_t bursts;                                    /**</ Flushes of the held publishes. */
+    uint32_t flushed;                                   /**</ Publishes sent in bursts. */
+    uint32_t aligned;                                   /**</ Bursts sent inside a radio window or ahead of a keepalive. */
+    uint32_t hold_ms;                                   /**</ Hold limit in use. */
+} HT_UplinkStats_t;
+
+/* Functions ------------------------------------------------------------------*/
+
+/*!******************************************************************
+ * \fn void HT_Uplink_SetRadioTiming(uint32_t edrx_ms, uint32_t psm_active_s)
+ * \brief Derive the hold limit from the network timers: one eDRX cycle
+ *        when eDRX is on, otherwise the PSM active time, clamped to
+ *        [HT_UPLINK_HOLD_MIN_MS, HT_UPLINK_HOLD_MAX_MS]. May be called
+ *        before HT_Uplink_Init().
+ *
+ * \param[in] uint32_t edrx_ms                  eDRX cycle granted by the network, 0 = off.
+ * \param[in] uint32_t psm_active_s             PSM active time (T3324), 0 = unknown.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Uplink_SetRadioTiming(uint32_t edrx_ms, uint32_t psm_active_s);
+
+/*!******************************************************************
+ * \fn void HT_Uplink_Init(MQTTClient *client, HT_UplinkSendFn send, HT_UplinkFlushHook hook)
+ * \brief Bind the scheduler to a client. Held publishes survive
+ *        reconnections and are sent in the first window after one.
+ *
+ * \param[in] MQTTClient *client                Client whose keepalive timers are watched.
+ * \param[in] HT_UplinkSendFn send              Publish function.
+ * \param[in] HT_UplinkFlushHook hook           Called after each burst, may be NULL.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Uplink_Init(MQTTClient *client, HT_UplinkSendFn send, HT_UplinkFlushHook hook);
+
+/*!******************************************************************
+ * \fn int HT_Uplink_Publish(uint16_t key, const uint8_t *payload, uint32_t len, HT_UplinkClass cls)
+ * \brief Send (urgent) or hold (deferred) a publish. Task context only,
+ *        same task as HT_Uplink_Poll().
+ *
+ * \param[in] uint16_t key                      Topic key handed back to the send function.
+ * \param[in] const uint8_t *payload            Payload, copied when held.
+ * \param[in] uint32_t len                      Payload length.
+ * \param[in] HT_UplinkClass cls                Urgency.
+ *
+ * \retval int                                  0 = sent or held, otherwise the send error.
+ *******************************************************************/
+int HT_Uplink_Publish(uint16_t key, const uint8_t *payload, uint32_t len, HT_UplinkClass cls);
+
+/*!******************************************************************
+ * \fn void HT_Uplink_NotifyRadio(void)
+ * \brief Report downlink traffic: the radio is connected now, so held
+ *        publishes can go without an extra wake.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Uplink_NotifyRadio(void);
+
+/*!******************************************************************
+ * \fn void HT_Uplink_Poll(void)
+ * \brief Flush the held publishes if a window is open, the keepalive is
+ *        about to wake the radio or the oldest one reached the hold limit.
+ *        Call from the MQTT loop while connected.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Uplink_Poll(void);
+
+/*!******************************************************************
+ * \fn uint32_t HT_Uplink_NextPollMs(void)
+ * \brief Time until HT_Uplink_Poll() has something to flush: the window
+ *        is open, the keepalive lead starts or the oldest held publish
+ *        reaches the hold limit. Lets the MQTT loop block until then.
+ *
+ * \retval uint32_t                             Milliseconds, UINT32_MAX when nothing is held.
+ *******************************************************************/
+uint32_t HT_Uplink_NextPollMs(void);
+
+/*!******************************************************************
+ * \fn void HT_Uplink_GetStats(HT_UplinkStats_t *stats)
+ * \brief Copy the scheduler counters.
+ *
+ * \param[out] HT_UplinkStats_t *stats         Destination.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_Uplink_GetStats(HT_UplinkStats_t *stats);
+
+#endif /* __HT_COREHUB_UPLINK_H__ */
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
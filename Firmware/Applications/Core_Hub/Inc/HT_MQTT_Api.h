@@ -44,8 +44,38 @@
 
 #define MQTT_TLS_ENABLE 0
 
+#define HT_MQTT_TLS_PROFILE 0                   /**</ HT_MQTT_TLSProfile set at boot (0 = certificates, 3 = certificates without verifying the broker). */
+/* Broker CA for the certificate profile, as a PEM string literal (define it
+ * here or with -D). Left undefined, TLS connections are refused. */
+/* #define HT_MQTT_TLS_CA_PEM "-----BEGIN CERTIFICATE-----\n...\n-----END CERTIFICATE-----\n" */
+#define HT_MQTT_TLS_BENCH 0                     /**</ 1 = before the first connection, one full handshake per profile with credentials (HT_MQTT_TLSBenchmark). */
+
 #define MQTT_GENERAL_TIMEOUT 60000
 
+#define HT_MQTT_PINGRESP_WAIT_MS 10000          /**</ Longest wait for a PINGRESP, the client drops the session after it. */
+
+#define HT_MQTT_HIB_NVMEM_OFFSET 0              /**</ Session record in the user NVMem (slpManGetUsrNVMem). */
+#define HT_MQTT_HIB_NVMEM_SIZE 160              /**</ Bytes reserved for it, the rest of the NVMem is free. */
+#define HT_MQTT_HIB_TIMER_ID DEEPSLP_TIMER_ID0  /**</ Deep sleep timer that wakes the device for the keepalive. */
+#define HT_MQTT_HIB_WAKE_GUARD_MS 5000          /**</ Wake this early: boot and session resume before the PINGREQ is due. */
+
+/* Typedefs  ------------------------------------------------------------------*/
+
+/**
+ * \enum HT_MQTT_ConnectResult
+ * \brief Values returned by HT_MQTT_Connect().
+ */
+typedef enum {
+    HT_MQTT_CONNECT_OK = 0,                     /**</ Connected and CONNACK accepted. */
+    HT_MQTT_CONNECT_ERR_SOCKET,                 /**</ Socket could not be created. */
+    HT_MQTT_CONNECT_ERR_DNS,                    /**</ Broker address could not be resolved. */
+    HT_MQTT_CONNECT_ERR_TCP,                    /**</ TCP connection refused or reset. */
+    HT_MQTT_CONNECT_ERR_TCP_TIMEOUT,            /**</ TCP connection timed out. */
+    HT_MQTT_CONNECT_ERR_CONNACK_REFUSED,        /**</ Broker refused the CONNECT. */
+    HT_MQTT_CONNECT_ERR_CONNACK_TIMEOUT,        /**</ CONNECT could not be sent or CONNACK never arrived. */
+    HT_MQTT_CONNECT_ERR_TLS                     /**</ TLS setup, handshake or certificate verification failed. */
+} HT_MQTT_ConnectResult;
+
 /* Functions ------------------------------------------------------------------*/
 
 /*!******************************************************************
@@ -69,12 +99,48 @@
  * \param[in] uint32_t readbuf                  Buffer allocated for RX process.
  * \param[in] uint32_t readbuf_size             Size of RX buffer.
  * 
- * \retval none
+ * \retval uint8_t                              HT_MQTT_ConnectResult code.
  *******************************************************************/
 uint8_t HT_MQTT_Connect(MQTTClient *mqtt_client, Network *mqtt_network, char *addr, int32_t port, uint32_t send_timeout, uint32_t rcv_timeout, char *clientID, 
                                         char *username, char *password, uint8_t mqtt_version, uint32_t keep_alive_interval, uint8_t *sendbuf, 
                                         uint32_t sendbuf_size, uint8_t *readbuf, uint32_t readbuf_size);
 
+/*!******************************************************************
+ * \fn void HT_MQTT_SetTlsCredentials(const char *ca_cert, int32_t ca_cert_len, const char *client_cert, int32_t client_cert_len,
+                                        const char *client_pk, int32_t client_pk_len)
+ * \brief Set the credentials used by HT_MQTT_Connect() when MQTT_TLS_ENABLE is 1.
+ *        Buffers are parsed on the next connection and must stay valid
+ *        (e.g. const arrays in flash). PEM lengths include the '\0'.
+ *
+ * \param[in] const char *ca_cert               Broker CA. Without it the certificate profile fails to
+ *                                              connect, unless HT_MQTT_TLS_PROFILE_CERT_NO_VERIFY is set.
+ * \param[in] int32_t ca_cert_len               CA length.
+ * \param[in] const char *client_cert           Device certificate, NULL = no client auth.
+ * \param[in] int32_t client_cert_len           Device certificate length.
+ * \param[in] const char *client_pk             Device private key.
+ * \param[in] int32_t client_pk_len             Device private key length.
+ * 
+ * \retval none
+ *******************************************************************/
+void HT_MQTT_SetTlsCredentials(const char *ca_cert, int32_t ca_cert_len, const char *client_cert, int32_t client_cert_len,
+                                        const char *client_pk, int32_t client_pk_len);
+
+/*!******************************************************************
+ * \fn void HT_MQTT_SetTlsProfile(uint8_t profile, const unsigned char *psk, int32_t psk_len, const char *psk_identity)
+ * \brief Select the handshake profile used when MQTT_TLS_ENABLE is 1.
+ *        PSK profiles skip all certificate work and are the cheapest
+ *        option on this MCU if the broker accepts them.
+ *
+ * \param[in] uint8_t profile                   HT_MQTT_TLSProfile (0 = certificates, 1 = PSK, 2 = ECDHE-PSK,
+ *                                              3 = certificates without verifying the broker).
+ * \param[in] const unsigned char *psk          Pre-shared key, must stay valid. Ignored for certificates.
+ * \param[in] int32_t psk_len                   Pre-shared key length.
+ * \param[in] const char *psk_identity          PSK identity.
+ * 
+ * \retval none
+ *******************************************************************/
+void HT_MQTT_SetTlsProfile(uint8_t profile, const unsigned char *psk, int32_t psk_len, const char *psk_identity);
+
 /*!******************************************************************
  * \fn int HT_MQTT_Publish(MQTTClient *mqtt_client, char *topic, uint8_t *payload, uint32_t len, enum QoS qos, uint8_t retained, uint16_t id, uint8_t dup)
 
@@ -118,6 +184,22 @@ void HT_MQTT_SubscribeCallback(MessageData *msg);
  *******************************************************************/
 void HT_MQTT_Subscribe(MQTTClient *mqtt_client, char *topic, enum QoS qos);
 
+/*!******************************************************************
+ * \fn void HT_MQTT_SubscribeTransient(MQTTClient *mqtt_client, char *topic, enum QoS qos)
+
+ * \brief Subscribe a MQTT topic held in a temporary buffer. The client
+ *        keeps no pointer to it: the handler slot is released right after
+ *        SUBACK and matching messages reach HT_MQTT_SubscribeCallback
+ *        through the client's default handler.
+ *
+ * \param[in] MQTTClient *mqtt_client           MQTT client handle.
+ * \param[in] char *topic                       MQTT topic to subscribe to, may be freed on return.
+ * \param[in] enum QoS qos                      QoS option.
+ *  
+ * \retval none
+ *******************************************************************/
+void HT_MQTT_SubscribeTransient(MQTTClient *mqtt_client, char *topic, enum QoS qos);
+
 /*!******************************************************************
  * \fn void HT_MQTT_SetMessageCallback(void (*callback)(MessageData *msg))
  * \brief Set the callback function for MQTT messages.
@@ -139,9 +221,81 @@ void HT_MQTT_SetMessageCallback(void (*callback)(MessageData *msg));
  *******************************************************************/
 int HT_MQTT_Yield(MQTTClient *mqtt_client, int timeout_ms);
 
+/*!******************************************************************
+ * \fn int HT_MQTT_WaitPacket(MQTTClient *mqtt_client, int timeout_ms)
+ * \brief Block on the socket until one packet is received and handled
+ *        or the timeout expires, then service the keepalive. The task
+ *        sleeps in the socket while waiting.
+ *
+ * \param[in] MQTTClient *mqtt_client           MQTT client handle.
+ * \param[in] int timeout_ms                    Longest wait in milliseconds.
+ * 
+ * \retval int                                  0 = Success, 1 = Error
+ *******************************************************************/
+int HT_MQTT_WaitPacket(MQTTClient *mqtt_client, int timeout_ms);
+
+/*!******************************************************************
+ * \fn uint32_t HT_MQTT_KeepaliveLeftMs(MQTTClient *mqtt_client)
+ * \brief Time until the keepalive needs the client: the PINGREQ when a
+ *        keepalive timer runs out, or HT_MQTT_PINGRESP_WAIT_MS while a
+ *        PINGRESP is outstanding.
+ *
+ * \param[in] MQTTClient *mqtt_client           MQTT client handle.
+ * 
+ * \retval uint32_t                             Milliseconds, UINT32_MAX with keepalive off.
+ *******************************************************************/
+uint32_t HT_MQTT_KeepaliveLeftMs(MQTTClient *mqtt_client);
+
+/*!******************************************************************
+ * \fn uint8_t HT_MQTT_HibArm(MQTTClient *mqtt_client)
+ * \brief Keep the connected session across sleep2/hibernate: the socket
+ *        is handed to sockmgr and the client state is written to the
+ *        user NVMem right before the platform goes down, with a deep
+ *        sleep timer (HT_MQTT_HIB_TIMER_ID) for the keepalive. Downlink
+ *        then waits in a NETWORK_HIB_RX_SIZE ring, so arm right before a
+ *        wait that may hibernate and disarm after it. Plain TCP only.
+ *
+ * \param[in] MQTTClient *mqtt_client           Connected MQTT client handle.
+ * 
+ * \retval uint8_t                              0 = Armed, 1 = Session is lost on deep sleep
+ *******************************************************************/
+uint8_t HT_MQTT_HibArm(MQTTClient *mqtt_client);
+
+/*!******************************************************************
+ * \fn uint8_t HT_MQTT_HibDisarm(MQTTClient *mqtt_client)
+ * \brief Give the socket back to the client after a wait that did not
+ *        hibernate (or after HT_MQTT_Resume()). Refused while downlink
+ *        is still in the sockmgr ring, call again after the next read.
+ *
+ * \param[in] MQTTClient *mqtt_client           MQTT client handle.
+ * 
+ * \retval uint8_t                              0 = Reads on the socket, 1 = Still armed
+ *******************************************************************/
+uint8_t HT_MQTT_HibDisarm(MQTTClient *mqtt_client);
+
+/*!******************************************************************
+ * \fn uint8_t HT_MQTT_Resume(MQTTClient *mqtt_client, Network *mqtt_network, uint8_t *sendbuf, uint32_t sendbuf_size,
+ *                             uint8_t *readbuf, uint32_t readbuf_size)
+ * \brief After a wake from sleep2/hibernate, rebuild the socket and the
+ *        client saved by HT_MQTT_HibArm() instead of a new CONNECT. The
+ *        broker kept the subscriptions (cleansession off). The saved
+ *        record is consumed, the session comes back armed.
+ *
+ * \param[in] MQTTClient *mqtt_client           MQTT client handle.
+ * \param[in] Network *mqtt_network             Network handle.
+ * \param[in] uint32_t sendbuf                  Buffer allocated for TX process.
+ * \param[in] uint32_t sendbuf_size             Size of TX buffer.
+ * \param[in] uint32_t readbuf                  Buffer allocated for RX process.
+ * \param[in] uint32_t readbuf_size             Size of RX buffer.
+ * 
+ * \retval uint8_t                              0 = Session resumed, 1 = Nothing to resume, connect instead
+ *******************************************************************/
+uint8_t HT_MQTT_Resume(MQTTClient *mqtt_client, Network *mqtt_network, uint8_t *sendbuf, uint32_t sendbuf_size,
+                       uint8_t *readbuf, uint32_t readbuf_size);
+
 /*!******************************************************************
  * \fn int HT_MQTT_Disconnect(MQTTClient *mqtt_client)
- * \brief Disconnect from MQTT broker.
+ * \brief Disconnect from MQTT broker. Drops the saved hibernation session.
  *
  * \param[in] MQTTClient *mqtt_client           MQTT client handle.
  * 
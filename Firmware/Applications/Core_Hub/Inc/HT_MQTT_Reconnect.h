@@ -0,0 +1,163 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file HT_MQTT_Reconnect.h
+ * \brief MQTT reconnect policy: failure classification and capped exponential backoff.
+  * \author HT Micron Advanced R&D,
+ *         Hêndrick Bataglin Gonçalves, Christian Roberto Lehmen,  Matheus da Silva Zorzeto, Felipe Kalinski Ferreira,
+ *         Leandro Borges, Mauricio Carlotto Ribeiro, Henrique Kuhn, Cleber Haack, Eduardo Mendel
+ *         Gleiser Alvarez Arrojo
+ *
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#ifndef __HT_MQTT_RECONNECT_H__
+#define __HT_MQTT_RECONNECT_H__
+
+#include "stdint.h"
+
+/* Defines  ------------------------------------------------------------------*/
+
+#define HT_MQTT_RECONN_NO_BEARER_BASE_MS    10000       /**</ First wait when the PDN bearer is down. */
+#define HT_MQTT_RECONN_NO_BEARER_CAP_MS     600000      /**</ Longest wait when the PDN bearer is down (woken early by NETINFO). */
+#define HT_MQTT_RECONN_TCP_RST_BASE_MS      2000        /**</ First wait after a TCP reset/refusal. */
+#define HT_MQTT_RECONN_TCP_RST_CAP_MS       120000      /**</ Longest wait after a TCP reset/refusal. */
+#define HT_MQTT_RECONN_REFUSED_BASE_MS      30000       /**</ First wait after the broker refused the CONNECT. */
+#define HT_MQTT_RECONN_REFUSED_CAP_MS       1800000     /**</ Longest wait after the broker refused the CONNECT. */
+#define HT_MQTT_RECONN_TIMEOUT_BASE_MS      5000        /**</ First wait after a connect/CONNACK/keepalive timeout. */
+#define HT_MQTT_RECONN_TIMEOUT_CAP_MS       300000      /**</ Longest wait after a connect/CONNACK/keepalive timeout. */
+
+/* Typedefs  ------------------------------------------------------------------*/
+
+/**
+ * \enum HT_MQTT_ReconnCause
+ * \brief Reason why the last connection attempt failed or the session was lost.
+ */
+typedef enum {
+    HT_MQTT_RECONN_CAUSE_NO_BEARER = 0,                 /**</ No PDN bearer / no route to the broker. */
+    HT_MQTT_RECONN_CAUSE_TCP_RST,                       /**</ TCP connection reset, aborted or refused. */
+    HT_MQTT_RECONN_CAUSE_CONNACK_REFUSED,               /**</ Broker answered CONNACK with a non-zero return code. */
+    HT_MQTT_RECONN_CAUSE_TIMEOUT,                       /**</ TCP connect, CONNACK or PINGRESP timed out. */
+    HT_MQTT_RECONN_CAUSE_NUM
+} HT_MQTT_ReconnCause;
+
+/**
+ * \struct HT_MQTT_ReconnStats_t
+ * \brief Reconnect counters, kept since boot.
+ */
+typedef struct {
+    uint32_t failures[HT_MQTT_RECONN_CAUSE_NUM];        /**</ Failures per cause. */
+    uint32_t connects;                                  /**</ Successful connections. */
+    uint32_t bearer_wakeups;                            /**</ Backoff waits cut short by the bearer coming back. */
+    uint32_t last_delay_ms;                             /**</ Last backoff delay applied. */
+} HT_MQTT_ReconnStats_t;
+
+/* Functions ------------------------------------------------------------------*/
+
+/*!******************************************************************
+ * \fn void HT_MQTT_ReconnInit(uint32_t seed)
+ * \brief Create the bearer wakeup semaphore and seed the jitter generator.
+ *        Must be called before HT_MQTT_ReconnWait().
+ *
+ * \param[in] uint32_t seed                     Device-unique value (e.g. IMSI hash) so hubs don't retry in lockstep.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_MQTT_ReconnInit(uint32_t seed);
+
+/*!******************************************************************
+ * \fn HT_MQTT_ReconnCause HT_MQTT_ReconnClassifyConnect(uint8_t connect_result)
+ * \brief Map a HT_MQTT_Connect() error code to a reconnect cause.
+ *
+ * \param[in] uint8_t connect_result            Non-zero value returned by HT_MQTT_Connect().
+ *
+ * \retval HT_MQTT_ReconnCause                  Failure class.
+ *******************************************************************/
+HT_MQTT_ReconnCause HT_MQTT_ReconnClassifyConnect(uint8_t connect_result);
+
+/*!******************************************************************
+ * \fn HT_MQTT_ReconnCause HT_MQTT_ReconnClassifyErrno(int sock_errno)
+ * \brief Map the errno of a socket that dropped an established session
+ *        to a reconnect cause.
+ *
+ * \param[in] int sock_errno                    Value of sock_get_errno() for the MQTT socket.
+ *
+ * \retval HT_MQTT_ReconnCause                  Failure class.
+ *******************************************************************/
+HT_MQTT_ReconnCause HT_MQTT_ReconnClassifyErrno(int sock_errno);
+
+/*!******************************************************************
+ * \fn uint32_t HT_MQTT_ReconnWait(HT_MQTT_ReconnCause cause)
+ * \brief Count the failure, compute the next backoff delay for its class
+ *        and block until it expires or the bearer comes back.
+ *
+ * \param[in] HT_MQTT_ReconnCause cause         Failure class.
+ *
+ * \retval uint32_t                             Time actually waited in ms.
+ *******************************************************************/
+uint32_t HT_MQTT_ReconnWait(HT_MQTT_ReconnCause cause);
+
+/*!******************************************************************
+ * \fn void HT_MQTT_ReconnSuccess(void)
+ * \brief Reset every backoff after a successful connection.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_MQTT_ReconnSuccess(void);
+
+/*!******************************************************************
+ * \fn void HT_MQTT_ReconnNotifyBearer(uint8_t up)
+ * \brief Report a bearer state change. A down->up transition wakes a
+ *        pending HT_MQTT_ReconnWait() immediately. Safe to call from the
+ *        PS URC callback.
+ *
+ * \param[in] uint8_t up                        1 = bearer activated, 0 = deactivated.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_MQTT_ReconnNotifyBearer(uint8_t up);
+
+/*!******************************************************************
+ * \fn uint8_t HT_MQTT_ReconnBearerUp(void)
+ * \brief Last bearer state reported through HT_MQTT_ReconnNotifyBearer().
+ *
+ * \retval uint8_t                              1 = up, 0 = down.
+ *******************************************************************/
+uint8_t HT_MQTT_ReconnBearerUp(void);
+
+/*!******************************************************************
+ * \fn void HT_MQTT_ReconnGetStats(HT_MQTT_ReconnStats_t *stats)
+ * \brief Copy the reconnect counters.
+ *
+ * \param[out] HT_MQTT_ReconnStats_t *stats     Destination.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_MQTT_ReconnGetStats(HT_MQTT_ReconnStats_t *stats);
+
+#endif /* __HT_MQTT_RECONNECT_H__ */
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -81,7 +81,7 @@ ________________________________________________________________________________
 #define RTE_UART0_RX_IO_MODE    POLLING_MODE
 #define USART0_RX_TRIG_LVL      (30)
 
-#define RTE_UART1_TX_IO_MODE    POLLING_MODE
+#define RTE_UART1_TX_IO_MODE    DMA_MODE
 #define RTE_UART1_RX_IO_MODE    POLLING_MODE
 
 #define RTE_UART2_TX_IO_MODE    POLLING_MODE
@@ -228,6 +228,12 @@ ________________________________________________________________________________
 #define USART_PRINT_SELECT  HAL_USART1_SELECT
 #define USART_UNILOG_SELECT HAL_USART0_SELECT
 
+// printf is copied into a RAM ring and drained by the print USART TX DMA
+// (needs the print USART TX in DMA_MODE, otherwise it stays polling)
+#define USART_PRINT_ASYNC_ENABLE    1
+#define USART_PRINT_RING_SIZE       1024
+#define USART_PRINT_OVF_POLICY      USART_PRINT_OVF_DROP
+
 // SPI0 (Serial Peripheral Interface) [Driver_SPI0]
 // Configuration settings for Driver_SPI0 in component ::Drivers:SPI
 #define RTE_SPI0                        0
@@ -67,8 +67,31 @@
 #define HTTP_RECV_BUF_SIZE      (1300)
 #define HTTP_URL_BUF_LEN        (128)
 
+/* Typedefs  ------------------------------------------------------------------*/
+
+/**
+ * \struct HT_PsEventStats_t
+ * \brief PS event queue counters, kept since boot. Items are queued by
+ *        value, so the queue never touches the heap.
+ */
+typedef struct {
+    uint32_t sent;                                      /**</ Events queued by the PS URC callback. */
+    uint32_t dropped;                                   /**</ Events lost because the queue was full or not created yet. */
+    uint32_t peak_depth;                                /**</ Most events waiting at once, out of APP_EVENT_QUEUE_SIZE. */
+} HT_PsEventStats_t;
+
 /* Funções */
 void HT_CoreHubFsm(void);
 
+/*!******************************************************************
+ * \fn void HT_PsEventGetStats(HT_PsEventStats_t *stats)
+ * \brief Copy the PS event queue counters.
+ *
+ * \param[out] HT_PsEventStats_t *stats         Destination.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_PsEventGetStats(HT_PsEventStats_t *stats);
+
 /************************ HT Micron Semicondutores S.A *****END OF FILE****/
 
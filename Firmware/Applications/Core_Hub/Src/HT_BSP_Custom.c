@@ -21,6 +21,7 @@
 #include "debug_log.h"
 #include "unilog_qcx212.h"
 #include "HT_usart_unilog.h"
+#include "HT_CoreHub_Sleep.h"
 
 void GPR_SetUartClk(void) {
     GPR_ClockDisable(GPR_UART0FuncClk);
@@ -31,11 +32,9 @@ void GPR_SetUartClk(void) {
 
 #if LOW_POWER_AT_TEST
 slpManSlpState_t CheckUsrdefSlpStatus(void) {
-    slpManSlpState_t status = SLP_HIB_STATE;
+    slpManSlpState_t status = HT_Sleep_MaxDepth();          // work held, deadline or session in RAM
     if((slpManGetWakeupPinValue() & (0x1<<1)) == 0)         // pad1 value is low
         status = SLP_IDLE_STATE;
-    else
-        status = SLP_HIB_STATE;
 
     return status;
 }
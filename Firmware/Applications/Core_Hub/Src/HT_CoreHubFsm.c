@@ -1,6 +1,15 @@
 
+#define HT_LOG_MODULE_LEVEL HT_LOG_LEVEL_FSM
+#include "HT_CoreHub_Log.h"
 #include "HT_CoreHubFsm.h"
 #include "HT_MQTT_Api.h"
+#include "HT_MQTT_Reconnect.h"
+#include "HT_CoreHub_Health.h"
+#include "HT_CoreHub_Uplink.h"
+#include "HT_CoreHub_Sleep.h"
+#include "HT_CoreHub_State.h"
+#include "HT_CoreHub_Series.h"
+#include "HT_CoreHub_Config.h"
 #include "stdio.h"
 #include "string.h"
 #include "FreeRTOS.h"
@@ -8,8 +17,6 @@
 #include "osasys.h" 
 #include "cJSON.h"
 
-extern const char* ambientes[NUM_AMBIENTES];
-
 /* Estados da FSM - Exatamente como no diagrama */
 typedef enum {
     COREHUB_INIT_STATE = 0,           // Início
@@ -45,14 +52,48 @@ typedef struct {
 // Instâncias para múltiplos ambientes
 CoreHub_Data_t corehub_data[NUM_AMBIENTES];
 CoreHub_FSM_States current_state[NUM_AMBIENTES];
-// Buffers de tópicos por ambiente
-static char topic_smartdoor_door[NUM_AMBIENTES][64];
-static char topic_smartdoor_light[NUM_AMBIENTES][64];
-static char topic_smartdoor_buzzer[NUM_AMBIENTES][64];
-static char topic_senseclima_temp[NUM_AMBIENTES][64];
-static char topic_senseclima_humidity[NUM_AMBIENTES][64];
-static char topic_aircontrol_power[NUM_AMBIENTES][64];
-static char topic_aircontrol_temp[NUM_AMBIENTES][64];
+// Tópicos: "hana/<ambiente>/<sufixo>". Prefixo e sufixos são constantes em flash,
+// cada ambiente guarda só o ponteiro do nome; a string é montada ao publicar/inscrever.
+typedef enum {
+    COREHUB_TOPIC_SMARTDOOR_DOOR = 0,
+    COREHUB_TOPIC_SMARTDOOR_LIGHT,
+    COREHUB_TOPIC_SMARTDOOR_BUZZER,
+    COREHUB_TOPIC_SENSECLIMA_TEMP,
+    COREHUB_TOPIC_SENSECLIMA_HUMIDITY,
+    COREHUB_TOPIC_AIRCONTROL_POWER,
+    COREHUB_TOPIC_AIRCONTROL_TEMP,
+    COREHUB_TOPIC_HISTORY_GET,
+    COREHUB_TOPIC_HISTORY,
+    COREHUB_TOPIC_NUM
+} CoreHub_TopicId;
+
+static const char corehub_topic_prefix[] = "hana/";
+static const char * const corehub_topic_suffix[COREHUB_TOPIC_NUM] = {
+    [COREHUB_TOPIC_SMARTDOOR_DOOR]      = "smartdoor/door",
+    [COREHUB_TOPIC_SMARTDOOR_LIGHT]     = "smartdoor/light",
+    [COREHUB_TOPIC_SMARTDOOR_BUZZER]    = "smartdoor/buzzer",
+    [COREHUB_TOPIC_SENSECLIMA_TEMP]     = "senseclima/01/temperature",
+    [COREHUB_TOPIC_SENSECLIMA_HUMIDITY] = "senseclima/01/humidity",
+    [COREHUB_TOPIC_AIRCONTROL_POWER]    = "aircontrol/01/power",
+    [COREHUB_TOPIC_AIRCONTROL_TEMP]     = "aircontrol/01/temperature",
+    [COREHUB_TOPIC_HISTORY_GET]         = "history/get",
+    [COREHUB_TOPIC_HISTORY]             = "history",
+};
+
+// Tópicos assinados em cada ambiente
+static const CoreHub_TopicId corehub_topic_subscribed[] = {
+    COREHUB_TOPIC_SMARTDOOR_DOOR,
+    COREHUB_TOPIC_SMARTDOOR_LIGHT,
+    COREHUB_TOPIC_SENSECLIMA_TEMP,
+    COREHUB_TOPIC_SENSECLIMA_HUMIDITY,
+    COREHUB_TOPIC_HISTORY_GET,
+};
+
+static const char *ambiente_nome[NUM_AMBIENTES];
+static int ambiente_count = 0;          // Ambientes inicializados (lista da imagem de configuração)
+
+// Chave do agendador de uplink: (ambiente, tópico) em 16 bits
+#define COREHUB_UPLINK_KEY(amb, id)     ((uint16_t)(((amb) << 8) | (id)))
 
 // Cliente MQTT único para todos os ambientes
 static MQTTClient mqttClient_global;
@@ -75,6 +116,24 @@ static uint8_t fsm_stuck_detected[NUM_AMBIENTES] = {0};
 // Watchdog global do sistema
 static uint32_t last_watchdog_check = 0;
 
+// Pedido de histórico: o callback só anota, a resposta sai do loop MQTT (fora do ciclo de leitura)
+static struct {
+    uint8_t pending;
+    uint8_t ambiente;
+    uint8_t tier;
+    uint32_t from;
+    uint32_t to;
+} corehub_history_req;
+
+// Resposta em andamento: pontos acumulados em pts, publicados em blocos
+static struct {
+    uint16_t points;
+    uint16_t seq;
+    int len;
+    char pts[HT_COREHUB_HISTORY_CHUNK];
+    char msg[HT_COREHUB_HISTORY_CHUNK + 48];
+} corehub_history;
+
 /* Declaração antecipada da função de tempo */
 static uint32_t CoreHub_GetTimeSecs(void);
 
@@ -82,51 +141,274 @@ static uint32_t CoreHub_GetTimeSecs(void);
 static void CoreHub_WatchdogCheck(void) {
     uint32_t current_time = CoreHub_GetTimeSecs();
     
-    // Verifica a cada 30 segundos
+    // Verifica a cada 30 segundos (ou no próximo despertar do loop)
     if (current_time - last_watchdog_check < 30) {
         return;
     }
     last_watchdog_check = current_time;
     
     // Verifica se alguma FSM está travada
-    for (int i = 0; i < NUM_AMBIENTES; i++) {
+    for (int i = 0; i < ambiente_count; i++) {
         if (fsm_execution_count[i] > 500) { // Se executou mais de 500 vezes sem reset
             fsm_stuck_detected[i] = 1;
-            printf("[CoreHub] WATCHDOG: FSM %s detectada como travada\n", ambientes[i]);
+            HT_LOG(watchdog_stuck, P_WARNING, 1, "[CoreHub][amb %d] WATCHDOG: FSM detectada como travada", i);
         }
     }
     
-    // Log de saúde do sistema a cada 5 minutos
-    static uint32_t health_log_counter = 0;
-    health_log_counter++;
-    if (health_log_counter >= 10) { // 30s * 10 = 5 minutos
-        printf("[CoreHub] SAÚDE: Sistema operando normalmente (%lu s uptime)\n", current_time);
-        health_log_counter = 0;
+    // Log de saúde do sistema a cada 5 minutos (o loop não acorda a cada 30 s, conta pelo relógio)
+    static uint32_t last_health_log = 0;
+    if (current_time - last_health_log >= 300) {
+        HT_LOG(health, P_INFO, 1, "[CoreHub] SAÚDE: Sistema operando normalmente (%u s uptime)", (unsigned int)current_time);
+        last_health_log = current_time;
+    }
+}
+
+/* Publica as estatísticas de I/O do socket da conexão atual */
+static void CoreHub_PublishNetStats(void) {
+    static uint32_t last_netstats = 0;
+    char status[320];
+    int len;
+
+    uint32_t current_time = CoreHub_GetTimeSecs();
+    if (current_time - last_netstats < (HT_COREHUB_NETSTATS_INTERVAL_MS / 1000)) {
+        return;
+    }
+    last_netstats = current_time;
+
+    len = NetworkStatsFormat(&mqttNetwork_global, status, sizeof(status));
+    if (len <= 0 || len >= (int)sizeof(status)) {
+        return;
+    }
+
+    HT_Sleep_Hold(HT_SLEEP_HOLD_PUBLISH);
+    HT_MQTT_Publish(&mqttClient_global, HT_COREHUB_NETSTATS_TOPIC, (uint8_t *)status, len, QOS0, 1, 0, 0);
+    HT_Sleep_Release(HT_SLEEP_HOLD_PUBLISH);
+}
+
+/* Publica o status de RAM (stacks, heap, sbrk, falhas de alocação) como retido */
+static void CoreHub_PublishHealth(void) {
+    static uint32_t last_health = 0;
+    static HT_HealthReport_t report;
+    char status[640];
+    int len;
+
+    uint32_t current_time = CoreHub_GetTimeSecs();
+    if (last_health != 0 && current_time - last_health < (HT_COREHUB_HEALTH_INTERVAL_MS / 1000)) {
+        return;
     }
+    last_health = current_time ? current_time : 1;
+
+    HT_Health_Collect(&report);
+    HT_LOG(health_heap, P_INFO, 4, "[CoreHub] Heap livre %u (mín %u), falhas heap %u malloc %u",
+           (unsigned int)report.heap_free, (unsigned int)report.heap_free_min,
+           (unsigned int)report.heap_alloc_failures, (unsigned int)report.malloc_failures);
+
+    len = HT_Health_Format(&report, status, sizeof(status));
+    if (len <= 0) {
+        return;
+    }
+
+    HT_Sleep_Hold(HT_SLEEP_HOLD_PUBLISH);
+    HT_MQTT_Publish(&mqttClient_global, HT_COREHUB_HEALTH_TOPIC, (uint8_t *)status, len, QOS0, 1, 0, 0);
+    HT_Sleep_Release(HT_SLEEP_HOLD_PUBLISH);
 }
 
-/* Configurações MQTT */
-static const char clientID[] = {"corehub01"};
-static const char username[] = {""};
-static const char password[] = {""};
-static const char broker_addr[] = {"131.255.82.115"};
-static const int32_t broker_port = HT_MQTT_PORT;
-
-/* Função para montar tópicos MQTT dinamicamente */
-static void CoreHub_MontaTopicos(int ambiente_idx, const char* ambiente) {
-    snprintf(topic_smartdoor_door[ambiente_idx], sizeof(topic_smartdoor_door[ambiente_idx]), "hana/%s/smartdoor/door", ambiente);
-    snprintf(topic_smartdoor_light[ambiente_idx], sizeof(topic_smartdoor_light[ambiente_idx]), "hana/%s/smartdoor/light", ambiente);
-    snprintf(topic_smartdoor_buzzer[ambiente_idx], sizeof(topic_smartdoor_buzzer[ambiente_idx]), "hana/%s/smartdoor/buzzer", ambiente);
-    snprintf(topic_senseclima_temp[ambiente_idx], sizeof(topic_senseclima_temp[ambiente_idx]), "hana/%s/senseclima/01/temperature", ambiente);
-    snprintf(topic_senseclima_humidity[ambiente_idx], sizeof(topic_senseclima_humidity[ambiente_idx]), "hana/%s/senseclima/01/humidity", ambiente);
-    snprintf(topic_aircontrol_power[ambiente_idx], sizeof(topic_aircontrol_power[ambiente_idx]), "hana/%s/aircontrol/01/power", ambiente);
-    snprintf(topic_aircontrol_temp[ambiente_idx], sizeof(topic_aircontrol_temp[ambiente_idx]), "hana/%s/aircontrol/01/temperature", ambiente);
+/* Monta o tópico (ambiente, sufixo) em buf, retorna o tamanho ou -1 se não couber */
+static int CoreHub_TopicFormat(char *buf, size_t size, int ambiente_idx, CoreHub_TopicId id) {
+    int len = snprintf(buf, size, "%s%s/%s", corehub_topic_prefix, ambiente_nome[ambiente_idx], corehub_topic_suffix[id]);
+    return (len < 0 || (size_t)len >= size) ? -1 : len;
+}
+
+/* Converte um tópico recebido de volta em (ambiente, sufixo), sem cópia */
+static int CoreHub_TopicParse(const char *topic, size_t len, int *ambiente_idx, CoreHub_TopicId *id) {
+    size_t prefix_len = sizeof(corehub_topic_prefix) - 1;
+    size_t name_len;
+    const char *name, *sep;
+
+    if (len <= prefix_len || memcmp(topic, corehub_topic_prefix, prefix_len) != 0) {
+        return -1;
+    }
+    name = topic + prefix_len;
+    sep = memchr(name, '/', len - prefix_len);
+    if (sep == NULL) {
+        return -1;
+    }
+    name_len = sep - name;
+
+    for (int i = 0; i < ambiente_count; i++) {
+        if (ambiente_nome[i] == NULL || strlen(ambiente_nome[i]) != name_len || memcmp(ambiente_nome[i], name, name_len) != 0) {
+            continue;
+        }
+        for (int t = 0; t < COREHUB_TOPIC_NUM; t++) {
+            size_t suffix_len = strlen(corehub_topic_suffix[t]);
+            if (suffix_len == len - prefix_len - name_len - 1 && memcmp(corehub_topic_suffix[t], sep + 1, suffix_len) == 0) {
+                *ambiente_idx = i;
+                *id = (CoreHub_TopicId)t;
+                return 0;
+            }
+        }
+        return -1;
+    }
+    return -1; // Não encontrado
+}
+
+/* Publica um bloco do histórico: {"tier":t,"seq":n,"last":0|1,"p":[[time,canal,count,média,mín,máx],...]} */
+static void CoreHub_HistorySend(uint8_t last) {
+    char topic[HT_COREHUB_TOPIC_MAX_LEN];
+    int len;
+
+    len = snprintf(corehub_history.msg, sizeof(corehub_history.msg), "{\"tier\":%u,\"seq\":%u,\"last\":%u,\"p\":[%.*s]}",
+                   (unsigned int)corehub_history_req.tier, (unsigned int)corehub_history.seq, (unsigned int)last,
+                   corehub_history.len, corehub_history.pts);
+    corehub_history.seq++;
+    corehub_history.len = 0;
+
+    if (len <= 0 || len >= (int)sizeof(corehub_history.msg) ||
+        CoreHub_TopicFormat(topic, sizeof(topic), corehub_history_req.ambiente, COREHUB_TOPIC_HISTORY) < 0) {
+        return;
+    }
+
+    HT_Sleep_Hold(HT_SLEEP_HOLD_PUBLISH);
+    HT_MQTT_Publish(&mqttClient_global, topic, (uint8_t *)corehub_history.msg, len, QOS0, 0, 0, 0);
+    HT_Sleep_Release(HT_SLEEP_HOLD_PUBLISH);
+}
+
+static int CoreHub_HistoryVisit(const HT_SeriesPoint *point, void *ctx) {
+    char entry[48];
+    int n;
+
+    (void)ctx;
+    if (point->ambiente != corehub_history_req.ambiente) {
+        return 0;
+    }
+
+    n = snprintf(entry, sizeof(entry), "%s[%lu,%u,%u,%d,%d,%d]", corehub_history.len ? "," : "",
+                 (unsigned long)point->time, (unsigned int)point->channel, (unsigned int)point->count,
+                 point->mean, point->min, point->max);
+    if (n <= 0 || n >= (int)sizeof(entry)) {
+        return 0;
+    }
+
+    // Bloco cheio: publica e recomeça sem a vírgula inicial
+    if (corehub_history.len + n > (int)sizeof(corehub_history.pts)) {
+        CoreHub_HistorySend(0);
+        n = snprintf(entry, sizeof(entry), "[%lu,%u,%u,%d,%d,%d]",
+                     (unsigned long)point->time, (unsigned int)point->channel, (unsigned int)point->count,
+                     point->mean, point->min, point->max);
+    }
+    memcpy(corehub_history.pts + corehub_history.len, entry, n);
+    corehub_history.len += n;
+
+    return ++corehub_history.points >= HT_COREHUB_HISTORY_MAX_POINTS;
+}
+
+/* Responde o pedido de histórico anotado pelo callback */
+static void CoreHub_PublishHistory(void) {
+    if (!corehub_history_req.pending) {
+        return;
+    }
+    corehub_history_req.pending = 0;
+
+    corehub_history.points = 0;
+    corehub_history.seq = 0;
+    corehub_history.len = 0;
+
+    HT_Series_Query((HT_SeriesTier)corehub_history_req.tier, corehub_history_req.from, corehub_history_req.to,
+                    CoreHub_HistoryVisit, NULL);
+    CoreHub_HistorySend(1);
+
+    HT_LOG(history_sent, P_INFO, 3, "[CoreHub][amb %d] Histórico camada %d: %d pontos",
+           corehub_history_req.ambiente, corehub_history_req.tier, corehub_history.points);
+}
+
+/* Lê um decimal sem sinal e avança p; 0 se não houver dígitos */
+static int CoreHub_ParseUint(const char **p, uint32_t *value) {
+    const char *s = *p;
+    uint32_t v = 0;
+
+    while (*s == ' ') {
+        s++;
+    }
+    if (*s < '0' || *s > '9') {
+        return 0;
+    }
+    for (; *s >= '0' && *s <= '9'; s++) {
+        v = v * 10 + (uint32_t)(*s - '0');
+    }
+    *p = s;
+    *value = v;
+    return 1;
+}
+
+/* Pedido "<camada> [<de> [<até>]]": camada 0 = bruto, 1 = 1 min, 2 = 15 min; tempos em segundos do
+   relógio do sistema (OsaSystemTimeReadSecs), sem limites = tudo que está em flash */
+static void CoreHub_HistoryRequest(int ambiente_idx, const char *payload) {
+    uint32_t tier, from = 0, to = UINT32_MAX;
+
+    if (!CoreHub_ParseUint(&payload, &tier) || tier >= HT_SERIES_TIERS) {
+        return;
+    }
+    if (CoreHub_ParseUint(&payload, &from)) {
+        CoreHub_ParseUint(&payload, &to);
+    }
+
+    corehub_history_req.ambiente = (uint8_t)ambiente_idx;
+    corehub_history_req.tier = (uint8_t)tier;
+    corehub_history_req.from = from;
+    corehub_history_req.to = to;
+    corehub_history_req.pending = 1;
 }
 
 void HT_CoreHub_InitAmbiente(int ambiente_idx, const char* nome) {
-    memset(&corehub_data[ambiente_idx], 0, sizeof(CoreHub_Data_t));
+    CoreHub_Data_t* data = &corehub_data[ambiente_idx];
+    HT_StateAmbiente saved;
+
+    memset(data, 0, sizeof(CoreHub_Data_t));
     current_state[ambiente_idx] = COREHUB_INIT_STATE;
-    CoreHub_MontaTopicos(ambiente_idx, nome);
+    ambiente_nome[ambiente_idx] = nome;   // Nome deve ser constante (string da imagem de configuração)
+    if (ambiente_idx >= ambiente_count) {
+        ambiente_count = ambiente_idx + 1;
+    }
+
+    // Decisões salvas em flash voltam no boot, sem esperar a rede nem as mensagens retidas
+    if (!HT_State_Restore(ambiente_idx, nome, &saved)) {
+        return;
+    }
+    data->temperature = saved.temperature;
+    data->door_state = saved.door_state;
+    data->light_state = saved.light_state;
+    data->ac_state = saved.ac_state;
+    data->buzzer_state = saved.buzzer_state;
+    HT_LOG(state_restored, P_INFO, 4, "[CoreHub][amb %d] Estado restaurado: porta %d luz %d AC %d",
+           ambiente_idx, data->door_state, data->light_state, data->ac_state);
+
+    if (saved.alarm_active) {
+        // Alarme retoma o timer de onde parou (o relógio recomeça em zero a cada boot)
+        data->alarm_active = 1;
+        data->alarm_start_time = CoreHub_GetTimeSecs() - saved.alarm_elapsed;
+        current_state[ambiente_idx] = COREHUB_WAIT_TIMER_STATE;
+        HT_LOG(state_alarm_restored, P_SIG, 2, "[CoreHub][amb %d] Alarme retomado em %u s", ambiente_idx, (unsigned int)saved.alarm_elapsed);
+    }
+}
+
+/* Entrega o estado de decisão de cada ambiente ao snapshot; a escrita em flash é agrupada */
+static void CoreHub_StateSnapshot(void) {
+    uint32_t now = CoreHub_GetTimeSecs();
+
+    for (int i = 0; i < ambiente_count; i++) {
+        HT_StateAmbiente amb;
+
+        memset(&amb, 0, sizeof(amb));
+        amb.temperature = corehub_data[i].temperature;
+        amb.door_state = corehub_data[i].door_state;
+        amb.light_state = corehub_data[i].light_state;
+        amb.ac_state = corehub_data[i].ac_state;
+        amb.buzzer_state = corehub_data[i].buzzer_state;
+        amb.alarm_active = corehub_data[i].alarm_active;
+        amb.alarm_elapsed = corehub_data[i].alarm_active ? now - corehub_data[i].alarm_start_time : 0;
+        HT_State_Update(i, &amb);
+    }
+    HT_State_Poll();
 }
 
 void HT_CoreHub_StartAmbienteTask(int ambiente_idx) {
@@ -171,17 +453,36 @@ static float string_to_float(const char* str) {
     return simple_str_to_float(str);
 }
 
+// Centésimos para as séries em flash, saturados em int16
+static int16_t CoreHub_SeriesValue(float value) {
+    value *= 100.0f;
+    if (value > 32767.0f) {
+        return INT16_MAX;
+    } else if (value < -32768.0f) {
+        return INT16_MIN;
+    }
+    return (int16_t)(value + (value < 0 ? -0.5f : 0.5f));
+}
+
 // Função de publish com retry otimizada
-static int CoreHub_MQTTPublishWithRetry(MQTTClient *mqtt_client, char *topic, uint8_t *payload, uint32_t len, enum QoS qos, uint8_t retained, uint16_t id, uint8_t dup, int max_retries) {
+static int CoreHub_MQTTPublishWithRetry(MQTTClient *mqtt_client, int ambiente_idx, CoreHub_TopicId topic_id, uint8_t *payload, uint32_t len, enum QoS qos, uint8_t retained, uint16_t id, uint8_t dup, int max_retries) {
+    char topic[HT_COREHUB_TOPIC_MAX_LEN];
+
     // Proteção contra parâmetros inválidos
-    if (!mqtt_client || !topic || !payload || len == 0) {
+    if (!mqtt_client || !payload || len == 0) {
+        return -1;
+    }
+    if (CoreHub_TopicFormat(topic, sizeof(topic), ambiente_idx, topic_id) < 0) {
         return -1;
     }
     
     int rc = -1;
+    // Voto de sleep enquanto a publicação (e suas retentativas) estiver em curso
+    HT_Sleep_Hold(HT_SLEEP_HOLD_PUBLISH);
     for (int attempt = 1; attempt <= max_retries; ++attempt) {
         rc = HT_MQTT_Publish(mqtt_client, topic, payload, len, qos, retained, id, dup);
         if (rc == 0) {
+            HT_Sleep_Release(HT_SLEEP_HOLD_PUBLISH);
             return 0;
         }
         
@@ -190,20 +491,26 @@ static int CoreHub_MQTTPublishWithRetry(MQTTClient *mqtt_client, char *topic, ui
         if (delay_ms > 500) delay_ms = 500; // Máximo 500ms
         vTaskDelay(pdMS_TO_TICKS(delay_ms));
     }
+    HT_Sleep_Release(HT_SLEEP_HOLD_PUBLISH);
     
-    printf("[CoreHub] ERRO: Falha ao publicar %s após %d tentativas\n", topic, max_retries);
+    HT_LOG(publish_fail, P_ERROR, 2, "[CoreHub] ERRO: Falha ao publicar após %d tentativas (rc %d)", max_retries, rc);
+    HT_LOG_STR(publish_fail_topic, P_ERROR, "[CoreHub] ERRO: tópico %s", topic);
     return rc;
 }
 
-static int CoreHub_IdentificaAmbientePorTopico(const char* topic) {
-    for (int i = 0; i < NUM_AMBIENTES; ++i) {
-        char prefix[32];
-        snprintf(prefix, sizeof(prefix), "hana/%s/", ambientes[i]);
-        if (strncmp(topic, prefix, strlen(prefix)) == 0) {
-            return i;
-        }
-    }
-    return -1; // Não encontrado
+/* Envio do agendador de uplink: materializa o tópico a partir da chave */
+static int CoreHub_UplinkSend(uint16_t key, const uint8_t *payload, uint32_t len) {
+    return CoreHub_MQTTPublishWithRetry(&mqttClient_global, key >> 8, (CoreHub_TopicId)(key & 0xFF),
+                                        (uint8_t *)payload, len, QOS0, 1, 0, 0, 3);
+}
+
+/* Relatórios periódicos vão junto de cada rajada de uplink */
+static void CoreHub_UplinkFlushHook(void) {
+    // Estatísticas de socket para ajuste de buffers e timeouts
+    CoreHub_PublishNetStats();
+
+    // Telemetria de RAM para dimensionar stacks e heap em campo
+    CoreHub_PublishHealth();
 }
 
 /* Callback para mensagens MQTT */
@@ -212,6 +519,13 @@ static void HT_CoreHub_MessageCallback(MessageData *msg) {
     if (msg == NULL || msg->message == NULL || msg->topicName == NULL) {
         return;
     }
+
+    // Pacote em processamento: mantém o voto até a FSM consumir o evento (liberado antes do próximo bloqueio)
+    HT_Sleep_Hold(HT_SLEEP_HOLD_PACKET);
+
+    // Downlink recebido: o rádio está conectado, uplinks retidos podem sair agora
+    HT_Uplink_NotifyRadio();
+
     if (msg->message->payload == NULL || msg->message->payloadlen == 0) {
         return;
     }
@@ -221,39 +535,40 @@ static void HT_CoreHub_MessageCallback(MessageData *msg) {
     size_t payload_len = msg->message->payloadlen;
     
     if (topic_len > 127 || payload_len > 63) {
-        printf("[CoreHub] ERRO: Mensagem MQTT muito grande (topic:%zu, payload:%zu)\n", topic_len, payload_len);
+        HT_LOG(msg_too_big, P_WARNING, 2, "[CoreHub] ERRO: Mensagem MQTT muito grande (topic:%u, payload:%u)", (unsigned int)topic_len, (unsigned int)payload_len);
         return;
     }
 
-    char topic[128] = {0};
     char payload[64] = {0};
+    int ambiente_idx;
+    CoreHub_TopicId topic_id;
+
+    // Identifica (ambiente, tópico) direto do buffer de leitura
+    if (CoreHub_TopicParse(msg->topicName->lenstring.data, topic_len, &ambiente_idx, &topic_id) != 0) {
+        return;
+    }
 
     // Cópia segura dos dados
-    memcpy(topic, msg->topicName->lenstring.data, topic_len);
-    topic[topic_len] = '\0';
     memcpy(payload, msg->message->payload, payload_len);
     payload[payload_len] = '\0';
 
-    int ambiente_idx = CoreHub_IdentificaAmbientePorTopico(topic);
-    if (ambiente_idx < 0 || ambiente_idx >= NUM_AMBIENTES) {
-        return;
-    }
-
     // Processa mensagens conforme diagrama
     CoreHub_Data_t* data = &corehub_data[ambiente_idx];
     CoreHub_FSM_States* state = &current_state[ambiente_idx];
     
     // Proteção contra dados corrompidos
     if (data == NULL || state == NULL) {
-        printf("[CoreHub] ERRO: Dados do ambiente %d corrompidos\n", ambiente_idx);
+        HT_LOG(amb_corrupt, P_ERROR, 1, "[CoreHub] ERRO: Dados do ambiente %d corrompidos", ambiente_idx);
         return;
     }
 
-    if (strstr(topic, "smartdoor/door")) {
+    if (topic_id == COREHUB_TOPIC_SMARTDOOR_DOOR) {
         if (strcmp(payload, "OPEN") == 0) {
             data->door_state = 1;
+            HT_Series_Append(ambiente_idx, HT_SERIES_DOOR, 100);
         } else if (strcmp(payload, "CLOSED") == 0) {
             data->door_state = 0;
+            HT_Series_Append(ambiente_idx, HT_SERIES_DOOR, 0);
             if (data->alarm_active || data->buzzer_state) {
                 *state = COREHUB_BUZZER_OFF_STATE;
                 return;
@@ -261,30 +576,109 @@ static void HT_CoreHub_MessageCallback(MessageData *msg) {
         }
         *state = COREHUB_ANALYZE_DOOR_STATE;
     }
-    else if (strstr(topic, "smartdoor/light")) {
+    else if (topic_id == COREHUB_TOPIC_SMARTDOOR_LIGHT) {
         data->light_state = (strcmp(payload, "ON") == 0) ? 1 : 0;
+        HT_Series_Append(ambiente_idx, HT_SERIES_LIGHT, data->light_state ? 100 : 0);
         if (data->light_state == 0 && (data->alarm_active || data->buzzer_state)) {
             *state = COREHUB_BUZZER_OFF_STATE;
             return;
         }
         *state = COREHUB_ANALYZE_DOOR_STATE;
     }
-    else if (strstr(topic, "senseclima/01/temperature")) {
+    else if (topic_id == COREHUB_TOPIC_SENSECLIMA_TEMP) {
         float temperature = string_to_float(payload);
         buffered_temp[ambiente_idx] = temperature;
         new_temp_data[ambiente_idx] = 1;
+        HT_Series_Append(ambiente_idx, HT_SERIES_TEMPERATURE, CoreHub_SeriesValue(temperature));
     }
-    else if (strstr(topic, "senseclima/01/humidity")) {
+    else if (topic_id == COREHUB_TOPIC_SENSECLIMA_HUMIDITY) {
         float humidity = string_to_float(payload);
         buffered_hum[ambiente_idx] = humidity;
         new_hum_data[ambiente_idx] = 1;
+        HT_Series_Append(ambiente_idx, HT_SERIES_HUMIDITY, CoreHub_SeriesValue(humidity));
     }
-    else if (strstr(topic, "aircontrol/01/power")) {
+    else if (topic_id == COREHUB_TOPIC_AIRCONTROL_POWER) {
         data->ac_state = (strcmp(payload, "ON") == 0) ? 1 : 0;
     }
+    else if (topic_id == COREHUB_TOPIC_HISTORY_GET) {
+        CoreHub_HistoryRequest(ambiente_idx, payload);
+    }
+}
+
+
+
+/* Próximo prazo do loop MQTT: keepalive, uplink retido ou passo da FSM fora do ocioso.
+   Pacotes (porta, luz, sensores) acordam a task pelo socket a qualquer momento. */
+static uint32_t CoreHub_NextWakeMs(void) {
+    uint32_t wait = HT_MQTT_KeepaliveLeftMs(&mqttClient_global);
+    uint32_t left = HT_Uplink_NextPollMs();
+    uint32_t now = CoreHub_GetTimeSecs();
+
+    if (left < wait) {
+        wait = left;
+    }
+
+    // Escrita agrupada do snapshot de estado
+    left = HT_State_NextPollMs();
+    if (left < wait) {
+        wait = left;
+    }
+
+    for (int i = 0; i < ambiente_count; i++) {
+        if (current_state[i] == COREHUB_WAIT_TIMER_STATE && corehub_data[i].alarm_active) {
+            // Alarme armado: basta acordar quando o timer esgotar
+            uint32_t elapsed = now - corehub_data[i].alarm_start_time;
+            uint32_t timeout = HT_Config_Get()->alarm_timeout_ms / 1000;
+            left = (elapsed < timeout) ? (timeout - elapsed) * 1000 : HT_COREHUB_FSM_STEP_MS;
+        } else if (current_state[i] != COREHUB_IDLE_STATE || new_temp_data[i] || new_hum_data[i]) {
+            // FSM avança no máximo um passo por segundo
+            left = HT_COREHUB_FSM_STEP_MS;
+        } else {
+            continue;
+        }
+        if (left < wait) {
+            wait = left;
+        }
+    }
+
+    if (wait < HT_COREHUB_WAIT_MIN_MS) {
+        wait = HT_COREHUB_WAIT_MIN_MS;
+    } else if (wait > HT_COREHUB_WAIT_MAX_MS) {
+        wait = HT_COREHUB_WAIT_MAX_MS;
+    }
+    return wait;
 }
 
+/* Sleep2/hibernação reinicia o firmware: só com a sessão preservada, o snapshot de estado
+   gravado e nada que viva apenas em RAM */
+static slpManSlpState_t CoreHub_SleepDepth(uint32_t wait_ms) {
+    if (HT_Uplink_NextPollMs() != UINT32_MAX || HT_State_NextPollMs() != UINT32_MAX) {
+        return HT_SLEEP_MAX_DEPTH;
+    }
 
+    for (int i = 0; i < ambiente_count; i++) {
+        if (current_state[i] != COREHUB_IDLE_STATE || new_temp_data[i] || new_hum_data[i] ||
+            corehub_data[i].alarm_active) {
+            return HT_SLEEP_MAX_DEPTH;
+        }
+    }
+
+    // Séries retidas em RAM: SLP1 as mantém; só hiberna quando o prazo de commit ou um buffer
+    // cheio já obrigaria a gravação, senão cada espera custaria um commit e uma cópia de bloco
+    if (HT_Series_Pending() && !HT_Series_FlushDue(wait_ms)) {
+        return HT_SLEEP_MAX_DEPTH;
+    }
+
+    // Socket entregue ao sockmgr só para esta espera: a sessão sobrevive a sleep2/hibernação,
+    // mas o downlink passa pelo anel de 1 KB, que derruba a sessão numa rajada maior
+    if (HT_MQTT_HibArm(&mqttClient_global) != 0) {
+        return HT_SLEEP_MAX_DEPTH;
+    }
+    if (HT_Series_Pending()) {
+        HT_Series_Flush();
+    }
+    return SLP_HIB_STATE;
+}
 
 /* Máquina de Estados - Exatamente como no diagrama */
 static void HT_CoreHub_StateMachine(int ambiente_idx) {
@@ -308,7 +702,7 @@ static void HT_CoreHub_StateMachine(int ambiente_idx) {
     if (fsm_execution_count[ambiente_idx] > 1000) { // Reset a cada 1000 execuções
         fsm_execution_count[ambiente_idx] = 0;
         if (fsm_stuck_detected[ambiente_idx]) {
-            printf("[CoreHub][%s] WATCHDOG: FSM resetada por travamento\n", ambientes[ambiente_idx]);
+            HT_LOG(watchdog_reset, P_WARNING, 1, "[CoreHub][amb %d] WATCHDOG: FSM resetada por travamento", ambiente_idx);
             *state = COREHUB_IDLE_STATE;
             fsm_stuck_detected[ambiente_idx] = 0;
         }
@@ -336,11 +730,12 @@ static void HT_CoreHub_StateMachine(int ambiente_idx) {
                 data->temperature = buffered_temp[ambiente_idx];
                 new_temp_data[ambiente_idx] = 0;
                 if (data->door_state == 0 && data->light_state == 1 && !data->alarm_active && !data->buzzer_state) {
-                    if (data->temperature > HT_COREHUB_TEMP_LIMIT_UPPER) {
-                        printf("[CoreHub][%s] Temp %.1f°C > %.1f°C - Ligando AC\n", ambientes[ambiente_idx], data->temperature, HT_COREHUB_TEMP_LIMIT_UPPER);
+                    // Limites em centésimos de °C na imagem de configuração
+                    if (data->temperature * 100.0f > HT_Config_Get()->temp_upper) {
+                        HT_LOG(temp_high, P_INFO, 2, "[CoreHub][amb %d] Temp %d x0.1°C acima do limite - Ligando AC", ambiente_idx, HT_LOG_DECI(data->temperature));
                         *state = COREHUB_AC_ON_STATE;
-                    } else if (data->temperature < HT_COREHUB_TEMP_LIMIT_LOWER) {
-                        printf("[CoreHub][%s] Temp %.1f°C < %.1f°C - Desligando AC\n", ambientes[ambiente_idx], data->temperature, HT_COREHUB_TEMP_LIMIT_LOWER);
+                    } else if (data->temperature * 100.0f < HT_Config_Get()->temp_lower) {
+                        HT_LOG(temp_low, P_INFO, 2, "[CoreHub][amb %d] Temp %d x0.1°C abaixo do limite - Desligando AC", ambiente_idx, HT_LOG_DECI(data->temperature));
                         *state = COREHUB_AC_OFF_STATE;
                     }
                 }
@@ -377,14 +772,14 @@ static void HT_CoreHub_StateMachine(int ambiente_idx) {
                 // Verifica se veio do ANALYZE_DOOR_STATE (liga power) ou ANALYZE_TEMP_STATE (só temperatura)
                 if (data->door_state == 0 && data->light_state == 1) {
                     // Veio do ANALYZE_DOOR_STATE - liga o AC
-                    CoreHub_MQTTPublishWithRetry(&mqttClient_global, topic_aircontrol_power[ambiente_idx], (uint8_t*)"ON", 2, QOS0, 1, 0, 0, 3);
-                    printf("[CoreHub][%s] AC LIGADO (Porta fechada + Luz ligada)\n", ambientes[ambiente_idx]);
+                    HT_Uplink_Publish(COREHUB_UPLINK_KEY(ambiente_idx, COREHUB_TOPIC_AIRCONTROL_POWER), (uint8_t*)"ON", 2, HT_UPLINK_URGENT);
+                    HT_LOG(ac_on, P_INFO, 1, "[CoreHub][amb %d] AC LIGADO (Porta fechada + Luz ligada)", ambiente_idx);
                 }
                 
-                // Sempre ajusta o setpoint de temperatura
+                // Sempre ajusta o setpoint de temperatura (refinamento: aguarda a próxima janela de rádio)
                 char temp_str[8];
-                sprintf(temp_str, "%d", HT_COREHUB_AC_TEMP_SETPOINT);
-                CoreHub_MQTTPublishWithRetry(&mqttClient_global, topic_aircontrol_temp[ambiente_idx], (uint8_t*)temp_str, strlen(temp_str), QOS0, 1, 0, 0, 3);
+                sprintf(temp_str, "%d", HT_Config_Get()->ac_setpoint);
+                HT_Uplink_Publish(COREHUB_UPLINK_KEY(ambiente_idx, COREHUB_TOPIC_AIRCONTROL_TEMP), (uint8_t*)temp_str, strlen(temp_str), HT_UPLINK_DEFERRED);
                 data->ac_state = 1;
             }
             // Transição: Ligar Ar Condicionado --> Ocioso
@@ -396,11 +791,11 @@ static void HT_CoreHub_StateMachine(int ambiente_idx) {
                 // Verifica se veio do ANALYZE_DOOR_STATE (desliga power) ou ANALYZE_TEMP_STATE (só temperatura)
                 if (data->light_state == 0 || (data->door_state == 0 && data->light_state == 0)) {
                     // Veio do ANALYZE_DOOR_STATE - desliga o AC
-                    CoreHub_MQTTPublishWithRetry(&mqttClient_global, topic_aircontrol_power[ambiente_idx], (uint8_t*)"OFF", 3, QOS0, 1, 0, 0, 3);
+                    HT_Uplink_Publish(COREHUB_UPLINK_KEY(ambiente_idx, COREHUB_TOPIC_AIRCONTROL_POWER), (uint8_t*)"OFF", 3, HT_UPLINK_URGENT);
                     if (data->door_state == 0 && data->light_state == 0) {
-                        printf("[CoreHub][%s] AC DESLIGADO (Porta fechada + Luz apagada)\n", ambientes[ambiente_idx]);
+                        HT_LOG(ac_off_door, P_INFO, 1, "[CoreHub][amb %d] AC DESLIGADO (Porta fechada + Luz apagada)", ambiente_idx);
                     } else {
-                        printf("[CoreHub][%s] AC DESLIGADO (Luz apagada)\n", ambientes[ambiente_idx]);
+                        HT_LOG(ac_off_light, P_INFO, 1, "[CoreHub][amb %d] AC DESLIGADO (Luz apagada)", ambiente_idx);
                     }
                 }
                 data->ac_state = 0;
@@ -413,7 +808,7 @@ static void HT_CoreHub_StateMachine(int ambiente_idx) {
             if (data->door_state == 1 && data->light_state == 1 && !data->alarm_active) {
                 data->alarm_active = 1;
                 data->alarm_start_time = CoreHub_GetTimeSecs();
-                printf("[CoreHub][%s] ALARME ATIVADO - Timer iniciado\n", ambientes[ambiente_idx]);
+                HT_LOG(alarm_on, P_SIG, 1, "[CoreHub][amb %d] ALARME ATIVADO - Timer iniciado", ambiente_idx);
                 // Transição: Inicia Timer (60s) --> Aguardando Timer
                 *state = COREHUB_WAIT_TIMER_STATE;
             } else {
@@ -424,11 +819,11 @@ static void HT_CoreHub_StateMachine(int ambiente_idx) {
             case COREHUB_WAIT_TIMER_STATE:
             if (data->alarm_active) {
                 uint32_t elapsed = CoreHub_GetTimeSecs() - data->alarm_start_time;
-                uint32_t timeout = HT_COREHUB_ALARM_TIMEOUT_MS / 1000;
+                uint32_t timeout = HT_Config_Get()->alarm_timeout_ms / 1000;
                 
                 // Proteção contra overflow de tempo
                 if (elapsed > 3600) { // Máximo 1 hora
-                    printf("[CoreHub][%s] WATCHDOG: Timer alarme resetado (overflow)\n", ambientes[ambiente_idx]);
+                    HT_LOG(alarm_overflow, P_WARNING, 1, "[CoreHub][amb %d] WATCHDOG: Timer alarme resetado (overflow)", ambiente_idx);
                     data->alarm_active = 0;
                     *state = COREHUB_IDLE_STATE;
                     break;
@@ -453,10 +848,10 @@ static void HT_CoreHub_StateMachine(int ambiente_idx) {
 
             case COREHUB_BUZZER_ON_STATE:
             if (!data->buzzer_state) {
-                CoreHub_MQTTPublishWithRetry(&mqttClient_global, topic_smartdoor_buzzer[ambiente_idx], (uint8_t*)"ON", 2, QOS0, 1, 0, 0, 3);
+                HT_Uplink_Publish(COREHUB_UPLINK_KEY(ambiente_idx, COREHUB_TOPIC_SMARTDOOR_BUZZER), (uint8_t*)"ON", 2, HT_UPLINK_URGENT);
                 data->buzzer_state = 1;
                 data->buzzer_start_time = CoreHub_GetTimeSecs(); // Registra quando ligou
-                printf("[CoreHub][%s] BUZZER LIGADO\n", ambientes[ambiente_idx]);
+                HT_LOG(buzzer_on, P_SIG, 1, "[CoreHub][amb %d] BUZZER LIGADO", ambiente_idx);
             }
             // Transição: Ligar Buzzer --> Ocioso
             *state = COREHUB_IDLE_STATE;
@@ -464,15 +859,15 @@ static void HT_CoreHub_StateMachine(int ambiente_idx) {
 
             case COREHUB_BUZZER_OFF_STATE:
             if (data->buzzer_state) {
-                CoreHub_MQTTPublishWithRetry(&mqttClient_global, topic_smartdoor_buzzer[ambiente_idx], (uint8_t*)"OFF", 3, QOS0, 1, 0, 0, 3);
+                HT_Uplink_Publish(COREHUB_UPLINK_KEY(ambiente_idx, COREHUB_TOPIC_SMARTDOOR_BUZZER), (uint8_t*)"OFF", 3, HT_UPLINK_URGENT);
                 data->buzzer_state = 0;
-                printf("[CoreHub][%s] BUZZER DESLIGADO\n", ambientes[ambiente_idx]);
+                HT_LOG(buzzer_off, P_SIG, 1, "[CoreHub][amb %d] BUZZER DESLIGADO", ambiente_idx);
             }
             
             // Desativa completamente o alarme
             if (data->alarm_active) {
                 data->alarm_active = 0;
-                printf("[CoreHub][%s] ALARME DESATIVADO\n", ambientes[ambiente_idx]);
+                HT_LOG(alarm_off, P_SIG, 1, "[CoreHub][amb %d] ALARME DESATIVADO", ambiente_idx);
             }
             
             // Transição: Desligar Buzzer --> Ocioso
@@ -487,64 +882,124 @@ static void HT_CoreHub_StateMachine(int ambiente_idx) {
 
 /* Task MQTT global única para todos os ambientes */
 void HT_CoreHub_MqttTask(void *pvParameters) {
-    printf("[CoreHub] Iniciando sistema para %d ambientes\n", NUM_AMBIENTES);
+    HT_MQTT_ReconnCause cause;
+
+    HT_LOG(start, P_INFO, 1, "[CoreHub] Iniciando sistema para %d ambientes", ambiente_count);
+    HT_Uplink_Init(&mqttClient_global, CoreHub_UplinkSend, CoreHub_UplinkFlushHook);
+    HT_Series_Init();
     
     while (1) {
-        printf("[CoreHub] Conectando ao MQTT Broker...\n");
-        
-        int result = HT_MQTT_Connect(&mqttClient_global, &mqttNetwork_global,
-                                    (char*)broker_addr, broker_port,
-                                    HT_MQTT_SEND_TIMEOUT, HT_MQTT_RECEIVE_TIMEOUT, (char*)clientID,
-                                    (char*)username, (char*)password, HT_MQTT_VERSION, HT_MQTT_KEEP_ALIVE_INTERVAL,
-                                    mqttSendbuf_global, HT_COREHUB_MQTT_BUFFER_SIZE,
-                                    mqttReadbuf_global, HT_COREHUB_MQTT_BUFFER_SIZE);
-
-        if (result == 0) {
-            printf("[CoreHub] Conectado ao MQTT Broker\n");
+        HT_LOG(connecting, P_INFO, 0, "[CoreHub] Conectando ao MQTT Broker...");
+
+        // Conexão e inscrições seguem sem pausa; o voto cai antes de qualquer espera longa
+        HT_Sleep_Hold(HT_SLEEP_HOLD_SESSION);
+
+        // Acordou de sleep2/hibernação com a sessão salva: socket e cliente voltam sem CONNECT,
+        // e o broker manteve as inscrições (cleansession desligado)
+        uint8_t resumed = (HT_MQTT_Resume(&mqttClient_global, &mqttNetwork_global,
+                                          mqttSendbuf_global, HT_COREHUB_MQTT_BUFFER_SIZE,
+                                          mqttReadbuf_global, HT_COREHUB_MQTT_BUFFER_SIZE) == 0);
+        int result = HT_MQTT_CONNECT_OK;
+        if (!resumed) {
+            // Broker e credenciais lidos no lugar da imagem de configuração
+            const HT_ConfigImage *cfg = HT_Config_Get();
+            result = HT_MQTT_Connect(&mqttClient_global, &mqttNetwork_global,
+                                     (char*)HT_Config_String(cfg->broker), cfg->broker_port,
+                                     HT_MQTT_SEND_TIMEOUT, HT_MQTT_RECEIVE_TIMEOUT, (char*)HT_Config_String(cfg->client_id),
+                                     (char*)HT_Config_String(cfg->username), (char*)HT_Config_String(cfg->password),
+                                     HT_MQTT_VERSION, HT_MQTT_KEEP_ALIVE_INTERVAL,
+                                     mqttSendbuf_global, HT_COREHUB_MQTT_BUFFER_SIZE,
+                                     mqttReadbuf_global, HT_COREHUB_MQTT_BUFFER_SIZE);
+        }
+
+        if (result == HT_MQTT_CONNECT_OK) {
+            HT_MQTT_ReconnSuccess();
             HT_MQTT_SetMessageCallback(HT_CoreHub_MessageCallback);
 
-            // Inscreve nos tópicos de todos os ambientes
-            for (int i = 0; i < NUM_AMBIENTES; i++) {
-                HT_MQTT_Subscribe(&mqttClient_global, topic_smartdoor_door[i], QOS0);
-                HT_MQTT_Subscribe(&mqttClient_global, topic_smartdoor_light[i], QOS0);
-                HT_MQTT_Subscribe(&mqttClient_global, topic_senseclima_temp[i], QOS0);
-                HT_MQTT_Subscribe(&mqttClient_global, topic_senseclima_humidity[i], QOS0);
+            if (resumed) {
+                HT_LOG(resumed, P_SIG, 0, "[CoreHub] Sessão MQTT retomada após hibernação");
+            } else {
+                HT_LOG(connected, P_SIG, 0, "[CoreHub] Conectado ao MQTT Broker");
+
+                // Inscreve nos tópicos de todos os ambientes (tópico montado num buffer temporário)
+                for (int i = 0; i < ambiente_count; i++) {
+                    char topic[HT_COREHUB_TOPIC_MAX_LEN];
+                    for (size_t t = 0; t < sizeof(corehub_topic_subscribed) / sizeof(corehub_topic_subscribed[0]); t++) {
+                        if (CoreHub_TopicFormat(topic, sizeof(topic), i, corehub_topic_subscribed[t]) > 0) {
+                            HT_MQTT_SubscribeTransient(&mqttClient_global, topic, QOS0);
+                        }
+                    }
+                }
+                HT_LOG(subscribed, P_INFO, 1, "[CoreHub] Inscrito em tópicos de %d ambientes", ambiente_count);
+            }
+            for (int i = 0; i < ambiente_count; i++) {
                 corehub_data[i].mqtt_connected = 1;
             }
             mqtt_connection_active = 1;
-            printf("[CoreHub] Inscrito em tópicos de %d ambientes\n", NUM_AMBIENTES);
 
-            vTaskDelay(pdMS_TO_TICKS(1000));
+            HT_Sleep_Release(HT_SLEEP_HOLD_SESSION);
+
+            if (!resumed) {
+                vTaskDelay(pdMS_TO_TICKS(1000));
+            }
 
             while (mqtt_connection_active) {
                 // Atualiza uptime para todos os ambientes
-                for (int i = 0; i < NUM_AMBIENTES; i++) {
+                for (int i = 0; i < ambiente_count; i++) {
                     corehub_data[i].system_uptime = CoreHub_GetTimeSecs();
                 }
 
-                // Yield MQTT com timeout reduzido para melhor responsividade
-                HT_MQTT_Yield(&mqttClient_global, 10);
+                // Bloqueia no socket até o próximo pacote ou prazo. Sem trabalho pendente o voto
+                // é liberado e a plataforma entra em sleep (tickless) durante a espera.
+                uint32_t wait_ms = CoreHub_NextWakeMs();
+                HT_Sleep_SetMaxDepth(CoreHub_SleepDepth(wait_ms));
+                HT_Sleep_SetDeadline(wait_ms);
+                HT_Sleep_Release(HT_SLEEP_HOLD_PACKET);
+                HT_MQTT_WaitPacket(&mqttClient_global, (int)wait_ms);
+
+                // Acordado sem hibernar (ou retomado): leituras voltam ao socket; com dados ainda
+                // no anel fica para o próximo ciclo
+                HT_MQTT_HibDisarm(&mqttClient_global);
+
+                // Sessão fechada pelo cliente (erro de socket ou PINGRESP perdido)
+                if (!mqttClient_global.isconnected) {
+                    for (int i = 0; i < ambiente_count; i++) {
+                        corehub_data[i].mqtt_connected = 0;
+                    }
+                }
 
                 // Executa watchdog global
                 CoreHub_WatchdogCheck();
+
+                // Publicações retidas (setpoints, status) saem numa rajada só, na janela de rádio
+                HT_Uplink_Poll();
                 
                 // Executa FSM para todos os ambientes com proteção
-                for (int i = 0; i < NUM_AMBIENTES; i++) {
+                for (int i = 0; i < ambiente_count; i++) {
                     // Verifica se FSM não está travada
                     if (!fsm_stuck_detected[i]) {
                         HT_CoreHub_StateMachine(i);
                     } else {
                         // Reset FSM travada
-                        printf("[CoreHub][%s] Resetando FSM travada\n", ambientes[i]);
+                        HT_LOG(fsm_reset, P_WARNING, 1, "[CoreHub][amb %d] Resetando FSM travada", i);
                         current_state[i] = COREHUB_IDLE_STATE;
                         fsm_stuck_detected[i] = 0;
                         fsm_execution_count[i] = 0;
                     }
                 }
 
+                // Snapshot de estado para o próximo boot (no máximo uma escrita a cada 10 min)
+                CoreHub_StateSnapshot();
+
+                // Séries: fecha os intervalos de 1/15 min e grava buffers antigos
+                HT_Series_Poll();
+
+                // Pedido de histórico recebido neste ciclo
+                CoreHub_PublishHistory();
+
                 // Verifica se algum ambiente perdeu conexão
                 int all_connected = 1;
-                for (int i = 0; i < NUM_AMBIENTES; i++) {
+                for (int i = 0; i < ambiente_count; i++) {
                     if (!corehub_data[i].mqtt_connected) {
                         all_connected = 0;
                         break;
@@ -552,25 +1007,30 @@ void HT_CoreHub_MqttTask(void *pvParameters) {
                 }
                 
                 if (!all_connected) {
-                    printf("[CoreHub] Conexão MQTT perdida\n");
+                    HT_LOG(conn_lost, P_WARNING, 0, "[CoreHub] Conexão MQTT perdida");
                     break;
                 }
-
-                // Delay otimizado para melhor performance
-                vTaskDelay(pdMS_TO_TICKS(50));
             }
 
-            printf("[CoreHub] Desconectando do MQTT Broker\n");
+            // Classifica antes de fechar o socket, senão o errno se perde
+            cause = HT_MQTT_ReconnClassifyErrno(sock_get_errno(mqttNetwork_global.my_socket));
+
+            HT_LOG(disconnecting, P_INFO, 0, "[CoreHub] Desconectando do MQTT Broker");
             HT_MQTT_Disconnect(&mqttClient_global);
-            for (int i = 0; i < NUM_AMBIENTES; i++) {
+            for (int i = 0; i < ambiente_count; i++) {
                 corehub_data[i].mqtt_connected = 0;
             }
             mqtt_connection_active = 0;
         } else {
-            printf("[CoreHub] Falha na conexão MQTT (erro: %d)\n", result);
+            HT_LOG(connect_fail, P_WARNING, 1, "[CoreHub] Falha na conexão MQTT (erro: %d)", result);
+            cause = HT_MQTT_ReconnClassifyConnect(result);
         }
 
-        printf("[CoreHub] Aguardando 5s para reconectar...\n");
-        vTaskDelay(pdMS_TO_TICKS(5000));
+        // Backoff de reconexão não é trabalho: nenhum voto pendente durante a espera
+        HT_Sleep_SetMaxDepth(HT_SLEEP_MAX_DEPTH);
+        HT_Sleep_Release(HT_SLEEP_HOLD_PACKET | HT_SLEEP_HOLD_SESSION | HT_SLEEP_HOLD_DEADLINE);
+
+        HT_LOG(reconn_wait, P_INFO, 1, "[CoreHub] Aguardando para reconectar (causa: %d)...", cause);
+        HT_MQTT_ReconnWait(cause);
     }
 }
@@ -0,0 +1,126 @@
+/**
+ *
+ * Copyright (c) 2023 HT Micron Semicondutores S.A.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "HT_CoreHub_Config.h"
+#include "HT_CoreHubFsm.h"
+#include "stddef.h"
+
+#define HT_CONFIG_IMAGE                 ((const HT_ConfigImage *)HT_CONFIG_XIP_ADDR)
+
+typedef char HT_ConfigLayout[(sizeof(HT_ConfigImage) == 60) ? 1 : -1];
+typedef char HT_ConfigFits[(NUM_AMBIENTES <= HT_CONFIG_MAX_AMBIENTES) ? 1 : -1];
+
+/* Built-in image, laid out like one from corehub_config.py */
+typedef struct {
+    HT_ConfigImage image;
+    char ambiente0[sizeof("externo")];
+    char ambiente1[sizeof("mesanino")];
+    char ambiente2[sizeof("prototipagem")];
+    char broker[sizeof(HT_CONFIG_DEFAULT_BROKER)];
+    char client_id[sizeof(HT_CONFIG_DEFAULT_CLIENT_ID)];
+    char apn[sizeof(HT_CONFIG_DEFAULT_APN)];
+    char empty[1];
+} HT_ConfigDefault;
+
+#define HT_CONFIG_OFFSET(field)         ((uint16_t)offsetof(HT_ConfigDefault, field))
+
+static const HT_ConfigDefault config_default = {
+    .image = {
+        .magic = HT_CONFIG_MAGIC,
+        .version = HT_CONFIG_VERSION,
+        .header_size = sizeof(HT_ConfigImage),
+        .size = sizeof(HT_ConfigDefault),
+        .alarm_timeout_ms = HT_COREHUB_ALARM_TIMEOUT_MS,
+        .ambiente_count = 3,
+        .ambiente = {
+            HT_CONFIG_OFFSET(ambiente0), HT_CONFIG_OFFSET(ambiente1), HT_CONFIG_OFFSET(ambiente2),
+            HT_CONFIG_OFFSET(empty), HT_CONFIG_OFFSET(empty), HT_CONFIG_OFFSET(empty),
+            HT_CONFIG_OFFSET(empty), HT_CONFIG_OFFSET(empty)
+        },
+        .broker = HT_CONFIG_OFFSET(broker),
+        .broker_port = HT_MQTT_PORT,
+        .client_id = HT_CONFIG_OFFSET(client_id),
+        .username = HT_CONFIG_OFFSET(empty),
+        .password = HT_CONFIG_OFFSET(empty),
+        .apn = HT_CONFIG_OFFSET(apn),
+        .band = HT_CONFIG_DEFAULT_BAND,
+        .temp_upper = (int16_t)(HT_COREHUB_TEMP_LIMIT_UPPER * 100),
+        .temp_lower = (int16_t)(HT_COREHUB_TEMP_LIMIT_LOWER * 100),
+        .ac_setpoint = HT_COREHUB_AC_TEMP_SETPOINT,
+    },
+    .ambiente0 = "externo",
+    .ambiente1 = "mesanino",
+    .ambiente2 = "prototipagem",
+    .broker = HT_CONFIG_DEFAULT_BROKER,
+    .client_id = HT_CONFIG_DEFAULT_CLIENT_ID,
+    .apn = HT_CONFIG_DEFAULT_APN,
+};
+
+static const HT_ConfigImage *config = &config_default.image;
+static uint8_t config_flash = 0;
+
+/* zlib CRC-32 with the crc field read as zero, bitwise: it runs once per boot */
+static uint32_t HT_Config_Crc(const HT_ConfigImage *image) {
+    const uint8_t *p = (const uint8_t *)image;
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (uint32_t i = 0; i < image->size; i++) {
+        uint8_t byte = (i >= offsetof(HT_ConfigImage, crc) && i < offsetof(HT_ConfigImage, crc) + sizeof(image->crc)) ? 0 : p[i];
+
+        crc ^= byte;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+
+    return ~crc;
+}
+
+void HT_Config_Init(void) {
+    const HT_ConfigImage *image = HT_CONFIG_IMAGE;
+
+    /* An erased region reads 0xFF, a half written one fails the CRC */
+    if (image->magic != HT_CONFIG_MAGIC || image->version != HT_CONFIG_VERSION ||
+        image->header_size != sizeof(HT_ConfigImage) || image->size <= sizeof(HT_ConfigImage) ||
+        image->size > FLASH_CFG_REGION_SIZE || image->ambiente_count == 0 ||
+        image->ambiente_count > HT_CONFIG_MAX_AMBIENTES) {
+        return;
+    }
+
+    /* Strings run at most to the last byte, which the generator leaves NUL */
+    if (((const char *)image)[image->size - 1] != '\0' || HT_Config_Crc(image) != image->crc) {
+        return;
+    }
+
+    config = image;
+    config_flash = 1;
+}
+
+const HT_ConfigImage *HT_Config_Get(void) {
+    return config;
+}
+
+const char *HT_Config_String(uint16_t offset) {
+    if (offset < sizeof(HT_ConfigImage) || offset >= config->size) {
+        return "";
+    }
+    return (const char *)config + offset;
+}
+
+uint8_t HT_Config_FromFlash(void) {
+    return config_flash;
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
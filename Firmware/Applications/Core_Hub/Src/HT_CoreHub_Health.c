@@ -0,0 +1,171 @@
+/**
+ *
+ * Copyright (c) 2023 HT Micron Semicondutores S.A.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "HT_CoreHub_Health.h"
+#include "HT_CoreHub_State.h"
+#include "HT_CoreHub_Series.h"
+#include "main.h"
+#include "task.h"
+#include "string.h"
+#include "stdio.h"
+
+/* Heap size of the prebuilt heap_4, set from the linker layout */
+extern UINT32 gTotalHeapSize;
+
+/* Provided by syscalls.c */
+extern void sbrk_get_usage(unsigned int *used, unsigned int *peak, unsigned int *failures);
+
+/* The heap lives in a prebuilt library without the malloc-failed hook, so
+ * failures are counted at the call boundary: the application Makefile links
+ * with --wrap=pvPortMalloc --wrap=malloc. */
+extern void *__real_pvPortMalloc(size_t size);
+extern void *__real_malloc(size_t size);
+
+static volatile uint32_t health_heap_failures = 0;
+static volatile uint32_t health_malloc_failures = 0;
+
+/* Scratch for uxTaskGetSystemState(), only touched by HT_Health_Collect() */
+static TaskStatus_t health_task_status[HT_HEALTH_MAX_TASKS];
+
+void *__wrap_pvPortMalloc(size_t size) {
+    void *ptr = __real_pvPortMalloc(size);
+
+    if (ptr == NULL && size != 0) {
+        taskENTER_CRITICAL();
+        health_heap_failures++;
+        taskEXIT_CRITICAL();
+    }
+
+    return ptr;
+}
+
+void *__wrap_malloc(size_t size) {
+    void *ptr = __real_malloc(size);
+
+    if (ptr == NULL && size != 0) {
+        taskENTER_CRITICAL();
+        health_malloc_failures++;
+        taskEXIT_CRITICAL();
+    }
+
+    return ptr;
+}
+
+void HT_Health_Collect(HT_HealthReport_t *report) {
+    HT_PsEventStats_t ps;
+    HT_StateStats state;
+    HT_SeriesStats series;
+    unsigned int used, peak, failures;
+    UBaseType_t n;
+
+    memset(report, 0, sizeof(*report));
+
+    report->uptime_s = xTaskGetTickCount() / configTICK_RATE_HZ;
+    report->heap_size = gTotalHeapSize;
+    report->heap_free = xPortGetFreeHeapSize();
+    report->heap_free_min = xPortGetMinimumEverFreeHeapSize();
+    report->heap_alloc_failures = health_heap_failures;
+    report->malloc_failures = health_malloc_failures;
+
+    sbrk_get_usage(&used, &peak, &failures);
+    report->sbrk_used = used;
+    report->sbrk_peak = peak;
+    report->sbrk_failures = failures;
+
+    HT_PsEventGetStats(&ps);
+    report->ps_events_dropped = ps.dropped;
+
+    HT_State_GetStats(&state);
+    report->state_writes = state.writes;
+    report->state_write_failures = state.write_failures;
+    report->state_coalesced = state.coalesced;
+    report->fs_erase_max = state.erase_max;
+    report->fs_erase_total = state.erase_total;
+    report->fs_erase_valid = state.erase_valid;
+
+    HT_Series_GetStats(&series);
+    report->ts_samples = series.samples;
+    report->ts_encoded_bytes = series.encoded_bytes;
+    report->ts_appends = series.appends;
+    report->ts_flash_bytes = series.flash_bytes;
+    report->ts_write_errors = series.write_errors;
+    report->ts_commits = series.commits;
+    report->ts_flush_commits = series.flush_commits;
+
+    /* Same high-water mark as uxTaskGetStackHighWaterMark(), for every task in one pass */
+    report->task_count = uxTaskGetNumberOfTasks();
+    n = uxTaskGetSystemState(health_task_status, HT_HEALTH_MAX_TASKS, NULL);
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        strncpy(report->tasks[i].name, health_task_status[i].pcTaskName, HT_HEALTH_TASK_NAME_LEN - 1);
+        report->tasks[i].stack_free_min = health_task_status[i].usStackHighWaterMark * sizeof(StackType_t);
+    }
+    report->task_reported = n;
+}
+
+int HT_Health_Format(const HT_HealthReport_t *report, char *buf, size_t size) {
+    char erase[24] = "null,null";
+    size_t len;
+    int ret;
+
+    /* Unknown wear is reported as unknown, not as zero */
+    if (report->fs_erase_valid) {
+        snprintf(erase, sizeof(erase), "%lu,%lu",
+                 (unsigned long)report->fs_erase_max, (unsigned long)report->fs_erase_total);
+    }
+
+    ret = snprintf(buf, size,
+        "{\"up\":%lu,\"hp\":[%lu,%lu,%lu],\"af\":[%lu,%lu,%lu],\"sb\":[%lu,%lu],\"pq\":%lu,"
+        "\"fs\":[%lu,%lu,%lu,%s],\"ts\":[%lu,%lu,%lu,%lu,%lu,%lu,%lu],\"tn\":%lu,\"st\":{",
+        (unsigned long)report->uptime_s,
+        (unsigned long)report->heap_size, (unsigned long)report->heap_free, (unsigned long)report->heap_free_min,
+        (unsigned long)report->heap_alloc_failures, (unsigned long)report->malloc_failures,
+        (unsigned long)report->sbrk_failures,
+        (unsigned long)report->sbrk_used, (unsigned long)report->sbrk_peak,
+        (unsigned long)report->ps_events_dropped,
+        (unsigned long)report->state_writes, (unsigned long)report->state_write_failures,
+        (unsigned long)report->state_coalesced,
+        erase,
+        (unsigned long)report->ts_samples, (unsigned long)report->ts_encoded_bytes,
+        (unsigned long)report->ts_appends, (unsigned long)report->ts_flash_bytes,
+        (unsigned long)report->ts_write_errors,
+        (unsigned long)report->ts_commits, (unsigned long)report->ts_flush_commits,
+        (unsigned long)report->task_count);
+    if (ret < 0 || (size_t)ret >= size)
+        return -1;
+    len = ret;
+
+    /* Keep room for the closing "}}" */
+    for (uint32_t i = 0; i < report->task_reported; i++) {
+        ret = snprintf(buf + len, size - len, "%s\"%s\":%lu", (i ? "," : ""),
+                       report->tasks[i].name, (unsigned long)report->tasks[i].stack_free_min);
+        if (ret < 0 || len + ret + 2 >= size) {
+            buf[len] = '\0';
+            break;
+        }
+        len += ret;
+    }
+
+    if (len + 2 >= size)
+        return -1;
+
+    buf[len++] = '}';
+    buf[len++] = '}';
+    buf[len] = '\0';
+
+    return (int)len;
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
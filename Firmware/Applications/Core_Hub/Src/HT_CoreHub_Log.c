@@ -0,0 +1,29 @@
+/**
+ *
+ * Copyright (c) 2023 HT Micron Semicondutores S.A.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "HT_CoreHub_Log.h"
+
+/* Everything compiled in is emitted until someone raises the ceiling */
+volatile uint8_t ht_log_level = P_DEBUG;
+
+void HT_Log_SetLevel(uint8_t level) {
+    ht_log_level = level;
+}
+
+uint8_t HT_Log_GetLevel(void) {
+    return ht_log_level;
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
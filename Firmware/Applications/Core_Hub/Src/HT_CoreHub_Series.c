@@ -0,0 +1,734 @@
+/**
+ *
+ * Copyright (c) 2023 HT Micron Semicondutores S.A.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "HT_CoreHub_Series.h"
+#include "HT_CoreHubFsm.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "osasys.h"
+#include "lfs_port.h"
+#include "string.h"
+#include "stdio.h"
+
+#define HT_SERIES_MAGIC                 0x5354          /* "TS" */
+#define HT_SERIES_VERSION               1
+#define HT_SERIES_STREAMS               (NUM_AMBIENTES * HT_SERIES_CHANNELS)
+#define HT_SERIES_SEGMENTS_MAX          HT_SERIES_RAW_SEGMENTS
+#define HT_SERIES_ENTRY_MAX             18              /* Stream byte, time and value deltas (5 + 3), min, max (3 + 3), count (3). */
+#define HT_SERIES_NAME_LEN              16
+
+/* First bytes of every segment, the entries that follow are deltas from it */
+typedef struct {
+    uint16_t magic;
+    uint8_t tier;
+    uint8_t version;
+    uint32_t seq;                                       /* Segment order in the tier, 0 is never used. */
+    uint32_t base;                                      /* Time the first entry is relative to. */
+    uint32_t reserved;
+} HT_SeriesHeader;
+
+/* Delta state, reset at every segment so each one decodes on its own */
+typedef struct {
+    uint32_t time;
+    int16_t prev[HT_SERIES_STREAMS];
+} HT_SeriesCodec;
+
+/* Open bucket of an aggregate tier */
+typedef struct {
+    uint32_t bucket;
+    int32_t sum;
+    uint16_t count;
+    int16_t min;
+    int16_t max;
+} HT_SeriesAcc;
+
+typedef struct {
+    const uint16_t segments;
+    const uint16_t buffer_size;
+    const uint32_t period;                              /* Bucket length (s), 0 on the raw tier. */
+    uint8_t *const buf;
+    uint16_t len;                                       /* Bytes waiting in buf. */
+    uint16_t used;                                      /* Bytes of the current segment, flash and buf. */
+    uint16_t committed;                                 /* Bytes of the current segment littlefs has committed. */
+    uint8_t slot;                                       /* Slot of the current segment. */
+    uint8_t open;                                       /* The current segment takes entries. */
+    uint8_t fresh;                                      /* Not committed yet, the slot file is still the old segment. */
+    uint8_t file_open;                                  /* file holds writes littlefs has not committed. */
+    lfs_file_t file;
+    TickType_t since;                                   /* Oldest byte not committed. */
+    uint32_t last_seq;
+    HT_SeriesCodec codec;
+    uint32_t seq[HT_SERIES_SEGMENTS_MAX];               /* Per slot, 0 when empty. */
+    uint32_t base[HT_SERIES_SEGMENTS_MAX];
+} HT_SeriesTierState;
+
+typedef char HT_SeriesHeaderFits[(sizeof(HT_SeriesHeader) == 16) ? 1 : -1];
+typedef char HT_SeriesStreamsFit[(HT_SERIES_STREAMS <= 255) ? 1 : -1];
+typedef char HT_SeriesSlotsFit[(HT_SERIES_1MIN_SEGMENTS <= HT_SERIES_SEGMENTS_MAX &&
+                                HT_SERIES_15MIN_SEGMENTS <= HT_SERIES_SEGMENTS_MAX) ? 1 : -1];
+
+static uint8_t series_raw_buf[HT_SERIES_RAW_BUFFER];
+static uint8_t series_1min_buf[HT_SERIES_AGG_BUFFER];
+static uint8_t series_15min_buf[HT_SERIES_AGG_BUFFER];
+
+static HT_SeriesTierState series_tier[HT_SERIES_TIERS] = {
+    { HT_SERIES_RAW_SEGMENTS, HT_SERIES_RAW_BUFFER, 0, series_raw_buf },
+    { HT_SERIES_1MIN_SEGMENTS, HT_SERIES_AGG_BUFFER, 60, series_1min_buf },
+    { HT_SERIES_15MIN_SEGMENTS, HT_SERIES_AGG_BUFFER, 900, series_15min_buf },
+};
+
+/* Aggregate entries of one bucket that a query folds into one point */
+typedef struct {
+    HT_SeriesVisitFn visit;
+    void *ctx;
+    int visited;
+    uint8_t held[HT_SERIES_STREAMS];
+    HT_SeriesPoint point[HT_SERIES_STREAMS];
+} HT_SeriesMerge;
+
+static HT_SeriesAcc series_acc[HT_SERIES_TIERS - 1][HT_SERIES_STREAMS];
+static HT_SeriesMerge series_merge;
+static HT_SeriesStats series_stats;
+static uint8_t series_ready = 0;
+
+static uint8_t HT_Series_PutVarint(uint8_t *p, uint32_t v) {
+    uint8_t n = 0;
+
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+
+    return n;
+}
+
+static int HT_Series_GetVarint(const uint8_t *p, int len, uint32_t *v) {
+    *v = 0;
+
+    for (int i = 0; i < len && i < 5; i++) {
+        *v |= (uint32_t)(p[i] & 0x7F) << (7 * i);
+        if (!(p[i] & 0x80)) {
+            return i + 1;
+        }
+    }
+
+    return -1;
+}
+
+static uint32_t HT_Series_Zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t HT_Series_Unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static void HT_Series_Name(char *name, uint8_t tier, uint8_t slot) {
+    snprintf(name, HT_SERIES_NAME_LEN, "ts%u_%02u.seg", tier, slot);
+}
+
+/* The segment stays open between buffers: littlefs 2.1 programs an open file's
+ * block in place, but the first write after a sync or close copies the block's
+ * committed part into a new one (lfs_ctz_extend). Reopening with LFS_O_APPEND
+ * for every 256 bytes cost ~16 block erases and 34 KB of programming per raw
+ * segment, now a segment costs one copy per commit. */
+static void HT_Series_Fail(uint8_t tier) {
+    HT_SeriesTierState *t = &series_tier[tier];
+
+    /* The file keeps what littlefs last committed but the encoder is ahead of it */
+    series_stats.write_errors++;
+    t->open = 0;
+    if (t->fresh) {
+        t->seq[t->slot] = 0;
+    }
+}
+
+static void HT_Series_Write(uint8_t tier) {
+    HT_SeriesTierState *t = &series_tier[tier];
+    char name[HT_SERIES_NAME_LEN];
+    lfs_ssize_t len = -1;
+
+    if (t->len == 0) {
+        return;
+    }
+
+    if (!t->file_open) {
+        /* The first write of a segment replaces the oldest one in its slot */
+        HT_Series_Name(name, tier, t->slot);
+        if (LFS_FileOpen(&t->file, name, LFS_O_WRONLY | LFS_O_CREAT | (t->fresh ? LFS_O_TRUNC : LFS_O_APPEND)) == 0) {
+            t->file_open = 1;
+            if (!t->fresh && t->committed != 0) {
+                series_stats.block_copies++;
+                series_stats.flash_bytes += t->committed;
+            }
+        }
+    }
+    if (t->file_open) {
+        len = LFS_FileWrite(&t->file, t->buf, t->len);
+    }
+
+    if (len != (lfs_ssize_t)t->len) {
+        if (t->file_open) {
+            LFS_FileClose(&t->file);
+            t->file_open = 0;
+        }
+        HT_Series_Fail(tier);
+    } else {
+        series_stats.appends++;
+        series_stats.encoded_bytes += t->len;
+        series_stats.flash_bytes += t->len;
+    }
+
+    t->len = 0;
+}
+
+/* Makes everything written so far durable and visible to readers */
+static void HT_Series_Commit(uint8_t tier) {
+    HT_SeriesTierState *t = &series_tier[tier];
+
+    HT_Series_Write(tier);
+    if (!t->file_open) {
+        return;
+    }
+
+    t->file_open = 0;
+    if (LFS_FileClose(&t->file) != 0) {
+        HT_Series_Fail(tier);
+        return;
+    }
+
+    series_stats.commits++;
+    t->committed = t->used;
+    t->fresh = 0;
+}
+
+static void HT_Series_NewSegment(uint8_t tier, uint32_t time) {
+    HT_SeriesTierState *t = &series_tier[tier];
+    HT_SeriesHeader header;
+
+    HT_Series_Commit(tier);
+
+    if (t->last_seq != 0) {
+        t->slot = (t->slot + 1) % t->segments;
+    }
+    t->last_seq++;
+
+    header.magic = HT_SERIES_MAGIC;
+    header.tier = tier;
+    header.version = HT_SERIES_VERSION;
+    header.seq = t->last_seq;
+    header.base = time;
+    header.reserved = 0;
+
+    /* The header goes out with the first entries, the segment costs no extra write */
+    memcpy(t->buf, &header, sizeof(header));
+    t->len = sizeof(header);
+    t->used = sizeof(header);
+    t->committed = 0;
+    t->since = xTaskGetTickCount();
+    t->open = 1;
+    t->fresh = 1;
+    t->seq[t->slot] = t->last_seq;
+    t->base[t->slot] = time;
+
+    t->codec.time = time;
+    memset(t->codec.prev, 0, sizeof(t->codec.prev));
+
+    series_stats.segments++;
+}
+
+static void HT_Series_Encode(uint8_t tier, uint32_t time, uint8_t stream, int16_t mean, int16_t min, int16_t max, uint16_t count) {
+    HT_SeriesTierState *t = &series_tier[tier];
+    uint8_t *p;
+    uint8_t n = 0;
+
+    if (!t->open || t->used + HT_SERIES_ENTRY_MAX > HT_SERIES_SEGMENT_SIZE) {
+        HT_Series_NewSegment(tier, time);
+    }
+    if (t->len + HT_SERIES_ENTRY_MAX > t->buffer_size) {
+        HT_Series_Write(tier);
+        if (!t->open) {
+            HT_Series_NewSegment(tier, time);
+        }
+    }
+    if (t->len == 0 && !t->file_open) {
+        t->since = xTaskGetTickCount();
+    }
+
+    p = t->buf + t->len;
+    p[n++] = stream;
+    n += HT_Series_PutVarint(p + n, HT_Series_Zigzag((int32_t)(time - t->codec.time)));
+    n += HT_Series_PutVarint(p + n, HT_Series_Zigzag((int32_t)mean - t->codec.prev[stream]));
+    if (tier != HT_SERIES_RAW) {
+        n += HT_Series_PutVarint(p + n, HT_Series_Zigzag((int32_t)mean - min));
+        n += HT_Series_PutVarint(p + n, HT_Series_Zigzag((int32_t)max - mean));
+        n += HT_Series_PutVarint(p + n, count);
+    }
+
+    t->codec.time = time;
+    t->codec.prev[stream] = mean;
+    t->len += n;
+    t->used += n;
+    series_stats.entries[tier]++;
+}
+
+static int HT_Series_Decode(HT_SeriesCodec *codec, uint8_t tier, const uint8_t *p, int len, HT_SeriesPoint *point) {
+    uint32_t dt, dv, dmin = 0, dmax = 0, count = 1;
+    int32_t mean;
+    uint8_t stream;
+    int n = 1, k;
+
+    if (len < 1 || p[0] >= HT_SERIES_STREAMS) {
+        return -1;
+    }
+    stream = p[0];
+
+    if ((k = HT_Series_GetVarint(p + n, len - n, &dt)) < 0) {
+        return -1;
+    }
+    n += k;
+    if ((k = HT_Series_GetVarint(p + n, len - n, &dv)) < 0) {
+        return -1;
+    }
+    n += k;
+    if (tier != HT_SERIES_RAW) {
+        if ((k = HT_Series_GetVarint(p + n, len - n, &dmin)) < 0) {
+            return -1;
+        }
+        n += k;
+        if ((k = HT_Series_GetVarint(p + n, len - n, &dmax)) < 0) {
+            return -1;
+        }
+        n += k;
+        if ((k = HT_Series_GetVarint(p + n, len - n, &count)) < 0) {
+            return -1;
+        }
+        n += k;
+    }
+
+    /* The codec only moves once the whole entry is there */
+    mean = codec->prev[stream] + HT_Series_Unzigzag(dv);
+    codec->time += (uint32_t)HT_Series_Unzigzag(dt);
+    codec->prev[stream] = (int16_t)mean;
+
+    point->time = codec->time;
+    point->ambiente = stream / HT_SERIES_CHANNELS;
+    point->channel = stream % HT_SERIES_CHANNELS;
+    point->count = (uint16_t)count;
+    point->mean = (int16_t)mean;
+    point->min = (int16_t)(mean - HT_Series_Unzigzag(dmin));
+    point->max = (int16_t)(mean + HT_Series_Unzigzag(dmax));
+
+    return n;
+}
+
+/* Decodes one segment, the file and then the part still in the RAM buffer.
+ * Returns 0 at its end, 1 when visit stopped, -1 on a bad header or entry. */
+static int HT_Series_Scan(uint8_t tier, uint8_t slot, HT_SeriesCodec *codec, uint32_t from, uint32_t to,
+                          HT_SeriesVisitFn visit, void *ctx, int *visited, uint32_t *consumed) {
+    HT_SeriesTierState *t = &series_tier[tier];
+    uint8_t chunk[HT_SERIES_READ_CHUNK + HT_SERIES_ENTRY_MAX];
+    char name[HT_SERIES_NAME_LEN];
+    const uint8_t *tail = NULL;
+    uint16_t tail_len = 0, tail_pos = 0;
+    uint8_t file_open = 0, file_end = 1, header_done = 0, last;
+    HT_SeriesHeader header;
+    HT_SeriesPoint point;
+    lfs_file_t file;
+    int have = 0, pos, n, ret = 0;
+
+    *consumed = 0;
+
+    if (t->open && slot == t->slot) {
+        tail = t->buf;
+        tail_len = t->len;
+    }
+    if (!(t->open && slot == t->slot && t->fresh)) {
+        HT_Series_Name(name, tier, slot);
+        file_open = LFS_FileOpen(&file, name, LFS_O_RDONLY) == 0;
+        file_end = !file_open;
+    }
+
+    for (;;) {
+        while (have < (int)sizeof(chunk)) {
+            if (!file_end) {
+                n = LFS_FileRead(&file, chunk + have, sizeof(chunk) - have);
+                if (n <= 0) {
+                    file_end = 1;
+                } else {
+                    have += n;
+                }
+            } else if (tail_pos < tail_len) {
+                n = sizeof(chunk) - have;
+                if (n > tail_len - tail_pos) {
+                    n = tail_len - tail_pos;
+                }
+                memcpy(chunk + have, tail + tail_pos, n);
+                tail_pos += n;
+                have += n;
+            } else {
+                break;
+            }
+        }
+        last = have < (int)sizeof(chunk);
+        pos = 0;
+
+        if (!header_done) {
+            if (have < (int)sizeof(header)) {
+                ret = -1;
+                break;
+            }
+            memcpy(&header, chunk, sizeof(header));
+            if (header.magic != HT_SERIES_MAGIC || header.version != HT_SERIES_VERSION || header.tier != tier) {
+                ret = -1;
+                break;
+            }
+            codec->time = header.base;
+            memset(codec->prev, 0, sizeof(codec->prev));
+            pos = sizeof(header);
+            header_done = 1;
+        }
+
+        /* Short of a whole entry only at the very end, otherwise refill first */
+        while (pos < have && (last || have - pos >= HT_SERIES_ENTRY_MAX)) {
+            n = HT_Series_Decode(codec, tier, chunk + pos, have - pos, &point);
+            if (n < 0) {
+                ret = -1;
+                break;
+            }
+            pos += n;
+
+            if (visit != NULL && point.time >= from && point.time <= to) {
+                (*visited)++;
+                if (visit(&point, ctx)) {
+                    ret = 1;
+                    break;
+                }
+            }
+        }
+        *consumed += pos;
+
+        if (ret != 0 || last) {
+            break;
+        }
+        memmove(chunk, chunk + pos, have - pos);
+        have -= pos;
+    }
+
+    if (file_open) {
+        LFS_FileClose(&file);
+    }
+
+    return ret;
+}
+
+static void HT_Series_Close(uint8_t tier, uint8_t stream) {
+    HT_SeriesAcc *acc = &series_acc[tier - 1][stream];
+
+    if (acc->count == 0) {
+        return;
+    }
+
+    HT_Series_Encode(tier, acc->bucket, stream, (int16_t)(acc->sum / (int32_t)acc->count), acc->min, acc->max, acc->count);
+    acc->count = 0;
+}
+
+static void HT_Series_Accumulate(uint8_t tier, uint8_t stream, uint32_t now, int16_t value) {
+    HT_SeriesAcc *acc = &series_acc[tier - 1][stream];
+    uint32_t bucket = now - now % series_tier[tier].period;
+
+    if (acc->count != 0 && (acc->bucket != bucket || acc->count == UINT16_MAX)) {
+        HT_Series_Close(tier, stream);
+    }
+    if (acc->count == 0) {
+        acc->bucket = bucket;
+        acc->sum = 0;
+        acc->min = value;
+        acc->max = value;
+    }
+
+    acc->sum += value;
+    acc->count++;
+    if (value < acc->min) {
+        acc->min = value;
+    }
+    if (value > acc->max) {
+        acc->max = value;
+    }
+}
+
+static int HT_Series_Emit(HT_SeriesMerge *merge, uint8_t stream) {
+    merge->held[stream] = 0;
+    merge->visited++;
+
+    return merge->visit(&merge->point[stream], merge->ctx);
+}
+
+/* HT_Series_Flush() closes the open buckets before every hibernate, so a bucket
+ * can be on flash as several entries. They follow each other in the stream. */
+static int HT_Series_Merge(const HT_SeriesPoint *point, void *ctx) {
+    HT_SeriesMerge *merge = (HT_SeriesMerge *)ctx;
+    uint8_t stream = point->ambiente * HT_SERIES_CHANNELS + point->channel;
+    HT_SeriesPoint *held = &merge->point[stream];
+    int32_t sum;
+
+    if (merge->held[stream]) {
+        if (held->time == point->time && (uint32_t)held->count + point->count <= UINT16_MAX) {
+            sum = (int32_t)held->mean * held->count + (int32_t)point->mean * point->count;
+            held->count += point->count;
+            held->mean = (int16_t)(sum / (int32_t)held->count);
+            if (point->min < held->min) {
+                held->min = point->min;
+            }
+            if (point->max > held->max) {
+                held->max = point->max;
+            }
+            return 0;
+        }
+        if (HT_Series_Emit(merge, stream)) {
+            return 1;
+        }
+    }
+
+    memcpy(held, point, sizeof(*held));
+    merge->held[stream] = 1;
+
+    return 0;
+}
+
+void HT_Series_Init(void) {
+    char name[HT_SERIES_NAME_LEN];
+    HT_SeriesHeader header;
+    struct lfs_info info;
+    lfs_file_t file;
+    uint32_t consumed;
+
+    for (uint8_t tier = 0; tier < HT_SERIES_TIERS; tier++) {
+        HT_SeriesTierState *t = &series_tier[tier];
+
+        for (uint8_t slot = 0; slot < t->segments; slot++) {
+            lfs_ssize_t len = -1;
+
+            HT_Series_Name(name, tier, slot);
+            if (LFS_FileOpen(&file, name, LFS_O_RDONLY) == 0) {
+                len = LFS_FileRead(&file, &header, sizeof(header));
+                LFS_FileClose(&file);
+            }
+
+            if (len != (lfs_ssize_t)sizeof(header) || header.magic != HT_SERIES_MAGIC ||
+                header.version != HT_SERIES_VERSION || header.tier != tier) {
+                continue;
+            }
+
+            t->seq[slot] = header.seq;
+            t->base[slot] = header.base;
+            if (header.seq > t->last_seq) {
+                t->last_seq = header.seq;
+                t->slot = slot;
+            }
+        }
+
+        if (t->last_seq == 0) {
+            continue;
+        }
+
+        /* Replaying the newest segment restores the encoder, appends go on from its end.
+         * One that does not decode to its last byte is left as is. */
+        HT_Series_Name(name, tier, t->slot);
+        t->open = 1;
+        if (HT_Series_Scan(tier, t->slot, &t->codec, 0, 0, NULL, NULL, NULL, &consumed) != 0 ||
+            LFS_Stat(name, &info) != 0 || info.size != consumed ||
+            consumed + HT_SERIES_ENTRY_MAX > HT_SERIES_SEGMENT_SIZE) {
+            t->open = 0;
+        }
+        t->used = consumed;
+        t->committed = consumed;
+    }
+
+    series_ready = 1;
+}
+
+void HT_Series_Append(int ambiente_idx, HT_SeriesChannel channel, int16_t value) {
+    uint32_t now = (uint32_t)OsaSystemTimeReadSecs();
+    uint8_t stream;
+
+    if (!series_ready || ambiente_idx < 0 || ambiente_idx >= NUM_AMBIENTES || channel >= HT_SERIES_CHANNELS) {
+        return;
+    }
+
+    stream = (uint8_t)(ambiente_idx * HT_SERIES_CHANNELS + channel);
+    series_stats.samples++;
+
+    HT_Series_Encode(HT_SERIES_RAW, now, stream, value, value, value, 1);
+    for (uint8_t tier = HT_SERIES_1MIN; tier < HT_SERIES_TIERS; tier++) {
+        HT_Series_Accumulate(tier, stream, now, value);
+    }
+}
+
+void HT_Series_Poll(void) {
+    uint32_t now = (uint32_t)OsaSystemTimeReadSecs();
+    TickType_t tick = xTaskGetTickCount();
+
+    if (!series_ready) {
+        return;
+    }
+
+    for (uint8_t tier = HT_SERIES_1MIN; tier < HT_SERIES_TIERS; tier++) {
+        for (uint8_t stream = 0; stream < HT_SERIES_STREAMS; stream++) {
+            HT_SeriesAcc *acc = &series_acc[tier - 1][stream];
+
+            if (acc->count != 0 && now - acc->bucket >= series_tier[tier].period) {
+                HT_Series_Close(tier, stream);
+            }
+        }
+    }
+
+    for (uint8_t tier = 0; tier < HT_SERIES_TIERS; tier++) {
+        HT_SeriesTierState *t = &series_tier[tier];
+
+        if ((t->len != 0 || t->file_open) && tick - t->since >= pdMS_TO_TICKS(HT_SERIES_COMMIT_MS)) {
+            HT_Series_Commit(tier);
+        }
+    }
+}
+
+void HT_Series_Flush(void) {
+    uint32_t commits = series_stats.commits;
+
+    if (!series_ready) {
+        return;
+    }
+
+    for (uint8_t tier = HT_SERIES_1MIN; tier < HT_SERIES_TIERS; tier++) {
+        for (uint8_t stream = 0; stream < HT_SERIES_STREAMS; stream++) {
+            HT_Series_Close(tier, stream);
+        }
+    }
+
+    for (uint8_t tier = 0; tier < HT_SERIES_TIERS; tier++) {
+        HT_Series_Commit(tier);
+    }
+
+    series_stats.flush_commits += series_stats.commits - commits;
+}
+
+uint8_t HT_Series_FlushDue(uint32_t within_ms) {
+    TickType_t tick = xTaskGetTickCount();
+    TickType_t deadline = pdMS_TO_TICKS(HT_SERIES_COMMIT_MS);
+    TickType_t ahead = pdMS_TO_TICKS(within_ms);
+
+    for (uint8_t tier = 0; tier < HT_SERIES_TIERS; tier++) {
+        HT_SeriesTierState *t = &series_tier[tier];
+
+        if (t->len + HT_SERIES_ENTRY_MAX > t->buffer_size) {
+            return 1;
+        }
+        if ((t->len != 0 || t->file_open) && tick - t->since + ahead >= deadline) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+uint8_t HT_Series_Pending(void) {
+    for (uint8_t tier = 0; tier < HT_SERIES_TIERS; tier++) {
+        if (series_tier[tier].len != 0 || series_tier[tier].file_open) {
+            return 1;
+        }
+    }
+
+    for (uint8_t tier = HT_SERIES_1MIN; tier < HT_SERIES_TIERS; tier++) {
+        for (uint8_t stream = 0; stream < HT_SERIES_STREAMS; stream++) {
+            if (series_acc[tier - 1][stream].count != 0) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int HT_Series_Query(HT_SeriesTier tier, uint32_t from, uint32_t to, HT_SeriesVisitFn visit, void *ctx) {
+    HT_SeriesTierState *t;
+    HT_SeriesCodec codec;
+    HT_SeriesMerge *merge = NULL;
+    uint32_t last = 0, next, consumed;
+    uint8_t slot = 0;
+    int visited = 0, stop = 0;
+
+    if (tier >= HT_SERIES_TIERS || visit == NULL) {
+        return -1;
+    }
+    t = &series_tier[tier];
+
+    /* Aggregate points go through the merge, one held back per stream (MQTT task only) */
+    if (tier != HT_SERIES_RAW) {
+        merge = &series_merge;
+        merge->visit = visit;
+        merge->ctx = ctx;
+        merge->visited = 0;
+        memset(merge->held, 0, sizeof(merge->held));
+        visit = HT_Series_Merge;
+        ctx = merge;
+    }
+
+    /* A reader only sees what littlefs committed, the RAM tail is read from buf */
+    if (t->file_open) {
+        HT_Series_Commit(tier);
+    }
+
+    for (;;) {
+        /* The ring wraps, slots are walked in sequence order */
+        next = UINT32_MAX;
+        for (uint8_t i = 0; i < t->segments; i++) {
+            if (t->seq[i] > last && t->seq[i] < next) {
+                next = t->seq[i];
+                slot = i;
+            }
+        }
+        if (next == UINT32_MAX) {
+            break;
+        }
+        last = next;
+
+        /* Not a break: a clock set backwards by the network leaves an older base after a newer one */
+        if (t->base[slot] > to) {
+            continue;
+        }
+        if (HT_Series_Scan(tier, slot, &codec, from, to, visit, ctx, &visited, &consumed) > 0) {
+            stop = 1;
+            break;
+        }
+    }
+
+    if (merge == NULL) {
+        return visited;
+    }
+    for (uint8_t stream = 0; stream < HT_SERIES_STREAMS && !stop; stream++) {
+        if (merge->held[stream]) {
+            stop = HT_Series_Emit(merge, stream);
+        }
+    }
+
+    return merge->visited;
+}
+
+void HT_Series_GetStats(HT_SeriesStats *stats) {
+    memcpy(stats, &series_stats, sizeof(*stats));
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -0,0 +1,75 @@
+/**
+ *
+ * Copyright (c) 2023 HT Micron Semicondutores S.A.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "HT_CoreHub_Sleep.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+static uint8_t sleep_handle = 0xff;
+static volatile uint32_t sleep_hold = 0;
+static volatile TickType_t sleep_deadline = 0;
+static volatile slpManSlpState_t sleep_max_depth = HT_SLEEP_MAX_DEPTH;
+
+void HT_Sleep_Init(void) {
+    slpManApplyPlatVoteHandle(HT_SLEEP_VOTE_NAME, &sleep_handle);
+}
+
+void HT_Sleep_Hold(uint32_t reasons) {
+    uint32_t was = sleep_hold;
+
+    sleep_hold = was | reasons;
+
+    /* One vote for any number of reasons, the platform counts votes per handle */
+    if (was == 0 && sleep_hold != 0 && sleep_handle != 0xff)
+        slpManPlatVoteDisableSleep(sleep_handle, HT_SLEEP_VOTE_STATE);
+}
+
+void HT_Sleep_Release(uint32_t reasons) {
+    uint32_t was = sleep_hold;
+
+    sleep_hold = was & ~reasons;
+
+    if (was != 0 && sleep_hold == 0 && sleep_handle != 0xff)
+        slpManPlatVoteEnableSleep(sleep_handle, HT_SLEEP_VOTE_STATE);
+}
+
+void HT_Sleep_SetDeadline(uint32_t ms) {
+    sleep_deadline = xTaskGetTickCount() + pdMS_TO_TICKS(ms);
+
+    if (ms < HT_SLEEP_DEADLINE_GUARD_MS)
+        HT_Sleep_Hold(HT_SLEEP_HOLD_DEADLINE);
+    else
+        HT_Sleep_Release(HT_SLEEP_HOLD_DEADLINE);
+}
+
+void HT_Sleep_SetMaxDepth(slpManSlpState_t depth) {
+    sleep_max_depth = depth;
+}
+
+slpManSlpState_t HT_Sleep_MaxDepth(void) {
+    TickType_t left = sleep_deadline - xTaskGetTickCount();
+
+    if (sleep_hold != 0)
+        return SLP_IDLE_STATE;
+
+    /* Not worth the entry/exit cost this close to the deadline; a past one
+       (reconnect backoff, boot) belongs to nobody and does not count */
+    if ((int32_t)left >= 0 && left < pdMS_TO_TICKS(HT_SLEEP_DEADLINE_GUARD_MS))
+        return SLP_IDLE_STATE;
+
+    return sleep_max_depth;
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -0,0 +1,203 @@
+/**
+ *
+ * Copyright (c) 2023 HT Micron Semicondutores S.A.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "HT_CoreHub_State.h"
+#include "HT_CoreHubFsm.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lfs_port.h"
+#include "nvram.h"
+#include "string.h"
+
+#define HT_STATE_MAGIC                  0x54534843      /* "CHST" */
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;                                     /* Valid entries in amb[]. */
+    uint16_t crc;                                       /* CRC16-CCITT of the record with crc = 0. */
+    uint16_t reserved;
+    char name[HT_STATE_MAX_AMBIENTES][HT_STATE_NAME_LEN];
+    HT_StateAmbiente amb[HT_STATE_MAX_AMBIENTES];
+} HT_StateRecord;
+
+typedef char HT_StateFits[(NUM_AMBIENTES <= HT_STATE_MAX_AMBIENTES) ? 1 : -1];
+
+static HT_StateRecord state_saved;                      /* As read from / last written to flash. */
+static HT_StateRecord state_pending;                    /* Latest values, written by HT_State_Poll(). */
+static uint8_t state_loaded = 0;
+static uint8_t state_dirty = 0;
+static uint8_t state_written = 0;                       /* A write happened since boot, state_last_write is valid. */
+static TickType_t state_last_write = 0;
+static HT_StateStats state_stats;
+static uint32_t state_erase[HT_STATE_LFS_BLOCKS];
+
+static uint16_t HT_State_Crc(HT_StateRecord *record) {
+    uint16_t crc, saved = record->crc;
+
+    record->crc = 0;
+    crc = nvram_crc16_ccitt(record, sizeof(*record));
+    record->crc = saved;
+
+    return crc;
+}
+
+static void HT_State_Load(void) {
+    lfs_file_t file;
+    lfs_ssize_t len = 0;
+
+    state_loaded = 1;
+
+    if (LFS_FileOpen(&file, HT_STATE_FILE, LFS_O_RDONLY) == 0) {
+        len = LFS_FileRead(&file, &state_saved, sizeof(state_saved));
+        LFS_FileClose(&file);
+    }
+
+    /* A short, foreign or corrupted record is the same as no record */
+    if (len != (lfs_ssize_t)sizeof(state_saved) || state_saved.magic != HT_STATE_MAGIC ||
+        state_saved.version != HT_STATE_VERSION || state_saved.count > HT_STATE_MAX_AMBIENTES ||
+        state_saved.crc != HT_State_Crc(&state_saved)) {
+        memset(&state_saved, 0, sizeof(state_saved));
+    }
+
+    memcpy(&state_pending, &state_saved, sizeof(state_pending));
+    state_pending.magic = HT_STATE_MAGIC;
+    state_pending.version = HT_STATE_VERSION;
+    state_pending.count = NUM_AMBIENTES;
+}
+
+uint8_t HT_State_Restore(int ambiente_idx, const char *name, HT_StateAmbiente *amb) {
+    if (!state_loaded) {
+        HT_State_Load();
+    }
+
+    if (ambiente_idx < 0 || ambiente_idx >= NUM_AMBIENTES) {
+        return 0;
+    }
+
+    /* The pending name is set even without a match, so the next write records it */
+    strncpy(state_pending.name[ambiente_idx], name, HT_STATE_NAME_LEN - 1);
+    state_pending.name[ambiente_idx][HT_STATE_NAME_LEN - 1] = '\0';
+
+    if (state_saved.magic != HT_STATE_MAGIC || ambiente_idx >= state_saved.count ||
+        strncmp(state_saved.name[ambiente_idx], name, HT_STATE_NAME_LEN - 1) != 0) {
+        memset(&state_pending.amb[ambiente_idx], 0, sizeof(HT_StateAmbiente));
+        return 0;
+    }
+
+    memcpy(amb, &state_saved.amb[ambiente_idx], sizeof(*amb));
+    return 1;
+}
+
+void HT_State_Update(int ambiente_idx, const HT_StateAmbiente *amb) {
+    const HT_StateAmbiente *saved = &state_saved.amb[ambiente_idx];
+    uint8_t changed;
+
+    if (!state_loaded || ambiente_idx < 0 || ambiente_idx >= NUM_AMBIENTES) {
+        return;
+    }
+
+    memcpy(&state_pending.amb[ambiente_idx], amb, sizeof(*amb));
+
+    /* Sensor values and the running alarm timer ride along, they never trigger a write */
+    changed = state_saved.magic != HT_STATE_MAGIC || ambiente_idx >= state_saved.count ||
+              strncmp(state_saved.name[ambiente_idx], state_pending.name[ambiente_idx], HT_STATE_NAME_LEN) != 0 ||
+              saved->door_state != amb->door_state || saved->light_state != amb->light_state ||
+              saved->ac_state != amb->ac_state || saved->buzzer_state != amb->buzzer_state ||
+              saved->alarm_active != amb->alarm_active;
+
+    if (changed && state_dirty) {
+        state_stats.coalesced++;
+    }
+    state_dirty |= changed;
+}
+
+uint32_t HT_State_NextPollMs(void) {
+    TickType_t since;
+
+    if (!state_dirty) {
+        return UINT32_MAX;
+    }
+    if (!state_written) {
+        return 0;
+    }
+
+    since = xTaskGetTickCount() - state_last_write;
+    if (since >= pdMS_TO_TICKS(HT_STATE_WRITE_INTERVAL_MS)) {
+        return 0;
+    }
+    return (pdMS_TO_TICKS(HT_STATE_WRITE_INTERVAL_MS) - since) * portTICK_PERIOD_MS;
+}
+
+void HT_State_Poll(void) {
+    lfs_file_t file;
+    lfs_ssize_t len = -1;
+
+    if (HT_State_NextPollMs() != 0) {
+        return;
+    }
+
+    state_pending.crc = HT_State_Crc(&state_pending);
+
+    /* littlefs commits the new contents on close, a reset mid-write keeps the old record */
+    if (LFS_FileOpen(&file, HT_STATE_FILE, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) == 0) {
+        len = LFS_FileWrite(&file, &state_pending, sizeof(state_pending));
+        if (LFS_FileClose(&file) != 0) {
+            len = -1;
+        }
+    }
+
+    /* A failed write also waits for the next interval, a dead flash is not retried in a loop */
+    state_written = 1;
+    state_last_write = xTaskGetTickCount();
+
+    if (len != (lfs_ssize_t)sizeof(state_pending)) {
+        state_stats.write_failures++;
+        return;
+    }
+
+    memcpy(&state_saved, &state_pending, sizeof(state_saved));
+    state_dirty = 0;
+    state_stats.writes++;
+}
+
+void HT_State_GetStats(HT_StateStats *stats) {
+    lfs_status_t fs;
+
+    memcpy(stats, &state_stats, sizeof(*stats));
+    stats->erase_max = 0;
+    stats->erase_total = 0;
+    stats->erase_valid = 0;
+
+    /* The port fills one counter per block of the region. The stub in the prebuilt
+       library returns 0 and leaves the array alone, hence the zeroing. */
+    memset(state_erase, 0, sizeof(state_erase));
+    if (LFS_Statfs(&fs) != 0 || fs.total_block > HT_STATE_LFS_BLOCKS ||
+        LFS_GetBlockEraseCountResult(state_erase) != 0) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < fs.total_block; i++) {
+        stats->erase_total += state_erase[i];
+        if (state_erase[i] > stats->erase_max) {
+            stats->erase_max = state_erase[i];
+        }
+    }
+
+    /* A mounted, used region has been erased at least once: all zero means no monitor */
+    stats->erase_valid = (stats->erase_total != 0);
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -0,0 +1,237 @@
+/**
+ *
+ * Copyright (c) 2023 HT Micron Semicondutores S.A.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "HT_CoreHub_Uplink.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "string.h"
+
+typedef struct {
+    uint8_t used;
+    uint8_t len;
+    uint16_t key;
+    TickType_t since;                                   /* When the oldest value for this key was held. */
+    uint8_t payload[HT_UPLINK_PAYLOAD_MAX];
+} HT_UplinkSlot;
+
+static HT_UplinkSlot uplink_slot[HT_UPLINK_SLOTS];
+static uint8_t uplink_held = 0;
+static MQTTClient *uplink_client = NULL;
+static HT_UplinkSendFn uplink_send = NULL;
+static HT_UplinkFlushHook uplink_hook = NULL;
+static TickType_t uplink_radio_tick = 0;
+static uint8_t uplink_radio_seen = 0;
+static HT_UplinkStats_t uplink_stats = { .hold_ms = HT_UPLINK_HOLD_DEFAULT_MS };
+
+static uint32_t HT_Uplink_ElapsedMs(TickType_t since) {
+    return (xTaskGetTickCount() - since) * portTICK_PERIOD_MS;
+}
+
+static void HT_Uplink_RadioActive(void) {
+    uplink_radio_tick = xTaskGetTickCount();
+    uplink_radio_seen = 1;
+}
+
+static uint8_t HT_Uplink_WindowOpen(void) {
+    return uplink_radio_seen && HT_Uplink_ElapsedMs(uplink_radio_tick) < HT_UPLINK_RADIO_TAIL_MS;
+}
+
+/* The client wakes the radio for a PINGREQ when either keepalive timer runs out
+ * (keepalive() in MQTTClient.c). A burst ahead of it shares that wake; it only
+ * resets last_sent, so it postpones the PINGREQ when last_sent is the earlier
+ * deadline and leaves it due when last_received is. */
+static int HT_Uplink_KeepaliveLeftMs(void) {
+    int left;
+
+    if (uplink_client == NULL || !uplink_client->isconnected || uplink_client->keepAliveInterval == 0)
+        return -1;
+
+    left = TimerLeftMS(&uplink_client->last_sent);
+    if (TimerLeftMS(&uplink_client->last_received) < left)
+        left = TimerLeftMS(&uplink_client->last_received);
+
+    return left;
+}
+
+static uint8_t HT_Uplink_KeepaliveDue(void) {
+    int left = HT_Uplink_KeepaliveLeftMs();
+
+    return left >= 0 && left < HT_UPLINK_KEEPALIVE_LEAD_MS;
+}
+
+static uint8_t HT_Uplink_HoldExpired(void) {
+    for (uint32_t i = 0; i < HT_UPLINK_SLOTS; i++) {
+        if (uplink_slot[i].used && HT_Uplink_ElapsedMs(uplink_slot[i].since) >= uplink_stats.hold_ms)
+            return 1;
+    }
+    return 0;
+}
+
+static void HT_Uplink_Flush(uint8_t aligned) {
+    HT_UplinkSlot *slot;
+    uint32_t sent = 0;
+
+    uplink_stats.bursts++;
+    if (aligned)
+        uplink_stats.aligned++;
+
+    for (uint32_t i = 0; i < HT_UPLINK_SLOTS && uplink_held; i++) {
+        slot = &uplink_slot[i];
+        if (!slot->used)
+            continue;
+
+        /* Keep it for the next window if the session just broke */
+        if (uplink_send(slot->key, slot->payload, slot->len) != 0)
+            break;
+
+        slot->used = 0;
+        uplink_held--;
+        uplink_stats.flushed++;
+        sent++;
+    }
+
+    if (uplink_hook != NULL)
+        uplink_hook();
+
+    /* A failed send says nothing about the radio */
+    if (sent != 0)
+        HT_Uplink_RadioActive();
+}
+
+void HT_Uplink_SetRadioTiming(uint32_t edrx_ms, uint32_t psm_active_s) {
+    uint32_t hold = HT_UPLINK_HOLD_DEFAULT_MS;
+
+    /* The next paging window is at most one eDRX cycle away; without eDRX,
+       the PSM active time is how long the UE stays reachable after an uplink */
+    if (edrx_ms != 0)
+        hold = edrx_ms;
+    else if (psm_active_s != 0)
+        hold = psm_active_s * 1000;
+
+    if (hold < HT_UPLINK_HOLD_MIN_MS)
+        hold = HT_UPLINK_HOLD_MIN_MS;
+    if (hold > HT_UPLINK_HOLD_MAX_MS)
+        hold = HT_UPLINK_HOLD_MAX_MS;
+
+    uplink_stats.hold_ms = hold;
+}
+
+void HT_Uplink_Init(MQTTClient *client, HT_UplinkSendFn send, HT_UplinkFlushHook hook) {
+    uplink_client = client;
+    uplink_send = send;
+    uplink_hook = hook;
+}
+
+int HT_Uplink_Publish(uint16_t key, const uint8_t *payload, uint32_t len, HT_UplinkClass cls) {
+    HT_UplinkSlot *slot = NULL;
+    int rc;
+
+    if (cls == HT_UPLINK_DEFERRED && len <= HT_UPLINK_PAYLOAD_MAX) {
+        for (uint32_t i = 0; i < HT_UPLINK_SLOTS; i++) {
+            if (uplink_slot[i].used && uplink_slot[i].key == key) {
+                slot = &uplink_slot[i];
+                uplink_stats.coalesced++;
+                break;
+            }
+            if (!uplink_slot[i].used && slot == NULL)
+                slot = &uplink_slot[i];
+        }
+
+        if (slot != NULL) {
+            if (!slot->used) {
+                slot->used = 1;
+                slot->key = key;
+                slot->since = xTaskGetTickCount();
+                uplink_held++;
+            }
+            memcpy(slot->payload, payload, len);
+            slot->len = (uint8_t)len;
+            uplink_stats.deferred++;
+            return 0;
+        }
+
+        uplink_stats.overflow++;
+    } else if (cls == HT_UPLINK_DEFERRED) {
+        uplink_stats.overflow++;
+    } else {
+        uplink_stats.urgent++;
+    }
+
+    rc = uplink_send(key, payload, len);
+    if (rc == 0)
+        HT_Uplink_RadioActive();
+
+    return rc;
+}
+
+void HT_Uplink_NotifyRadio(void) {
+    HT_Uplink_RadioActive();
+}
+
+void HT_Uplink_Poll(void) {
+    uint8_t window, keepalive;
+
+    if (uplink_send == NULL || uplink_client == NULL || !uplink_client->isconnected)
+        return;
+
+    window = HT_Uplink_WindowOpen();
+    keepalive = HT_Uplink_KeepaliveDue();
+
+    if (uplink_held) {
+        if (window || keepalive)
+            HT_Uplink_Flush(1);
+        else if (HT_Uplink_HoldExpired())
+            HT_Uplink_Flush(0);
+    } else if ((window || keepalive) && uplink_hook != NULL) {
+        /* Nothing held, periodic reports still ride the wake */
+        uplink_hook();
+    }
+}
+
+uint32_t HT_Uplink_NextPollMs(void) {
+    uint32_t next = UINT32_MAX, age, left;
+    int keepalive;
+
+    /* Nothing held: reports ride whatever wakes the task (keepalive, downlink) */
+    if (!uplink_held || uplink_client == NULL || !uplink_client->isconnected)
+        return UINT32_MAX;
+
+    if (HT_Uplink_WindowOpen())
+        return 0;
+
+    for (uint32_t i = 0; i < HT_UPLINK_SLOTS; i++) {
+        if (!uplink_slot[i].used)
+            continue;
+        age = HT_Uplink_ElapsedMs(uplink_slot[i].since);
+        left = (age < uplink_stats.hold_ms) ? uplink_stats.hold_ms - age : 0;
+        if (left < next)
+            next = left;
+    }
+
+    keepalive = HT_Uplink_KeepaliveLeftMs();
+    if (keepalive >= 0) {
+        left = (keepalive > HT_UPLINK_KEEPALIVE_LEAD_MS) ? (uint32_t)(keepalive - HT_UPLINK_KEEPALIVE_LEAD_MS) : 0;
+        if (left < next)
+            next = left;
+    }
+
+    return next;
+}
+
+void HT_Uplink_GetStats(HT_UplinkStats_t *stats) {
+    *stats = uplink_stats;
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -13,7 +13,13 @@
  *
  */
 
+#define HT_LOG_MODULE_LEVEL HT_LOG_LEVEL_MQTT_API
+#include "HT_CoreHub_Log.h"
 #include "HT_MQTT_Api.h"
+#if MQTT_TLS_ENABLE == 1
+#include "HT_MQTT_Tls.h"
+#endif
+#include "slpman_qcx212.h"
 #include "stdio.h"
 #include "string.h"
 
@@ -29,36 +35,70 @@ static void (*g_mqtt_message_callback)(MessageData *msg) = NULL;
 
 static MQTTPacket_connectData connectData = MQTTPacket_connectData_initializer;
 
-/* TLS context - simplified for non-TLS usage */
 #if MQTT_TLS_ENABLE == 1
-static struct {
-    uint32_t caCertLen;
-    int32_t port;
-    char *host;
-    uint32_t timeout_ms;
-    bool isMqtt;
-    uint32_t timeout_r;
-    uint32_t timeout_s;
-} mqtt_client_ctx;
+static MqttClientContext mqtt_client_ctx;
+#if HT_MQTT_TLS_BENCH == 1
+static uint8_t mqtt_tls_bench_done = 0;
+static HT_MQTT_TLSHandshakeStats_t mqtt_tls_bench[HT_MQTT_TLS_PROFILE_NUM];
+#endif
 #endif
 
+#define HT_MQTT_HIB_MAGIC   0x51544D48          /* "HMTQ" */
+#define HT_MQTT_HIB_VERSION 1
+
+/* Client and socket state kept in the user NVMem across sleep2/hibernate */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t next_packetid;
+    uint16_t keepalive;                         /* s */
+    uint8_t cleansession;
+    uint8_t ping_outstanding;
+    uint8_t default_handler;                    /* downlink routed to HT_MQTT_SubscribeCallback */
+    uint8_t reserved[3];
+    uint32_t sent_left_ms;                      /* keepalive timers at backup */
+    uint32_t received_left_ms;
+    uint32_t saved_secs;                        /* hib second counter at backup */
+    CmsSockMgrConnHibContext sock;
+} HT_MQTT_HibState;
+
+typedef char HT_MQTT_HibStateFits[(sizeof(HT_MQTT_HibState) <= HT_MQTT_HIB_NVMEM_SIZE) ? 1 : -1];
+
+void HT_MQTT_SetTlsCredentials(const char *ca_cert, int32_t ca_cert_len, const char *client_cert, int32_t client_cert_len,
+                                        const char *client_pk, int32_t client_pk_len) {
+#if MQTT_TLS_ENABLE == 1
+    mqtt_client_ctx.caCert = ca_cert;
+    mqtt_client_ctx.caCertLen = ca_cert_len;
+    mqtt_client_ctx.clientCert = client_cert;
+    mqtt_client_ctx.clientCertLen = client_cert_len;
+    mqtt_client_ctx.clientPk = client_pk;
+    mqtt_client_ctx.clientPkLen = client_pk_len;
+#else
+    (void)ca_cert; (void)ca_cert_len;
+    (void)client_cert; (void)client_cert_len;
+    (void)client_pk; (void)client_pk_len;
+#endif
+}
+
+void HT_MQTT_SetTlsProfile(uint8_t profile, const unsigned char *psk, int32_t psk_len, const char *psk_identity) {
+#if MQTT_TLS_ENABLE == 1
+    mqtt_client_ctx.profile = profile;
+    mqtt_client_ctx.psk = psk;
+    mqtt_client_ctx.pskLen = psk_len;
+    mqtt_client_ctx.pskIdentity = psk_identity;
+#else
+    (void)profile; (void)psk; (void)psk_len; (void)psk_identity;
+#endif
+}
+
 uint8_t HT_MQTT_Connect(MQTTClient *mqtt_client, Network *mqtt_network, char *addr, int32_t port, uint32_t send_timeout, uint32_t rcv_timeout, char *clientID, 
                                         char *username, char *password, uint8_t mqtt_version, uint32_t keep_alive_interval, uint8_t *sendbuf, 
                                         uint32_t sendbuf_size, uint8_t *readbuf, uint32_t readbuf_size) {
+    int ret;
 
-    printf("HT_MQTT_Connect: Iniciando conexão...\n");
-
-#if  MQTT_TLS_ENABLE == 1
-    mqtt_client_ctx.caCertLen = 0;
-    mqtt_client_ctx.port = port;
-    mqtt_client_ctx.host = addr;
-    mqtt_client_ctx.timeout_ms = MQTT_GENERAL_TIMEOUT;
-    mqtt_client_ctx.isMqtt = true;
-    mqtt_client_ctx.timeout_r = MQTT_GENERAL_TIMEOUT;
-    mqtt_client_ctx.timeout_s = MQTT_GENERAL_TIMEOUT;
-#endif
+    HT_LOG(mqtt_connect_start, P_DEBUG, 0, "HT_MQTT_Connect: Iniciando conexão...");
 
-    printf("HT_MQTT_Connect: Configurando dados de conexão...\n");
+    HT_LOG(mqtt_connect_cfg, P_DEBUG, 0, "HT_MQTT_Connect: Configurando dados de conexão...");
     connectData.MQTTVersion = mqtt_version;
     connectData.clientID.cstring = clientID;
     connectData.username.cstring = username;
@@ -67,49 +107,90 @@ uint8_t HT_MQTT_Connect(MQTTClient *mqtt_client, Network *mqtt_network, char *ad
     connectData.will.qos = QOS0;
     connectData.cleansession = false;
 
+    HT_LOG(mqtt_net_init, P_DEBUG, 0, "HT_MQTT_Connect: Inicializando rede...");
+    NetworkInit(mqtt_network);
+    HT_LOG(mqtt_client_init, P_DEBUG, 0, "HT_MQTT_Connect: Inicializando cliente MQTT...");
+    MQTTClientInit(mqtt_client, mqtt_network, MQTT_GENERAL_TIMEOUT, (unsigned char *)sendbuf, sendbuf_size, (unsigned char *)readbuf, readbuf_size);
+
 #if MQTT_TLS_ENABLE == 1
-    /* TLS connection - simplified implementation */
-    printf("TLS not fully implemented, using non-TLS connection\n");
-    mqtt_client_ctx.caCertLen = 0;
+    /* Credentials stay as set by HT_MQTT_SetTlsCredentials(), timeouts are in seconds */
     mqtt_client_ctx.port = port;
     mqtt_client_ctx.host = addr;
     mqtt_client_ctx.timeout_ms = MQTT_GENERAL_TIMEOUT;
     mqtt_client_ctx.isMqtt = true;
-    mqtt_client_ctx.timeout_r = MQTT_GENERAL_TIMEOUT;
-    mqtt_client_ctx.timeout_s = MQTT_GENERAL_TIMEOUT;
-    
-    /* For now, fall through to non-TLS implementation */
+    mqtt_client_ctx.timeout_s = send_timeout / 1000;
+    mqtt_client_ctx.timeout_r = rcv_timeout / 1000;
+
+#if HT_MQTT_TLS_BENCH == 1
+    /* Custo de handshake de cada perfil, uma vez por boot: os resultados saem no log do HT_MQTT_TLSBenchmark */
+    if(!mqtt_tls_bench_done) {
+        mqtt_tls_bench_done = 1;
+        ret = HT_MQTT_TLSBenchmark(&mqtt_client_ctx, mqtt_network, mqtt_tls_bench);
+        HT_LOG(mqtt_tls_bench, P_INFO, 1, "HT_MQTT_Connect: benchmark TLS, %d perfis medidos", ret);
+    }
 #endif
 
-    printf("HT_MQTT_Connect: Inicializando rede...\n");
-    NetworkInit(mqtt_network);
-    printf("HT_MQTT_Connect: Inicializando cliente MQTT...\n");
-    MQTTClientInit(mqtt_client, mqtt_network, MQTT_GENERAL_TIMEOUT, (unsigned char *)sendbuf, sendbuf_size, (unsigned char *)readbuf, readbuf_size);
-    
-    printf("HT_MQTT_Connect: Configurando timeout de conexão...\n");
+    HT_LOG(mqtt_tls_connect, P_DEBUG, 0, "HT_MQTT_Connect: Conectando à rede (TLS)...");
+    /* Opens the socket and runs the handshake, closes the socket on failure */
+    ret = HT_MQTT_TLSConnect(&mqtt_client_ctx, mqtt_network);
+    if(ret != 0) {
+        HT_LOG(mqtt_tls_fail, P_WARNING, 1, "HT_MQTT_Connect: TLS connection failed (%d)", ret);
+
+        switch(ret) {
+            case HT_MQTT_TLS_ERR_SOCKET:
+                return HT_MQTT_CONNECT_ERR_SOCKET;
+            case HT_MQTT_TLS_ERR_DNS:
+                return HT_MQTT_CONNECT_ERR_DNS;
+            case HT_MQTT_TLS_ERR_TCP:
+                return HT_MQTT_CONNECT_ERR_TCP;
+            case HT_MQTT_TLS_ERR_TCP_TIMEOUT:
+                return HT_MQTT_CONNECT_ERR_TCP_TIMEOUT;
+            default:
+                return HT_MQTT_CONNECT_ERR_TLS;
+        }
+    }
+#else
+    HT_LOG(mqtt_set_timeout, P_DEBUG, 0, "HT_MQTT_Connect: Configurando timeout de conexão...");
     /* Set connection timeout */
     if(NetworkSetConnTimeout(mqtt_network, send_timeout, rcv_timeout) != 0) {
-        printf("HT_MQTT_Connect: Failed to set connection timeout\n");
-        return 1;
+        HT_LOG(mqtt_set_timeout_fail, P_WARNING, 0, "HT_MQTT_Connect: Failed to set connection timeout");
+        if(mqtt_network->my_socket >= 0)
+            mqtt_network->disconnect(mqtt_network);
+        return HT_MQTT_CONNECT_ERR_SOCKET;
     }
     
-    printf("HT_MQTT_Connect: Conectando à rede...\n");
+    HT_LOG(mqtt_net_connect, P_DEBUG, 0, "HT_MQTT_Connect: Conectando à rede...");
     /* Connect to network */
-    if(NetworkConnect(mqtt_network, addr, port) != 0) {
-        printf("HT_MQTT_Connect: Network connection failed\n");
-        return 1;
+    ret = NetworkConnect(mqtt_network, addr, port);
+    if(ret != 0) {
+        HT_LOG(mqtt_net_fail, P_WARNING, 1, "HT_MQTT_Connect: Network connection failed (%d)", ret);
+        mqtt_network->disconnect(mqtt_network);
+
+        if(ret < 0)
+            return HT_MQTT_CONNECT_ERR_DNS;
+        else if(ret == MQTT_TIMEOUT)
+            return HT_MQTT_CONNECT_ERR_TCP_TIMEOUT;
+        return HT_MQTT_CONNECT_ERR_TCP;
     }
+#endif
     
-    printf("HT_MQTT_Connect: Conectando ao broker MQTT...\n");
+    HT_LOG(mqtt_broker_connect, P_DEBUG, 0, "HT_MQTT_Connect: Conectando ao broker MQTT...");
     /* Connect to MQTT broker */
-    if(MQTTConnect(mqtt_client, &connectData) != 0) {
-        printf("HT_MQTT_Connect: MQTT connection failed\n");
-        return 1;
+    ret = MQTTConnect(mqtt_client, &connectData);
+    if(ret != 0) {
+        HT_LOG(mqtt_broker_fail, P_WARNING, 1, "HT_MQTT_Connect: MQTT connection failed (%d)", ret);
+        mqtt_network->disconnect(mqtt_network);
+
+        /* Positive values are the CONNACK return code sent by the broker */
+        if(ret > 0)
+            return HT_MQTT_CONNECT_ERR_CONNACK_REFUSED;
+        return HT_MQTT_CONNECT_ERR_CONNACK_TIMEOUT;
     }
     
-    printf("HT_MQTT_Connect: Successfully connected to MQTT broker %s:%ld\n", addr, port);
+    HT_LOG_STR(mqtt_connected, P_INFO, "HT_MQTT_Connect: Successfully connected to MQTT broker %s", addr);
+    HT_LOG(mqtt_connected_port, P_INFO, 1, "HT_MQTT_Connect: port %d", (int)port);
 
-    return 0;
+    return HT_MQTT_CONNECT_OK;
 }
 
 int HT_MQTT_Publish(MQTTClient *mqtt_client, char *topic, uint8_t *payload, uint32_t len, enum QoS qos, uint8_t retained, uint16_t id, uint8_t dup) {
@@ -146,19 +227,29 @@ void HT_MQTT_SubscribeCallback(MessageData *msg) {
             payload[msg->message->payloadlen] = '\0';
         }
         
-        printf("HT_MQTT_SubscribeCallback: Received message - Topic: %s, Payload: %s\n", topic, payload);
+        HT_LOG_STR(mqtt_rx_topic, P_INFO, "HT_MQTT_SubscribeCallback: Received message - Topic: %s", topic);
+        HT_LOG_STR(mqtt_rx_payload, P_INFO, "HT_MQTT_SubscribeCallback: Payload: %s", payload);
     }
 }
 
 void HT_MQTT_Subscribe(MQTTClient *mqtt_client, char *topic, enum QoS qos) {
     int result = MQTTSubscribe(mqtt_client, topic, qos, HT_MQTT_SubscribeCallback);
     if (result != 0) {
-        printf("HT_MQTT_Subscribe: Failed to subscribe to topic %s, result = %d\n", topic, result);
+        HT_LOG(mqtt_sub_fail, P_WARNING, 1, "HT_MQTT_Subscribe: Failed to subscribe, result = %d", result);
+        HT_LOG_STR(mqtt_sub_fail_topic, P_WARNING, "HT_MQTT_Subscribe: topic %s", topic);
     } else {
-        printf("HT_MQTT_Subscribe: Successfully subscribed to topic: %s\n", topic);
+        HT_LOG_STR(mqtt_sub_ok, P_DEBUG, "HT_MQTT_Subscribe: Successfully subscribed to topic: %s", topic);
     }
 }
 
+void HT_MQTT_SubscribeTransient(MQTTClient *mqtt_client, char *topic, enum QoS qos) {
+    HT_MQTT_Subscribe(mqtt_client, topic, qos);
+
+    /* Drop the slot that points at the caller's buffer, delivery falls back to the default handler */
+    MQTTSetMessageHandler(mqtt_client, topic, NULL);
+    mqtt_client->defaultMessageHandler = HT_MQTT_SubscribeCallback;
+}
+
 /*!******************************************************************
  * \fn void HT_MQTT_SetMessageCallback(void (*callback)(MessageData *msg))
  * \brief Set the callback function for MQTT messages.
@@ -186,6 +277,214 @@ int HT_MQTT_Yield(MQTTClient *mqtt_client, int timeout_ms)
     return MQTTYield(mqtt_client, timeout_ms);
 }
 
+/*!******************************************************************
+ * \fn int HT_MQTT_WaitPacket(MQTTClient *mqtt_client, int timeout_ms)
+ * \brief Block on the socket until one packet is received and handled
+ *        or the timeout expires, then service the keepalive.
+ *
+ * \param[in] MQTTClient *mqtt_client           MQTT client handle.
+ * \param[in] int timeout_ms                    Longest wait in milliseconds.
+ * 
+ * \retval int                                  0 = Success, 1 = Error
+ *******************************************************************/
+int HT_MQTT_WaitPacket(MQTTClient *mqtt_client, int timeout_ms)
+{
+    return MQTTWaitPacket(mqtt_client, timeout_ms);
+}
+
+/*!******************************************************************
+ * \fn uint32_t HT_MQTT_KeepaliveLeftMs(MQTTClient *mqtt_client)
+ * \brief Time until the keepalive needs the client.
+ *
+ * \param[in] MQTTClient *mqtt_client           MQTT client handle.
+ * 
+ * \retval uint32_t                             Milliseconds, UINT32_MAX with keepalive off.
+ *******************************************************************/
+uint32_t HT_MQTT_KeepaliveLeftMs(MQTTClient *mqtt_client)
+{
+    int sent, received;
+
+    if (mqtt_client->keepAliveInterval == 0)
+        return UINT32_MAX;
+
+    /* A cycle that ends with the timers expired and the PINGRESP still
+       missing closes the session, so give the broker time to answer */
+    if (mqtt_client->ping_outstanding)
+        return HT_MQTT_PINGRESP_WAIT_MS;
+
+    sent = TimerLeftMS(&mqtt_client->last_sent);
+    received = TimerLeftMS(&mqtt_client->last_received);
+
+    return (uint32_t)((sent < received) ? sent : received);
+}
+
+static HT_MQTT_HibState *HT_MQTT_HibRecord(void)
+{
+    return (HT_MQTT_HibState *)(slpManGetUsrNVMem() + HT_MQTT_HIB_NVMEM_OFFSET);
+}
+
+static void HT_MQTT_HibInvalidate(void)
+{
+    HT_MQTT_HibState *record = HT_MQTT_HibRecord();
+
+    /* Only touch the flash copy when there is something to drop */
+    if (record->magic != 0) {
+        record->magic = 0;
+        slpManUpdateUserNVMem();
+    }
+}
+
+/* Runs in the sleep path before sleep2/hibernate, must not block */
+static void HT_MQTT_HibBackup(void *pdata, slpManLpState state)
+{
+    MQTTClient *mqtt_client = (MQTTClient *)pdata;
+    HT_MQTT_HibState record;
+    uint32_t wake_ms;
+
+    (void)state;
+
+    memset(&record, 0, sizeof(record));
+    if (!mqtt_client->isconnected || NetworkGetHibContext(mqtt_client->ipstack, &record.sock) != 0) {
+        HT_MQTT_HibInvalidate();
+        return;
+    }
+
+    /* Nothing else wakes a hibernated device before the broker's keepalive runs out */
+    wake_ms = HT_MQTT_KeepaliveLeftMs(mqtt_client);
+    if (wake_ms != UINT32_MAX) {
+        slpManDeepSlpTimerStart(HT_MQTT_HIB_TIMER_ID,
+                                (wake_ms > HT_MQTT_HIB_WAKE_GUARD_MS) ? wake_ms - HT_MQTT_HIB_WAKE_GUARD_MS : 1);
+    }
+
+    record.magic = HT_MQTT_HIB_MAGIC;
+    record.version = HT_MQTT_HIB_VERSION;
+    record.next_packetid = (uint16_t)mqtt_client->next_packetid;
+    record.keepalive = (uint16_t)mqtt_client->keepAliveInterval;
+    record.cleansession = (uint8_t)mqtt_client->cleansession;
+    record.ping_outstanding = (uint8_t)mqtt_client->ping_outstanding;
+    record.default_handler = (mqtt_client->defaultMessageHandler == HT_MQTT_SubscribeCallback);
+    record.sent_left_ms = (uint32_t)TimerLeftMS(&mqtt_client->last_sent);
+    record.received_left_ms = (uint32_t)TimerLeftMS(&mqtt_client->last_received);
+    record.saved_secs = GosGetHibSecondCount();
+
+    memcpy(HT_MQTT_HibRecord(), &record, sizeof(record));
+    slpManUpdateUserNVMem();
+}
+
+static void HT_MQTT_HibRegisterBackup(MQTTClient *mqtt_client)
+{
+    static uint8_t registered = 0;
+
+    /* The state is a threshold: called before sleep2 and hibernate, not sleep1 */
+    if (!registered && slpManRegisterUsrdefinedBackupCb(HT_MQTT_HibBackup, mqtt_client, SLPMAN_SLEEP2_STATE) == RET_TRUE)
+        registered = 1;
+}
+
+/*!******************************************************************
+ * \fn uint8_t HT_MQTT_HibArm(MQTTClient *mqtt_client)
+ * \brief Keep the connected session across sleep2/hibernate.
+ *
+ * \param[in] MQTTClient *mqtt_client           Connected MQTT client handle.
+ * 
+ * \retval uint8_t                              0 = Armed, 1 = Session is lost on deep sleep
+ *******************************************************************/
+uint8_t HT_MQTT_HibArm(MQTTClient *mqtt_client)
+{
+#if MQTT_TLS_ENABLE == 1
+    /* The TLS session keys only exist in RAM */
+    (void)mqtt_client;
+    return 1;
+#else
+    if (((Network *)mqtt_client->ipstack)->hib != NULL)
+        return 0;
+
+    if (NetworkEnableHib(mqtt_client->ipstack) != 0) {
+        HT_LOG(mqtt_hib_arm_fail, P_WARNING, 0, "HT_MQTT_HibArm: sockmgr refused the socket, deep sleep drops the session");
+        return 1;
+    }
+
+    HT_MQTT_HibRegisterBackup(mqtt_client);
+    HT_LOG(mqtt_hib_armed, P_DEBUG, 1, "HT_MQTT_HibArm: socket %d kept across hibernation", (int)mqtt_client->ipstack->my_socket);
+    return 0;
+#endif
+}
+
+/*!******************************************************************
+ * \fn uint8_t HT_MQTT_HibDisarm(MQTTClient *mqtt_client)
+ * \brief Give the socket back to the client after a wait that did not
+ *        hibernate.
+ *
+ * \param[in] MQTTClient *mqtt_client           MQTT client handle.
+ * 
+ * \retval uint8_t                              0 = Reads on the socket, 1 = Still armed
+ *******************************************************************/
+uint8_t HT_MQTT_HibDisarm(MQTTClient *mqtt_client)
+{
+    /* Awake, a downlink burst no longer goes through the ring */
+    return (NetworkDisableHib(mqtt_client->ipstack) == 0) ? 0 : 1;
+}
+
+/*!******************************************************************
+ * \fn uint8_t HT_MQTT_Resume(MQTTClient *mqtt_client, Network *mqtt_network, uint8_t *sendbuf, uint32_t sendbuf_size,
+ *                             uint8_t *readbuf, uint32_t readbuf_size)
+ * \brief Rebuild the session saved before sleep2/hibernate.
+ *
+ * \param[in] MQTTClient *mqtt_client           MQTT client handle.
+ * \param[in] Network *mqtt_network             Network handle.
+ * \param[in] uint32_t sendbuf                  Buffer allocated for TX process.
+ * \param[in] uint32_t sendbuf_size             Size of TX buffer.
+ * \param[in] uint32_t readbuf                  Buffer allocated for RX process.
+ * \param[in] uint32_t readbuf_size             Size of RX buffer.
+ * 
+ * \retval uint8_t                              0 = Session resumed, 1 = Nothing to resume
+ *******************************************************************/
+uint8_t HT_MQTT_Resume(MQTTClient *mqtt_client, Network *mqtt_network, uint8_t *sendbuf, uint32_t sendbuf_size,
+                       uint8_t *readbuf, uint32_t readbuf_size)
+{
+    HT_MQTT_HibState record;
+    slpManSlpState_t last = slpManGetLastSlpState();
+    uint32_t elapsed_ms;
+
+    memcpy(&record, HT_MQTT_HibRecord(), sizeof(record));
+
+    /* One shot: a failed resume falls back to CONNECT, a good one is armed again */
+    HT_MQTT_HibInvalidate();
+
+    if (record.magic != HT_MQTT_HIB_MAGIC || record.version != HT_MQTT_HIB_VERSION)
+        return 1;
+
+    /* The NVMem also comes back on power on, but the TCP context does not */
+    if (last != SLP_SLP2_STATE && last != SLP_HIB_STATE)
+        return 1;
+
+    NetworkInit(mqtt_network);
+    MQTTClientInit(mqtt_client, mqtt_network, MQTT_GENERAL_TIMEOUT, (unsigned char *)sendbuf, sendbuf_size, (unsigned char *)readbuf, readbuf_size);
+
+    if (NetworkResume(mqtt_network, &record.sock) != 0) {
+        HT_LOG(mqtt_resume_fail, P_WARNING, 1, "HT_MQTT_Resume: socket %d not rebuilt, reconnecting", (int)record.sock.sockId);
+        return 1;
+    }
+
+    mqtt_client->next_packetid = record.next_packetid;
+    mqtt_client->keepAliveInterval = record.keepalive;
+    mqtt_client->cleansession = record.cleansession;
+    mqtt_client->ping_outstanding = record.ping_outstanding;
+    if (record.default_handler)
+        mqtt_client->defaultMessageHandler = HT_MQTT_SubscribeCallback;
+
+    /* Keepalive timers continue from where they stopped, minus the time asleep */
+    elapsed_ms = (GosGetHibSecondCount() - record.saved_secs) * 1000;
+    TimerCountdownMS(&mqtt_client->last_sent, (record.sent_left_ms > elapsed_ms) ? record.sent_left_ms - elapsed_ms : 0);
+    TimerCountdownMS(&mqtt_client->last_received, (record.received_left_ms > elapsed_ms) ? record.received_left_ms - elapsed_ms : 0);
+    mqtt_client->isconnected = 1;
+
+    HT_MQTT_HibRegisterBackup(mqtt_client);
+
+    HT_LOG(mqtt_resumed, P_INFO, 2, "HT_MQTT_Resume: socket %d resumed after %u s asleep",
+           (int)mqtt_network->my_socket, (unsigned int)(elapsed_ms / 1000));
+    return 0;
+}
+
 /*!******************************************************************
  * \fn int HT_MQTT_Disconnect(MQTTClient *mqtt_client)
  * \brief Disconnect from MQTT broker.
@@ -197,22 +496,29 @@ int HT_MQTT_Yield(MQTTClient *mqtt_client, int timeout_ms)
 int HT_MQTT_Disconnect(MQTTClient *mqtt_client)
 {
     int result = MQTTDisconnect(mqtt_client);
+
+    HT_MQTT_HibInvalidate();
+
+    /* MQTTDisconnect only sends the packet, the socket must be released here */
+    mqtt_client->ipstack->disconnect(mqtt_client->ipstack);
+
     if (result != 0) {
-        printf("HT_MQTT_Disconnect: Failed to disconnect, result = %d\n", result);
+        HT_LOG(mqtt_disc_fail, P_WARNING, 1, "HT_MQTT_Disconnect: Failed to disconnect, result = %d", result);
         return 1;
     }
     
-    printf("HT_MQTT_Disconnect: Successfully disconnected from MQTT broker\n");
+    HT_LOG(mqtt_disc_ok, P_INFO, 0, "HT_MQTT_Disconnect: Successfully disconnected from MQTT broker");
     return 0;
 }
 
 int HT_MQTT_Unsubscribe(MQTTClient *mqtt_client, char *topic) {
     int result = MQTTUnsubscribe(mqtt_client, topic);
     if (result != 0) {
-        printf("HT_MQTT_Unsubscribe: Failed to unsubscribe from topic %s, result = %d\n", topic, result);
+        HT_LOG(mqtt_unsub_fail, P_WARNING, 1, "HT_MQTT_Unsubscribe: Failed to unsubscribe, result = %d", result);
+        HT_LOG_STR(mqtt_unsub_fail_topic, P_WARNING, "HT_MQTT_Unsubscribe: topic %s", topic);
         return 1;
     } else {
-        printf("HT_MQTT_Unsubscribe: Successfully unsubscribed from topic: %s\n", topic);
+        HT_LOG_STR(mqtt_unsub_ok, P_DEBUG, "HT_MQTT_Unsubscribe: Successfully unsubscribed from topic: %s", topic);
         return 0;
     }
 }
@@ -0,0 +1,172 @@
+/**
+ *
+ * Copyright (c) 2023 HT Micron Semicondutores S.A.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "HT_MQTT_Reconnect.h"
+#include "HT_MQTT_Api.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "lwip/errno.h"
+#include "string.h"
+
+/* Maximum number of doublings, keeps base << attempts from overflowing */
+#define HT_MQTT_RECONN_MAX_SHIFT    16
+
+typedef struct {
+    uint32_t base_ms;
+    uint32_t cap_ms;
+} HT_MQTT_ReconnPolicy;
+
+static const HT_MQTT_ReconnPolicy reconn_policy[HT_MQTT_RECONN_CAUSE_NUM] = {
+    [HT_MQTT_RECONN_CAUSE_NO_BEARER]       = {HT_MQTT_RECONN_NO_BEARER_BASE_MS, HT_MQTT_RECONN_NO_BEARER_CAP_MS},
+    [HT_MQTT_RECONN_CAUSE_TCP_RST]         = {HT_MQTT_RECONN_TCP_RST_BASE_MS,   HT_MQTT_RECONN_TCP_RST_CAP_MS},
+    [HT_MQTT_RECONN_CAUSE_CONNACK_REFUSED] = {HT_MQTT_RECONN_REFUSED_BASE_MS,   HT_MQTT_RECONN_REFUSED_CAP_MS},
+    [HT_MQTT_RECONN_CAUSE_TIMEOUT]         = {HT_MQTT_RECONN_TIMEOUT_BASE_MS,   HT_MQTT_RECONN_TIMEOUT_CAP_MS},
+};
+
+static SemaphoreHandle_t reconn_bearer_sem = NULL;
+static volatile uint8_t reconn_bearer_up = 0;
+static uint8_t reconn_attempts[HT_MQTT_RECONN_CAUSE_NUM];
+static uint32_t reconn_seed = 0;
+static HT_MQTT_ReconnStats_t reconn_stats;
+
+static uint32_t HT_MQTT_ReconnRand(void) {
+    /* xorshift32: cheap, good enough to spread a fleet of hubs apart */
+    reconn_seed ^= reconn_seed << 13;
+    reconn_seed ^= reconn_seed >> 17;
+    reconn_seed ^= reconn_seed << 5;
+    return reconn_seed;
+}
+
+static uint32_t HT_MQTT_ReconnNextDelay(HT_MQTT_ReconnCause cause) {
+    const HT_MQTT_ReconnPolicy *policy = &reconn_policy[cause];
+    uint8_t shift = reconn_attempts[cause];
+    uint32_t delay;
+
+    if (shift > HT_MQTT_RECONN_MAX_SHIFT)
+        shift = HT_MQTT_RECONN_MAX_SHIFT;
+
+    delay = policy->base_ms << shift;
+    if (delay > policy->cap_ms || delay < policy->base_ms)
+        delay = policy->cap_ms;
+    else if (reconn_attempts[cause] < 0xFF)
+        reconn_attempts[cause]++;
+
+    /* Equal jitter: half fixed, half random */
+    return (delay / 2) + (HT_MQTT_ReconnRand() % (delay / 2 + 1));
+}
+
+void HT_MQTT_ReconnInit(uint32_t seed) {
+    if (reconn_bearer_sem == NULL)
+        reconn_bearer_sem = xSemaphoreCreateBinary();
+
+    memset(reconn_attempts, 0, sizeof(reconn_attempts));
+    memset(&reconn_stats, 0, sizeof(reconn_stats));
+
+    reconn_seed = seed ^ (uint32_t)xTaskGetTickCount() ^ 0x9E3779B9;
+    if (reconn_seed == 0)
+        reconn_seed = 0x9E3779B9;
+}
+
+HT_MQTT_ReconnCause HT_MQTT_ReconnClassifyConnect(uint8_t connect_result) {
+    /* Whatever went wrong, nothing can work without a bearer */
+    if (!reconn_bearer_up)
+        return HT_MQTT_RECONN_CAUSE_NO_BEARER;
+
+    switch (connect_result) {
+        case HT_MQTT_CONNECT_ERR_SOCKET:
+        case HT_MQTT_CONNECT_ERR_DNS:
+            return HT_MQTT_RECONN_CAUSE_NO_BEARER;
+        case HT_MQTT_CONNECT_ERR_TCP:
+            return HT_MQTT_RECONN_CAUSE_TCP_RST;
+        case HT_MQTT_CONNECT_ERR_CONNACK_REFUSED:
+            return HT_MQTT_RECONN_CAUSE_CONNACK_REFUSED;
+        case HT_MQTT_CONNECT_ERR_TCP_TIMEOUT:
+        case HT_MQTT_CONNECT_ERR_CONNACK_TIMEOUT:
+        case HT_MQTT_CONNECT_ERR_TLS:
+        default:
+            return HT_MQTT_RECONN_CAUSE_TIMEOUT;
+    }
+}
+
+HT_MQTT_ReconnCause HT_MQTT_ReconnClassifyErrno(int sock_errno) {
+    if (!reconn_bearer_up)
+        return HT_MQTT_RECONN_CAUSE_NO_BEARER;
+
+    switch (sock_errno) {
+        case ENETUNREACH:
+        case EHOSTUNREACH:
+        case ENETDOWN:
+            return HT_MQTT_RECONN_CAUSE_NO_BEARER;
+        case ECONNRESET:
+        case ECONNABORTED:
+        case ECONNREFUSED:
+        case ENOTCONN:
+        case EPIPE:
+            return HT_MQTT_RECONN_CAUSE_TCP_RST;
+        default:
+            /* No socket error: the keepalive ran out waiting for PINGRESP */
+            return HT_MQTT_RECONN_CAUSE_TIMEOUT;
+    }
+}
+
+uint32_t HT_MQTT_ReconnWait(HT_MQTT_ReconnCause cause) {
+    TickType_t start;
+    uint32_t delay_ms;
+
+    if (cause >= HT_MQTT_RECONN_CAUSE_NUM)
+        cause = HT_MQTT_RECONN_CAUSE_TIMEOUT;
+
+    reconn_stats.failures[cause]++;
+    delay_ms = HT_MQTT_ReconnNextDelay(cause);
+    reconn_stats.last_delay_ms = delay_ms;
+
+    start = xTaskGetTickCount();
+    if (xSemaphoreTake(reconn_bearer_sem, pdMS_TO_TICKS(delay_ms)) == pdTRUE) {
+        /* Bearer is back, whatever was backing off is worth retrying now */
+        reconn_stats.bearer_wakeups++;
+        memset(reconn_attempts, 0, sizeof(reconn_attempts));
+    }
+
+    return (uint32_t)(xTaskGetTickCount() - start) * portTICK_PERIOD_MS;
+}
+
+void HT_MQTT_ReconnSuccess(void) {
+    reconn_stats.connects++;
+    memset(reconn_attempts, 0, sizeof(reconn_attempts));
+
+    /* Drop any wakeup given while we were not waiting */
+    xSemaphoreTake(reconn_bearer_sem, 0);
+}
+
+void HT_MQTT_ReconnNotifyBearer(uint8_t up) {
+    uint8_t was_up = reconn_bearer_up;
+
+    reconn_bearer_up = up ? 1 : 0;
+
+    if (up && !was_up && reconn_bearer_sem != NULL)
+        xSemaphoreGive(reconn_bearer_sem);
+}
+
+uint8_t HT_MQTT_ReconnBearerUp(void) {
+    return reconn_bearer_up;
+}
+
+void HT_MQTT_ReconnGetStats(HT_MQTT_ReconnStats_t *stats) {
+    if (stats != NULL)
+        memcpy(stats, &reconn_stats, sizeof(reconn_stats));
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
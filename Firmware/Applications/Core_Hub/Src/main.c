@@ -7,6 +7,8 @@
  * Seguindo a estrutura do MQTT_EXAMPLE
  */
 
+#define HT_LOG_MODULE_LEVEL HT_LOG_LEVEL_MAIN
+#include "HT_CoreHub_Log.h"
 #include "string.h"
 #include "bsp.h"
 #include "ostask.h"
@@ -16,6 +18,10 @@
 #include "HT_MQTT_Api.h"
 #include "ps_lib_api.h"
 #include "HT_CoreHubFsm.h"
+#include "HT_MQTT_Reconnect.h"
+#include "HT_CoreHub_Uplink.h"
+#include "HT_CoreHub_Sleep.h"
+#include "HT_CoreHub_Config.h"
 
 /* Variáveis globais do sistema */
 static StaticTask_t initTask;
@@ -25,53 +31,73 @@ static QueueHandle_t psEventQueueHandle;
 static uint8_t gImsi[16] = {0};
 static uint32_t gCellID = 0;
 static NmAtiSyncRet gNetworkInfo;
-static uint8_t mqttEpSlpHandler = 0xff;
 static volatile uint8_t simReady = 0;
+static HT_PsEventStats_t psEventStats = {0};
 
 /* Configuração UART */
 static uint32_t uart_cntrl = (ARM_USART_MODE_ASYNCHRONOUS | ARM_USART_DATA_BITS_8 | ARM_USART_PARITY_NONE | 
                                 ARM_USART_STOP_BITS_1 | ARM_USART_FLOW_CONTROL_NONE);
 
+#if MQTT_TLS_ENABLE == 1 && defined(HT_MQTT_TLS_CA_PEM)
+/* CA do broker em flash, o tamanho inclui o '\0' como o mbedtls espera */
+static const char corehub_ca_pem[] = HT_MQTT_TLS_CA_PEM;
+#endif
+
 /* Declarações externas */
 extern void mqtt_demo_onenet(void);
 extern USART_HandleTypeDef huart1;
 
-/* Array de ambientes - definição global */
-const char* ambientes[NUM_AMBIENTES] = {"externo", "mesanino", "prototipagem"};
-
-/* Função para configurar parâmetros de conexão */
+/* Função para configurar parâmetros de conexão (banda e APN da imagem de configuração) */
 static void HT_SetConnectioParameters(void) {
+    const HT_ConfigImage *cfg = HT_Config_Get();
+    const char *apn = HT_Config_String(cfg->apn);
     uint8_t cid = 0;
     PsAPNSetting apnSetting;
     int32_t ret;
     uint8_t networkMode = 0; //nb-iot network mode
     uint8_t bandNum = 1;
-    uint8_t band = 28;
+    uint8_t band = cfg->band;
 
     ret = appSetBandModeSync(networkMode, bandNum, &band);
     if(ret == CMS_RET_SUCC) {
-        printf("SetBand Result: %d\n", ret);
+        HT_LOG(main_set_band, P_INFO, 1, "SetBand Result: %d", ret);
     }
 
     apnSetting.cid = 0;
-    apnSetting.apnLength = strlen("iot.datatem.com.br");
-    strcpy((char *)apnSetting.apnStr, "iot.datatem.com.br");
+    apnSetting.apnLength = strnlen(apn, CMI_PS_MAX_APN_LEN - 1);
+    memcpy(apnSetting.apnStr, apn, apnSetting.apnLength);
+    apnSetting.apnStr[apnSetting.apnLength] = '\0';
     apnSetting.pdnType = CMI_PS_PDN_TYPE_IP_V4V6;
     ret = appSetAPNSettingSync(&apnSetting, &cid);
 }
 
-/* Função para enviar mensagem para a fila */
+/* Função para enviar mensagem para a fila.
+ * O item vai por valor (eventCallbackMessage_t tem 8 bytes): nada é alocado
+ * no contexto do callback PS e o consumidor não tem o que liberar. */
 static void sendQueueMsg(uint32_t msgId, uint32_t xTickstoWait) {
-    eventCallbackMessage_t *queueMsg = NULL;
-    queueMsg = malloc(sizeof(eventCallbackMessage_t));
-    queueMsg->messageId = msgId;
-    if (psEventQueueHandle)
+    eventCallbackMessage_t queueMsg;
+    uint32_t depth;
+
+    queueMsg.messageId = msgId;
+    queueMsg.param = NULL;
+
+    if (psEventQueueHandle == NULL || pdTRUE != xQueueSend(psEventQueueHandle, &queueMsg, xTickstoWait))
     {
-        if (pdTRUE != xQueueSend(psEventQueueHandle, &queueMsg, xTickstoWait))
-        {
-            HT_TRACE(UNILOG_MQTT, mqttAppTask80, P_INFO, 0, "xQueueSend error");
-        }
+        psEventStats.dropped++;
+        HT_TRACE(UNILOG_MQTT, mqttAppTask80, P_INFO, 0, "xQueueSend error");
+        return;
     }
+
+    psEventStats.sent++;
+    depth = (uint32_t)uxQueueMessagesWaiting(psEventQueueHandle);
+    if (depth > psEventStats.peak_depth)
+        psEventStats.peak_depth = depth;
+}
+
+void HT_PsEventGetStats(HT_PsEventStats_t *stats) {
+    taskENTER_CRITICAL();
+    *stats = psEventStats;
+    taskEXIT_CRITICAL();
 }
 
 /* Callback para eventos de rede */
@@ -88,7 +114,7 @@ static INT32 registerPSUrcCallback(urcID_t eventID, void *param, uint32_t paramL
             imsi = (CmiSimImsiStr *)param;
             memcpy(gImsi, imsi->contents, imsi->length);
             simReady = 1;
-            printf("SIM Ready - IMSI: %s\n", gImsi);
+            HT_LOG_STR(main_sim_ready, P_SIG, "SIM Ready - IMSI: %s", gImsi);
             break;
         }
         case NB_URC_ID_MM_SIGQ:
@@ -105,6 +131,7 @@ static INT32 registerPSUrcCallback(urcID_t eventID, void *param, uint32_t paramL
         case NB_URC_ID_PS_BEARER_DEACTED:
         {
             HT_TRACE(UNILOG_MQTT, mqttAppTask83, P_INFO, 0, "Default bearer Deactivated");
+            HT_MQTT_ReconnNotifyBearer(0);
             break;
         }
         case NB_URC_ID_PS_CEREG_CHANGED:
@@ -117,8 +144,12 @@ static INT32 registerPSUrcCallback(urcID_t eventID, void *param, uint32_t paramL
         case NB_URC_ID_PS_NETINFO:
         {
             netif = (NmAtiNetifInfo *)param;
-            if (netif->netStatus == NM_NETIF_ACTIVATED)
+            if (netif->netStatus == NM_NETIF_ACTIVATED) {
+                HT_MQTT_ReconnNotifyBearer(1);
                 sendQueueMsg(QMSG_ID_NW_IPV4_READY, 0);
+            } else if (netif->netStatus != NM_NETIF_ACTIVATED_INFO_CHNAGED) {
+                HT_MQTT_ReconnNotifyBearer(0);
+            }
             break;
         }
 
@@ -135,27 +166,41 @@ static void HT_CoreHubTask(void *arg){
     uint16_t tac = 0;
     uint32_t tauTime = 0, activeTime = 0, cellID = 0, nwEdrxValueMs = 0, nwPtwMs = 0;
 
-    eventCallbackMessage_t *queueItem = NULL;
+    eventCallbackMessage_t queueItem;
 
     /* Registra callback de eventos de rede */
     registerPSEventCallback(NB_GROUP_ALL_MASK, registerPSUrcCallback);
-    psEventQueueHandle = xQueueCreate(APP_EVENT_QUEUE_SIZE, sizeof(eventCallbackMessage_t*));
+    psEventQueueHandle = xQueueCreate(APP_EVENT_QUEUE_SIZE, sizeof(eventCallbackMessage_t));
     if (psEventQueueHandle == NULL)
     {
         HT_TRACE(UNILOG_MQTT, mqttAppTask0, P_INFO, 0, "psEventQueue create error!");
         return;
     }
 
-    /* Configura gerenciamento de sleep */
-    slpManApplyPlatVoteHandle("EP_MQTT",&mqttEpSlpHandler);
-    slpManPlatVoteDisableSleep(mqttEpSlpHandler, SLP_ACTIVE_STATE);
+    /* Voto de sleep só enquanto há trabalho em curso (ver HT_CoreHub_Sleep) */
+    HT_Sleep_Init();
     
     HT_TRACE(UNILOG_MQTT, mqttAppTask1, P_INFO, 0, "CoreHub iniciando...");
 
     /* Inicializa UART para debug */
     HAL_USART_InitPrint(&huart1, GPR_UART1ClkSel_26M, uart_cntrl, 115200);
-    printf("=== CoreHub - Central de Decisão e Automação ===\n");
-    printf("Aguardando SIM e rede NB-IoT...\n");
+    HT_LOG(main_banner, P_SIG, 0, "=== CoreHub - Central de Decisão e Automação ===");
+
+    /* Configuração da frota lida no lugar (XIP): sem parse nem cópia, a imagem embutida se a região estiver vazia */
+    HT_Config_Init();
+    const HT_ConfigImage *cfg = HT_Config_Get();
+    int num_ambientes = (cfg->ambiente_count < NUM_AMBIENTES) ? cfg->ambiente_count : NUM_AMBIENTES;
+    HT_LOG(main_config, P_INFO, 2, "Configuração da flash %d, %d ambientes", HT_Config_FromFlash(), num_ambientes);
+    if (cfg->ambiente_count > NUM_AMBIENTES) {
+        HT_LOG(main_config_amb, P_WARNING, 2, "Imagem lista %d ambientes, o firmware atende %d (NUM_AMBIENTES)", cfg->ambiente_count, NUM_AMBIENTES);
+    }
+
+    /* Inicializa todos os ambientes já com o estado salvo em flash, antes da rede */
+    for (int i = 0; i < num_ambientes; ++i) {
+        HT_CoreHub_InitAmbiente(i, HT_Config_String(cfg->ambiente[i]));
+    }
+
+    HT_LOG(main_wait_sim, P_INFO, 0, "Aguardando SIM e rede NB-IoT...");
     
     /* Aguarda SIM estar pronto */
     while(!simReady) {
@@ -165,7 +210,17 @@ static void HT_CoreHubTask(void *arg){
     /* Configura parâmetros de conexão */
     HT_SetConnectioParameters();
 
-    printf("Iniciando CoreHub...\n");
+    /* Credenciais TLS antes da primeira conexão; sem CA o perfil de certificados recusa conectar */
+#if MQTT_TLS_ENABLE == 1
+    HT_MQTT_SetTlsProfile(HT_MQTT_TLS_PROFILE, NULL, 0, NULL);
+#if defined(HT_MQTT_TLS_CA_PEM)
+    HT_MQTT_SetTlsCredentials(corehub_ca_pem, sizeof(corehub_ca_pem), NULL, 0, NULL, 0);
+#else
+    HT_LOG(main_tls_no_ca, P_WARNING, 0, "TLS sem HT_MQTT_TLS_CA_PEM: conexões com certificado serão recusadas");
+#endif
+#endif
+
+    HT_LOG(main_start, P_INFO, 0, "Iniciando CoreHub...");
     static uint8_t corehub_tasks_started = 0;
 
     /* Loop principal de eventos de rede */
@@ -173,12 +228,12 @@ static void HT_CoreHubTask(void *arg){
     {
         if (xQueueReceive(psEventQueueHandle, &queueItem, portMAX_DELAY))
         {
-            switch(queueItem->messageId)
+            switch(queueItem.messageId)
             {
                 case QMSG_ID_NW_IPV4_READY:
                 case QMSG_ID_NW_IPV6_READY:
                 case QMSG_ID_NW_IPV4_6_READY:
-                    printf("Rede NB-IoT pronta!\n");
+                    HT_LOG(main_nw_ready, P_INFO, 0, "Rede NB-IoT pronta!");
                     
                     appGetImsiNumSync((CHAR *)gImsi);
                     HT_STRING(UNILOG_MQTT, mqttAppTask2, P_SIG, "IMSI = %s", gImsi);
@@ -204,29 +259,32 @@ static void HT_CoreHubTask(void *arg){
                     appGetPSMSettingSync(&psmMode, &tauTime, &activeTime);
                     HT_TRACE(UNILOG_MQTT, mqttAppTask6, P_INFO, 3, "Get PSM info mode=%d, TAU=%d, ActiveTime=%d", psmMode, tauTime, activeTime);
 
+                    /* Janela de rádio para o agendador de uplink */
+                    HT_Uplink_SetRadioTiming(nwEdrxValueMs, psmMode ? activeTime : 0);
+
                     /* Inicia o CoreHub FSM apenas uma vez */
                     if (!corehub_tasks_started) {
-                        printf("=== CoreHub - Iniciando Sistema ===\n");
-                        printf("Rede NB-IoT: OK\n");
-                        printf("IP: %u.%u.%u.%u\n", 
+                        HT_LOG(main_sys_start, P_SIG, 0, "=== CoreHub - Iniciando Sistema ===");
+                        HT_LOG(main_nw_ok, P_INFO, 0, "Rede NB-IoT: OK");
+                        HT_LOG(main_ip, P_INFO, 4, "IP: %u.%u.%u.%u",
                                ((UINT8 *)&gNetworkInfo.body.netInfoRet.netifInfo.ipv4Info.ipv4Addr.addr)[0],
                                ((UINT8 *)&gNetworkInfo.body.netInfoRet.netifInfo.ipv4Info.ipv4Addr.addr)[1],
                                ((UINT8 *)&gNetworkInfo.body.netInfoRet.netifInfo.ipv4Info.ipv4Addr.addr)[2],
                                ((UINT8 *)&gNetworkInfo.body.netInfoRet.netifInfo.ipv4Info.ipv4Addr.addr)[3]);
-                        printf("Cell ID: %lu\n", cellID);
-                        printf("TAC: %u\n", tac);
-                        printf("Iniciando CoreHub com cliente único...\n");
+                        HT_LOG(main_cell, P_INFO, 2, "Cell ID: %u TAC: %u", (unsigned int)cellID, tac);
+                        HT_LOG(main_single_client, P_INFO, 0, "Iniciando CoreHub com cliente único...");
                         
-                        // Inicializa todos os ambientes
-                        for (int i = 0; i < NUM_AMBIENTES; ++i) {
-                            HT_CoreHub_InitAmbiente(i, ambientes[i]);
+                        // Política de reconexão semeada pelo IMSI para espalhar as tentativas da frota
+                        uint32_t seed = 0;
+                        for (int i = 0; i < (int)sizeof(gImsi) && gImsi[i]; ++i) {
+                            seed = (seed * 31) + gImsi[i];
                         }
-                        
+                        HT_MQTT_ReconnInit(seed);
+
                         // Cria uma única task global para todos os ambientes
                         xTaskCreate(HT_CoreHub_MqttTask, "CoreHub_Global", HT_COREHUB_MQTT_TASK_STACK_SIZE, NULL, HT_COREHUB_MQTT_TASK_PRIORITY, NULL);
                         corehub_tasks_started = 1;
-                        printf("CoreHub iniciado com sucesso!\n");
-                        printf("=== Sistema Pronto para Operação ===\n");
+                        HT_LOG(main_started, P_SIG, 0, "=== CoreHub iniciado: Sistema Pronto para Operação ===");
                     }
                     break;
 
@@ -236,7 +294,6 @@ static void HT_CoreHubTask(void *arg){
                 default:
                     break;
             }
-            free(queueItem);
         }
     }
 }
@@ -0,0 +1,409 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file hal_bench.c
+ * \brief Host benchmark of the USART, SPI and I2C HAL transfer modes on the
+ *        register-level simulator (periph_sim.c). The unmodified drivers and
+ *        ISRs run against the models; each mode reports simulated time, ISR
+ *        entries, register accesses and instructions per byte (x86 steps,
+ *        a proxy for Cortex-M3 instructions) and checks the data.
+ *
+ *        Build and run with the Makefile next to this file (x86-64 Linux,
+ *        gcc): make -C Debug/HostSim run
+ *
+ * \author HT Micron Advanced R&D
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "periph_sim.h"
+#include "htnb32lxxx_hal_usart.h"
+#include "htnb32lxxx_hal_spi.h"
+#include "htnb32lxxx_hal_i2c.h"
+
+#define BENCH_BAUDRATE          921600
+#define BENCH_SPI_SPEED         1000000
+#define BENCH_EEPROM_ADDR       0x50
+#define BENCH_DEADLINE_NS       2000000000ULL
+#define BENCH_UART_SIZE         256
+#define BENCH_SPI_SIZE          256
+#define BENCH_I2C_SIZE          64
+#define BENCH_RING_SIZE         128
+
+extern const USART_HandleTypeDef huart0;
+extern const USART_HandleTypeDef huart1;
+extern const USART_HandleTypeDef huart2;
+extern SPI_HandleTypeDef hspi0;
+extern SPI_HandleTypeDef hspi1;
+extern I2C_HandleTypeDef hi2c0;
+extern I2C_HandleTypeDef hi2c1;
+
+#define UART0   ((USART_HandleTypeDef *)&huart0)
+#define UART1   ((USART_HandleTypeDef *)&huart1)
+#define UART2   ((USART_HandleTypeDef *)&huart2)
+
+/* DMA sees 32-bit addresses, keep every buffer static */
+static uint8_t pattern[1024];
+static uint8_t rx_buf[1024];
+static uint8_t line_buf[1024];
+static uint8_t ring[BENCH_RING_SIZE];
+
+static volatile uint32_t uart_event[SIM_USART_NUM];
+static volatile uint32_t spi_event[SIM_SPI_NUM];
+static volatile uint32_t done;
+
+static uint32_t failures = 0;
+
+static void uart0_cb(uint32_t event) { uart_event[0] |= event; }
+static void uart1_cb(uint32_t event) { uart_event[1] |= event; }
+static void uart2_cb(uint32_t event) { uart_event[2] |= event; }
+static void spi0_cb(uint32_t event)  { spi_event[0] |= event; }
+static void spi1_cb(uint32_t event)  { spi_event[1] |= event; }
+static void i2c_cb(uint32_t event)   { (void)event; }
+
+static void tx_done(const uint8_t *pTxBuff, uint32_t size, void *arg) {
+    (void)pTxBuff;
+    (void)size;
+    (void)arg;
+    done++;
+}
+
+static void spi_xfer_done(SPI_TRANSACTION *xfer, void *arg) {
+    (void)xfer;
+    (void)arg;
+    done = 1;
+}
+
+static void i2c_xfer_done(I2C_TRANSACTION *xfer, void *arg) {
+    (void)xfer;
+    (void)arg;
+    done = 1;
+}
+
+static void i2c_sched_done(I2C_TRANSACTION *xfer, void *arg) {
+    (void)xfer;
+    (void)arg;
+    done++;
+}
+
+/* Measurement window ---------------------------------------------------------*/
+
+static SIM_HOST void bench_begin(void) {
+    memset(rx_buf, 0, sizeof(rx_buf));
+    memset(line_buf, 0, sizeof(line_buf));
+    done = 0;
+
+    sim_stats_reset();
+    sim_set_deadline(BENCH_DEADLINE_NS);
+    sim_trace(true);
+}
+
+static SIM_HOST void bench_end(const char *mode, uint32_t bytes, const uint8_t *got) {
+    sim_stats_t st;
+    bool ok;
+
+    sim_trace(false);
+    sim_stats_get(&st);
+    sim_set_deadline(0);
+
+    ok = (memcmp(got, pattern, bytes) == 0);
+    failures += ok ? 0 : 1;
+
+    printf("%-26s %6u %10.1f %7llu %8llu %9.1f %9.1f %7u  %s\n", mode, bytes, st.time_ns / 1000.0,
+           (unsigned long long)st.isr_entries, (unsigned long long)st.accesses,
+           (double)st.insn / bytes, (double)st.isr_insn / bytes, st.overruns, ok ? "ok" : "DATA MISMATCH");
+}
+
+static SIM_HOST void bench_wait_count(volatile const uint32_t *counter, uint32_t target) {
+    while(*counter < target)
+        sim_wfi();
+}
+
+static SIM_HOST void bench_wait_tx(uint32_t instance, uint32_t bytes) {
+    uint32_t n = 0;
+
+    while(n < bytes) {
+        n += sim_usart_sent(instance, line_buf + n, bytes - n);
+
+        if(n < bytes)
+            sim_wfi();
+    }
+}
+
+/* USART ----------------------------------------------------------------------*/
+
+static void uart_setup(USART_HandleTypeDef *huart, ARM_USART_SignalEvent_t cb) {
+    HAL_USART_Initialize(cb, huart);
+    HAL_USART_PowerControl(ARM_POWER_FULL, huart);
+    HAL_USART_Control(ARM_USART_MODE_ASYNCHRONOUS | ARM_USART_DATA_BITS_8 | ARM_USART_PARITY_NONE |
+                      ARM_USART_STOP_BITS_1 | ARM_USART_FLOW_CONTROL_NONE, BENCH_BAUDRATE, huart);
+}
+
+static void bench_uart_polling(void) {
+    bench_begin();
+    HAL_USART_SendPolling(UART0, pattern, BENCH_UART_SIZE);
+    bench_wait_tx(0, BENCH_UART_SIZE);
+    bench_end("usart0 tx polling", BENCH_UART_SIZE, line_buf);
+
+    sim_usart_feed(0, pattern, BENCH_UART_SIZE);
+    bench_begin();
+    HAL_USART_ReceivePolling(UART0, rx_buf, BENCH_UART_SIZE);
+    bench_end("usart0 rx polling", BENCH_UART_SIZE, rx_buf);
+}
+
+static void bench_uart_queue(void) {
+    uint32_t i, chunks = BENCH_UART_SIZE / 32;
+
+    bench_begin();
+
+    for(i = 0; i < chunks; i++) {
+        while(HAL_USART_TransmitQueue_IT(UART1, pattern + i * 32, 32, tx_done, NULL) == ARM_DRIVER_ERROR_BUSY)
+            sim_wfi();
+    }
+
+    bench_wait_count(&done, chunks);
+    bench_wait_tx(1, BENCH_UART_SIZE);
+    bench_end("usart1 tx queue irq", BENCH_UART_SIZE, line_buf);
+}
+
+static void bench_uart_stream(void) {
+    uint32_t n = 0, size = 4 * BENCH_UART_SIZE;
+
+    HAL_USART_RxStreamStart(UART1, ring, sizeof(ring));
+    sim_usart_feed(1, pattern, size);
+
+    bench_begin();
+
+    while(n < size) {
+        n += HAL_USART_RxStreamRead(UART1, rx_buf + n, size - n);
+
+        if(n < size)
+            sim_wfi();
+    }
+
+    bench_end("usart1 rx stream dma", size, rx_buf);
+    HAL_USART_RxStreamStop(UART1);
+}
+
+static void bench_uart_dma(void) {
+    uart_event[2] = 0;
+    bench_begin();
+    HAL_USART_Transmit_DMA(UART2, pattern, BENCH_UART_SIZE);
+    bench_wait_count(&uart_event[2], 1);
+    bench_wait_tx(2, BENCH_UART_SIZE);
+    bench_end("usart2 tx dma", BENCH_UART_SIZE, line_buf);
+
+    // Legacy RX DMA only drains the FIFO on its own for multiples of the burst
+    uart_event[2] = 0;
+    bench_begin();
+    HAL_USART_Receive_DMA(UART2, rx_buf, BENCH_UART_SIZE);
+    sim_usart_feed(2, pattern, BENCH_UART_SIZE);
+    bench_wait_count(&uart_event[2], 1);
+    bench_end("usart2 rx dma", BENCH_UART_SIZE, rx_buf);
+}
+
+/* SPI ------------------------------------------------------------------------*/
+
+static void spi_setup(SPI_HandleTypeDef *hspi, ARM_SPI_SignalEvent_t cb) {
+    HAL_SPI_Initialize(cb, hspi);
+    HAL_SPI_PowerControl(ARM_POWER_FULL, hspi);
+    HAL_SPI_Control(ARM_SPI_MODE_MASTER | ARM_SPI_CPOL0_CPHA0 | ARM_SPI_DATA_BITS(8) | ARM_SPI_MSB_LSB |
+                    ARM_SPI_SS_MASTER_UNUSED, BENCH_SPI_SPEED, hspi);
+}
+
+/* Legacy IT/polling paths count against xfer.num, which nothing else sets */
+static void spi_legacy_arm(SPI_HandleTypeDef *hspi, uint32_t size) {
+    hspi->info->transfer_type = SPI_TRANSMIT_RECEIVE;
+    hspi->info->xfer.num      = size;
+    hspi->info->xfer.tx_cnt   = 0;
+    hspi->info->xfer.rx_cnt   = 0;
+}
+
+static void bench_spi(void) {
+    static SPI_SEGMENT seg[2];
+    static SPI_TRANSACTION xfer;
+
+    spi_event[0] = 0;
+    bench_begin();
+    HAL_SPI_TransmitReceive_DMA(&hspi0, pattern, rx_buf, BENCH_SPI_SIZE);
+    bench_wait_count(&spi_event[0], 1);
+    bench_end("spi0 txrx dma", BENCH_SPI_SIZE, rx_buf);
+
+    seg[0].tx_buf = pattern;
+    seg[0].rx_buf = rx_buf;
+    seg[0].size   = 4;
+    seg[1].tx_buf = pattern + 4;
+    seg[1].rx_buf = rx_buf + 4;
+    seg[1].size   = BENCH_SPI_SIZE - 4;
+
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.seg      = seg;
+    xfer.count    = 2;
+    xfer.cs_port  = -1;
+    xfer.callback = spi_xfer_done;
+
+    bench_begin();
+    HAL_SPI_TransactionSubmit(&hspi0, &xfer);
+    bench_wait_count(&done, 1);
+    bench_end("spi0 transaction queue", BENCH_SPI_SIZE, rx_buf);
+
+    spi_legacy_arm(&hspi1, BENCH_SPI_SIZE);
+    bench_begin();
+    HAL_SPI_TransmitReceive_Polling(&hspi1, pattern, rx_buf, BENCH_SPI_SIZE);
+    bench_end("spi1 txrx polling", BENCH_SPI_SIZE, rx_buf);
+
+    spi_event[1] = 0;
+    spi_legacy_arm(&hspi1, BENCH_SPI_SIZE);
+    bench_begin();
+    HAL_SPI_TransmitReceive_IT(&hspi1, pattern, rx_buf, BENCH_SPI_SIZE);
+    HAL_SPI_EnableIRQ(&hspi1);
+    bench_wait_count(&spi_event[1], 1);
+    bench_end("spi1 txrx irq", BENCH_SPI_SIZE, rx_buf);
+}
+
+/* I2C ------------------------------------------------------------------------*/
+
+static void i2c_setup(I2C_HandleTypeDef *hi2c) {
+    HAL_I2C_Initialize(i2c_cb, hi2c);
+    HAL_I2C_PowerControl(ARM_POWER_FULL, hi2c);
+    HAL_I2C_Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST, hi2c);
+}
+
+static void bench_i2c(void) {
+    static uint8_t frame[BENCH_I2C_SIZE + 1];
+    static uint8_t reg_addr = 0;
+    static I2C_TRANSACTION xfer;
+    static I2C_SCHEDULE sched[2];
+    static uint8_t sched_reg[2];
+    uint8_t *eeprom;
+    uint32_t wait, i;
+    int32_t refused;
+
+    // Polling: write the block behind the word address, then point and read back
+    eeprom = sim_i2c_device(1, BENCH_EEPROM_ADDR);
+    memset(eeprom, 0, SIM_I2C_MEM_SIZE);
+    frame[0] = 0;
+    memcpy(frame + 1, pattern, BENCH_I2C_SIZE);
+
+    bench_begin();
+    HAL_I2C_MasterTransmit_Polling(&hi2c1, BENCH_EEPROM_ADDR, frame, BENCH_I2C_SIZE + 1);
+    bench_end("i2c1 write polling", BENCH_I2C_SIZE, eeprom);
+
+    bench_begin();
+    HAL_I2C_MasterTransmit_Polling(&hi2c1, BENCH_EEPROM_ADDR, &reg_addr, 1);
+    HAL_I2C_MasterReceive_Polling(&hi2c1, BENCH_EEPROM_ADDR, rx_buf, BENCH_I2C_SIZE);
+    bench_end("i2c1 read polling", BENCH_I2C_SIZE, rx_buf);
+
+    // Queue: one write transaction, one register read with repeated START
+    eeprom = sim_i2c_device(0, BENCH_EEPROM_ADDR);
+    memset(eeprom, 0, SIM_I2C_MEM_SIZE);
+
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.addr     = BENCH_EEPROM_ADDR;
+    xfer.wr_buf   = frame;
+    xfer.wr_len   = BENCH_I2C_SIZE + 1;
+    xfer.callback = i2c_xfer_done;
+
+    bench_begin();
+    HAL_I2C_TransactionSubmit(&hi2c0, &xfer);
+    bench_wait_count(&done, 1);
+    bench_end("i2c0 write queue", BENCH_I2C_SIZE, eeprom);
+
+    xfer.wr_buf = &reg_addr;
+    xfer.wr_len = 1;
+    xfer.rd_buf = rx_buf;
+    xfer.rd_len = BENCH_I2C_SIZE;
+
+    bench_begin();
+    HAL_I2C_TransactionSubmit(&hi2c0, &xfer);
+    bench_wait_count(&done, 1);
+    bench_end("i2c0 register read queue", BENCH_I2C_SIZE, rx_buf);
+
+    // Schedule: the second read is due within its slack, both go out in one batch
+    memset(sched, 0, sizeof(sched));
+    for(i = 0; i < 2; i++) {
+        sched_reg[i]           = (uint8_t)(i * BENCH_I2C_SIZE / 2);
+        sched[i].xfer.addr     = BENCH_EEPROM_ADDR;
+        sched[i].xfer.wr_buf   = &sched_reg[i];
+        sched[i].xfer.wr_len   = 1;
+        sched[i].xfer.rd_buf   = rx_buf + sched_reg[i];
+        sched[i].xfer.rd_len   = BENCH_I2C_SIZE / 2;
+        sched[i].xfer.callback = i2c_sched_done;
+        sched[i].period        = 100;
+        sched[i].slack         = 50;
+        HAL_I2C_ScheduleAdd(&hi2c0, &sched[i], i * 30);
+    }
+
+    bench_begin();
+    wait = HAL_I2C_ScheduleRun(&hi2c0, 0);
+    refused = HAL_I2C_MasterTransmit_Polling(&hi2c0, BENCH_EEPROM_ADDR, &reg_addr, 1);
+    bench_wait_count(&done, 2);
+    bench_end("i2c0 schedule batch", BENCH_I2C_SIZE, rx_buf);
+
+    // The queue owns the controller until it drains, the next run is one period on
+    if((wait != 100) || (refused != ARM_DRIVER_ERROR_BUSY) || sched[0].overruns || sched[1].overruns) {
+        printf("  schedule: wait %u, polling %d, overruns %u/%u\n", wait, (int)refused,
+               sched[0].overruns, sched[1].overruns);
+        failures++;
+    }
+
+    HAL_I2C_ScheduleRemove(&hi2c0, &sched[0]);
+    HAL_I2C_ScheduleRemove(&hi2c0, &sched[1]);
+}
+
+int main(void) {
+    uint32_t i;
+
+    for(i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 7 + (i >> 8) + 1);
+
+    sim_init();
+
+    uart_setup(UART0, uart0_cb);
+    uart_setup(UART1, uart1_cb);
+    uart_setup(UART2, uart2_cb);
+    spi_setup(&hspi0, spi0_cb);
+    spi_setup(&hspi1, spi1_cb);
+    i2c_setup(&hi2c0);
+    i2c_setup(&hi2c1);
+
+    printf("USART %u baud, SPI %u Hz, I2C fast mode; insn = traced x86 instructions, ISRs included\n\n",
+           BENCH_BAUDRATE, BENCH_SPI_SPEED);
+    printf("%-26s %6s %10s %7s %8s %9s %9s %7s\n", "mode", "bytes", "time_us", "isr", "reg_acc",
+           "insn/B", "isr_in/B", "ovr");
+
+    bench_uart_polling();
+    bench_uart_queue();
+    bench_uart_stream();
+    bench_uart_dma();
+    bench_spi();
+    bench_i2c();
+
+    return failures ? 1 : 0;
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
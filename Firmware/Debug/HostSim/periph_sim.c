@@ -0,0 +1,1357 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/* sim_cmsis.h is force-included first, so _GNU_SOURCE comes from the command line */
+#ifndef _GNU_SOURCE
+#error "periph_sim.c needs -D_GNU_SOURCE (ucontext register names)"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#include "periph_sim.h"
+#include "htnb32lxxx_hal_usart.h"
+
+/* Defines  ------------------------------------------------------------------*/
+
+#define SIM_PAGE_SIZE           4096UL
+#define SIM_ALTSTACK_SIZE       (256UL * 1024UL)
+#define SIM_EXC_NS              120U                 /**</ Exception entry plus return, ~12 cycles. */
+#define SIM_NEVER               UINT64_MAX
+#define SIM_EFL_TF              0x100UL
+#define SIM_USART_SENT_SIZE     8192U
+#define SIM_USART_CTI_CHARS     4U                   /**</ Idle character times before the RX timeout. */
+#define SIM_SPI_RT_BITS         32U                  /**</ Idle bit times before the RX timeout. */
+#define SIM_I2C_HOLD_BYTES      4U                   /**</ Bus hold without STOP before the controller releases it. */
+
+#define SIM_FIFO_MAX            32U
+
+/* Typedefs  ------------------------------------------------------------------*/
+
+typedef struct {
+    uint16_t data[SIM_FIFO_MAX];
+    uint32_t head;
+    uint32_t cnt;
+    uint32_t size;
+} sim_fifo_t;
+
+typedef struct {
+    uint32_t ier, lcr, mcr, fcr, scr, mfcr, efcr, lpdr, adcr, dll, dlh;
+    sim_fifo_t tx;
+    sim_fifo_t rx;
+    bool overrun;
+    bool tfe_armed;                                  /**</ THRE style TX interrupt, re-armed when the FIFO drains to the trigger level. */
+    bool shifting;
+    uint8_t shift;
+    uint64_t shift_end;
+    uint64_t rx_last;                                /**</ Last character arrival or RBR read, for the character timeout. */
+    const uint8_t *feed;
+    uint32_t feed_len;
+    uint32_t feed_pos;
+    uint64_t feed_next;
+    uint8_t sent[SIM_USART_SENT_SIZE];
+    uint32_t sent_head;
+    uint32_t sent_cnt;
+} sim_usart_t;
+
+typedef struct {
+    uint32_t cr0, cr1, cpsr, imsc, dmacr;
+    uint32_t latched;                                /**</ RT and ROR raw bits, cleared through ICR. */
+    sim_fifo_t tx;
+    sim_fifo_t rx;
+    bool shifting;
+    uint16_t shift;
+    uint64_t shift_end;
+    uint64_t rx_last;
+} sim_spi_t;
+
+typedef enum {
+    SIM_I2C_IDLE = 0,
+    SIM_I2C_ADDR,
+    SIM_I2C_DATA,
+    SIM_I2C_HOLD
+} sim_i2c_state_t;
+
+typedef struct {
+    uint32_t mcr, scr, sar, tpr, tor, ier, imr;
+    uint32_t isr;                                    /**</ Latched events, W1C. */
+    sim_fifo_t tx;
+    sim_fifo_t rx;
+    sim_i2c_state_t state;
+    bool rd;
+    bool stop;
+    uint8_t addr;
+    uint32_t num;
+    uint32_t done;
+    bool byte_active;
+    uint8_t byte;
+    uint64_t byte_end;
+    uint64_t hold_end;
+    bool present;
+    uint8_t dev_addr;
+    bool ptr_set;
+    uint8_t ptr;
+    uint8_t mem[SIM_I2C_MEM_SIZE];
+} sim_i2c_t;
+
+/* Globals  ------------------------------------------------------------------*/
+
+volatile uint32_t sim_primask = 0;
+volatile uint32_t sim_ipsr = 0;
+
+extern char __start_sim_host[];
+extern char __stop_sim_host[];
+
+void sim_irq_trampoline(void);
+void sim_irq_dispatch(void);
+
+static struct {
+    bool ready;
+    bool trace;
+    uint64_t now;
+    uint64_t t0;
+    uint64_t deadline;
+    uint64_t progress;                               /**</ Bumped on every FIFO move, DMA beat and line event. */
+    uint64_t storm_progress;
+    uint32_t storm_cnt;
+    uintptr_t last_rip;
+    uintptr_t acc_addr;                              /**</ Register word being stepped, 0 when none. */
+    uint32_t acc_prefill;
+    bool acc_write;
+    sim_stats_t st;
+    void (*vector[SIM_IRQ_NUM])(void);
+    bool enabled[SIM_IRQ_NUM];
+} sim;
+
+static sim_usart_t sim_usart[SIM_USART_NUM];
+static sim_spi_t sim_spi[SIM_SPI_NUM];
+static sim_i2c_t sim_i2c[SIM_I2C_NUM];
+static sim_dma_chan_t sim_dma[SIM_DMA_CHANNELS];
+
+static uint8_t sim_altstack[SIM_ALTSTACK_SIZE] __attribute__((aligned(16)));
+
+/* Interrupt trampoline -------------------------------------------------------*/
+
+/*
+ * Entered in place of the interrupted instruction with the return address
+ * pushed below the red zone. Saves the caller-saved integer registers, the
+ * flags and the full extended state (glibc string functions use AVX), runs
+ * the dispatcher and returns dropping the red zone gap.
+ */
+__asm__(
+    ".pushsection sim_host,\"ax\",@progbits\n"
+    ".globl sim_irq_trampoline\n"
+    ".type sim_irq_trampoline,@function\n"
+    "sim_irq_trampoline:\n"
+    "    pushfq\n"
+    "    push %rax\n"
+    "    push %rcx\n"
+    "    push %rdx\n"
+    "    push %rsi\n"
+    "    push %rdi\n"
+    "    push %r8\n"
+    "    push %r9\n"
+    "    push %r10\n"
+    "    push %r11\n"
+    "    push %rbp\n"
+    "    mov %rsp, %rbp\n"
+    "    and $-64, %rsp\n"
+    "    sub $16384, %rsp\n"
+    "    xor %eax, %eax\n"
+    "    mov %rax, 512(%rsp)\n"
+    "    mov %rax, 520(%rsp)\n"
+    "    mov %rax, 528(%rsp)\n"
+    "    mov %rax, 536(%rsp)\n"
+    "    mov %rax, 544(%rsp)\n"
+    "    mov %rax, 552(%rsp)\n"
+    "    mov %rax, 560(%rsp)\n"
+    "    mov %rax, 568(%rsp)\n"
+    "    mov $-1, %eax\n"
+    "    mov $-1, %edx\n"
+    "    xsave (%rsp)\n"
+    "    cld\n"
+    "    call sim_irq_dispatch\n"
+    "    mov $-1, %eax\n"
+    "    mov $-1, %edx\n"
+    "    xrstor (%rsp)\n"
+    "    mov %rbp, %rsp\n"
+    "    pop %rbp\n"
+    "    pop %r11\n"
+    "    pop %r10\n"
+    "    pop %r9\n"
+    "    pop %r8\n"
+    "    pop %rdi\n"
+    "    pop %rsi\n"
+    "    pop %rdx\n"
+    "    pop %rcx\n"
+    "    pop %rax\n"
+    "    popfq\n"
+    "    ret $128\n"
+    ".size sim_irq_trampoline, .-sim_irq_trampoline\n"
+    ".popsection\n");
+
+/* Helpers  ------------------------------------------------------------------*/
+
+static SIM_HOST void sim_die(const char *what) {
+    fflush(stdout);
+    fprintf(stderr, "periph_sim: %s at t=%llu ns, last pc %p, ipsr %u, primask %u\n", what,
+            (unsigned long long)sim.now, (void *)sim.last_rip, sim_ipsr, sim_primask);
+    _exit(2);
+}
+
+static SIM_HOST bool sim_in_host(uintptr_t pc) {
+    return (pc >= (uintptr_t)__start_sim_host) && (pc < (uintptr_t)__stop_sim_host);
+}
+
+static SIM_HOST void sim_fifo_init(sim_fifo_t *f, uint32_t size) {
+    f->head = 0;
+    f->cnt  = 0;
+    f->size = size;
+}
+
+static SIM_HOST bool sim_fifo_push(sim_fifo_t *f, uint16_t value) {
+    if(f->cnt == f->size)
+        return false;
+
+    f->data[(f->head + f->cnt) % f->size] = value;
+    f->cnt++;
+    sim.progress++;
+
+    return true;
+}
+
+static SIM_HOST uint16_t sim_fifo_pop(sim_fifo_t *f) {
+    uint16_t value;
+
+    if(f->cnt == 0)
+        return 0;
+
+    value = f->data[f->head];
+    f->head = (f->head + 1) % f->size;
+    f->cnt--;
+    sim.progress++;
+
+    return value;
+}
+
+static SIM_HOST uint16_t sim_fifo_peek(const sim_fifo_t *f) {
+    return f->cnt ? f->data[f->head] : 0;
+}
+
+static SIM_HOST uint64_t sim_min(uint64_t a, uint64_t b) {
+    return (a < b) ? a : b;
+}
+
+/* USART model ----------------------------------------------------------------*/
+
+static SIM_HOST uint64_t sim_usart_char_ns(const sim_usart_t *u) {
+    uint64_t clk = (uint64_t)SIM_PERIPH_CLOCK_HZ << ((u->mfcr & USART_MFCR_PRESCALE_FACTOR_Msk) >> USART_MFCR_PRESCALE_FACTOR_Pos);
+    uint64_t div = (((u->dlh << 8) | u->dll) << 4) | ((u->efcr & USART_EFCR_FRAC_DIVISOR_Msk) >> USART_EFCR_FRAC_DIVISOR_Pos);
+    uint64_t bits = 1 + 5 + ((u->lcr & USART_LCR_CHAR_LEN_Msk) >> USART_LCR_CHAR_LEN_Pos) +
+                    ((u->lcr & USART_LCR_PARITY_EN_Msk) ? 1 : 0) + ((u->lcr & USART_LCR_STOP_BIT_NUM_Msk) ? 2 : 1);
+
+    if(div == 0)
+        div = 16;
+
+    return (bits * 1000000000ULL * div + clk - 1) / clk;
+}
+
+static SIM_HOST uint32_t sim_usart_rx_trigger(const sim_usart_t *u) {
+    static const uint8_t level[4] = {1, 8, 16, 30};
+    return level[(u->fcr & USART_FCR_RX_FIFO_AVAIL_TRIG_LEVEL_Msk) >> USART_FCR_RX_FIFO_AVAIL_TRIG_LEVEL_Pos];
+}
+
+static SIM_HOST uint32_t sim_usart_tx_trigger(const sim_usart_t *u) {
+    static const uint8_t level[4] = {0, 2, 8, 16};
+    return level[(u->fcr & USART_FCR_TX_FIFO_EMPTY_TRIG_LEVEL_Msk) >> USART_FCR_TX_FIFO_EMPTY_TRIG_LEVEL_Pos];
+}
+
+static SIM_HOST bool sim_usart_cti(const sim_usart_t *u) {
+    return (u->rx.cnt > 0) && (sim.now >= u->rx_last + SIM_USART_CTI_CHARS * sim_usart_char_ns(u));
+}
+
+static SIM_HOST uint32_t sim_usart_int_id(const sim_usart_t *u) {
+    if(u->overrun && (u->ier & USART_IER_RX_LINE_STATUS_Msk))
+        return USART_RLS_INT;
+
+    if((u->rx.cnt >= sim_usart_rx_trigger(u)) && (u->ier & USART_IER_RX_DATA_REQ_Msk))
+        return USART_RDA_INT;
+
+    if((u->ier & USART_IER_RX_TIMEOUT_Msk) && sim_usart_cti(u))
+        return USART_CTI_INT;
+
+    if(u->tfe_armed && (u->tx.cnt <= sim_usart_tx_trigger(u)) && (u->ier & USART_IER_TX_DATA_REQ_Msk))
+        return USART_TFE_INT;
+
+    return 0;
+}
+
+static SIM_HOST void sim_usart_rx_push(sim_usart_t *u, uint8_t data, uint64_t when) {
+    if(!sim_fifo_push(&u->rx, data)) {
+        u->overrun = true;
+        sim.st.overruns++;
+    }
+
+    u->rx_last = when;
+}
+
+static SIM_HOST void sim_usart_tick(sim_usart_t *u) {
+    uint64_t t, char_ns = sim_usart_char_ns(u);
+
+    // Shifter, each character starts when the previous one ends
+    for(;;) {
+        if(u->shifting) {
+            if(u->shift_end > sim.now)
+                break;
+
+            t = u->shift_end;
+            u->shifting = false;
+
+            if(u->mcr & USART_MCR_LOOPBACK_MODE_Msk) {
+                sim_usart_rx_push(u, u->shift, t);
+            } else {
+                u->sent[(u->sent_head + u->sent_cnt) % SIM_USART_SENT_SIZE] = u->shift;
+
+                if(u->sent_cnt < SIM_USART_SENT_SIZE)
+                    u->sent_cnt++;
+                else
+                    u->sent_head = (u->sent_head + 1) % SIM_USART_SENT_SIZE;
+            }
+        } else {
+            t = sim.now;
+        }
+
+        if((u->tx.cnt == 0) || !(u->mfcr & USART_MFCR_UART_EN_Msk))
+            break;
+
+        u->shift     = (uint8_t)sim_fifo_pop(&u->tx);
+        u->shifting  = true;
+        u->shift_end = t + char_ns;
+
+        if(u->tx.cnt <= sim_usart_tx_trigger(u))
+            u->tfe_armed = true;
+    }
+
+    // Line stimulus
+    while(u->feed && (u->feed_pos < u->feed_len) && (u->feed_next <= sim.now)) {
+        if(u->mfcr & USART_MFCR_UART_EN_Msk)
+            sim_usart_rx_push(u, u->feed[u->feed_pos], u->feed_next);
+
+        u->feed_pos++;
+        u->feed_next += char_ns;
+    }
+}
+
+static SIM_HOST uint64_t sim_usart_next(const sim_usart_t *u) {
+    uint64_t next = SIM_NEVER, cti;
+
+    if(u->shifting)
+        next = u->shift_end;
+
+    if(u->feed && (u->feed_pos < u->feed_len))
+        next = sim_min(next, u->feed_next);
+
+    if((u->rx.cnt > 0) && (u->ier & USART_IER_RX_TIMEOUT_Msk)) {
+        cti = u->rx_last + SIM_USART_CTI_CHARS * sim_usart_char_ns(u);
+
+        if(cti > sim.now)
+            next = sim_min(next, cti);
+    }
+
+    return next;
+}
+
+static SIM_HOST uint32_t sim_usart_read(sim_usart_t *u, uint32_t offset, bool consume) {
+    bool dlab = (u->lcr & USART_LCR_ACCESS_DIVISOR_LATCH_Msk) != 0;
+    uint32_t value;
+
+    switch(offset) {
+        case 0x00:
+            if(dlab)
+                return u->dll;
+
+            if(!consume)
+                return sim_fifo_peek(&u->rx);
+
+            u->rx_last = sim.now;
+            return sim_fifo_pop(&u->rx);
+
+        case 0x04:
+            return dlab ? u->dlh : u->ier;
+
+        case 0x08:
+            value = sim_usart_int_id(u);
+
+            // Reading the TX empty identification clears it, like a 16550 THRE
+            if(consume && (value == USART_TFE_INT))
+                u->tfe_armed = false;
+
+            return value ? value : USART_IIR_INT_PENDING_Msk;
+
+        case 0x0C: return u->lcr;
+        case 0x10: return u->mcr;
+
+        case 0x14:
+            value = ((u->rx.cnt > 0) ? USART_LSR_RX_DATA_READY_Msk : 0) |
+                    (u->overrun ? USART_LSR_RX_OVERRUN_ERROR_Msk : 0) |
+                    ((u->tx.cnt < u->tx.size) ? USART_LSR_TX_DATA_REQ_Msk : 0) |
+                    (((u->tx.cnt == 0) && !u->shifting) ? USART_LSR_TX_EMPTY_Msk : 0);
+
+            if(consume)
+                u->overrun = false;
+
+            return value;
+
+        case 0x18: return 0;
+        case 0x1C: return u->scr;
+        case 0x20: return u->mfcr;
+        case 0x24: return u->efcr;
+        case 0x28: return u->lpdr;
+        case 0x2C: return (u->tx.cnt << USART_FCNR_TX_FIFO_NUM_Pos) | (u->rx.cnt << USART_FCNR_RX_FIFO_NUM_Pos);
+        case 0x30: return u->adcr;
+        default:   return 0;
+    }
+}
+
+static SIM_HOST void sim_usart_write(sim_usart_t *u, uint32_t offset, uint32_t value) {
+    bool dlab = (u->lcr & USART_LCR_ACCESS_DIVISOR_LATCH_Msk) != 0;
+
+    switch(offset) {
+        case 0x00:
+            if(dlab) {
+                u->dll = value & 0xFF;
+            } else {
+                sim_fifo_push(&u->tx, value & 0xFF);
+                u->tfe_armed = false;
+            }
+            break;
+
+        case 0x04:
+            if(dlab) {
+                u->dlh = value & 0xFF;
+            } else {
+                // Enabling the TX interrupt with the FIFO already drained raises it at once
+                if(!(u->ier & USART_IER_TX_DATA_REQ_Msk) && (value & USART_IER_TX_DATA_REQ_Msk))
+                    u->tfe_armed = true;
+
+                u->ier = value;
+            }
+            break;
+
+        case 0x08:
+            if(value & USART_FCR_RESET_RX_FIFO_Msk)
+                u->rx.cnt = 0;
+
+            if(value & USART_FCR_RESET_TX_FIFO_Msk)
+                u->tx.cnt = 0;
+
+            u->fcr = value & ~(USART_FCR_RESET_RX_FIFO_Msk | USART_FCR_RESET_TX_FIFO_Msk);
+            break;
+
+        case 0x0C: u->lcr  = value; break;
+        case 0x10: u->mcr  = value; break;
+        case 0x1C: u->scr  = value; break;
+        case 0x20: u->mfcr = value; break;
+        case 0x24: u->efcr = value; break;
+        case 0x28: u->lpdr = value; break;
+        case 0x30: u->adcr = value; break;
+        default:   break;
+    }
+}
+
+static SIM_HOST bool sim_usart_line(const sim_usart_t *u) {
+    return sim_usart_int_id(u) != 0;
+}
+
+/* SPI model ------------------------------------------------------------------*/
+
+static SIM_HOST uint64_t sim_spi_bit_ns(const sim_spi_t *s) {
+    uint64_t div = (s->cpsr ? s->cpsr : 2) * ((((s->cr0 & SPI_CR0_SCR_Msk) >> SPI_CR0_SCR_Pos)) + 1);
+
+    return (1000000000ULL * div + SIM_PERIPH_CLOCK_HZ - 1) / SIM_PERIPH_CLOCK_HZ;
+}
+
+static SIM_HOST uint32_t sim_spi_bits(const sim_spi_t *s) {
+    return ((s->cr0 & SPI_CR0_DSS_Msk) >> SPI_CR0_DSS_Pos) + 1;
+}
+
+static SIM_HOST uint32_t sim_spi_ris(const sim_spi_t *s) {
+    return s->latched |
+           ((s->rx.cnt >= SIM_SPI_FIFO_SIZE / 2) ? SPI_RIS_RXRIS_Msk : 0) |
+           ((s->tx.cnt <= SIM_SPI_FIFO_SIZE / 2) ? SPI_RIS_TXRIS_Msk : 0);
+}
+
+static SIM_HOST void sim_spi_tick(sim_spi_t *s) {
+    uint64_t t, bit_ns = sim_spi_bit_ns(s);
+    uint32_t mask = (1UL << sim_spi_bits(s)) - 1;
+
+    for(;;) {
+        if(s->shifting) {
+            if(s->shift_end > sim.now)
+                break;
+
+            t = s->shift_end;
+            s->shifting = false;
+
+            // MISO is wired to MOSI
+            if(!sim_fifo_push(&s->rx, s->shift & mask)) {
+                s->latched |= SPI_RIS_RORRIS_Msk;
+                sim.st.overruns++;
+            }
+
+            s->rx_last = t;
+        } else {
+            t = sim.now;
+        }
+
+        if((s->tx.cnt == 0) || !(s->cr1 & SPI_CR1_SSE_Msk))
+            break;
+
+        s->shift     = sim_fifo_pop(&s->tx);
+        s->shifting  = true;
+        s->shift_end = t + sim_spi_bits(s) * bit_ns;
+    }
+
+    if((s->rx.cnt > 0) && !(s->latched & SPI_RIS_RTRIS_Msk) && (sim.now >= s->rx_last + SIM_SPI_RT_BITS * bit_ns)) {
+        s->latched |= SPI_RIS_RTRIS_Msk;
+        sim.progress++;
+    }
+}
+
+static SIM_HOST uint64_t sim_spi_next(const sim_spi_t *s) {
+    uint64_t next = SIM_NEVER, rt;
+
+    if(s->shifting)
+        next = s->shift_end;
+
+    if((s->rx.cnt > 0) && !(s->latched & SPI_RIS_RTRIS_Msk)) {
+        rt = s->rx_last + SIM_SPI_RT_BITS * sim_spi_bit_ns(s);
+
+        if(rt > sim.now)
+            next = sim_min(next, rt);
+    }
+
+    return next;
+}
+
+static SIM_HOST uint32_t sim_spi_read(sim_spi_t *s, uint32_t offset, bool consume) {
+    switch(offset) {
+        case 0x00: return s->cr0;
+        case 0x04: return s->cr1;
+
+        case 0x08:
+            if(!consume)
+                return sim_fifo_peek(&s->rx);
+
+            s->rx_last = sim.now;
+            return sim_fifo_pop(&s->rx);
+
+        case 0x0C:
+            return ((s->tx.cnt == 0) ? SPI_SR_TFE_Msk : 0) |
+                   ((s->tx.cnt < s->tx.size) ? SPI_SR_TNF_Msk : 0) |
+                   ((s->rx.cnt > 0) ? SPI_SR_RNE_Msk : 0) |
+                   ((s->rx.cnt == s->rx.size) ? SPI_SR_RFF_Msk : 0) |
+                   ((s->shifting || (s->tx.cnt > 0)) ? SPI_SR_BSY_Msk : 0);
+
+        case 0x10: return s->cpsr;
+        case 0x14: return s->imsc;
+        case 0x18: return sim_spi_ris(s);
+        case 0x1C: return sim_spi_ris(s) & s->imsc;
+        case 0x24: return s->dmacr;
+        default:   return 0;
+    }
+}
+
+static SIM_HOST void sim_spi_write(sim_spi_t *s, uint32_t offset, uint32_t value) {
+    switch(offset) {
+        case 0x00: s->cr0 = value; break;
+        case 0x04: s->cr1 = value; break;
+        case 0x08: sim_fifo_push(&s->tx, value & 0xFFFF); break;
+        case 0x10: s->cpsr = value & 0xFF; break;
+        case 0x14: s->imsc = value & 0xF; break;
+
+        case 0x20:
+            s->latched &= ~(value & (SPI_ICR_RORIC_Msk | SPI_ICR_RTIC_Msk));
+            break;
+
+        case 0x24: s->dmacr = value & SPI_DMACR_BITMASK; break;
+        default:   break;
+    }
+}
+
+static SIM_HOST bool sim_spi_line(const sim_spi_t *s) {
+    return (sim_spi_ris(s) & s->imsc) != 0;
+}
+
+/* I2C model ------------------------------------------------------------------*/
+
+static SIM_HOST uint64_t sim_i2c_byte_ns(const sim_i2c_t *c) {
+    uint64_t cycles = ((c->tpr & I2C_TPR_SCLH_Msk) >> I2C_TPR_SCLH_Pos) + ((c->tpr & I2C_TPR_SCLL_Msk) >> I2C_TPR_SCLL_Pos);
+
+    if(cycles == 0)
+        cycles = SIM_PERIPH_CLOCK_HZ / 100000;
+
+    // 8 data bits plus ACK
+    return (9 * cycles * 1000000000ULL + SIM_PERIPH_CLOCK_HZ - 1) / SIM_PERIPH_CLOCK_HZ;
+}
+
+static SIM_HOST uint32_t sim_i2c_isr(const sim_i2c_t *c) {
+    return c->isr |
+           ((c->tx.cnt == 0) ? I2C_ISR_TX_FIFO_EMPTY_Msk : 0) |
+           ((c->rx.cnt == c->rx.size) ? I2C_ISR_RX_FIFO_FULL_Msk : 0);
+}
+
+static SIM_HOST void sim_i2c_release(sim_i2c_t *c) {
+    c->isr  |= I2C_ISR_DETECT_STOP_Msk;
+    c->state = SIM_I2C_IDLE;
+    sim.progress++;
+}
+
+static SIM_HOST void sim_i2c_command(sim_i2c_t *c, uint32_t value) {
+    if(value & I2C_SCR_FLUSH_TX_FIFO_Msk)
+        c->tx.cnt = 0;
+
+    if(value & I2C_SCR_FLUSH_RX_FIFO_Msk)
+        c->rx.cnt = 0;
+
+    if(value & (I2C_SCR_START_Msk | I2C_SCR_RESTART_Msk)) {
+        c->addr  = (value & I2C_SCR_TARGET_SLAVE_ADDR_Msk) >> 1;
+        c->rd    = (value & I2C_SCR_TARGET_RWN_Msk) != 0;
+        c->stop  = (value & I2C_SCR_STOP_Msk) != 0;
+        c->num   = ((value & I2C_SCR_BYTE_NUM_Msk) >> I2C_SCR_BYTE_NUM_Pos) + 1;
+        c->done  = 0;
+        c->state = SIM_I2C_ADDR;
+
+        // Address byte on the wire first
+        c->byte_active = true;
+        c->byte_end    = sim.now + sim_i2c_byte_ns(c);
+
+        if(!c->rd)
+            c->ptr_set = false;
+    } else if((value & I2C_SCR_STOP_Msk) && (c->state == SIM_I2C_HOLD)) {
+        sim_i2c_release(c);
+    }
+
+    c->scr = value & ~(I2C_SCR_START_Msk | I2C_SCR_RESTART_Msk | I2C_SCR_STOP_Msk |
+                       I2C_SCR_FLUSH_TX_FIFO_Msk | I2C_SCR_FLUSH_RX_FIFO_Msk);
+}
+
+static SIM_HOST void sim_i2c_tick(sim_i2c_t *c) {
+    uint64_t t = sim.now;
+
+    for(;;) {
+        if(!c->byte_active) {
+            if((c->state == SIM_I2C_HOLD) && (c->hold_end <= sim.now)) {
+                sim_i2c_release(c);
+                break;
+            }
+
+            if(c->state != SIM_I2C_DATA)
+                break;
+
+            // Write stretches on an empty TX FIFO, read stalls on a full RX FIFO
+            if(!c->rd) {
+                if(c->tx.cnt == 0)
+                    break;
+
+                c->byte = (uint8_t)sim_fifo_pop(&c->tx);
+            } else if(c->rx.cnt == c->rx.size) {
+                break;
+            }
+
+            c->byte_active = true;
+            c->byte_end    = t + sim_i2c_byte_ns(c);
+        }
+
+        if(c->byte_end > sim.now)
+            break;
+
+        t = c->byte_end;
+        c->byte_active = false;
+
+        if(c->state == SIM_I2C_ADDR) {
+            if(!c->present || (c->addr != c->dev_addr)) {
+                c->isr |= I2C_ISR_RX_NACK_Msk;
+                sim_i2c_release(c);
+                break;
+            }
+
+            c->state = SIM_I2C_DATA;
+            continue;
+        }
+
+        if(c->rd) {
+            sim_fifo_push(&c->rx, c->mem[c->ptr++]);
+        } else if(!c->ptr_set) {
+            c->ptr     = c->byte;
+            c->ptr_set = true;
+            sim.progress++;
+        } else {
+            c->mem[c->ptr++] = c->byte;
+            sim.progress++;
+        }
+
+        if(++c->done == c->num) {
+            c->isr |= I2C_ISR_TRANSFER_DONE_Msk;
+
+            if(c->stop) {
+                sim_i2c_release(c);
+            } else {
+                c->state    = SIM_I2C_HOLD;
+                c->hold_end = t + SIM_I2C_HOLD_BYTES * sim_i2c_byte_ns(c);
+            }
+            break;
+        }
+    }
+}
+
+static SIM_HOST uint64_t sim_i2c_next(const sim_i2c_t *c) {
+    if(c->byte_active)
+        return c->byte_end;
+
+    if(c->state == SIM_I2C_HOLD)
+        return c->hold_end;
+
+    return SIM_NEVER;
+}
+
+static SIM_HOST uint32_t sim_i2c_read(sim_i2c_t *c, uint32_t offset, bool consume) {
+    switch(offset) {
+        case 0x00: return c->mcr;
+        case 0x04: return c->scr;
+        case 0x08: return c->sar;
+        case 0x0C: return c->tpr;
+        case 0x10: return consume ? sim_fifo_pop(&c->rx) : sim_fifo_peek(&c->rx);
+        case 0x14: return c->tor;
+        case 0x18: return sim_i2c_isr(c);
+        case 0x1C: return c->ier;
+        case 0x20: return c->imr;
+        case 0x24: return (c->state != SIM_I2C_IDLE) ? I2C_STR_BUSY_Msk : 0;
+
+        case 0x28:
+            return ((c->tx.size - c->tx.cnt) << I2C_FSR_TX_FIFO_FREE_NUM_Pos) |
+                   (c->rx.cnt << I2C_FSR_RX_FIFO_DATA_NUM_Pos);
+
+        default:   return 0;
+    }
+}
+
+static SIM_HOST void sim_i2c_write(sim_i2c_t *c, uint32_t offset, uint32_t value) {
+    switch(offset) {
+        case 0x00: c->mcr = value; break;
+        case 0x04: sim_i2c_command(c, value); break;
+        case 0x08: c->sar = value; break;
+        case 0x0C: c->tpr = value; break;
+        case 0x10: sim_fifo_push(&c->tx, value & 0xFF); break;
+        case 0x14: c->tor = value; break;
+        case 0x18: c->isr &= ~value; break;
+        case 0x1C: c->ier = value; break;
+        case 0x20: c->imr = value; break;
+        default:   break;
+    }
+}
+
+static SIM_HOST bool sim_i2c_line(const sim_i2c_t *c) {
+    return (sim_i2c_isr(c) & c->ier) != 0;
+}
+
+/* Register decode ------------------------------------------------------------*/
+
+static SIM_HOST bool sim_periph_read(uint32_t addr, bool consume, uint32_t *value) {
+    uint32_t offset = addr & 0xFFFF;
+
+    switch(addr & ~0xFFFFUL) {
+        case USART0_BASE_ADDR: *value = sim_usart_read(&sim_usart[0], offset, consume); return true;
+        case USART1_BASE_ADDR: *value = sim_usart_read(&sim_usart[1], offset, consume); return true;
+        case USART2_BASE_ADDR: *value = sim_usart_read(&sim_usart[2], offset, consume); return true;
+        case SPI0_BASE_ADDR:   *value = sim_spi_read(&sim_spi[0], offset, consume);     return true;
+        case SPI1_BASE_ADDR:   *value = sim_spi_read(&sim_spi[1], offset, consume);     return true;
+        case I2C0_BASE_ADDR:   *value = sim_i2c_read(&sim_i2c[0], offset, consume);     return true;
+        case I2C1_BASE_ADDR:   *value = sim_i2c_read(&sim_i2c[1], offset, consume);     return true;
+        default:               return false;
+    }
+}
+
+static SIM_HOST void sim_periph_write(uint32_t addr, uint32_t value) {
+    uint32_t offset = addr & 0xFFFF;
+
+    switch(addr & ~0xFFFFUL) {
+        case USART0_BASE_ADDR: sim_usart_write(&sim_usart[0], offset, value); break;
+        case USART1_BASE_ADDR: sim_usart_write(&sim_usart[1], offset, value); break;
+        case USART2_BASE_ADDR: sim_usart_write(&sim_usart[2], offset, value); break;
+        case SPI0_BASE_ADDR:   sim_spi_write(&sim_spi[0], offset, value);     break;
+        case SPI1_BASE_ADDR:   sim_spi_write(&sim_spi[1], offset, value);     break;
+        case I2C0_BASE_ADDR:   sim_i2c_write(&sim_i2c[0], offset, value);     break;
+        case I2C1_BASE_ADDR:   sim_i2c_write(&sim_i2c[1], offset, value);     break;
+        default:               break;
+    }
+}
+
+static SIM_HOST bool sim_is_periph(uint32_t addr) {
+    return (addr >= APB_PERIPH_BASE) && (addr < APB_PERIPH_BASE + SIM_APB_SIZE);
+}
+
+/* DMA model ------------------------------------------------------------------*/
+
+/* Elements the peripheral behind a request line accepts (TX) or offers (RX) now */
+static SIM_HOST uint32_t sim_dma_request_level(int16_t request) {
+    const sim_usart_t *u;
+    const sim_spi_t *s;
+
+    if((request >= DMA_RequestUSART0TX) && (request <= DMA_RequestUSART2RX)) {
+        u = &sim_usart[(request - DMA_RequestUSART0TX) / 2];
+
+        if(!(u->mfcr & USART_MFCR_DMA_EN_Msk))
+            return 0;
+
+        if((request - DMA_RequestUSART0TX) & 1)
+            return (u->rx.cnt >= SIM_USART_DMA_LEVEL) ? u->rx.cnt : 0;
+
+        return ((u->tx.size - u->tx.cnt) >= SIM_USART_DMA_LEVEL) ? (u->tx.size - u->tx.cnt) : 0;
+    }
+
+    if((request >= DMA_RequestSPI0TX) && (request <= DMA_RequestSPI1RX)) {
+        s = &sim_spi[(request - DMA_RequestSPI0TX) / 2];
+
+        if((request - DMA_RequestSPI0TX) & 1)
+            return ((s->dmacr & SPI_DMACR_RXDMAE_Msk) && (s->rx.cnt >= SIM_SPI_FIFO_SIZE / 2)) ? s->rx.cnt : 0;
+
+        return ((s->dmacr & SPI_DMACR_TXDMAE_Msk) && (s->tx.cnt <= SIM_SPI_FIFO_SIZE / 2)) ? (s->tx.size - s->tx.cnt) : 0;
+    }
+
+    return 0;
+}
+
+static SIM_HOST uint32_t sim_dma_load_word(uint32_t addr, uint32_t width) {
+    uint32_t value = 0;
+
+    if(sim_is_periph(addr)) {
+        sim_periph_read(addr & ~3UL, true, &value);
+        return value;
+    }
+
+    switch(width) {
+        case 1:  return *(volatile uint8_t *)(uintptr_t)addr;
+        case 2:  return *(volatile uint16_t *)(uintptr_t)addr;
+        default: return *(volatile uint32_t *)(uintptr_t)addr;
+    }
+}
+
+static SIM_HOST void sim_dma_store_word(uint32_t addr, uint32_t width, uint32_t value) {
+    if(sim_is_periph(addr)) {
+        sim_periph_write(addr & ~3UL, value);
+        return;
+    }
+
+    switch(width) {
+        case 1:  *(volatile uint8_t *)(uintptr_t)addr  = (uint8_t)value;  break;
+        case 2:  *(volatile uint16_t *)(uintptr_t)addr = (uint16_t)value; break;
+        default: *(volatile uint32_t *)(uintptr_t)addr = value;           break;
+    }
+}
+
+static SIM_HOST void sim_dma_descriptor_end(sim_dma_chan_t *ch) {
+    if(ch->cmdr & SIM_DMA_CMDR_END_IRQ)
+        ch->pending |= (1UL << DMA_EVENT_END);
+
+    if(ch->dar & SIM_DMA_DAR_STOP)
+        ch->running = 0;
+    else
+        sim_dma_load(ch, ch->dar);
+
+    sim.progress++;
+}
+
+/* One burst per channel, or as much of it as the request line allows */
+static SIM_HOST void sim_dma_run(void) {
+    sim_dma_chan_t *ch;
+    uint32_t i, width, elems, n, value;
+    bool flow;
+
+    for(i = 0; i < SIM_DMA_CHANNELS; i++) {
+        ch = &sim_dma[i];
+
+        if(!ch->open || !ch->running)
+            continue;
+
+        if(ch->count >= ch->len) {
+            sim_dma_descriptor_end(ch);
+            continue;
+        }
+
+        width = (ch->cmdr & SIM_DMA_CMDR_WIDTH_Msk) >> SIM_DMA_CMDR_WIDTH_Pos;
+        width = (width == 0) ? 1 : (1UL << (width - 1));
+        flow  = (ch->cmdr & (SIM_DMA_CMDR_FLOW_SRC | SIM_DMA_CMDR_FLOW_TRG)) != 0;
+
+        elems = (4UL << ((ch->cmdr & SIM_DMA_CMDR_BURST_Msk) >> SIM_DMA_CMDR_BURST_Pos)) / width;
+        elems = (elems < (ch->len - ch->count) / width) ? elems : (ch->len - ch->count) / width;
+
+        if(flow) {
+            n = sim_dma_request_level(ch->request);
+
+            if(n < elems)
+                elems = n;
+        }
+
+        for(n = 0; n < elems; n++) {
+            value = sim_dma_load_word(ch->sar, width);
+            sim_dma_store_word(ch->tar, width, value);
+
+            if(ch->cmdr & SIM_DMA_CMDR_INC_SRC)
+                ch->sar += width;
+
+            if(ch->cmdr & SIM_DMA_CMDR_INC_TRG)
+                ch->tar += width;
+
+            ch->count += width;
+            sim.st.dma_bytes += width;
+            sim.progress++;
+        }
+
+        if(ch->count >= ch->len)
+            sim_dma_descriptor_end(ch);
+    }
+}
+
+static SIM_HOST uint64_t sim_dma_next(void) {
+    uint32_t i;
+
+    // Memory to memory moves one burst per APB access time
+    for(i = 0; i < SIM_DMA_CHANNELS; i++) {
+        if(sim_dma[i].open && sim_dma[i].running && (sim_dma[i].request < 0))
+            return sim.now + SIM_ACCESS_NS;
+    }
+
+    return SIM_NEVER;
+}
+
+static SIM_HOST bool sim_dma_line(void) {
+    uint32_t i;
+
+    for(i = 0; i < SIM_DMA_CHANNELS; i++) {
+        if(sim_dma[i].open && sim_dma[i].pending && sim_dma[i].callback)
+            return true;
+    }
+
+    return false;
+}
+
+/* PDMA interrupt, hands the latched channel events to the driver callbacks */
+static SIM_HOST void sim_dma_irq(void) {
+    uint32_t i, event, pending;
+
+    for(i = 0; i < SIM_DMA_CHANNELS; i++) {
+        pending = sim_dma[i].pending;
+        sim_dma[i].pending = 0;
+
+        for(event = DMA_EVENT_ERROR; event <= DMA_EVENT_STOP; event++) {
+            if((pending & (1UL << event)) && sim_dma[i].callback)
+                sim_dma[i].callback(event);
+        }
+    }
+}
+
+/* Scheduler ------------------------------------------------------------------*/
+
+static SIM_HOST void sim_tick(void) {
+    uint32_t i, pass;
+
+    // Second pass lets a shifter start on data the DMA just delivered
+    for(pass = 0; pass < 2; pass++) {
+        for(i = 0; i < SIM_USART_NUM; i++)
+            sim_usart_tick(&sim_usart[i]);
+
+        for(i = 0; i < SIM_SPI_NUM; i++)
+            sim_spi_tick(&sim_spi[i]);
+
+        for(i = 0; i < SIM_I2C_NUM; i++)
+            sim_i2c_tick(&sim_i2c[i]);
+
+        if(pass == 0)
+            sim_dma_run();
+    }
+}
+
+static SIM_HOST uint64_t sim_next_event(void) {
+    uint64_t next = sim_dma_next();
+    uint32_t i;
+
+    for(i = 0; i < SIM_USART_NUM; i++)
+        next = sim_min(next, sim_usart_next(&sim_usart[i]));
+
+    for(i = 0; i < SIM_SPI_NUM; i++)
+        next = sim_min(next, sim_spi_next(&sim_spi[i]));
+
+    for(i = 0; i < SIM_I2C_NUM; i++)
+        next = sim_min(next, sim_i2c_next(&sim_i2c[i]));
+
+    return next;
+}
+
+static SIM_HOST void sim_advance(uint64_t ns) {
+    uint64_t target = sim.now + ns, next;
+
+    do {
+        next = sim_next_event();
+
+        if(next <= sim.now)
+            next = sim.now + 1;
+
+        sim.now = sim_min(next, target);
+        sim_tick();
+    } while(sim.now < target);
+
+    if(sim.deadline && (sim.now > sim.deadline))
+        sim_die("deadline passed, driver stuck waiting");
+}
+
+static SIM_HOST bool sim_irq_line(uint32_t irq) {
+    switch(irq) {
+        case PXIC_Uart0_IRQn: return sim_usart_line(&sim_usart[0]);
+        case PXIC_Uart1_IRQn: return sim_usart_line(&sim_usart[1]);
+        case PXIC_Uart2_IRQn: return sim_usart_line(&sim_usart[2]);
+        case PXIC_Spi0_IRQn:  return sim_spi_line(&sim_spi[0]);
+        case PXIC_Spi1_IRQn:  return sim_spi_line(&sim_spi[1]);
+        case PXIC_I2c0_IRQn:  return sim_i2c_line(&sim_i2c[0]);
+        case PXIC_I2c1_IRQn:  return sim_i2c_line(&sim_i2c[1]);
+        case PXIC_Pdma_IRQn:  return sim_dma_line();
+        default:              return false;
+    }
+}
+
+/* Lowest enabled line with a handler wins, there is no preemption */
+static SIM_HOST int32_t sim_irq_next(void) {
+    uint32_t irq;
+
+    for(irq = 0; irq < SIM_IRQ_NUM; irq++) {
+        if(sim.enabled[irq] && sim.vector[irq] && sim_irq_line(irq))
+            return (int32_t)irq;
+    }
+
+    return -1;
+}
+
+SIM_HOST void sim_irq_dispatch(void) {
+    int32_t irq;
+
+    while((sim_primask == 0) && (sim_ipsr == 0) && ((irq = sim_irq_next()) >= 0)) {
+        if(sim.progress == sim.storm_progress) {
+            if(++sim.storm_cnt >= SIM_STORM_LIMIT) {
+                fprintf(stderr, "periph_sim: IRQ %d keeps firing with no device progress\n", irq);
+                sim_die("interrupt storm");
+            }
+        } else {
+            sim.storm_progress = sim.progress;
+            sim.storm_cnt = 0;
+        }
+
+        sim.st.isr_entries++;
+        sim.st.irq_entries[irq]++;
+        sim_advance(SIM_EXC_NS);
+
+        sim_ipsr = 16 + irq;
+        sim.vector[irq]();
+        sim_ipsr = 0;
+    }
+}
+
+SIM_HOST void sim_irq_unmasked(void) {
+    if(sim.ready && (sim_ipsr == 0))
+        sim_irq_dispatch();
+}
+
+static SIM_HOST void sim_tf(bool on) {
+    if(on)
+        __asm__ volatile("pushfq; orq $0x100, (%%rsp); popfq" ::: "memory", "cc");
+    else
+        __asm__ volatile("pushfq; andq $~0x100, (%%rsp); popfq" ::: "memory", "cc");
+}
+
+SIM_HOST void sim_wfi(void) {
+    bool traced = sim.trace;
+    uint64_t next;
+
+    if(traced)
+        sim_tf(false);
+
+    // Wakes on the next device event even without an interrupt, callers loop on their condition
+    if(sim_irq_next() < 0) {
+        next = sim_next_event();
+
+        if(next == SIM_NEVER)
+            sim_die("WFI with no interrupt or device event pending");
+
+        sim_advance((next > sim.now) ? (next - sim.now) : 1);
+    }
+
+    if(traced)
+        sim_tf(true);
+
+    // A pending line wakes the core even with PRIMASK set, it is taken on unmask
+    if(sim_ipsr == 0)
+        sim_irq_dispatch();
+}
+
+/* Trap handlers --------------------------------------------------------------*/
+
+static SIM_HOST void sim_segv(int sig, siginfo_t *si, void *context) {
+    ucontext_t *uc = (ucontext_t *)context;
+    uintptr_t addr = (uintptr_t)si->si_addr;
+    uint32_t value;
+
+    (void)sig;
+
+    if(!sim_is_periph((uint32_t)addr) || (addr >> 32) || sim.acc_addr) {
+        fprintf(stderr, "periph_sim: fault at %p, pc %p\n", (void *)addr, (void *)uc->uc_mcontext.gregs[REG_RIP]);
+        signal(SIGSEGV, SIG_DFL);
+        return;
+    }
+
+    addr &= ~3UL;
+    sim.acc_write = (uc->uc_mcontext.gregs[REG_ERR] & 2) != 0;
+
+    // Stores get the current value too, read-modify-write instructions load it first
+    if(!sim_periph_read((uint32_t)addr, !sim.acc_write, &value)) {
+        mprotect((void *)(addr & ~(SIM_PAGE_SIZE - 1)), SIM_PAGE_SIZE, PROT_READ | PROT_WRITE);
+        value = *(uint32_t *)addr;
+    }
+
+    mprotect((void *)(addr & ~(SIM_PAGE_SIZE - 1)), SIM_PAGE_SIZE, PROT_READ | PROT_WRITE);
+    *(uint32_t *)addr = value;
+
+    sim.acc_addr    = addr;
+    sim.acc_prefill = value;
+    sim.st.accesses++;
+
+    uc->uc_mcontext.gregs[REG_EFL] |= SIM_EFL_TF;
+}
+
+static SIM_HOST void sim_trap(int sig, siginfo_t *si, void *context) {
+    ucontext_t *uc = (ucontext_t *)context;
+    greg_t *gregs = uc->uc_mcontext.gregs;
+    uintptr_t pc = (uintptr_t)gregs[REG_RIP];
+    uint32_t value;
+
+    (void)sig;
+    (void)si;
+
+    if(sim.acc_addr) {
+        value = *(uint32_t *)sim.acc_addr;
+
+        if(sim.acc_write || (value != sim.acc_prefill))
+            sim_periph_write((uint32_t)sim.acc_addr, value);
+
+        mprotect((void *)(sim.acc_addr & ~(SIM_PAGE_SIZE - 1)), SIM_PAGE_SIZE, PROT_NONE);
+        sim.acc_addr = 0;
+        sim_advance(SIM_ACCESS_NS);
+    }
+
+    if(sim.trace) {
+        if(sim.last_rip && !sim_in_host(sim.last_rip)) {
+            sim.st.insn++;
+
+            if(sim_ipsr)
+                sim.st.isr_insn++;
+
+            sim_advance(SIM_INSN_NS);
+        }
+    } else {
+        gregs[REG_EFL] &= ~SIM_EFL_TF;
+    }
+
+    sim.last_rip = pc;
+
+    // Interrupt entry between two instructions of normal (thread) code
+    if(!sim_in_host(pc) && (sim_primask == 0) && (sim_ipsr == 0) && (sim_irq_next() >= 0)) {
+        gregs[REG_RSP] -= 136;
+        *(uint64_t *)gregs[REG_RSP] = pc;
+        gregs[REG_RIP] = (greg_t)(uintptr_t)sim_irq_trampoline;
+        sim.last_rip = 0;
+    }
+}
+
+/* Functions ------------------------------------------------------------------*/
+
+SIM_HOST void sim_init(void) {
+    struct sigaction sa;
+    stack_t ss;
+    uint32_t i;
+    void *window;
+
+    window = mmap((void *)(uintptr_t)APB_PERIPH_BASE, SIM_APB_SIZE, PROT_NONE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if(window != (void *)(uintptr_t)APB_PERIPH_BASE) {
+        fprintf(stderr, "periph_sim: cannot map the APB window at 0x%08x\n", APB_PERIPH_BASE);
+        exit(1);
+    }
+
+    // The interrupt frame is pushed below the red zone of the interrupted stack
+    ss.ss_sp    = sim_altstack;
+    ss.ss_size  = sizeof(sim_altstack);
+    ss.ss_flags = 0;
+    sigaltstack(&ss, NULL);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    sigaddset(&sa.sa_mask, SIGSEGV);
+    sigaddset(&sa.sa_mask, SIGTRAP);
+
+    sa.sa_sigaction = sim_segv;
+    sigaction(SIGSEGV, &sa, NULL);
+    sa.sa_sigaction = sim_trap;
+    sigaction(SIGTRAP, &sa, NULL);
+
+    memset(&sim, 0, sizeof(sim));
+    memset(sim_usart, 0, sizeof(sim_usart));
+    memset(sim_spi, 0, sizeof(sim_spi));
+    memset(sim_i2c, 0, sizeof(sim_i2c));
+    memset(sim_dma, 0, sizeof(sim_dma));
+
+    for(i = 0; i < SIM_USART_NUM; i++) {
+        sim_fifo_init(&sim_usart[i].tx, SIM_USART_FIFO_SIZE);
+        sim_fifo_init(&sim_usart[i].rx, SIM_USART_FIFO_SIZE);
+        sim_usart[i].dll = 1;
+    }
+
+    for(i = 0; i < SIM_SPI_NUM; i++) {
+        sim_fifo_init(&sim_spi[i].tx, SIM_SPI_FIFO_SIZE);
+        sim_fifo_init(&sim_spi[i].rx, SIM_SPI_FIFO_SIZE);
+    }
+
+    for(i = 0; i < SIM_I2C_NUM; i++) {
+        sim_fifo_init(&sim_i2c[i].tx, SIM_I2C_FIFO_SIZE);
+        sim_fifo_init(&sim_i2c[i].rx, SIM_I2C_FIFO_SIZE);
+    }
+
+    for(i = 0; i < SIM_DMA_CHANNELS; i++)
+        sim_dma[i].request = DMA_MemoryToMemory;
+
+    sim.vector[PXIC_Pdma_IRQn]  = sim_dma_irq;
+    sim.enabled[PXIC_Pdma_IRQn] = true;
+
+    sim_primask = 0;
+    sim_ipsr    = 0;
+    sim.ready   = true;
+}
+
+SIM_HOST void sim_trace(bool on) {
+    sim.trace    = on;
+    sim.last_rip = 0;
+
+    if(on)
+        sim_tf(true);
+}
+
+SIM_HOST void sim_stats_reset(void) {
+    memset(&sim.st, 0, sizeof(sim.st));
+    sim.t0 = sim.now;
+}
+
+SIM_HOST void sim_stats_get(sim_stats_t *stats) {
+    *stats = sim.st;
+    stats->time_ns = sim.now - sim.t0;
+}
+
+SIM_HOST uint64_t sim_now(void) {
+    return sim.now;
+}
+
+SIM_HOST void sim_set_deadline(uint64_t ns) {
+    sim.deadline = ns ? (sim.now + ns) : 0;
+}
+
+SIM_HOST void sim_wait(volatile const uint32_t *flag) {
+    while(*flag == 0)
+        sim_wfi();
+}
+
+SIM_HOST void sim_usart_feed(uint32_t instance, const uint8_t *data, uint32_t size) {
+    sim_usart_t *u = &sim_usart[instance];
+
+    u->feed      = data;
+    u->feed_len  = size;
+    u->feed_pos  = 0;
+    u->feed_next = sim.now + sim_usart_char_ns(u);
+}
+
+SIM_HOST uint32_t sim_usart_sent(uint32_t instance, uint8_t *data, uint32_t size) {
+    sim_usart_t *u = &sim_usart[instance];
+    uint32_t n = 0;
+
+    while((n < size) && u->sent_cnt) {
+        if(data)
+            data[n] = u->sent[u->sent_head];
+
+        u->sent_head = (u->sent_head + 1) % SIM_USART_SENT_SIZE;
+        u->sent_cnt--;
+        n++;
+    }
+
+    return n;
+}
+
+SIM_HOST uint8_t *sim_i2c_device(uint32_t instance, uint8_t addr) {
+    sim_i2c[instance].present  = true;
+    sim_i2c[instance].dev_addr = addr;
+
+    return sim_i2c[instance].mem;
+}
+
+SIM_HOST void sim_xic_set_vector(uint32_t irq, void (*vector)(void)) {
+    if(irq < SIM_IRQ_NUM)
+        sim.vector[irq] = vector;
+}
+
+SIM_HOST void sim_xic_enable(uint32_t irq, bool enable) {
+    if(irq < SIM_IRQ_NUM)
+        sim.enabled[irq] = enable;
+}
+
+SIM_HOST sim_dma_chan_t *sim_dma_chan(uint32_t channel) {
+    return &sim_dma[channel % SIM_DMA_CHANNELS];
+}
+
+SIM_HOST void sim_dma_load(sim_dma_chan_t *ch, uint32_t descriptor) {
+    const dma_descriptor_t *desc = (const dma_descriptor_t *)(uintptr_t)(descriptor & ~SIM_DMA_DAR_STOP);
+
+    ch->dar   = desc->DAR;
+    ch->sar   = desc->SAR;
+    ch->tar   = desc->TAR;
+    ch->cmdr  = desc->CMDR;
+    ch->len   = desc->CMDR & SIM_DMA_CMDR_LEN_Msk;
+    ch->count = 0;
+
+    if(ch->cmdr & SIM_DMA_CMDR_START_IRQ)
+        ch->pending |= (1UL << DMA_EVENT_START);
+}
+
+SIM_HOST void sim_dma_kick(void) {
+    sim_tick();
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
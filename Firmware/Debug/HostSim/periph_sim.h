@@ -0,0 +1,248 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file periph_sim.h
+ * \brief Register-level host simulator of the qcx212 USART, SPI, I2C and DMA
+ *        blocks (x86-64 Linux). The APB window is mapped with no access at
+ *        its real address, every driver load/store traps and is served by a
+ *        FIFO/timing model, and pending interrupts are injected between
+ *        instructions so the unmodified HAL drivers and ISRs run on the host.
+ *
+ *        Time only advances on register accesses, traced instructions and
+ *        sim_wfi(). Interrupts are level-sensitive with a single priority
+ *        (no nesting). Code in the SIM_HOST section stands for hardware or
+ *        ROM library code: it is never counted and never interrupted.
+ *
+ * \author HT Micron Advanced R&D
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#ifndef __PERIPH_SIM_H__
+#define __PERIPH_SIM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "qcx212.h"
+#include "dma_qcx212.h"
+
+/* Defines  ------------------------------------------------------------------*/
+
+#define SIM_HOST                __attribute__((section("sim_host"), noinline))
+
+#define SIM_APB_SIZE            0x200000U    /**</ Mapped part of the APB window, covers I2C/SPI/USART/GPIO/PAD. */
+#define SIM_IRQ_NUM             64U          /**</ XIC lines, same numbering as IRQn_Type. */
+#define SIM_DMA_CHANNELS        16U
+#define SIM_ACCESS_NS           50U          /**</ APB access cost. */
+#define SIM_INSN_NS             10U          /**</ Traced instruction cost, ~100 MHz core. */
+#define SIM_STORM_LIMIT         10000U       /**</ ISR entries in a row with no model progress before aborting. */
+
+#define SIM_USART_NUM           3U
+#define SIM_USART_FIFO_SIZE     32U
+#define SIM_USART_DMA_LEVEL     8U           /**</ RX DMA request level and TX DMA free space, UART_DMA_BURST_SIZE. */
+#define SIM_SPI_NUM             2U
+#define SIM_SPI_FIFO_SIZE       8U
+#define SIM_I2C_NUM             2U
+#define SIM_I2C_FIFO_SIZE       16U
+#define SIM_I2C_MEM_SIZE        256U
+
+#define SIM_PERIPH_CLOCK_HZ     26000000U    /**</ Functional clock returned by GPR_GetClockFreq. */
+
+/* Typedefs  ------------------------------------------------------------------*/
+
+/* Run counters, reset with sim_stats_reset() */
+typedef struct {
+    uint64_t time_ns;                         /**</ Simulated time. */
+    uint64_t accesses;                        /**</ Trapped register loads/stores. */
+    uint64_t insn;                            /**</ Traced instructions outside SIM_HOST, ISRs included. */
+    uint64_t isr_insn;                        /**</ Part of insn executed in interrupt context. */
+    uint64_t isr_entries;                     /**</ Interrupt entries, all lines. */
+    uint64_t irq_entries[SIM_IRQ_NUM];        /**</ Interrupt entries per line. */
+    uint64_t dma_bytes;                       /**</ Bytes moved by the DMA model. */
+    uint32_t overruns;                        /**</ RX FIFO overruns, all models. */
+} sim_stats_t;
+
+/* DMA channel as kept by the model, also driven by the DMA_xxx API (sim_platform.c) */
+typedef struct {
+    uint8_t        open;
+    uint8_t        running;
+    int16_t        request;                   /**</ dma_request_source_t, -1 for memory to memory. */
+    dma_callback_t callback;
+    uint32_t       dar;                       /**</ Next descriptor address, bit 0 stops the fetch. */
+    uint32_t       sar;                       /**</ Current source address. */
+    uint32_t       tar;                       /**</ Current target address. */
+    uint32_t       cmdr;                      /**</ Command word of the running descriptor. */
+    uint32_t       len;                       /**</ Bytes of the running descriptor. */
+    uint32_t       count;                     /**</ Bytes done in the running descriptor. */
+    uint32_t       pending;                   /**</ DMA_EVENT_xxx bit mask waiting for the PDMA interrupt. */
+} sim_dma_chan_t;
+
+/* Command word layout of the simulated controller */
+#define SIM_DMA_CMDR_INC_SRC    (1UL << 31)
+#define SIM_DMA_CMDR_INC_TRG    (1UL << 30)
+#define SIM_DMA_CMDR_FLOW_SRC   (1UL << 29)
+#define SIM_DMA_CMDR_FLOW_TRG   (1UL << 28)
+#define SIM_DMA_CMDR_START_IRQ  DMA_StartInterruptEnable
+#define SIM_DMA_CMDR_END_IRQ    DMA_EndInterruptEnable
+#define SIM_DMA_CMDR_BURST_Pos  16
+#define SIM_DMA_CMDR_BURST_Msk  (0x7UL << SIM_DMA_CMDR_BURST_Pos)
+#define SIM_DMA_CMDR_WIDTH_Pos  14
+#define SIM_DMA_CMDR_WIDTH_Msk  (0x3UL << SIM_DMA_CMDR_WIDTH_Pos)
+#define SIM_DMA_CMDR_LEN_Msk    0x1FFFUL
+#define SIM_DMA_DAR_STOP        (1UL << 0)
+
+/* Functions ------------------------------------------------------------------*/
+
+/*!******************************************************************
+ * \fn void sim_init(void)
+ * \brief Maps the APB window, installs the trap handlers on an
+ *        alternate stack and resets every model. Exits on failure.
+ *
+ * \param[in]  none
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+void sim_init(void);
+
+/*!******************************************************************
+ * \fn void sim_trace(bool on)
+ * \brief Starts/stops single-stepping of the caller, which is what
+ *        counts instructions. Time also advances per traced instruction.
+ *
+ * \param[in]  bool on                   Trace the following code.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+void sim_trace(bool on);
+
+/*!******************************************************************
+ * \fn void sim_stats_reset(void)
+ * \brief Clears the run counters, time keeps running.
+ *
+ * \param[in]  none
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+void sim_stats_reset(void);
+
+/*!******************************************************************
+ * \fn void sim_stats_get(sim_stats_t *stats)
+ * \brief Copies the run counters, time is relative to the last reset.
+ *
+ * \param[in]  none
+ * \param[out] sim_stats_t *stats        Counters.
+ *
+ * \retval none.
+ *******************************************************************/
+void sim_stats_get(sim_stats_t *stats);
+
+/*!******************************************************************
+ * \fn uint64_t sim_now(void)
+ * \brief Simulated time since sim_init.
+ *
+ * \param[in]  none
+ * \param[out] none
+ *
+ * \retval Time in ns.
+ *******************************************************************/
+uint64_t sim_now(void);
+
+/*!******************************************************************
+ * \fn void sim_set_deadline(uint64_t ns)
+ * \brief Aborts with the stuck instruction address if the simulated
+ *        time passes now + ns (0 disables). Catches driver busy-waits
+ *        on a status that never comes.
+ *
+ * \param[in]  uint64_t ns               Budget from now.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+void sim_set_deadline(uint64_t ns);
+
+/*!******************************************************************
+ * \fn void sim_wait(volatile const uint32_t *flag)
+ * \brief Sleeps (sim_wfi) until *flag becomes non-zero, the idle loop
+ *        itself is not counted.
+ *
+ * \param[in]  volatile const uint32_t *flag    Set by a driver callback.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+void sim_wait(volatile const uint32_t *flag);
+
+/*!******************************************************************
+ * \fn void sim_usart_feed(uint32_t instance, const uint8_t *data, uint32_t size)
+ * \brief Queues bytes on the RX line of a USART, received back to back
+ *        at the programmed baud rate. The buffer must stay valid.
+ *
+ * \param[in]  uint32_t instance         USART0..2.
+ * \param[in]  const uint8_t *data       Line data.
+ * \param[in]  uint32_t size             Bytes.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+void sim_usart_feed(uint32_t instance, const uint8_t *data, uint32_t size);
+
+/*!******************************************************************
+ * \fn uint32_t sim_usart_sent(uint32_t instance, uint8_t *data, uint32_t size)
+ * \brief Drains the bytes shifted out on the TX line since the last call.
+ *
+ * \param[in]  uint32_t instance         USART0..2.
+ * \param[in]  uint32_t size             Room in data.
+ * \param[out] uint8_t *data             Line data, may be NULL to drop.
+ *
+ * \retval Bytes returned (or dropped).
+ *******************************************************************/
+uint32_t sim_usart_sent(uint32_t instance, uint8_t *data, uint32_t size);
+
+/*!******************************************************************
+ * \fn uint8_t *sim_i2c_device(uint32_t instance, uint8_t addr)
+ * \brief Attaches a 256 byte EEPROM-like target (first written byte is
+ *        the word address, auto-increment) to an I2C bus.
+ *
+ * \param[in]  uint32_t instance         I2C0..1.
+ * \param[in]  uint8_t addr              7-bit address.
+ * \param[out] none
+ *
+ * \retval Target memory, SIM_I2C_MEM_SIZE bytes.
+ *******************************************************************/
+uint8_t *sim_i2c_device(uint32_t instance, uint8_t addr);
+
+/* Hooks for sim_platform.c */
+void sim_xic_set_vector(uint32_t irq, void (*vector)(void));
+void sim_xic_enable(uint32_t irq, bool enable);
+sim_dma_chan_t *sim_dma_chan(uint32_t channel);
+void sim_dma_load(sim_dma_chan_t *ch, uint32_t descriptor);
+void sim_dma_kick(void);
+
+#endif /* __PERIPH_SIM_H__ */
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -0,0 +1,46 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file FreeRTOS.h
+ * \brief Host stand-in for the FreeRTOS headers of the series test
+ *        (series_test.c): a millisecond tick the test advances by hand.
+ *
+ * \author HT Micron Advanced R&D
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#ifndef __SERIES_SIM_FREERTOS_H__
+#define __SERIES_SIM_FREERTOS_H__
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+
+extern TickType_t series_sim_tick;
+
+#endif /* __SERIES_SIM_FREERTOS_H__ */
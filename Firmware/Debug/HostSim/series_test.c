@@ -0,0 +1,426 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file series_test.c
+ * \brief Host round trip of the Core_Hub time series (HT_CoreHub_Series.c)
+ *        on a littlefs model: appends across segment rollovers and a wrap
+ *        of the raw ring, replay in HT_Series_Init() after a reboot, the
+ *        loss of what was not committed on a reset, the join of aggregate
+ *        buckets split by HT_Series_Flush(), and queries back.
+ *
+ *        The model keeps a committed and a pending copy per file: writes
+ *        become visible to readers on close, as in littlefs, and a reset
+ *        drops the pending copy.
+ *
+ *        Build and run with the Makefile next to this file (x86-64 Linux,
+ *        gcc): make -C Debug/HostSim run
+ *
+ * \author HT Micron Advanced R&D
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+/* The statics are reset on a simulated reboot, so the unit is built in */
+#include "HT_CoreHub_Series.c"
+
+#define TEST_FILES              (HT_SERIES_RAW_SEGMENTS + HT_SERIES_1MIN_SEGMENTS + HT_SERIES_15MIN_SEGMENTS)
+#define TEST_RECORDS            48000
+#define TEST_START_SECS         1700000040u             /* Minute aligned. */
+#define TEST_STEP_MS            1000
+
+TickType_t series_sim_tick = 0;
+uint32_t series_sim_secs = TEST_START_SECS;
+
+/* littlefs model -------------------------------------------------------------*/
+
+typedef struct {
+    char name[HT_SERIES_NAME_LEN];
+    uint8_t data[HT_SERIES_SEGMENT_SIZE];               /* Committed. */
+    uint8_t pending[HT_SERIES_SEGMENT_SIZE];            /* Open for writing, visible on close. */
+    uint32_t size;
+    uint32_t pending_size;
+} TestFile;
+
+static TestFile test_fs[TEST_FILES];
+static uint32_t test_fs_files = 0;
+static uint32_t test_fs_overflows = 0;
+
+static int test_fs_find(const char *path, int create) {
+    for (uint32_t i = 0; i < test_fs_files; i++) {
+        if (strcmp(test_fs[i].name, path) == 0) {
+            return (int)i;
+        }
+    }
+    if (!create || test_fs_files == TEST_FILES) {
+        return -1;
+    }
+
+    snprintf(test_fs[test_fs_files].name, HT_SERIES_NAME_LEN, "%s", path);
+    test_fs[test_fs_files].size = 0;
+
+    return (int)test_fs_files++;
+}
+
+int LFS_FileOpen(lfs_file_t *file, const char *path, int flags) {
+    int i = test_fs_find(path, flags & LFS_O_CREAT);
+    TestFile *f;
+
+    if (i < 0) {
+        return LFS_ERR_NOENT;
+    }
+    f = &test_fs[i];
+
+    file->id = (uint16_t)i;
+    file->flags = (uint32_t)flags;
+    file->pos = 0;
+    if (flags & LFS_O_WRONLY) {
+        memcpy(f->pending, f->data, f->size);
+        f->pending_size = (flags & LFS_O_TRUNC) ? 0 : f->size;
+        file->pos = f->pending_size;
+    }
+
+    return 0;
+}
+
+lfs_ssize_t LFS_FileRead(lfs_file_t *file, void *buffer, lfs_size_t size) {
+    TestFile *f = &test_fs[file->id];
+    lfs_size_t n = f->size - file->pos;
+
+    if (n > size) {
+        n = size;
+    }
+    memcpy(buffer, f->data + file->pos, n);
+    file->pos += n;
+
+    return (lfs_ssize_t)n;
+}
+
+lfs_ssize_t LFS_FileWrite(lfs_file_t *file, const void *buffer, lfs_size_t size) {
+    TestFile *f = &test_fs[file->id];
+
+    /* A segment is one block, the series never writes past it */
+    if (file->pos + size > HT_SERIES_SEGMENT_SIZE) {
+        test_fs_overflows++;
+        return LFS_ERR_NOSPC;
+    }
+    memcpy(f->pending + file->pos, buffer, size);
+    file->pos += size;
+    f->pending_size = file->pos;
+
+    return (lfs_ssize_t)size;
+}
+
+int LFS_FileClose(lfs_file_t *file) {
+    TestFile *f = &test_fs[file->id];
+
+    if (file->flags & LFS_O_WRONLY) {
+        memcpy(f->data, f->pending, f->pending_size);
+        f->size = f->pending_size;
+    }
+
+    return 0;
+}
+
+int LFS_Stat(const char *path, struct lfs_info *info) {
+    int i = test_fs_find(path, 0);
+
+    if (i < 0) {
+        return LFS_ERR_NOENT;
+    }
+    info->type = LFS_TYPE_REG;
+    info->size = test_fs[i].size;
+
+    return 0;
+}
+
+/* Reference ------------------------------------------------------------------*/
+
+typedef struct {
+    uint32_t time;
+    uint8_t ambiente;
+    uint8_t channel;
+    int16_t value;
+} TestRecord;
+
+static TestRecord records[TEST_RECORDS];
+static uint32_t record_count = 0;
+static HT_SeriesPoint got[TEST_RECORDS];
+static uint32_t got_count = 0;
+static HT_SeriesTierState tier_boot[HT_SERIES_TIERS];
+static uint32_t failures = 0;
+
+static void test_append(int ambiente, HT_SeriesChannel channel, int16_t value) {
+    HT_Series_Append(ambiente, channel, value);
+
+    records[record_count].time = series_sim_secs;
+    records[record_count].ambiente = (uint8_t)ambiente;
+    records[record_count].channel = (uint8_t)channel;
+    records[record_count].value = value;
+    record_count++;
+}
+
+/* One event per second, alternating sensors, value steps of up to ~2000 */
+static void test_append_raw(uint32_t n, uint8_t poll) {
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t k = record_count;
+
+        series_sim_secs++;
+        series_sim_tick += pdMS_TO_TICKS(TEST_STEP_MS);
+        if (k % 3 == 2) {
+            test_append(0, HT_SERIES_HUMIDITY, (int16_t)(4000 + (k * 37) % 2000));
+        } else {
+            test_append(1, HT_SERIES_TEMPERATURE, (int16_t)(1500 + (k * 53) % 1200 - 600));
+        }
+        if (poll) {
+            HT_Series_Poll();
+        }
+    }
+}
+
+static int test_collect(const HT_SeriesPoint *point, void *ctx) {
+    (void)ctx;
+
+    if (got_count < TEST_RECORDS) {
+        got[got_count] = *point;
+    }
+    got_count++;
+
+    return 0;
+}
+
+static int test_stop(const HT_SeriesPoint *point, void *ctx) {
+    (void)point;
+
+    return ++*(int *)ctx >= 3;
+}
+
+/* The points read back must be records[end - got_count .. end - 1] */
+static uint8_t test_match(uint32_t end, int visited) {
+    uint32_t first;
+
+    if (visited < 0 || (uint32_t)visited != got_count || got_count > end || got_count > TEST_RECORDS) {
+        return 0;
+    }
+    first = end - got_count;
+
+    for (uint32_t i = 0; i < got_count; i++) {
+        const TestRecord *r = &records[first + i];
+        const HT_SeriesPoint *p = &got[i];
+
+        if (p->time != r->time || p->ambiente != r->ambiente || p->channel != r->channel ||
+            p->count != 1 || p->mean != r->value || p->min != r->value || p->max != r->value) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int test_query(HT_SeriesTier tier, uint32_t from, uint32_t to) {
+    got_count = 0;
+
+    return HT_Series_Query(tier, from, to, test_collect, NULL);
+}
+
+/* RAM is lost, flash keeps what littlefs committed */
+static void test_reboot(void) {
+    memcpy(series_tier, tier_boot, sizeof(series_tier));
+    memset(series_acc, 0, sizeof(series_acc));
+    memset(&series_stats, 0, sizeof(series_stats));
+    series_ready = 0;
+
+    HT_Series_Init();
+}
+
+static void test_report(const char *name, uint32_t points, uint8_t ok) {
+    failures += ok ? 0 : 1;
+
+    printf("%-32s %8u  %s\n", name, points, ok ? "ok" : "DATA MISMATCH");
+}
+
+/* Cases ----------------------------------------------------------------------*/
+
+static void test_raw_wrap(void) {
+    HT_SeriesTierState *t = &series_tier[HT_SERIES_RAW];
+    HT_SeriesStats stats;
+    uint32_t slots = 0;
+    int visited;
+    uint8_t ok;
+
+    test_append_raw(40000, 1);
+    HT_Series_GetStats(&stats);
+
+    /* Every slot holds one of the newest segments */
+    for (uint8_t i = 0; i < t->segments; i++) {
+        slots += t->seq[i] != 0 && t->last_seq - t->seq[i] < t->segments;
+    }
+
+    /* The oldest segments are gone, the rest reads back in order up to the last event */
+    visited = test_query(HT_SERIES_RAW, 0, UINT32_MAX);
+    ok = stats.segments > HT_SERIES_RAW_SEGMENTS && slots == HT_SERIES_RAW_SEGMENTS && stats.commits > stats.segments &&
+         stats.write_errors == 0 && got_count < record_count &&
+         got_count > (HT_SERIES_RAW_SEGMENTS - 1) * (HT_SERIES_SEGMENT_SIZE / HT_SERIES_ENTRY_MAX) &&
+         test_match(record_count, visited);
+    test_report("raw rollover and ring wrap", got_count, ok);
+}
+
+static void test_raw_range(void) {
+    uint32_t from = records[record_count - 5000].time;
+    uint32_t to = records[record_count - 1000].time;
+    int visited = test_query(HT_SERIES_RAW, from, to);
+
+    test_report("raw range", got_count, got_count == 4001 && test_match(record_count - 999, visited));
+}
+
+static void test_replay(void) {
+    HT_SeriesTierState *t = &series_tier[HT_SERIES_RAW];
+    uint32_t last_seq, slot;
+    struct lfs_info info;
+    char name[HT_SERIES_NAME_LEN];
+    int visited;
+    uint8_t ok;
+
+    HT_Series_Flush();
+    last_seq = t->last_seq;
+    slot = t->slot;
+    test_reboot();
+
+    /* The newest segment is decoded to its end and appends go on in it */
+    HT_Series_Name(name, HT_SERIES_RAW, t->slot);
+    ok = t->last_seq == last_seq && t->slot == slot && t->open &&
+         LFS_Stat(name, &info) == 0 && t->used == info.size && t->committed == info.size;
+
+    test_append_raw(1, 1);
+    ok = ok && series_stats.segments == 0 && t->slot == slot;
+
+    test_append_raw(199, 1);
+    HT_Series_Flush();
+    visited = test_query(HT_SERIES_RAW, 0, UINT32_MAX);
+    ok = ok && test_match(record_count, visited);
+    test_report("replay in HT_Series_Init", got_count, ok);
+}
+
+static void test_reset(void) {
+    uint32_t committed = record_count;
+    uint32_t commits = series_stats.commits;
+    int visited;
+    uint8_t ok;
+
+    /* More than a buffer: some of it reaches the open file, none is committed */
+    test_append_raw(300, 0);
+    ok = series_stats.commits == commits && series_stats.appends != 0;
+    test_reboot();
+
+    visited = test_query(HT_SERIES_RAW, 0, UINT32_MAX);
+    ok = ok && test_match(committed, visited);
+    record_count = committed;
+
+    test_append_raw(100, 1);
+    HT_Series_Flush();
+    visited = test_query(HT_SERIES_RAW, 0, UINT32_MAX);
+    ok = ok && test_match(record_count, visited);
+    test_report("reset keeps the committed part", got_count, ok);
+}
+
+static void test_merge(HT_SeriesTier tier, const char *name) {
+    uint32_t period = series_tier[tier].period;
+    uint32_t start, first, bucket, count, i;
+    int16_t min, max;
+    int visited;
+    uint8_t ok = 1;
+
+    /* Start on a bucket boundary, no bucket open from the cases before */
+    HT_Series_Flush();
+    series_sim_secs += period - series_sim_secs % period;
+    start = series_sim_secs;
+    first = record_count;
+
+    /* A hibernate every 25 s cuts the buckets into several entries */
+    for (i = 0; i < 1200; i++) {
+        series_sim_secs += 5;
+        series_sim_tick += pdMS_TO_TICKS(5000);
+        test_append(2, HT_SERIES_DOOR, (i % 7) < 3 ? 100 : 0);
+        if (i % 5 == 4) {
+            HT_Series_Flush();
+        }
+    }
+    HT_Series_Flush();
+
+    /* One point per bucket, with the count, min and max of all its events */
+    visited = test_query(tier, start, UINT32_MAX);
+    i = first;
+    for (uint32_t k = 0; k < got_count && ok; k++) {
+        const HT_SeriesPoint *p = &got[k];
+
+        if (p->ambiente != 2 || p->channel != HT_SERIES_DOOR || i >= record_count) {
+            ok = 0;
+            break;
+        }
+        bucket = records[i].time - records[i].time % period;
+        count = 0;
+        min = INT16_MAX;
+        max = INT16_MIN;
+        for (; i < record_count && records[i].time - records[i].time % period == bucket; i++) {
+            count++;
+            min = records[i].value < min ? records[i].value : min;
+            max = records[i].value > max ? records[i].value : max;
+        }
+        ok = p->time == bucket && p->count == count && p->min == min && p->max == max &&
+             p->mean >= min && p->mean <= max;
+    }
+    ok = ok && visited == (int)got_count && i == record_count;
+    test_report(name, got_count, ok);
+}
+
+static void test_visit_stop(void) {
+    int calls = 0;
+    int visited = HT_Series_Query(HT_SERIES_1MIN, 0, UINT32_MAX, test_stop, &calls);
+
+    test_report("query stops on the visitor", (uint32_t)visited, visited == 3 && calls == 3);
+}
+
+int main(void) {
+    memcpy(tier_boot, series_tier, sizeof(tier_boot));
+    HT_Series_Init();
+
+    printf("%-32s %8s\n", "case", "points");
+
+    test_raw_wrap();
+    test_raw_range();
+    test_replay();
+    test_reset();
+    test_merge(HT_SERIES_1MIN, "1 min buckets split by flush");
+    test_merge(HT_SERIES_15MIN, "15 min buckets split by flush");
+    test_visit_stop();
+
+    if (test_fs_overflows != 0) {
+        printf("segment writes past the block: %u\n", test_fs_overflows);
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
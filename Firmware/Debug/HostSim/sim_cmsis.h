@@ -0,0 +1,133 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file sim_cmsis.h
+ * \brief Host replacement for cmsis_gcc.h, force-included (-include) in every
+ *        host simulator unit. Claims the cmsis_gcc.h include guard so the
+ *        Cortex-M inline assembly never reaches the host compiler, and maps
+ *        PRIMASK/IPSR onto the simulated core state in periph_sim.c.
+ *
+ * \author HT Micron Advanced R&D
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#ifndef __SIM_CMSIS_H__
+#define __SIM_CMSIS_H__
+
+#define __CMSIS_GCC_H
+
+#include <stdint.h>
+
+/* Defines  ------------------------------------------------------------------*/
+
+#define __ASM                   __asm
+#define __INLINE                inline
+#define __STATIC_INLINE         static inline
+#define __STATIC_FORCEINLINE    __attribute__((always_inline)) static inline
+#define __NO_RETURN             __attribute__((noreturn))
+#define __USED                  __attribute__((used))
+#define __WEAK                  __attribute__((weak))
+#define __PACKED                __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT         struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION          union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)            __attribute__((aligned(x)))
+#define __RESTRICT              __restrict
+
+#define __NOP()                 do { } while(0)
+#define __WFI()                 sim_wfi()
+#define __WFE()                 sim_wfi()
+#define __SEV()                 do { } while(0)
+#define __ISB()                 __sync_synchronize()
+#define __DSB()                 __sync_synchronize()
+#define __DMB()                 __sync_synchronize()
+#define __BKPT(value)           __builtin_trap()
+#define __CLZ                   __builtin_clz
+#define __REV                   __builtin_bswap32
+
+/* Simulated core state (periph_sim.c) */
+extern volatile uint32_t sim_primask;
+extern volatile uint32_t sim_ipsr;
+
+void sim_irq_unmasked(void);
+void sim_wfi(void);
+
+/* Functions ------------------------------------------------------------------*/
+
+static inline void __enable_irq(void) {
+    sim_primask = 0;
+    sim_irq_unmasked();
+}
+
+static inline void __disable_irq(void) {
+    sim_primask = 1;
+}
+
+static inline uint32_t __get_PRIMASK(void) {
+    return sim_primask;
+}
+
+static inline void __set_PRIMASK(uint32_t priMask) {
+    sim_primask = priMask & 1U;
+
+    if(sim_primask == 0)
+        sim_irq_unmasked();
+}
+
+static inline uint32_t __get_IPSR(void) {
+    return sim_ipsr;
+}
+
+static inline uint32_t __get_CONTROL(void) {
+    return 0;
+}
+
+static inline uint32_t __get_xPSR(void) {
+    return sim_ipsr;
+}
+
+static inline uint32_t __get_BASEPRI(void) {
+    return 0;
+}
+
+static inline void __set_BASEPRI(uint32_t basePri) {
+    (void)basePri;
+}
+
+static inline uint32_t __RBIT(uint32_t value) {
+    uint32_t result = 0;
+    int i;
+
+    for(i = 0; i < 32; i++) {
+        result = (result << 1) | (value & 1U);
+        value >>= 1;
+    }
+
+    return result;
+}
+
+#endif /* __SIM_CMSIS_H__ */
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -0,0 +1,344 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2023 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file sim_platform.c
+ * \brief Host stand-ins for the prebuilt platform library used by the HAL
+ *        drivers: clock/reset (GPR), pads, GPIO, XIC, sleep manager, unilog
+ *        and the DMA channel API, the latter driving the DMA model of
+ *        periph_sim.c. Everything here lives in SIM_HOST, on target these
+ *        run from the ROM/prebuilt library and are not part of the driver cost.
+ *
+ * \author HT Micron Advanced R&D
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
+
+#include "periph_sim.h"
+#include "htnb32lxxx_hal_usart.h"
+#include "pad_qcx212.h"
+#include "gpio_qcx212.h"
+#include "ic_qcx212.h"
+#include "slpman_qcx212.h"
+#include "debug_trace.h"
+
+/* Globals  ------------------------------------------------------------------*/
+
+static plat_config_raw_flash_t sim_plat_config;
+
+/* Clock and reset ------------------------------------------------------------*/
+
+SIM_HOST int32_t GPR_ClockEnable(clock_ID_t id) {
+    (void)id;
+    return 0;
+}
+
+SIM_HOST int32_t GPR_ClockDisable(clock_ID_t id) {
+    (void)id;
+    return 0;
+}
+
+SIM_HOST int32_t GPR_SetClockSrc(clock_ID_t id, clock_select_t select) {
+    (void)id;
+    (void)select;
+    return 0;
+}
+
+SIM_HOST uint32_t GPR_GetClockFreq(clock_ID_t id) {
+    (void)id;
+    return SIM_PERIPH_CLOCK_HZ;
+}
+
+SIM_HOST void GPR_SWReset(sw_reset_ID_t id) {
+    (void)id;
+}
+
+SIM_HOST int32_t HT_GPR_ClockEnable(clock_ID_t id) {
+    return GPR_ClockEnable(id);
+}
+
+SIM_HOST int32_t HT_GPR_ClockDisable(clock_ID_t id) {
+    return GPR_ClockDisable(id);
+}
+
+SIM_HOST int32_t HT_GPR_SetClockSrc(clock_ID_t id, clock_select_t select) {
+    return GPR_SetClockSrc(id, select);
+}
+
+SIM_HOST void HT_GPR_SWReset(sw_reset_ID_t id) {
+    GPR_SWReset(id);
+}
+
+/* Pads and GPIO --------------------------------------------------------------*/
+
+SIM_HOST void PAD_GetDefaultConfig(pad_config_t *config) {
+    (void)config;
+}
+
+SIM_HOST void PAD_SetPinConfig(uint32_t pin, const pad_config_t *config) {
+    (void)pin;
+    (void)config;
+}
+
+SIM_HOST void PAD_SetPinPullConfig(uint32_t pin, pad_pull_config_t config) {
+    (void)pin;
+    (void)config;
+}
+
+SIM_HOST void GPIO_PinConfig(uint32_t port, uint16_t pin, const gpio_pin_config_t *config) {
+    (void)port;
+    (void)pin;
+    (void)config;
+}
+
+SIM_HOST void GPIO_PinWrite(uint32_t port, uint16_t pinMask, uint16_t output) {
+    (void)port;
+    (void)pinMask;
+    (void)output;
+}
+
+/* Interrupt controller -------------------------------------------------------*/
+
+SIM_HOST void XIC_SetVector(IRQn_Type IRQn, ISRFunc_T vector) {
+    sim_xic_set_vector((uint32_t)IRQn, vector);
+}
+
+SIM_HOST void XIC_EnableIRQ(IRQn_Type IRQn) {
+    sim_xic_enable((uint32_t)IRQn, true);
+}
+
+SIM_HOST void XIC_DisableIRQ(IRQn_Type IRQn) {
+    sim_xic_enable((uint32_t)IRQn, false);
+}
+
+/* Lines are level-sensitive in the model, nothing is latched in the XIC */
+SIM_HOST void XIC_ClearPendingIRQ(IRQn_Type IRQn) {
+    (void)IRQn;
+}
+
+SIM_HOST void XIC_SuppressOvfIRQ(IRQn_Type IRQn) {
+    (void)IRQn;
+}
+
+/* Sleep manager, board and log -----------------------------------------------*/
+
+SIM_HOST slpManRet_t slpManDrvVoteSleep(slpDrvVoteModule_t module, slpManSlpState_t status) {
+    (void)module;
+    (void)status;
+    return RET_TRUE;
+}
+
+SIM_HOST slpManSlpState_t slpManGetLastSlpState(void) {
+    return SLP_ACTIVE_STATE;
+}
+
+SIM_HOST slpManRet_t slpManRegisterPredefinedBackupCb(slpCbModule_t module, slpManBackupCb_t backup_cb, void *pdata, slpManLpState state) {
+    (void)module;
+    (void)backup_cb;
+    (void)pdata;
+    (void)state;
+    return RET_TRUE;
+}
+
+SIM_HOST slpManRet_t slpManRegisterPredefinedRestoreCb(slpCbModule_t module, slpManRestoreCb_t restore_cb, void *pdata, slpManLpState state) {
+    (void)module;
+    (void)restore_cb;
+    (void)pdata;
+    (void)state;
+    return RET_TRUE;
+}
+
+SIM_HOST slpManRet_t slpManUnregisterPredefinedBackupCb(slpCbModule_t module) {
+    (void)module;
+    return RET_TRUE;
+}
+
+SIM_HOST slpManRet_t slpManUnregisterPredefinedRestoreCb(slpCbModule_t module) {
+    (void)module;
+    return RET_TRUE;
+}
+
+SIM_HOST plat_config_raw_flash_t *HT_BSP_GetRawFlashPlatConfig(void) {
+    return &sim_plat_config;
+}
+
+SIM_HOST void HT_BSP_LoadPlatConfigFromRawFlash(void) {
+}
+
+SIM_HOST void HT_SetUnilogUart(usart_port_t port, uint32_t baudrate, bool startRecv) {
+    (void)port;
+    (void)baudrate;
+    (void)startRecv;
+}
+
+SIM_HOST void uniLogInitStart(unilogPeripheralType periphType) {
+    (void)periphType;
+}
+
+/* DMA channel API ------------------------------------------------------------*/
+
+static SIM_HOST uint32_t sim_dma_cmdr(const dma_transfer_config *config) {
+    uint32_t cmdr = 0;
+
+    if(config->addressIncrement & DMA_AddressIncrementSource)
+        cmdr |= SIM_DMA_CMDR_INC_SRC;
+
+    if(config->addressIncrement & DMA_AddressIncrementTarget)
+        cmdr |= SIM_DMA_CMDR_INC_TRG;
+
+    if(config->flowControl == DMA_FlowControlSource)
+        cmdr |= SIM_DMA_CMDR_FLOW_SRC;
+    else if(config->flowControl == DMA_FlowControlTarget)
+        cmdr |= SIM_DMA_CMDR_FLOW_TRG;
+
+    cmdr |= ((uint32_t)config->burstSize << SIM_DMA_CMDR_BURST_Pos) & SIM_DMA_CMDR_BURST_Msk;
+    cmdr |= ((uint32_t)config->dataWidth << SIM_DMA_CMDR_WIDTH_Pos) & SIM_DMA_CMDR_WIDTH_Msk;
+    cmdr |= config->totalLength & SIM_DMA_CMDR_LEN_Msk;
+
+    return cmdr;
+}
+
+SIM_HOST void DMA_Init(void) {
+}
+
+SIM_HOST int32_t DMA_OpenChannel(void) {
+    sim_dma_chan_t *ch;
+    uint32_t i;
+
+    for(i = 0; i < SIM_DMA_CHANNELS; i++) {
+        ch = sim_dma_chan(i);
+
+        if(!ch->open) {
+            ch->open     = 1;
+            ch->running  = 0;
+            ch->pending  = 0;
+            ch->request  = DMA_MemoryToMemory;
+            ch->callback = NULL;
+            return (int32_t)i;
+        }
+    }
+
+    return ARM_DMA_ERROR_CHANNEL_ALLOC;
+}
+
+SIM_HOST int32_t DMA_CloseChannel(uint32_t channel) {
+    sim_dma_chan_t *ch = sim_dma_chan(channel);
+
+    ch->running = 0;
+    ch->pending = 0;
+    ch->open    = 0;
+
+    return ARM_DRIVER_OK;
+}
+
+SIM_HOST void DMA_StartChannel(uint32_t channel) {
+    sim_dma_chan(channel)->running = 1;
+    sim_dma_kick();
+}
+
+/* Pending events stay latched, the PDMA interrupt still reports them */
+SIM_HOST int32_t DMA_StopChannel(uint32_t channel, bool waitForStop) {
+    (void)waitForStop;
+    sim_dma_chan(channel)->running = 0;
+
+    return ARM_DRIVER_OK;
+}
+
+SIM_HOST void DMA_StopChannelNoWait(uint32_t channel) {
+    sim_dma_chan(channel)->running = 0;
+}
+
+SIM_HOST void DMA_ResetChannel(uint32_t channel) {
+    sim_dma_chan_t *ch = sim_dma_chan(channel);
+
+    ch->running = 0;
+    ch->pending = 0;
+    ch->count   = 0;
+}
+
+SIM_HOST void DMA_ChannelRigisterCallback(uint32_t channel, dma_callback_t callback) {
+    sim_dma_chan(channel)->callback = callback;
+}
+
+SIM_HOST void DMA_EnableChannelInterrupts(uint32_t channel, uint32_t mask) {
+    sim_dma_chan(channel)->cmdr |= mask & (SIM_DMA_CMDR_START_IRQ | SIM_DMA_CMDR_END_IRQ);
+}
+
+SIM_HOST void DMA_DisableChannelInterrupts(uint32_t channel, uint32_t mask) {
+    sim_dma_chan(channel)->cmdr &= ~(mask & (SIM_DMA_CMDR_START_IRQ | SIM_DMA_CMDR_END_IRQ));
+}
+
+SIM_HOST uint32_t DMA_GetEnabledInterrupts(uint32_t channel) {
+    return sim_dma_chan(channel)->cmdr & (SIM_DMA_CMDR_START_IRQ | SIM_DMA_CMDR_END_IRQ);
+}
+
+SIM_HOST uint32_t DMA_ChannelGetCount(uint32_t channel) {
+    return sim_dma_chan(channel)->count;
+}
+
+SIM_HOST uint32_t DMA_ChannelGetCurrentTargetAddress(uint32_t channel, bool sync) {
+    (void)sync;
+    return sim_dma_chan(channel)->tar;
+}
+
+SIM_HOST void DMA_ChannelSetRequestSource(uint32_t channel, dma_request_source_t request) {
+    sim_dma_chan(channel)->request = (int16_t)request;
+}
+
+SIM_HOST void DMA_TransferSetup(uint32_t channel, const dma_transfer_config *config) {
+    sim_dma_chan_t *ch = sim_dma_chan(channel);
+
+    ch->dar   = SIM_DMA_DAR_STOP;
+    ch->sar   = (uint32_t)(uintptr_t)config->sourceAddress;
+    ch->tar   = (uint32_t)(uintptr_t)config->targetAddress;
+    ch->cmdr  = (ch->cmdr & (SIM_DMA_CMDR_START_IRQ | SIM_DMA_CMDR_END_IRQ)) | sim_dma_cmdr(config);
+    ch->len   = config->totalLength;
+    ch->count = 0;
+}
+
+SIM_HOST void DMA_BuildDescriptor(dma_descriptor_t *descriptor, const dma_transfer_config *config, const dma_extra_config *extraConfig) {
+    descriptor->DAR  = (uint32_t)(uintptr_t)extraConfig->nextDesriptorAddress | (extraConfig->stopDecriptorFetch ? SIM_DMA_DAR_STOP : 0);
+    descriptor->SAR  = (uint32_t)(uintptr_t)config->sourceAddress;
+    descriptor->TAR  = (uint32_t)(uintptr_t)config->targetAddress;
+    descriptor->CMDR = sim_dma_cmdr(config) |
+                       (extraConfig->enableStartInterrupt ? SIM_DMA_CMDR_START_IRQ : 0) |
+                       (extraConfig->enableEndInterrupt ? SIM_DMA_CMDR_END_IRQ : 0);
+}
+
+SIM_HOST int32_t DMA_ChannelLoadFirstDescriptor(uint32_t channel, void *descriptorAddress) {
+    sim_dma_load(sim_dma_chan(channel), (uint32_t)(uintptr_t)descriptorAddress);
+
+    return ARM_DRIVER_OK;
+}
+
+SIM_HOST void DMA_ChannelLoadDescriptorAndRun(uint32_t channel, void *descriptorAddress) {
+    DMA_ChannelLoadFirstDescriptor(channel, descriptorAddress);
+    DMA_StartChannel(channel);
+}
+
+SIM_HOST uint32_t DMA_SetDescriptorTransferLen(uint32_t dcmd, uint32_t len) {
+    return (dcmd & ~SIM_DMA_CMDR_LEN_Msk) | (len & SIM_DMA_CMDR_LEN_Msk);
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -0,0 +1,194 @@
+#   _    _ _______   __  __ _____ _____ _____   ____  _   _
+#  | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+#  | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+#  |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+#  | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+#  |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+#  =================== Advanced R&D ========================
+
+#  Copyright (c) 2023 HT Micron Semicondutores S.A.
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#  http://www.apache.org/licenses/LICENSE-2.0
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+
+# file: corehub_config.py
+# brief: Host generator for the Core_Hub configuration image (HT_CoreHub_Config.h). The image
+#        is flashed on its own at FLASH_XIP_ADDR + FLASH_CFG_REGION_OFFSET and read in place by
+#        the firmware, so the layout here is the C struct byte for byte: HT_ConfigImage (60
+#        bytes, little endian) followed by the NUL terminated strings its fields point to.
+#        Version, magic and region come from the headers on every run.
+#
+#        usage: python Debug/Scripts/corehub_config.py template > fleet.json
+#               python Debug/Scripts/corehub_config.py build fleet.json -o corehub_cfg.bin
+#               python Debug/Scripts/corehub_config.py dump corehub_cfg.bin
+# author: HT Micron Advanced R&D
+# link: https://github.com/htmicron
+# version: 0.1
+# date: October 19, 2026
+
+import os
+import re
+import sys
+import json
+import zlib
+import struct
+import argparse
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+APP = os.path.join(ROOT, "Applications", "Core_Hub")
+CONFIG_H = os.path.join(APP, "Inc", "HT_CoreHub_Config.h")
+CONFIG_C = os.path.join(APP, "Src", "HT_CoreHub_Config.c")
+FSM_H = os.path.join(APP, "Inc", "HT_CoreHubFsm.h")
+MQTT_H = os.path.join(APP, "Inc", "HT_MQTT_Api.h")
+MEM_MAP_H = os.path.join(ROOT, "SDK", "HT_API", "Startup", "Inc", "mem_map.h")
+
+# magic version header_size size crc alarm_timeout_ms ambiente_count ambiente[8]
+# broker broker_port client_id username password apn band reserved0
+# temp_upper temp_lower ac_setpoint reserved1
+HEADER = struct.Struct("<IHHIIIH8HHHHHHHBBhhhH")
+MAX_AMBIENTES = 8
+STRINGS = ["broker", "client_id", "username", "password", "apn"]
+
+def define(path, name):
+    body = open(path, encoding="utf-8", errors="ignore").read()
+    m = re.search(r"#define\s+{}\s+(\S+)".format(name), body)
+    if not m:
+        raise SystemExit("{} not found in {}".format(name, os.path.basename(path)))
+    value = m.group(1)
+    if value.startswith('"'):
+        return value.strip('"')
+    return value.rstrip("f")
+
+def layout():
+    if define(CONFIG_H, "HT_CONFIG_MAX_AMBIENTES") != str(MAX_AMBIENTES) or HEADER.size != 60:
+        raise SystemExit("HT_ConfigImage changed, update HEADER in corehub_config.py")
+    xip = int(define(MEM_MAP_H, "FLASH_XIP_ADDR"), 0)
+    return {
+        "magic": int(define(CONFIG_H, "HT_CONFIG_MAGIC"), 0),
+        "version": int(define(CONFIG_H, "HT_CONFIG_VERSION"), 0),
+        "address": xip + int(define(MEM_MAP_H, "FLASH_CFG_REGION_OFFSET"), 0),
+        "region": int(define(MEM_MAP_H, "FLASH_CFG_REGION_SIZE"), 0),
+    }
+
+def builtin():
+    # Same values as the built-in image of HT_CoreHub_Config.c
+    names = re.findall(r'\.ambiente\d\s*=\s*"([^"]*)"', open(CONFIG_C, encoding="utf-8").read())
+    tls = define(MQTT_H, "MQTT_TLS_ENABLE") == "1"
+    return {
+        "ambientes": names,
+        "broker": define(CONFIG_H, "HT_CONFIG_DEFAULT_BROKER"),
+        "broker_port": 8883 if tls else 1883,
+        "client_id": define(CONFIG_H, "HT_CONFIG_DEFAULT_CLIENT_ID"),
+        "username": "",
+        "password": "",
+        "apn": define(CONFIG_H, "HT_CONFIG_DEFAULT_APN"),
+        "band": int(define(CONFIG_H, "HT_CONFIG_DEFAULT_BAND")),
+        "temp_upper": float(define(FSM_H, "HT_COREHUB_TEMP_LIMIT_UPPER")),
+        "temp_lower": float(define(FSM_H, "HT_COREHUB_TEMP_LIMIT_LOWER")),
+        "ac_setpoint": int(define(FSM_H, "HT_COREHUB_AC_TEMP_SETPOINT")),
+        "alarm_timeout_ms": int(define(FSM_H, "HT_COREHUB_ALARM_TIMEOUT_MS")),
+    }
+
+def build(cfg, lay):
+    names = cfg["ambientes"]
+    # The image has room for MAX_AMBIENTES, the firmware runs NUM_AMBIENTES and ignores the rest
+    held = int(define(FSM_H, "NUM_AMBIENTES"))
+    if not 1 <= len(names) <= min(held, MAX_AMBIENTES):
+        raise SystemExit("ambientes: 1 to {} names (NUM_AMBIENTES in HT_CoreHubFsm.h)".format(min(held, MAX_AMBIENTES)))
+    name_len = int(define(os.path.join(APP, "Inc", "HT_CoreHub_State.h"), "HT_STATE_NAME_LEN")) - 1
+    for n in names:
+        # One topic level of "hana/<name>/...", matched by the state snapshot on its first bytes
+        if not n or any(c in n for c in "/+#") or len(n.encode("utf-8")) > name_len:
+            raise SystemExit("ambiente {!r}: 1 to {} bytes, no '/', '+' or '#'".format(n, name_len))
+        if names.count(n) > 1:
+            raise SystemExit("ambiente {!r} listed twice".format(n))
+    if cfg["temp_lower"] >= cfg["temp_upper"]:
+        raise SystemExit("temp_lower must be below temp_upper")
+
+    # Equal strings share one copy, "" included
+    blob = bytearray()
+    offsets = {}
+    def place(text):
+        data = text.encode("utf-8")
+        if b"\0" in data:
+            raise SystemExit("NUL inside {!r}".format(text))
+        if text not in offsets:
+            offsets[text] = HEADER.size + len(blob)
+            blob.extend(data + b"\0")
+        return offsets[text]
+
+    amb = [place(n) for n in names] + [place("")] * (MAX_AMBIENTES - len(names))
+    strs = {k: place(str(cfg[k])) for k in STRINGS}
+    size = HEADER.size + len(blob)
+    if size > lay["region"]:
+        raise SystemExit("image is {} bytes, region holds {}".format(size, lay["region"]))
+
+    fields = [lay["magic"], lay["version"], HEADER.size, size, 0, int(cfg["alarm_timeout_ms"]), len(names)] + amb + [
+        strs["broker"], int(cfg["broker_port"]), strs["client_id"], strs["username"], strs["password"], strs["apn"],
+        int(cfg["band"]), 0,
+        int(round(cfg["temp_upper"] * 100)), int(round(cfg["temp_lower"] * 100)), int(cfg["ac_setpoint"]), 0]
+    image = bytearray(HEADER.pack(*fields)) + blob
+    struct.pack_into("<I", image, 12, zlib.crc32(bytes(image)) & 0xFFFFFFFF)
+    return bytes(image)
+
+def parse(image, lay):
+    if len(image) < HEADER.size:
+        raise SystemExit("short image")
+    f = HEADER.unpack_from(image)
+    magic, version, header_size, size, crc, alarm, count = f[:7]
+    amb = f[7:15]
+    broker, port, client_id, username, password, apn, band, _, upper, lower, setpoint, _ = f[15:]
+    if magic != lay["magic"] or version != lay["version"] or header_size != HEADER.size:
+        raise SystemExit("not a version {} image".format(lay["version"]))
+    if size > len(image) or image[size - 1] != 0:
+        raise SystemExit("truncated image")
+    check = bytearray(image[:size])
+    struct.pack_into("<I", check, 12, 0)
+    if zlib.crc32(bytes(check)) & 0xFFFFFFFF != crc:
+        raise SystemExit("CRC mismatch")
+
+    def text(offset):
+        return image[offset:image.index(b"\0", offset)].decode("utf-8")
+
+    return {
+        "ambientes": [text(o) for o in amb[:count]],
+        "broker": text(broker), "broker_port": port, "client_id": text(client_id),
+        "username": text(username), "password": text(password), "apn": text(apn), "band": band,
+        "temp_upper": upper / 100.0, "temp_lower": lower / 100.0, "ac_setpoint": setpoint,
+        "alarm_timeout_ms": alarm,
+    }
+
+def main():
+    parser = argparse.ArgumentParser(description="Core_Hub configuration image generator")
+    sub = parser.add_subparsers(dest="cmd")
+    sub.add_parser("template", help="print the built-in configuration as JSON")
+    bld = sub.add_parser("build", help="make an image from a JSON configuration")
+    bld.add_argument("file")
+    bld.add_argument("-o", "--output", default="corehub_cfg.bin")
+    dmp = sub.add_parser("dump", help="check an image and print it as JSON")
+    dmp.add_argument("file")
+    args = parser.parse_args()
+
+    lay = layout()
+
+    if args.cmd == "template":
+        print(json.dumps(builtin(), indent=4, ensure_ascii=False))
+    elif args.cmd == "build":
+        cfg = builtin()
+        cfg.update(json.load(open(args.file, encoding="utf-8")))
+        image = build(cfg, lay)
+        open(args.output, "wb").write(image)
+        print("{}: {} bytes, flash at 0x{:x} ({} byte region)".format(args.output, len(image), lay["address"], lay["region"]))
+    elif args.cmd == "dump":
+        print(json.dumps(parse(open(args.file, "rb").read(), lay), indent=4, ensure_ascii=False))
+    else:
+        parser.print_help()
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,271 @@
+#   _    _ _______   __  __ _____ _____ _____   ____  _   _
+#  | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+#  | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+#  |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+#  | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+#  |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+#  =================== Advanced R&D ========================
+
+#  Copyright (c) 2023 HT Micron Semicondutores S.A.
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#  http://www.apache.org/licenses/LICENSE-2.0
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+
+# file: corehub_log.py
+# brief: Host decoder for the tokenized Core_Hub logs (HT_LOG / HT_LOG_STR, see HT_CoreHub_Log.h).
+#        The token table is rebuilt on every run from the sources: sub ID order comes from
+#        UNILOG_COREHUB_Tag in debug_log.h, the module number from debug_trace.h and the
+#        format strings from the HT_LOG call sites, so there is no database to keep in sync.
+#
+#        Input is the SW-log payload of each unilog record: the 32-bit swLogID followed by
+#        the 32-bit arguments (HT_LOG) or by the NUL terminated string padded to 4 bytes
+#        (HT_LOG_STR), little endian. Records from other modules are skipped.
+#
+#        usage: python Debug/Scripts/corehub_log.py table
+#               python Debug/Scripts/corehub_log.py check
+#               python Debug/Scripts/corehub_log.py size
+#               python Debug/Scripts/corehub_log.py decode capture.bin
+#               python Debug/Scripts/corehub_log.py decode --text capture.txt   ("<id> <arg> <arg>..." per line)
+# author: HT Micron Advanced R&D
+# link: https://github.com/htmicron
+# version: 0.1
+# date: October 19, 2026
+
+import os
+import re
+import sys
+import struct
+import argparse
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+DEBUG_INC = os.path.join(ROOT, "SDK", "PLAT", "middleware", "developed", "debug", "inc")
+SOURCES = [
+    os.path.join(ROOT, "Applications", "Core_Hub", "Src", "HT_CoreHubFsm.c"),
+    os.path.join(ROOT, "Applications", "Core_Hub", "Src", "HT_MQTT_Api.c"),
+    os.path.join(ROOT, "Applications", "Core_Hub", "Src", "main.c"),
+]
+MODULE = "UNILOG_COREHUB"
+LEVELS = ["P_DEBUG", "P_INFO", "P_VALUE", "P_SIG", "P_WARNING", "P_ERROR"]
+
+SWLOG_ID_MASK = (1 << 29) - 1                  # drop the owner bits
+SPEC_RE = re.compile(r"%[-+ 0#]*\d*(?:\.\d+)?(hh|h|ll|l|z|j|t)?([diuxXcsp%])")
+LOG_RE = re.compile(r'HT_LOG\(\s*(\w+)\s*,\s*(\w+)\s*,\s*(\d+)\s*,\s*"((?:[^"\\]|\\.)*)"')
+LOG_STR_RE = re.compile(r'HT_LOG_STR\(\s*(\w+)\s*,\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"')
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+def module_number(name):
+    body = open(os.path.join(DEBUG_INC, "debug_trace.h"), encoding="utf-8", errors="ignore").read()
+    body = strip_comments(body)
+    body = body[body.index("UNILOG_PHY_DUMP"):body.index("UniLogModuleIdType")]
+
+    value = -1
+    for entry in body.replace("}", "").split(","):
+        entry = entry.strip()
+        if not entry:
+            continue
+        if "=" in entry:
+            entry, expr = [x.strip() for x in entry.split("=")]
+            value = int(expr, 0)
+        else:
+            value += 1
+        if entry == name:
+            return value
+
+    raise SystemExit("{} not found in debug_trace.h".format(name))
+
+def sub_ids(module):
+    body = open(os.path.join(DEBUG_INC, "debug_log.h"), encoding="utf-8", errors="ignore").read()
+    start = body.index("{}_START = {} << 19".format(module, module))
+    block = body[start:body.index("}", start)]
+
+    ids = {}
+    for index, entry in enumerate(block.split(",")[1:], start=1):
+        entry = entry.strip()
+        if entry.startswith(module + "_") and not entry.endswith("_INVALID_ID"):
+            ids[entry[len(module) + 1:]] = index
+    return ids
+
+def c_unescape(literal):
+    return bytes(literal, "utf-8").decode("unicode_escape").encode("latin-1").decode("utf-8")
+
+def call_sites():
+    sites = []
+    for path in SOURCES:
+        if not os.path.exists(path):
+            continue
+        text = open(path, encoding="utf-8").read()
+        for m in LOG_RE.finditer(text):
+            line = text.count("\n", 0, m.start()) + 1
+            sites.append(dict(sub=m.group(1), level=m.group(2), argc=int(m.group(3)),
+                              fmt=c_unescape(m.group(4)), is_str=False, where="{}:{}".format(os.path.basename(path), line)))
+        for m in LOG_STR_RE.finditer(text):
+            line = text.count("\n", 0, m.start()) + 1
+            sites.append(dict(sub=m.group(1), level=m.group(2), argc=1,
+                              fmt=c_unescape(m.group(3)), is_str=True, where="{}:{}".format(os.path.basename(path), line)))
+    return sites
+
+def build_table():
+    base = module_number(MODULE) << 19
+    ids = sub_ids(MODULE)
+    table = {}
+    errors = []
+
+    for site in call_sites():
+        if site["sub"] not in ids:
+            errors.append("{}: {} is not in {}_Tag".format(site["where"], site["sub"], MODULE))
+            continue
+        nspec = len([s for s in SPEC_RE.findall(site["fmt"]) if s[1] != "%"])
+        if nspec != site["argc"]:
+            errors.append("{}: {} has {} specifiers but argc {}".format(site["where"], site["sub"], nspec, site["argc"]))
+        swid = base + ids[site["sub"]]
+        if swid in table:
+            errors.append("{}: {} already used at {}".format(site["where"], site["sub"], table[swid]["where"]))
+            continue
+        table[swid] = site
+
+    unused = sorted(set(ids) - set(s["sub"] for s in table.values()))
+    return table, errors, unused
+
+def render(fmt, args):
+    args = list(args)
+
+    def conv(m):
+        spec = m.group(0)
+        kind = m.group(2)
+        if kind == "%":
+            return "%"
+        value = args.pop(0) if args else 0
+        spec = spec.replace(m.group(1) or "", "", 1) if m.group(1) else spec
+        if kind == "s":
+            return spec % value
+        if kind in "di":
+            value = struct.unpack("<i", struct.pack("<I", value & 0xFFFFFFFF))[0]
+        if kind == "p":
+            return "0x%08x" % value
+        if kind == "u":
+            spec = spec[:-1] + "d"
+        return spec % value
+
+    return SPEC_RE.sub(conv, fmt)
+
+def decode_binary(data, table):
+    pos = 0
+    skipped = 0
+    while pos + 4 <= len(data):
+        swid = struct.unpack_from("<I", data, pos)[0] & SWLOG_ID_MASK
+        site = table.get(swid)
+        if site is None:
+            # foreign record or garbage, slide until the next known ID
+            pos += 1
+            skipped += 1
+            continue
+        pos += 4
+        if site["is_str"]:
+            end = data.find(b"\0", pos)
+            if end < 0:
+                break
+            text = data[pos:end].decode("utf-8", errors="replace")
+            pos = (end + 4) & ~3
+            yield site, render(site["fmt"], [text])
+        else:
+            need = 4 * site["argc"]
+            if pos + need > len(data):
+                break
+            args = struct.unpack_from("<{}I".format(site["argc"]), data, pos)
+            pos += need
+            yield site, render(site["fmt"], args)
+    if skipped:
+        sys.stderr.write("{} bytes skipped (records from other modules)\n".format(skipped))
+
+def decode_text(lines, table):
+    for line in lines:
+        fields = line.strip().split(None, 1)
+        if not fields:
+            continue
+        site = table.get(int(fields[0], 0) & SWLOG_ID_MASK)
+        if site is None:
+            continue
+        rest = fields[1] if len(fields) > 1 else ""
+        if site["is_str"]:
+            yield site, render(site["fmt"], [rest])
+        else:
+            yield site, render(site["fmt"], [int(x, 0) for x in rest.split()])
+
+def cmd_table(table):
+    for swid in sorted(table):
+        site = table[swid]
+        print("0x{:08x} {:<10} {:<24} {}".format(swid, site["level"], site["sub"], site["fmt"]))
+
+def cmd_size(table):
+    # Typical text: numbers print as 3 chars, strings as a 32 byte topic
+    text_total = 0
+    token_total = 0
+    for site in table.values():
+        sample = render(site["fmt"], ["x" * 32] if site["is_str"] else [100] * site["argc"])
+        text = len(sample.encode("utf-8")) + 1
+        token = 4 + (36 if site["is_str"] else 4 * site["argc"])
+        text_total += text
+        token_total += token
+        print("{:<24} text {:4d} B  token {:3d} B".format(site["sub"], text, token))
+
+    count = max(len(table), 1)
+    print("average per event: text {:.1f} B, token {:.1f} B ({:.1f}x)".format(
+        text_total / count, token_total / count, text_total / max(token_total, 1)))
+    numeric = [s for s in table.values() if not s["is_str"]]
+    if numeric:
+        text_num = sum(len(render(s["fmt"], [100] * s["argc"]).encode("utf-8")) + 1 for s in numeric)
+        token_num = sum(4 + 4 * s["argc"] for s in numeric)
+        print("numeric records only: {:.1f}x".format(text_num / token_num))
+
+    # A unilog record is at least the 32-bit swLogID and every argument is a
+    # 32-bit word, so even with no arguments at all the ratio stops here
+    print("ceiling of the unilog format (ID only): {:.1f}x".format(text_total / (4.0 * count)))
+
+def main():
+    parser = argparse.ArgumentParser(description="Core_Hub tokenized log decoder")
+    sub = parser.add_subparsers(dest="cmd")
+    sub.add_parser("table", help="print the token table")
+    sub.add_parser("check", help="verify call sites against debug_log.h")
+    sub.add_parser("size", help="estimate bytes per event, text vs tokenized")
+    dec = sub.add_parser("decode", help="decode a capture")
+    dec.add_argument("file")
+    dec.add_argument("--text", action="store_true", help="one record per line: <id> <args...>")
+    args = parser.parse_args()
+
+    table, errors, unused = build_table()
+
+    if args.cmd == "check":
+        for e in errors:
+            print("error: " + e)
+        for u in unused:
+            print("warning: {}_{} has no call site".format(MODULE, u))
+        sys.exit(1 if errors else 0)
+
+    for e in errors:
+        sys.stderr.write("warning: " + e + "\n")
+
+    if args.cmd == "table":
+        cmd_table(table)
+    elif args.cmd == "size":
+        cmd_size(table)
+    elif args.cmd == "decode":
+        if args.text:
+            records = decode_text(open(args.file, encoding="utf-8"), table)
+        else:
+            records = decode_binary(open(args.file, "rb").read(), table)
+        for site, text in records:
+            print("{:<9} {}".format(site["level"][2:], text))
+    else:
+        parser.print_help()
+
+if __name__ == "__main__":
+    main()
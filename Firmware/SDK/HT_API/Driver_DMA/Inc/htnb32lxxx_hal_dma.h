@@ -1,7 +1,254 @@
+/*
+
+  _    _ _______   __  __ _____ _____ _____   ____  _   _
+ | |  | |__   __| |  \/  |_   _/ ____|  __ \ / __ \| \ | |
+ | |__| |  | |    | \  / | | || |    | |__) | |  | |  \| |
+ |  __  |  | |    | |\/| | | || |    |  _  /| |  | | . ` |
+ | |  | |  | |    | |  | |_| || |____| | \ \| |__| | |\  |
+ |_|  |_|  |_|    |_|  |_|_____\_____|_|  \_\\____/|_| \_|
+ =================== Advanced R&D ========================
+
+ Copyright (c) 2024 HT Micron Semicondutores S.A.
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * \file htnb32lxxx_hal_dma.h
+ * \brief DMA HAL module driver.
+ *        Shared layer over the qcx212 DMA driver (dma_qcx212.h): channel
+ *        allocation with a per-channel callback and argument, single block
+ *        transfers, descriptor lists (chained or circular) and memory to
+ *        memory copies usable as an asynchronous memcpy.
+ *
+ *        Handles and descriptor arrays are used by the DMA after the call
+ *        returns (and again after sleep restore), so they must be static.
+ *        Callbacks run in the DMA interrupt.
+ *
+ * \author HT Micron Advanced R&D,
+ *         Hêndrick Bataglin Gonçalves, Christian Roberto Lehmen,  Matheus da Silva Zorzeto, Felipe Kalinski Ferreira,
+ *         Leandro Borges, Mauricio Carlotto Ribeiro, Henrique Kuhn, Cleber Haack, Eduardo Mendel
+ *
+ * \link https://github.com/htmicron
+ * \version 0.1
+ * \date October 19, 2026
+ */
 
 #ifndef __HTNB32Lxxx_HAL_DMA_H__
 #define __HTNB32Lxxx_HAL_DMA_H__
 
+#include <stdio.h>
+#include <stdbool.h>
+#include "string.h"
+#include "qcx212.h"
+#include "dma_qcx212.h"
+
+/* Defines  ------------------------------------------------------------------*/
+
+#define HAL_DMA_MAX_BLOCK_SIZE        4096U        /**</ Largest length programmed in one descriptor/register transfer. */
+
+#ifndef HAL_DMA_MEMCPY_MIN_SIZE
+#define HAL_DMA_MEMCPY_MIN_SIZE       64U          /**</ HAL_DMA_Memcpy copies smaller buffers with the CPU. */
+#endif
+
+#define HAL_DMA_MEMCPY_SPINS_PER_BYTE 64U          /**</ HAL_DMA_Memcpy wait budget, far above the bus rate of a copy. */
+
+/* Events passed to HAL_DMA_Callback_t */
+#define HAL_DMA_EVENT_DONE            (1U << 0)    /**</ Transfer, list or copy finished, the channel is idle. */
+#define HAL_DMA_EVENT_BLOCK           (1U << 1)    /**</ A list block ended and the channel moved on (HAL_DMA_LIST_IRQ_EACH or circular). */
+#define HAL_DMA_EVENT_ERROR           (1U << 2)    /**</ Bus error, the channel is stopped. */
+
+/* HAL_DMA_ListBuild flags */
+#define HAL_DMA_LIST_CIRCULAR         (1U << 0)    /**</ Last descriptor links back to the first one. */
+#define HAL_DMA_LIST_IRQ_EACH         (1U << 1)    /**</ End interrupt on every block, not only on the last one. */
+
+/* Typedefs  ------------------------------------------------------------------*/
+
+/**
+  \brief DMA completion callback, called in the DMA interrupt.
+  \param channel  Hardware channel of the handle.
+  \param event    HAL_DMA_EVENT_xxx.
+  \param arg      Argument given to HAL_DMA_Open.
+ */
+typedef void (*HAL_DMA_Callback_t)(int32_t channel, uint32_t event, void *arg);
+
+/** \brief One block of a descriptor list. */
+typedef struct _HAL_DMA_Block {
+  const void              *src;                 /**</ Source address (peripheral register or memory). */
+  void                    *dst;                 /**</ Target address (peripheral register or memory). */
+  uint32_t                 size;                /**</ Length in bytes, 1..HAL_DMA_MAX_BLOCK_SIZE. */
+} HAL_DMA_Block;
 
+/** \brief Descriptor list built by HAL_DMA_ListBuild. */
+typedef struct _HAL_DMA_List {
+  dma_descriptor_t        *desc;                /**</ Caller array, 16-byte aligned (__ALIGNED(16)). */
+  uint16_t                 count;               /**</ Descriptors in use. */
+  uint8_t                  flags;               /**</ HAL_DMA_LIST_xxx. */
+} HAL_DMA_List;
+
+/** \brief DMA channel handle. */
+typedef struct _HAL_DMA_HandleTypeDef {
+  int8_t                   channel;             /**</ Hardware channel, -1 while closed. */
+  int8_t                   request;             /**</ dma_request_source_t, DMA_MemoryToMemory for copies. */
+  volatile uint8_t         busy;                /**</ Transfer in progress. */
+  HAL_DMA_Callback_t       callback;            /**</ Completion callback, may be NULL. */
+  void                    *arg;                 /**</ Callback argument. */
+  dma_transfer_config      config;              /**</ Register mode configuration, kept for sleep restore. */
+  const HAL_DMA_List      *list;                /**</ List in progress, NULL in register mode. */
+  uint16_t                 ends;                /**</ End interrupts received for the list in progress. */
+  uint8_t                 *copy_src;            /**</ Memory to memory: next chunk source. */
+  uint8_t                 *copy_dst;            /**</ Memory to memory: next chunk target. */
+  uint32_t                 copy_left;           /**</ Memory to memory: bytes not programmed yet. */
+} HAL_DMA_HandleTypeDef;
+
+/* Functions  ----------------------------------------------------------------*/
+
+/*!******************************************************************
+ * \fn int32_t HAL_DMA_Open(HAL_DMA_HandleTypeDef *hdma, dma_request_source_t request, HAL_DMA_Callback_t callback, void *arg)
+ * \brief Allocates a DMA channel and binds it to a request source.
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma       DMA handle (static storage).
+ * \param[in] dma_request_source_t request      Peripheral request, DMA_MemoryToMemory for copies.
+ * \param[in] HAL_DMA_Callback_t callback       Completion callback, may be NULL.
+ * \param[in] void *arg                         Callback argument.
+ * \param[out] none
+ *
+ * \retval ARM_DRIVER_OK, ARM_DMA_ERROR_CHANNEL_ALLOC when every channel is taken.
+ *******************************************************************/
+int32_t HAL_DMA_Open(HAL_DMA_HandleTypeDef *hdma, dma_request_source_t request, HAL_DMA_Callback_t callback, void *arg);
+
+/*!******************************************************************
+ * \fn int32_t HAL_DMA_Close(HAL_DMA_HandleTypeDef *hdma)
+ * \brief Stops the channel if needed and gives it back to the allocator.
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma       DMA handle.
+ * \param[out] none
+ *
+ * \retval ARM Driver status.
+ *******************************************************************/
+int32_t HAL_DMA_Close(HAL_DMA_HandleTypeDef *hdma);
+
+/*!******************************************************************
+ * \fn int32_t HAL_DMA_Start(HAL_DMA_HandleTypeDef *hdma, const dma_transfer_config *config)
+ * \brief Starts a single block transfer in register mode. HAL_DMA_EVENT_DONE
+ *        is signalled when totalLength bytes have been moved.
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma       DMA handle.
+ * \param[in] const dma_transfer_config *config Transfer configuration, copied into the handle.
+ * \param[out] none
+ *
+ * \retval ARM_DRIVER_OK, ARM_DRIVER_ERROR_BUSY or ARM_DRIVER_ERROR_PARAMETER.
+ *******************************************************************/
+int32_t HAL_DMA_Start(HAL_DMA_HandleTypeDef *hdma, const dma_transfer_config *config);
+
+/*!******************************************************************
+ * \fn int32_t HAL_DMA_ListBuild(HAL_DMA_List *list, dma_descriptor_t *desc, const dma_transfer_config *config, const HAL_DMA_Block *blocks, uint16_t count, uint8_t flags)
+ * \brief Builds a descriptor list, one descriptor per block, every block
+ *        sharing the flow control, address increment, width and burst of
+ *        config. Blocks are chained in order; the last one stops the fetch
+ *        unless HAL_DMA_LIST_CIRCULAR is given.
+ *
+ * \param[out] HAL_DMA_List *list               List to fill.
+ * \param[in] dma_descriptor_t *desc            Descriptor array of at least count entries, 16-byte aligned.
+ * \param[in] const dma_transfer_config *config Template (addresses and length are taken from blocks).
+ * \param[in] const HAL_DMA_Block *blocks       Blocks to chain.
+ * \param[in] uint16_t count                    Number of blocks.
+ * \param[in] uint8_t flags                     HAL_DMA_LIST_xxx.
+ *
+ * \retval ARM_DRIVER_OK, ARM_DRIVER_ERROR_PARAMETER or ARM_DMA_ERROR_ADDRESS_NOT_ALIGNED.
+ *******************************************************************/
+int32_t HAL_DMA_ListBuild(HAL_DMA_List *list, dma_descriptor_t *desc, const dma_transfer_config *config, const HAL_DMA_Block *blocks, uint16_t count, uint8_t flags);
+
+/*!******************************************************************
+ * \fn int32_t HAL_DMA_StartList(HAL_DMA_HandleTypeDef *hdma, const HAL_DMA_List *list)
+ * \brief Runs a descriptor list. A linear list ends with HAL_DMA_EVENT_DONE
+ *        (plus HAL_DMA_EVENT_BLOCK per block with HAL_DMA_LIST_IRQ_EACH); a
+ *        circular one signals HAL_DMA_EVENT_BLOCK until HAL_DMA_Stop.
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma       DMA handle.
+ * \param[in] const HAL_DMA_List *list          List built by HAL_DMA_ListBuild, must stay valid while running.
+ * \param[out] none
+ *
+ * \retval ARM_DRIVER_OK, ARM_DRIVER_ERROR_BUSY or ARM_DRIVER_ERROR_PARAMETER.
+ *******************************************************************/
+int32_t HAL_DMA_StartList(HAL_DMA_HandleTypeDef *hdma, const HAL_DMA_List *list);
+
+/*!******************************************************************
+ * \fn int32_t HAL_DMA_MemcpyAsync(HAL_DMA_HandleTypeDef *hdma, void *dst, const void *src, uint32_t size)
+ * \brief Starts a memory to memory copy of any size. The copy runs in
+ *        chunks of HAL_DMA_MAX_BLOCK_SIZE, each one re-armed from the end
+ *        interrupt, and HAL_DMA_EVENT_DONE is signalled after the last one.
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma       Handle opened with DMA_MemoryToMemory.
+ * \param[in] void *dst                         Target buffer.
+ * \param[in] const void *src                   Source buffer, must not overlap dst.
+ * \param[in] uint32_t size                     Bytes to copy.
+ * \param[out] none
+ *
+ * \retval ARM_DRIVER_OK, ARM_DRIVER_ERROR_BUSY or ARM_DRIVER_ERROR_PARAMETER.
+ *******************************************************************/
+int32_t HAL_DMA_MemcpyAsync(HAL_DMA_HandleTypeDef *hdma, void *dst, const void *src, uint32_t size);
+
+/*!******************************************************************
+ * \fn int32_t HAL_DMA_Memcpy(HAL_DMA_HandleTypeDef *hdma, void *dst, const void *src, uint32_t size)
+ * \brief Blocking copy. Buffers below HAL_DMA_MEMCPY_MIN_SIZE are copied by
+ *        the CPU; larger ones go through HAL_DMA_MemcpyAsync and the call
+ *        waits for the channel to go idle. A copy still running after
+ *        HAL_DMA_MEMCPY_SPINS_PER_BYTE polls per byte is stopped with
+ *        HAL_DMA_Stop and ARM_DRIVER_ERROR_TIMEOUT is returned, dst then
+ *        holds a partial copy.
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma       Handle opened with DMA_MemoryToMemory.
+ * \param[in] void *dst                         Target buffer.
+ * \param[in] const void *src                   Source buffer, must not overlap dst.
+ * \param[in] uint32_t size                     Bytes to copy.
+ * \param[out] none
+ *
+ * \retval ARM Driver status.
+ *******************************************************************/
+int32_t HAL_DMA_Memcpy(HAL_DMA_HandleTypeDef *hdma, void *dst, const void *src, uint32_t size);
+
+/*!******************************************************************
+ * \fn int32_t HAL_DMA_Stop(HAL_DMA_HandleTypeDef *hdma)
+ * \brief Aborts the transfer in progress. No callback is called.
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma       DMA handle.
+ * \param[out] none
+ *
+ * \retval ARM Driver status.
+ *******************************************************************/
+int32_t HAL_DMA_Stop(HAL_DMA_HandleTypeDef *hdma);
+
+/*!******************************************************************
+ * \fn bool HAL_DMA_IsBusy(HAL_DMA_HandleTypeDef *hdma)
+ * \brief Checks if a transfer is in progress.
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma       DMA handle.
+ * \param[out] none
+ *
+ * \retval true while the channel is running.
+ *******************************************************************/
+bool HAL_DMA_IsBusy(HAL_DMA_HandleTypeDef *hdma);
+
+/*!******************************************************************
+ * \fn uint32_t HAL_DMA_GetCount(HAL_DMA_HandleTypeDef *hdma)
+ * \brief Bytes moved so far by the register mode transfer (or copy chunk) in progress.
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma       DMA handle.
+ * \param[out] none
+ *
+ * \retval Transferred bytes.
+ *******************************************************************/
+uint32_t HAL_DMA_GetCount(HAL_DMA_HandleTypeDef *hdma);
 
 #endif /*__HTNB32Lxxx_HAL_DMA_H__*/
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
@@ -1,4 +1,411 @@
+/**
+ *
+ * Copyright (c) 2024 HT Micron Semicondutores S.A.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
 
 #include "htnb32lxxx_hal_dma.h"
+#include "bsp.h"
 
-void HAL_DMA_Transfer()
\ No newline at end of file
+/* Function prototypes  ------------------------------------------------------------------*/
+
+// declearation for DMA API
+extern void DMA_ChannelLoadDescriptorAndRun(uint32_t channel, void* descriptorAddress);
+
+/*!******************************************************************
+ * \fn static void HAL_DMA_Event(uint32_t channel, uint32_t event)
+ * \brief Common DMA event handler, dispatches to the handle that owns the channel.
+ *
+ * \param[in] uint32_t channel                     Hardware channel.
+ * \param[in] uint32_t event                       DMA_EVENT_xxx from the low level driver.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void HAL_DMA_Event(uint32_t channel, uint32_t event);
+
+/*!******************************************************************
+ * \fn static void HAL_DMA_CopyNext(HAL_DMA_HandleTypeDef *hdma)
+ * \brief Programs the next memory to memory chunk in register mode.
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma          DMA handle.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void HAL_DMA_CopyNext(HAL_DMA_HandleTypeDef *hdma);
+
+/*!******************************************************************
+ * \fn static void HAL_DMA_Notify(HAL_DMA_HandleTypeDef *hdma, uint32_t event)
+ * \brief Calls the handle callback, if any.
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma          DMA handle.
+ * \param[in] uint32_t event                       HAL_DMA_EVENT_xxx.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void HAL_DMA_Notify(HAL_DMA_HandleTypeDef *hdma, uint32_t event);
+
+/*!******************************************************************
+ * \fn static bool HAL_DMA_IsOpen(HAL_DMA_HandleTypeDef *hdma)
+ * \brief Checks that the handle owns its channel (a zeroed handle does not).
+ *
+ * \param[in] HAL_DMA_HandleTypeDef *hdma          DMA handle.
+ * \param[out] none
+ *
+ * \retval true if the handle is open.
+ *******************************************************************/
+static bool HAL_DMA_IsOpen(HAL_DMA_HandleTypeDef *hdma);
+
+/* ---------------------------------------------------------------------------------------*/
+
+#if (DMA_NUMBER_OF_HW_CHANNEL_SUPPORTED != 8)
+#error "HAL DMA: update the per-channel event handlers below!"
+#endif
+
+// The low level callback has no context argument, one entry point per hardware channel
+#define HAL_DMA_CHANNEL_EVENT(n)    static void HAL_DMA_Ch##n##Event(uint32_t event) { HAL_DMA_Event(n, event); }
+
+HAL_DMA_CHANNEL_EVENT(0)
+HAL_DMA_CHANNEL_EVENT(1)
+HAL_DMA_CHANNEL_EVENT(2)
+HAL_DMA_CHANNEL_EVENT(3)
+HAL_DMA_CHANNEL_EVENT(4)
+HAL_DMA_CHANNEL_EVENT(5)
+HAL_DMA_CHANNEL_EVENT(6)
+HAL_DMA_CHANNEL_EVENT(7)
+
+static const dma_callback_t hal_dma_channel_event[DMA_NUMBER_OF_HW_CHANNEL_SUPPORTED] = {
+    HAL_DMA_Ch0Event, HAL_DMA_Ch1Event, HAL_DMA_Ch2Event, HAL_DMA_Ch3Event,
+    HAL_DMA_Ch4Event, HAL_DMA_Ch5Event, HAL_DMA_Ch6Event, HAL_DMA_Ch7Event
+};
+
+/* Variable Declarations  ----------------------------------------------------------------*/
+
+static HAL_DMA_HandleTypeDef *hal_dma_owner[DMA_NUMBER_OF_HW_CHANNEL_SUPPORTED] = {NULL};
+
+/* ---------------------------------------------------------------------------------------*/
+
+static bool HAL_DMA_IsOpen(HAL_DMA_HandleTypeDef *hdma) {
+    return (hdma != NULL) && (hdma->channel >= 0) && (hdma->channel < DMA_NUMBER_OF_HW_CHANNEL_SUPPORTED) && (hal_dma_owner[hdma->channel] == hdma);
+}
+
+static void HAL_DMA_Notify(HAL_DMA_HandleTypeDef *hdma, uint32_t event) {
+    if(hdma->callback)
+        hdma->callback(hdma->channel, event, hdma->arg);
+}
+
+static void HAL_DMA_CopyNext(HAL_DMA_HandleTypeDef *hdma) {
+    uint32_t len = MIN(hdma->copy_left, HAL_DMA_MAX_BLOCK_SIZE);
+
+    hdma->config.sourceAddress = hdma->copy_src;
+    hdma->config.targetAddress = hdma->copy_dst;
+    hdma->config.totalLength   = len;
+
+    hdma->copy_src  += len;
+    hdma->copy_dst  += len;
+    hdma->copy_left -= len;
+
+    DMA_TransferSetup(hdma->channel, &hdma->config);
+    DMA_EnableChannelInterrupts(hdma->channel, DMA_EndInterruptEnable);
+    DMA_StartChannel(hdma->channel);
+}
+
+static void HAL_DMA_Event(uint32_t channel, uint32_t event) {
+    HAL_DMA_HandleTypeDef *hdma = hal_dma_owner[channel];
+    const HAL_DMA_List *list;
+
+    if(hdma == NULL)
+        return;
+
+    switch (event) {
+        case DMA_EVENT_END:
+            list = hdma->list;
+
+            if(list) {
+                hdma->ends++;
+
+                if(!(list->flags & HAL_DMA_LIST_CIRCULAR) && (!(list->flags & HAL_DMA_LIST_IRQ_EACH) || (hdma->ends >= list->count))) {
+                    hdma->list = NULL;
+                    hdma->busy = 0;
+                    HAL_DMA_Notify(hdma, HAL_DMA_EVENT_DONE);
+                } else {
+                    HAL_DMA_Notify(hdma, HAL_DMA_EVENT_BLOCK);
+                }
+
+            } else if(hdma->copy_left) {
+                HAL_DMA_CopyNext(hdma);
+
+            } else if(hdma->busy) {
+                // Idle before the callback so it can start the next transfer
+                hdma->busy = 0;
+                HAL_DMA_Notify(hdma, HAL_DMA_EVENT_DONE);
+            }
+            break;
+
+        case DMA_EVENT_ERROR:
+            DMA_StopChannel(channel, false);
+
+            hdma->list = NULL;
+            hdma->copy_left = 0;
+            hdma->busy = 0;
+            HAL_DMA_Notify(hdma, HAL_DMA_EVENT_ERROR);
+            break;
+
+        default:
+            break;
+    }
+}
+
+int32_t HAL_DMA_Open(HAL_DMA_HandleTypeDef *hdma, dma_request_source_t request, HAL_DMA_Callback_t callback, void *arg) {
+    int32_t returnCode;
+
+    if(hdma == NULL)
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    if(HAL_DMA_IsOpen(hdma))
+        return ARM_DRIVER_ERROR_BUSY;
+
+    DMA_Init();
+
+    returnCode = DMA_OpenChannel();
+
+    if(returnCode == ARM_DMA_ERROR_CHANNEL_ALLOC)
+        return returnCode;
+
+    memset(hdma, 0, sizeof(HAL_DMA_HandleTypeDef));
+    hdma->channel  = returnCode;
+    hdma->request  = request;
+    hdma->callback = callback;
+    hdma->arg      = arg;
+
+    if(request != DMA_MemoryToMemory)
+        DMA_ChannelSetRequestSource(hdma->channel, request);
+
+    hal_dma_owner[hdma->channel] = hdma;
+    DMA_ChannelRigisterCallback(hdma->channel, hal_dma_channel_event[hdma->channel]);
+
+    return ARM_DRIVER_OK;
+}
+
+int32_t HAL_DMA_Close(HAL_DMA_HandleTypeDef *hdma) {
+    int32_t channel;
+
+    if(!HAL_DMA_IsOpen(hdma))
+        return ARM_DRIVER_OK;
+
+    channel = hdma->channel;
+
+    HAL_DMA_Stop(hdma);
+
+    DMA_ChannelRigisterCallback(channel, NULL);
+    hal_dma_owner[channel] = NULL;
+    hdma->channel = -1;
+
+    return DMA_CloseChannel(channel);
+}
+
+int32_t HAL_DMA_Start(HAL_DMA_HandleTypeDef *hdma, const dma_transfer_config *config) {
+    uint32_t mask;
+
+    if(!HAL_DMA_IsOpen(hdma) || (config == NULL))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    if((config->totalLength == 0) || (config->totalLength > HAL_DMA_MAX_BLOCK_SIZE))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    mask = SaveAndSetIRQMask();
+
+    if(hdma->busy) {
+        RestoreIRQMask(mask);
+        return ARM_DRIVER_ERROR_BUSY;
+    }
+
+    hdma->busy = 1;
+    hdma->list = NULL;
+    hdma->copy_left = 0;
+    hdma->config = *config;
+
+    RestoreIRQMask(mask);
+
+    DMA_TransferSetup(hdma->channel, &hdma->config);
+    DMA_EnableChannelInterrupts(hdma->channel, DMA_EndInterruptEnable);
+    DMA_StartChannel(hdma->channel);
+
+    return ARM_DRIVER_OK;
+}
+
+int32_t HAL_DMA_ListBuild(HAL_DMA_List *list, dma_descriptor_t *desc, const dma_transfer_config *config, const HAL_DMA_Block *blocks, uint16_t count, uint8_t flags) {
+    dma_transfer_config dmaConfig;
+    dma_extra_config extraConfig;
+    bool last;
+    uint16_t i;
+
+    if((list == NULL) || (desc == NULL) || (config == NULL) || (blocks == NULL) || (count == 0))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    // Descriptors are fetched on a 16-byte boundary
+    if((uint32_t)desc & 0xFU)
+        return ARM_DMA_ERROR_ADDRESS_NOT_ALIGNED;
+
+    for(i = 0; i < count; i++) {
+        if((blocks[i].size == 0) || (blocks[i].size > HAL_DMA_MAX_BLOCK_SIZE))
+            return ARM_DRIVER_ERROR_PARAMETER;
+    }
+
+    dmaConfig = *config;
+
+    extraConfig.enableStartInterrupt        = false;
+
+    for(i = 0; i < count; i++) {
+        last = (i == (count - 1));
+
+        dmaConfig.sourceAddress             = (void *)blocks[i].src;
+        dmaConfig.targetAddress             = blocks[i].dst;
+        dmaConfig.totalLength               = blocks[i].size;
+
+        extraConfig.nextDesriptorAddress    = last ? &desc[0] : &desc[i + 1];
+        extraConfig.stopDecriptorFetch      = last && !(flags & HAL_DMA_LIST_CIRCULAR);
+        extraConfig.enableEndInterrupt      = last || (flags & HAL_DMA_LIST_IRQ_EACH);
+
+        DMA_BuildDescriptor(&desc[i], &dmaConfig, &extraConfig);
+    }
+
+    list->desc  = desc;
+    list->count = count;
+    list->flags = flags;
+
+    return ARM_DRIVER_OK;
+}
+
+int32_t HAL_DMA_StartList(HAL_DMA_HandleTypeDef *hdma, const HAL_DMA_List *list) {
+    uint32_t mask;
+
+    if(!HAL_DMA_IsOpen(hdma) || (list == NULL) || (list->desc == NULL) || (list->count == 0))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    mask = SaveAndSetIRQMask();
+
+    if(hdma->busy) {
+        RestoreIRQMask(mask);
+        return ARM_DRIVER_ERROR_BUSY;
+    }
+
+    hdma->busy = 1;
+    hdma->list = list;
+    hdma->ends = 0;
+    hdma->copy_left = 0;
+
+    RestoreIRQMask(mask);
+
+    DMA_ChannelLoadDescriptorAndRun(hdma->channel, list->desc);
+
+    return ARM_DRIVER_OK;
+}
+
+int32_t HAL_DMA_MemcpyAsync(HAL_DMA_HandleTypeDef *hdma, void *dst, const void *src, uint32_t size) {
+    uint32_t mask;
+
+    if(!HAL_DMA_IsOpen(hdma) || (hdma->request != DMA_MemoryToMemory))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    if((dst == NULL) || (src == NULL) || (size == 0))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    mask = SaveAndSetIRQMask();
+
+    if(hdma->busy) {
+        RestoreIRQMask(mask);
+        return ARM_DRIVER_ERROR_BUSY;
+    }
+
+    hdma->busy = 1;
+    hdma->list = NULL;
+
+    hdma->config.flowControl      = DMA_FlowControlNone;
+    hdma->config.addressIncrement = DMA_AddressIncrementBoth;
+    hdma->config.dataWidth        = DMA_DataWidthNoUse;
+    hdma->config.burstSize        = DMA_Burst32Bytes;
+
+    hdma->copy_src  = (uint8_t *)src;
+    hdma->copy_dst  = (uint8_t *)dst;
+    hdma->copy_left = size;
+
+    RestoreIRQMask(mask);
+
+    HAL_DMA_CopyNext(hdma);
+
+    return ARM_DRIVER_OK;
+}
+
+int32_t HAL_DMA_Memcpy(HAL_DMA_HandleTypeDef *hdma, void *dst, const void *src, uint32_t size) {
+    uint32_t spins = size * HAL_DMA_MEMCPY_SPINS_PER_BYTE;
+    int32_t ret;
+
+    // Small copies, or no way for the DMA interrupt to run while we wait
+    if((size < HAL_DMA_MEMCPY_MIN_SIZE) || !HAL_DMA_IsOpen(hdma) || __get_IPSR() || __get_PRIMASK()) {
+        memcpy(dst, src, size);
+        return ARM_DRIVER_OK;
+    }
+
+    ret = HAL_DMA_MemcpyAsync(hdma, dst, src, size);
+
+    if(ret == ARM_DRIVER_ERROR_BUSY) {
+        memcpy(dst, src, size);
+        return ARM_DRIVER_OK;
+    }
+
+    if(ret != ARM_DRIVER_OK)
+        return ret;
+
+    while(hdma->busy) {
+        if(--spins == 0) {
+            // Channel or its end interrupt stuck, do not leave it running into dst
+            HAL_DMA_Stop(hdma);
+            return ARM_DRIVER_ERROR_TIMEOUT;
+        }
+    }
+
+    return ARM_DRIVER_OK;
+}
+
+int32_t HAL_DMA_Stop(HAL_DMA_HandleTypeDef *hdma) {
+    int32_t ret;
+    uint32_t mask;
+
+    if(!HAL_DMA_IsOpen(hdma))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    ret = DMA_StopChannel(hdma->channel, true);
+
+    mask = SaveAndSetIRQMask();
+    hdma->list = NULL;
+    hdma->copy_left = 0;
+    hdma->busy = 0;
+    RestoreIRQMask(mask);
+
+    return ret;
+}
+
+bool HAL_DMA_IsBusy(HAL_DMA_HandleTypeDef *hdma) {
+    return HAL_DMA_IsOpen(hdma) && hdma->busy;
+}
+
+uint32_t HAL_DMA_GetCount(HAL_DMA_HandleTypeDef *hdma) {
+    if(!HAL_DMA_IsOpen(hdma))
+        return 0;
+
+    return DMA_ChannelGetCount(hdma->channel);
+}
+
+/************************ HT Micron Semicondutores S.A *****END OF FILE****/
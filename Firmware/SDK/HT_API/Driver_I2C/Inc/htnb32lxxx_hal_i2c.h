@@ -72,6 +72,20 @@
 #define I2C_BUS_CLEAR_MASK (1 << 2)
 #define I2C_ABORT_TRANSFER_MASK (1 << 3)
 
+// Queued transactions (HAL_I2C_TransactionSubmit), IRQ_MODE only
+#ifndef I2C_XFER_QUEUE_DEPTH
+#define I2C_XFER_QUEUE_DEPTH            8         // Transactions pending per instance, power of two
+#endif
+
+#if (I2C_XFER_QUEUE_DEPTH & (I2C_XFER_QUEUE_DEPTH - 1)) != 0 || (I2C_XFER_QUEUE_DEPTH > 128)
+#error "I2C_XFER_QUEUE_DEPTH must be a power of two up to 128!"
+#endif
+
+#define I2C_XFER_MAX_SIZE               512       // Bytes per phase (SCR BYTE_NUM field)
+
+// HAL_I2C_ScheduleRun return when no schedule is registered
+#define I2C_SCHEDULE_IDLE               0xFFFFFFFFU
+
 /* Typedefs  ------------------------------------------------------------------*/
 
 // I2C IRQ
@@ -98,6 +112,43 @@ typedef struct _I2C_DMA {
 } I2C_DMA;
 
 
+struct _I2C_TRANSACTION;
+
+// Transaction completion: called from the I2C ISR after the STOP condition
+typedef void (*I2C_XferCallback_t)(struct _I2C_TRANSACTION *xfer, void *arg);
+
+// Write, read, or write then repeated START read (register read) on one device
+typedef struct _I2C_TRANSACTION {
+  uint16_t              addr;               // 7-bit slave address
+  const uint8_t        *wr_buf;             // Bytes written first (register address), may be NULL
+  uint16_t              wr_len;             // Bytes to write, 0 for a plain read
+  uint8_t              *rd_buf;             // Bytes read after the repeated START, may be NULL
+  uint16_t              rd_len;             // Bytes to read, 0 for a plain write
+  I2C_XferCallback_t    callback;           // Completion callback, may be NULL
+  void                 *arg;                // Callback argument
+  volatile int32_t      status;             // ARM_DRIVER_ERROR_BUSY while queued, then the result
+} I2C_TRANSACTION;
+
+// Transaction queue run-time state
+typedef struct {
+  I2C_TRANSACTION      *req[I2C_XFER_QUEUE_DEPTH];              // Pending transactions, req[tail] is on the bus
+  uint16_t              cnt;                // Bytes moved in the current phase
+  uint8_t               phase;              // Write or read phase of req[tail]
+  volatile uint8_t      head;               // Free running enqueue count
+  volatile uint8_t      tail;               // Free running completion count
+  volatile uint8_t      active;             // Queue owns the controller
+} I2C_XFER_QUEUE;
+
+// Periodic transaction, see HAL_I2C_ScheduleRun
+typedef struct _I2C_SCHEDULE {
+  I2C_TRANSACTION       xfer;               // Submitted every period, first member so callbacks can cast back
+  uint32_t              period;             // Period, in the time unit given to HAL_I2C_ScheduleRun
+  uint32_t              slack;              // How early it may run to share another device's bus wakeup
+  uint32_t              due;                // Next due time
+  uint32_t              overruns;           // Periods dropped (previous read still queued or queue full)
+  struct _I2C_SCHEDULE *next;               // Instance schedule list
+} I2C_SCHEDULE;
+
 // I2C Control Information
 typedef struct {
   ARM_I2C_SignalEvent_t cb_event;           // Event callback
@@ -112,6 +163,8 @@ typedef struct {
   uint32_t              num;                // Number of bytes to transfer
   uint8_t              *sdata;              // Slave data to transfer
   uint32_t              snum;               // Number of bytes to transfer
+  I2C_XFER_QUEUE        xq;                 // Queued transactions
+  I2C_SCHEDULE         *sched;              // Periodic transactions
 } I2C_CTRL;
 
 
@@ -132,30 +185,32 @@ typedef enum {
 /* Functions  ----------------------------------------------------------------*/
 
 /*!******************************************************************
- * \fn void HAL_I2C_MasterReceive_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_t *pRxData, uint32_t size);
- * \brief I2C master receive in polling mode.
+ * \fn int32_t HAL_I2C_MasterReceive_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_t *pRxData, uint32_t size);
+ * \brief I2C master receive in polling mode. Refused while the transaction
+ *        queue or another transfer owns the controller.
  *
  * \param[in] I2C_HandleTypeDef *hi2c           I2C handle.
  * \param[in] uint32_t addr                     I2C slave address.
  * \param[in] uint32_t size                     Amount of data to be received.
  * \param[out] uint8_t *pRxData                 RX buffer.
  *
- * \retval none
+ * \retval ARM driver status, ARM_DRIVER_ERROR_BUSY when refused.
  *******************************************************************/
-void HAL_I2C_MasterReceive_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_t *pRxData, uint32_t size);
+int32_t HAL_I2C_MasterReceive_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_t *pRxData, uint32_t size);
 
 /*!******************************************************************
- * \fn void HAL_I2C_MasterTransmit_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, const uint8_t *data, uint32_t size);
- * \brief I2C master transmit in polling mode.
+ * \fn int32_t HAL_I2C_MasterTransmit_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, const uint8_t *data, uint32_t size);
+ * \brief I2C master transmit in polling mode. Refused while the transaction
+ *        queue or another transfer owns the controller.
  *
  * \param[in] I2C_HandleTypeDef *hi2c           I2C handle.
  * \param[in] uint32_t addr                     I2C slave address.
  * \param[in] const uint8_t *data               TX buffer.
  * \param[in] uint32_t size                     Amount of data to be sent.
  *
- * \retval none
+ * \retval ARM driver status, ARM_DRIVER_ERROR_BUSY when refused.
  *******************************************************************/
-void HAL_I2C_MasterTransmit_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, const uint8_t *data, uint32_t size);
+int32_t HAL_I2C_MasterTransmit_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, const uint8_t *data, uint32_t size);
 
 /*!******************************************************************
  * \fn int32_t HAL_I2C_MasterTransmit_IT(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_t *pTxData, uint32_t size);
@@ -183,6 +238,71 @@ int32_t HAL_I2C_MasterTransmit_IT(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_
  *******************************************************************/
 int32_t HAL_I2C_MasterReceive_IT(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_t *pRxData, uint32_t size);
 
+/*!******************************************************************
+ * \fn int32_t HAL_I2C_TransactionSubmit(I2C_HandleTypeDef *hi2c, I2C_TRANSACTION *xfer)
+ * \brief Queues a transaction. The instance runs its queue back to back from
+ *        the I2C ISR, so a batch submitted together is served in one bus (and
+ *        sleep) wakeup. A transaction with both wr_len and rd_len is a register
+ *        read: the write phase ends without STOP and the read phase starts with
+ *        a repeated START. Callbacks run in interrupt context and may submit
+ *        again. Requires the instance in IRQ_MODE with the bus speed set.
+ *
+ * \param[in] I2C_HandleTypeDef *hi2c           I2C handle.
+ * \param[in] I2C_TRANSACTION *xfer             Transaction, must stay valid until the callback.
+ * \param[out] none
+ *
+ * \retval ARM_DRIVER_OK, ARM_DRIVER_ERROR_BUSY when the queue is full or a
+ *         blocking transfer owns the controller, ARM_DRIVER_ERROR_PARAMETER
+ *         or ARM_DRIVER_ERROR.
+ *******************************************************************/
+int32_t HAL_I2C_TransactionSubmit(I2C_HandleTypeDef *hi2c, I2C_TRANSACTION *xfer);
+
+/*!******************************************************************
+ * \fn int32_t HAL_I2C_ScheduleAdd(I2C_HandleTypeDef *hi2c, I2C_SCHEDULE *sched, uint32_t now)
+ * \brief Registers a periodic transaction, first due at now. Fill xfer,
+ *        period and slack before the call.
+ *
+ * \param[in] I2C_HandleTypeDef *hi2c           I2C handle.
+ * \param[in] I2C_SCHEDULE *sched               Schedule, must stay valid until removed.
+ * \param[in] uint32_t now                      Current time.
+ * \param[out] none
+ *
+ * \retval ARM_DRIVER_OK or ARM_DRIVER_ERROR_PARAMETER.
+ *******************************************************************/
+int32_t HAL_I2C_ScheduleAdd(I2C_HandleTypeDef *hi2c, I2C_SCHEDULE *sched, uint32_t now);
+
+/*!******************************************************************
+ * \fn void HAL_I2C_ScheduleRemove(I2C_HandleTypeDef *hi2c, I2C_SCHEDULE *sched)
+ * \brief Unregisters a periodic transaction. A read already queued still
+ *        completes, wait for its status before reusing the memory.
+ *
+ * \param[in] I2C_HandleTypeDef *hi2c           I2C handle.
+ * \param[in] I2C_SCHEDULE *sched               Schedule.
+ * \param[out] none
+ *
+ * \retval none
+ *******************************************************************/
+void HAL_I2C_ScheduleRemove(I2C_HandleTypeDef *hi2c, I2C_SCHEDULE *sched);
+
+/*!******************************************************************
+ * \fn uint32_t HAL_I2C_ScheduleRun(I2C_HandleTypeDef *hi2c, uint32_t now)
+ * \brief Submits the periodic transactions. Nothing runs until at least one
+ *        schedule is due; then every schedule due within its slack is
+ *        submitted in the same batch, so devices with close periods share a
+ *        single bus wakeup. Late schedules skip the missed periods instead of
+ *        bursting. Call it from one context, a task or a timer interrupt,
+ *        whenever the returned delay expires. It walks the list with
+ *        interrupts masked, as ScheduleAdd/Remove do around their update,
+ *        so those may be called from any task.
+ *
+ * \param[in] I2C_HandleTypeDef *hi2c           I2C handle.
+ * \param[in] uint32_t now                      Current time, any unit matching period/slack.
+ * \param[out] none
+ *
+ * \retval Time until the next schedule is due, I2C_SCHEDULE_IDLE if none.
+ *******************************************************************/
+uint32_t HAL_I2C_ScheduleRun(I2C_HandleTypeDef *hi2c, uint32_t now);
+
 /*!******************************************************************
  * \fn void I2C_IRQHandler(I2C_HandleTypeDef *i2c)
  * \brief I2C Event Interrupt handler.
@@ -159,6 +159,13 @@ static void I2C_ExitLowPowerStateRestore(void* pdata, slpManLpState state)
 
 #define I2C_POLLING_TIMEOUT_CYCLES       1000000
 
+// Transaction queue
+#define I2C_XFER_PHASE_WRITE             0
+#define I2C_XFER_PHASE_READ              1
+
+#define I2C_XFER_IER                     (I2C_IER_TRANSFER_DONE_Msk | I2C_IER_ARBITRATATION_LOST_Msk | \
+                                          I2C_IER_DETECT_STOP_Msk | I2C_IER_BUS_ERROR_Msk | I2C_IER_RX_NACK_Msk)
+
 /* Driver Version */
 static const ARM_DRIVER_VERSION DriverVersion =
 {
@@ -339,6 +346,87 @@ static void HAL_I2C_DmaTxEvent(uint32_t event, I2C_HandleTypeDef *i2c);
  *******************************************************************/
 static void HAL_I2C_DmaRxEvent(uint32_t event, I2C_HandleTypeDef *i2c);
 
+/*!******************************************************************
+ * \fn static int32_t I2C_Claim(I2C_HandleTypeDef *i2c)
+ * \brief Marks the controller busy for a blocking transfer, unless the
+ *        transaction queue or another transfer already owns it.
+ *
+ * \param[in]  I2C_HandleTypeDef *i2c           I2C handle.
+ * \param[out] none
+ *
+ * \retval ARM_DRIVER_OK or ARM_DRIVER_ERROR_BUSY.
+ *******************************************************************/
+static int32_t I2C_Claim(I2C_HandleTypeDef *i2c);
+
+/*!******************************************************************
+ * \fn static void I2C_XferFill(I2C_HandleTypeDef *i2c)
+ * \brief Moves write-phase bytes to the TX FIFO while it has room.
+ *
+ * \param[in]  I2C_HandleTypeDef *i2c           I2C handle.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void I2C_XferFill(I2C_HandleTypeDef *i2c);
+
+/*!******************************************************************
+ * \fn static void I2C_XferDrain(I2C_HandleTypeDef *i2c)
+ * \brief Moves read-phase bytes out of the RX FIFO.
+ *
+ * \param[in]  I2C_HandleTypeDef *i2c           I2C handle.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void I2C_XferDrain(I2C_HandleTypeDef *i2c);
+
+/*!******************************************************************
+ * \fn static void I2C_XferRead(I2C_HandleTypeDef *i2c, uint32_t start)
+ * \brief Issues the read phase of req[tail], always closed by STOP.
+ *
+ * \param[in]  I2C_HandleTypeDef *i2c           I2C handle.
+ * \param[in]  uint32_t start                   I2C_GENERATE_START_READ or I2C_GENERATE_RESTART_READ.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void I2C_XferRead(I2C_HandleTypeDef *i2c, uint32_t start);
+
+/*!******************************************************************
+ * \fn static void I2C_XferStart(I2C_HandleTypeDef *i2c)
+ * \brief Issues the first phase of req[tail].
+ *
+ * \param[in]  I2C_HandleTypeDef *i2c           I2C handle.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void I2C_XferStart(I2C_HandleTypeDef *i2c);
+
+/*!******************************************************************
+ * \fn static void I2C_XferFinish(I2C_HandleTypeDef *i2c, int32_t status)
+ * \brief Completes req[tail], starts the next transaction and then calls
+ *        the callback.
+ *
+ * \param[in]  I2C_HandleTypeDef *i2c           I2C handle.
+ * \param[in]  int32_t status                   Transaction result.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void I2C_XferFinish(I2C_HandleTypeDef *i2c, int32_t status);
+
+/*!******************************************************************
+ * \fn static void I2C_XferIRQn(I2C_HandleTypeDef *i2c)
+ * \brief I2C interrupt while the transaction queue owns the controller.
+ *
+ * \param[in]  I2C_HandleTypeDef *i2c           I2C handle.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void I2C_XferIRQn(I2C_HandleTypeDef *i2c);
+
 /* ---------------------------------------------------------------------------------------*/
 
 
@@ -498,6 +586,19 @@ int32_t HAL_I2C_PowerControl(ARM_POWER_STATE state, I2C_HandleTypeDef *i2c) {
             }
             // Disable I2C and other control bits
             i2c->reg->MCR = 0;
+            i2c->reg->IER = 0;
+
+            // Drop queued transactions, no callback
+            while(i2c->ctrl->xq.tail != i2c->ctrl->xq.head) {
+                i2c->ctrl->xq.req[i2c->ctrl->xq.tail & (I2C_XFER_QUEUE_DEPTH - 1)]->status = ARM_DRIVER_ERROR;
+                i2c->ctrl->xq.tail++;
+            }
+
+#ifdef PM_FEATURE_ENABLE
+            if(i2c->ctrl->xq.active)
+                CHECK_TO_UNLOCK_SLEEP(instance);
+#endif
+            i2c->ctrl->xq.active = 0;
 
             // Disable I2C power
             GPR_ClockDisable(g_i2cClocks[instance*2]);
@@ -547,6 +648,23 @@ int32_t HAL_I2C_PowerControl(ARM_POWER_STATE state, I2C_HandleTypeDef *i2c) {
     return ARM_DRIVER_OK;
 }
 
+static int32_t I2C_Claim(I2C_HandleTypeDef *i2c) {
+    int32_t ret = ARM_DRIVER_ERROR_BUSY;
+    uint32_t mask;
+
+    // TransactionSubmit may run from an interrupt
+    mask = SaveAndSetIRQMask();
+
+    if(!i2c->ctrl->xq.active && !i2c->ctrl->status.busy) {
+        i2c->ctrl->status.busy = 1;
+        ret = ARM_DRIVER_OK;
+    }
+
+    RestoreIRQMask(mask);
+
+    return ret;
+}
+
 static int32_t HAL_I2C_MasterCheckStatus(I2C_HandleTypeDef *i2c) {
     int32_t ret = ARM_DRIVER_OK;
 
@@ -585,6 +703,10 @@ int32_t HAL_I2C_MasterTransmit_IT(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_
     if(!(hi2c->ctrl->flags & I2C_FLAG_SETUP))
         return ARM_DRIVER_ERROR;
 
+    // The transaction queue or another transfer owns the controller
+    if(I2C_Claim(hi2c) != ARM_DRIVER_OK)
+        return ARM_DRIVER_ERROR_BUSY;
+
     // Enable interrupts to reflect specific status
     hi2c->reg->IER = (I2C_IER_TRANSFER_DONE_Msk |
                      I2C_IER_ARBITRATATION_LOST_Msk |
@@ -638,11 +760,15 @@ int32_t HAL_I2C_MasterTransmit_IT(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_
     return ARM_DRIVER_OK;
 }
 
-void HAL_I2C_MasterTransmit_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, const uint8_t *pTxData, uint32_t size) {
+int32_t HAL_I2C_MasterTransmit_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, const uint8_t *pTxData, uint32_t size) {
     uint32_t reg_value;
     int32_t ret = 0;
     uint32_t i = 0;
 
+    // The transaction queue or another transfer owns the controller
+    if(I2C_Claim(hi2c) != ARM_DRIVER_OK)
+        return ARM_DRIVER_ERROR_BUSY;
+
     // Config and issue command
     hi2c->reg->MCR = (I2C_MCR_CONTROL_MODE_Msk | I2C_MCR_I2C_EN_Msk);
     
@@ -658,7 +784,8 @@ void HAL_I2C_MasterTransmit_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, cons
         } while(((hi2c->reg->FSR & I2C_FSR_TX_FIFO_FREE_NUM_Msk) == 0) && (ret == ARM_DRIVER_OK));
         
         if(ret != ARM_DRIVER_OK) {
-            return;
+            hi2c->ctrl->status.busy = 0;
+            return ARM_DRIVER_ERROR;
         }
 
         hi2c->reg->TDR = pTxData[i];
@@ -671,7 +798,8 @@ void HAL_I2C_MasterTransmit_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, cons
     } while((QCOM_FLD2VAL(I2C_FSR_TX_FIFO_FREE_NUM, hi2c->reg->FSR) != 0x10) && (ret == ARM_DRIVER_OK));
 
     if(ret != ARM_DRIVER_OK) {
-        return;
+        hi2c->ctrl->status.busy = 0;
+        return ARM_DRIVER_ERROR;
     }
 
     while((hi2c->reg->ISR & I2C_ISR_DETECT_STOP_Msk) == 0);
@@ -680,6 +808,7 @@ void HAL_I2C_MasterTransmit_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, cons
     hi2c->reg->IER = 0;
     hi2c->ctrl->status.busy = 0;
 
+    return ARM_DRIVER_OK;
 }
 #if 0 //not implemented yet
 int32_t HAL_I2C_MasterReceive_DMA(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_t *pRxData, uint32_t size)  {
@@ -759,6 +888,10 @@ int32_t HAL_I2C_MasterReceive_IT(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_t
     if(!(hi2c->ctrl->flags & I2C_FLAG_SETUP))
         return ARM_DRIVER_ERROR;
 
+    // The transaction queue or another transfer owns the controller
+    if(I2C_Claim(hi2c) != ARM_DRIVER_OK)
+        return ARM_DRIVER_ERROR_BUSY;
+
     // Enable interrupts to reflect specific status
     hi2c->reg->IER = (I2C_IER_TRANSFER_DONE_Msk |
                      I2C_IER_ARBITRATATION_LOST_Msk |
@@ -791,10 +924,14 @@ int32_t HAL_I2C_MasterReceive_IT(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_t
     return ARM_DRIVER_OK;
 }
 
-void HAL_I2C_MasterReceive_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_t *pRxData, uint32_t size) {
+int32_t HAL_I2C_MasterReceive_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8_t *pRxData, uint32_t size) {
     uint32_t i = 0;
     uint32_t reg_value;
-    int32_t ret;
+    int32_t ret = ARM_DRIVER_OK;
+
+    // The transaction queue or another transfer owns the controller
+    if(I2C_Claim(hi2c) != ARM_DRIVER_OK)
+        return ARM_DRIVER_ERROR_BUSY;
 
     // Clear all flags first(W1C)
     hi2c->reg->ISR = hi2c->reg->ISR;
@@ -811,10 +948,290 @@ void HAL_I2C_MasterReceive_Polling(I2C_HandleTypeDef *hi2c, uint32_t addr, uint8
             ret = HAL_I2C_MasterCheckStatus(hi2c);
         } while(((hi2c->reg->FSR & I2C_FSR_RX_FIFO_DATA_NUM_Msk) == 0) && (ret == ARM_DRIVER_OK));
 
+        if(ret != ARM_DRIVER_OK) {
+            hi2c->ctrl->status.busy = 0;
+            return ARM_DRIVER_ERROR;
+        }
+
         pRxData[i] = hi2c->reg->RDR;
         i++;
     }
-    
+
+    hi2c->ctrl->status.busy = 0;
+
+    return ARM_DRIVER_OK;
+}
+
+static void I2C_XferFill(I2C_HandleTypeDef *i2c) {
+    I2C_XFER_QUEUE *xq = &i2c->ctrl->xq;
+    const I2C_TRANSACTION *xfer = xq->req[xq->tail & (I2C_XFER_QUEUE_DEPTH - 1)];
+
+    while((xq->cnt < xfer->wr_len) && (i2c->reg->FSR & I2C_FSR_TX_FIFO_FREE_NUM_Msk))
+        i2c->reg->TDR = xfer->wr_buf[xq->cnt++];
+
+    if(xq->cnt == xfer->wr_len)
+        i2c->reg->IER &= ~I2C_IER_TX_FIFO_EMPTY_Msk;
+}
+
+static void I2C_XferDrain(I2C_HandleTypeDef *i2c) {
+    I2C_XFER_QUEUE *xq = &i2c->ctrl->xq;
+    const I2C_TRANSACTION *xfer = xq->req[xq->tail & (I2C_XFER_QUEUE_DEPTH - 1)];
+    uint8_t data;
+
+    while(i2c->reg->FSR & I2C_FSR_RX_FIFO_DATA_NUM_Msk) {
+        data = i2c->reg->RDR;
+
+        if((xq->cnt < xfer->rd_len) && xfer->rd_buf)
+            xfer->rd_buf[xq->cnt] = data;
+
+        xq->cnt++;
+    }
+}
+
+static void I2C_XferRead(I2C_HandleTypeDef *i2c, uint32_t start) {
+    I2C_XFER_QUEUE *xq = &i2c->ctrl->xq;
+    const I2C_TRANSACTION *xfer = xq->req[xq->tail & (I2C_XFER_QUEUE_DEPTH - 1)];
+
+    xq->phase = I2C_XFER_PHASE_READ;
+    xq->cnt   = 0;
+
+    i2c->ctrl->status.direction = 1;
+
+    // RX FIFO full stretches SCL until the ISR drains it
+    i2c->reg->IER = (I2C_XFER_IER | I2C_IER_RX_FIFO_FULL_Msk);
+    i2c->reg->SCR = (((xfer->addr << 1) & I2C_SCR_TARGET_SLAVE_ADDR_Msk) | ((xfer->rd_len - 1) << I2C_SCR_BYTE_NUM_Pos) |
+                     start | I2C_GENERATE_STOP);
+}
+
+static void I2C_XferStart(I2C_HandleTypeDef *i2c) {
+    I2C_XFER_QUEUE *xq = &i2c->ctrl->xq;
+    const I2C_TRANSACTION *xfer = xq->req[xq->tail & (I2C_XFER_QUEUE_DEPTH - 1)];
+
+    i2c->reg->IER = 0;
+
+    // Clear all flags first(W1C)
+    i2c->reg->ISR = i2c->reg->ISR;
+    i2c->reg->SCR = (I2C_SCR_FLUSH_TX_FIFO_Msk | I2C_SCR_FLUSH_RX_FIFO_Msk);
+    i2c->reg->MCR = (I2C_MCR_CONTROL_MODE_Msk | I2C_MCR_I2C_EN_Msk);
+
+    if(xfer->wr_len == 0) {
+        I2C_XferRead(i2c, I2C_GENERATE_START_READ);
+        return;
+    }
+
+    xq->phase = I2C_XFER_PHASE_WRITE;
+    xq->cnt   = 0;
+
+    i2c->ctrl->status.direction = 0;
+
+    // No STOP when a read follows, the read phase starts with a repeated START
+    i2c->reg->IER = (I2C_XFER_IER | I2C_IER_TX_FIFO_EMPTY_Msk);
+    i2c->reg->SCR = (((xfer->addr << 1) & I2C_SCR_TARGET_SLAVE_ADDR_Msk) | ((xfer->wr_len - 1) << I2C_SCR_BYTE_NUM_Pos) |
+                     I2C_GENERATE_START_WRITE | (xfer->rd_len ? I2C_NO_STARTSTOP : I2C_GENERATE_STOP));
+
+    I2C_XferFill(i2c);
+}
+
+static void I2C_XferFinish(I2C_HandleTypeDef *i2c, int32_t status) {
+#ifdef PM_FEATURE_ENABLE
+    uint32_t instance = HAL_I2C_GetInstanceNumber(i2c);
+#endif
+    I2C_XFER_QUEUE *xq = &i2c->ctrl->xq;
+    I2C_TRANSACTION *xfer = xq->req[xq->tail & (I2C_XFER_QUEUE_DEPTH - 1)];
+
+    i2c->reg->IER = 0;
+
+    xfer->status = status;
+    xq->tail++;
+
+    // Next transaction goes on the bus before the callback runs
+    if(xq->head != xq->tail) {
+        I2C_XferStart(i2c);
+    } else {
+        xq->active = 0;
+        i2c->ctrl->status.busy = 0;
+
+#ifdef PM_FEATURE_ENABLE
+        CHECK_TO_UNLOCK_SLEEP(instance);
+#endif
+    }
+
+    if(xfer->callback)
+        xfer->callback(xfer, xfer->arg);
+}
+
+static void I2C_XferIRQn(I2C_HandleTypeDef *i2c) {
+    I2C_XFER_QUEUE *xq = &i2c->ctrl->xq;
+    const I2C_TRANSACTION *xfer = xq->req[xq->tail & (I2C_XFER_QUEUE_DEPTH - 1)];
+    uint32_t isr_reg = i2c->reg->ISR;
+
+    i2c->reg->ISR = isr_reg;
+
+    if(isr_reg & (I2C_ISR_ARBITRATATION_LOST_Msk | I2C_ISR_BUS_ERROR_Msk | I2C_ISR_RX_NACK_Msk)) {
+        if(isr_reg & I2C_ISR_ARBITRATATION_LOST_Msk)
+            i2c->ctrl->status.arbitration_lost = 1;
+
+        if(isr_reg & I2C_ISR_BUS_ERROR_Msk)
+            i2c->ctrl->status.bus_error = 1;
+
+        if(isr_reg & I2C_ISR_RX_NACK_Msk)
+            i2c->ctrl->status.rx_nack = 1;
+
+        i2c->reg->SCR |= (I2C_SCR_FLUSH_TX_FIFO_Msk | I2C_SCR_FLUSH_RX_FIFO_Msk);
+
+        I2C_XferFinish(i2c, ARM_DRIVER_ERROR);
+        return;
+    }
+
+    if(xq->phase == I2C_XFER_PHASE_WRITE) {
+        I2C_XferFill(i2c);
+
+        // Register address sent, turn the bus around without releasing it
+        if((isr_reg & I2C_ISR_TRANSFER_DONE_Msk) && xfer->rd_len) {
+            I2C_XferRead(i2c, I2C_GENERATE_RESTART_READ);
+            return;
+        }
+    } else {
+        I2C_XferDrain(i2c);
+    }
+
+    if(isr_reg & I2C_ISR_DETECT_STOP_Msk)
+        I2C_XferFinish(i2c, ((xq->phase == I2C_XFER_PHASE_READ) && (xq->cnt < xfer->rd_len)) ? ARM_DRIVER_ERROR : ARM_DRIVER_OK);
+}
+
+int32_t HAL_I2C_TransactionSubmit(I2C_HandleTypeDef *hi2c, I2C_TRANSACTION *xfer) {
+#ifdef PM_FEATURE_ENABLE
+    uint32_t instance = HAL_I2C_GetInstanceNumber(hi2c);
+#endif
+    I2C_XFER_QUEUE *xq = &hi2c->ctrl->xq;
+    uint32_t mask;
+
+    if(!xfer || (xfer->addr > 0x7f) || ((xfer->wr_len == 0) && (xfer->rd_len == 0)) ||
+       (xfer->wr_len > I2C_XFER_MAX_SIZE) || (xfer->rd_len > I2C_XFER_MAX_SIZE) || (xfer->wr_len && !xfer->wr_buf))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    if(!hi2c->irq || !(hi2c->ctrl->flags & I2C_FLAG_SETUP))
+        return ARM_DRIVER_ERROR;
+
+    mask = SaveAndSetIRQMask();
+
+    // A blocking transfer owns the controller until it clears busy
+    if((!xq->active && hi2c->ctrl->status.busy) || ((uint8_t)(xq->head - xq->tail) >= I2C_XFER_QUEUE_DEPTH)) {
+        RestoreIRQMask(mask);
+        return ARM_DRIVER_ERROR_BUSY;
+    }
+
+    xfer->status = ARM_DRIVER_ERROR_BUSY;
+    xq->req[xq->head & (I2C_XFER_QUEUE_DEPTH - 1)] = xfer;
+    xq->head++;
+
+    if(!xq->active) {
+        xq->active = 1;
+
+        hi2c->ctrl->status.busy             = 1;
+        hi2c->ctrl->status.mode             = 1;
+        hi2c->ctrl->status.arbitration_lost = 0;
+        hi2c->ctrl->status.bus_error        = 0;
+        hi2c->ctrl->status.rx_nack          = 0;
+
+#ifdef PM_FEATURE_ENABLE
+        LOCK_SLEEP(instance);
+#endif
+
+        I2C_XferStart(hi2c);
+    }
+
+    RestoreIRQMask(mask);
+
+    return ARM_DRIVER_OK;
+}
+
+int32_t HAL_I2C_ScheduleAdd(I2C_HandleTypeDef *hi2c, I2C_SCHEDULE *sched, uint32_t now) {
+    I2C_SCHEDULE *it;
+    uint32_t mask;
+
+    if(!sched || (sched->period == 0) || (sched->slack >= sched->period))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    // ScheduleRun may walk the list from a timer interrupt
+    mask = SaveAndSetIRQMask();
+
+    for(it = hi2c->ctrl->sched; it; it = it->next) {
+        if(it == sched) {
+            RestoreIRQMask(mask);
+            return ARM_DRIVER_ERROR_PARAMETER;
+        }
+    }
+
+    sched->due         = now;
+    sched->overruns    = 0;
+    sched->xfer.status = ARM_DRIVER_OK;
+    sched->next        = hi2c->ctrl->sched;
+
+    hi2c->ctrl->sched = sched;
+
+    RestoreIRQMask(mask);
+
+    return ARM_DRIVER_OK;
+}
+
+void HAL_I2C_ScheduleRemove(I2C_HandleTypeDef *hi2c, I2C_SCHEDULE *sched) {
+    I2C_SCHEDULE **it;
+    uint32_t mask;
+
+    mask = SaveAndSetIRQMask();
+
+    for(it = &hi2c->ctrl->sched; *it; it = &(*it)->next) {
+        if(*it == sched) {
+            *it = sched->next;
+            sched->next = NULL;
+            break;
+        }
+    }
+
+    RestoreIRQMask(mask);
+}
+
+uint32_t HAL_I2C_ScheduleRun(I2C_HandleTypeDef *hi2c, uint32_t now) {
+    I2C_SCHEDULE *it;
+    uint32_t wait = I2C_SCHEDULE_IDLE;
+    uint32_t mask;
+    bool due = false;
+
+    // ScheduleAdd/Remove may edit the list from another task, TransactionSubmit nests the mask
+    mask = SaveAndSetIRQMask();
+
+    for(it = hi2c->ctrl->sched; it; it = it->next) {
+        if((int32_t)(it->due - now) <= 0) {
+            due = true;
+            break;
+        }
+    }
+
+    for(it = hi2c->ctrl->sched; it; it = it->next) {
+        if(due && ((int32_t)(it->due - now) <= (int32_t)it->slack)) {
+            // Previous read still on the queue, this period is lost
+            if((it->xfer.status == ARM_DRIVER_ERROR_BUSY) || (HAL_I2C_TransactionSubmit(hi2c, &it->xfer) != ARM_DRIVER_OK))
+                it->overruns++;
+
+            it->due += it->period;
+
+            // Came back late, skip the missed periods instead of catching up
+            if((int32_t)(it->due - now) <= 0) {
+                it->overruns += (now - it->due) / it->period + 1;
+                it->due = now + it->period;
+            }
+        }
+
+        if((int32_t)(it->due - now) <= 0)
+            wait = 0;
+        else
+            wait = MIN(wait, it->due - now);
+    }
+
+    RestoreIRQMask(mask);
+
+    return wait;
 }
 
 static int32_t HAL_I2C_GetClockFreq(I2C_HandleTypeDef *i2c) {
@@ -917,6 +1334,11 @@ int32_t HAL_I2C_Control(uint32_t control, uint32_t arg, I2C_HandleTypeDef *i2c)
 void I2C_IRQHandler(I2C_HandleTypeDef *i2c) {
     uint32_t tmp_status = 0;
 
+    if(i2c->ctrl->xq.active) {
+        I2C_XferIRQn(i2c);
+        return;
+    }
+
     tmp_status = i2c->reg->ISR;
 
     //i2c->reg->ISR = tmp_status;
@@ -53,6 +53,30 @@
 #define SPI_FLAG_DATA_LOST            (1UL << 3)     // SPI data lost occurred
 #define SPI_FLAG_MODE_FAULT           (1UL << 4)     // SPI mode fault occurred
 
+// Queued transactions (HAL_SPI_TransactionSubmit), DMA_MODE only
+#ifndef SPI_XFER_QUEUE_DEPTH
+#define SPI_XFER_QUEUE_DEPTH          4              // Transactions pending per instance, power of two
+#endif
+
+#if (SPI_XFER_QUEUE_DEPTH & (SPI_XFER_QUEUE_DEPTH - 1)) != 0 || (SPI_XFER_QUEUE_DEPTH > 128)
+#error "SPI_XFER_QUEUE_DEPTH must be a power of two up to 128!"
+#endif
+
+#ifndef SPI_XFER_MAX_SEGMENTS
+#define SPI_XFER_MAX_SEGMENTS         8              // Segments per transaction (one TX descriptor each)
+#endif
+
+#ifndef SPI_XFER_RX_DESC_NUM
+#define SPI_XFER_RX_DESC_NUM          32             // RX chunk descriptors, a pass moves up to 4 frames each
+#endif
+
+#define SPI_XFER_CHUNK_SIZE           8              // RX FIFO trigger level (4 frames) of up to 2 bytes
+#define SPI_XFER_DESC_NUM             (SPI_XFER_MAX_SEGMENTS + SPI_XFER_RX_DESC_NUM)
+
+// Transaction flags
+#define SPI_XFER_CS_ACTIVE_HIGH       (1U << 0)      // Chip select asserted high (default low)
+#define SPI_XFER_CS_KEEP              (1U << 1)      // Leave chip select asserted: the next transaction on the pin takes it over, one on another pin releases it first
+
 /* Typedefs  ------------------------------------------------------------------*/
 
 typedef enum {
@@ -76,6 +100,7 @@ typedef struct _SPI_DMA {
   uint8_t               rx_req;                                 // Receive DMA request number
   void                  (*rx_callback)(uint32_t event);         // Receive callback
   dma_descriptor_t      *descriptor;                            // Rx descriptor
+  dma_descriptor_t      *xfer_desc;                             // Transaction queue TX/RX descriptor chains (SPI_XFER_DESC_NUM)
 } SPI_DMA;
 
 // SPI PINS
@@ -103,6 +128,60 @@ typedef struct _SPI_TRANSFER_INFO {
   uint16_t              def_val;        // Default transfer value
 } SPI_TRANSFER_INFO;
 
+// One piece of a transaction, full duplex on size frames
+typedef struct _SPI_SEGMENT {
+  const uint8_t        *tx_buf;         // Frames to send, NULL sends the default TX value
+  uint8_t              *rx_buf;         // Frames received, NULL discards them
+  uint16_t              size;           // Number of frames
+} SPI_SEGMENT;
+
+struct _SPI_TRANSACTION;
+
+// Transaction completion: called from the DMA ISR after chip select is released
+typedef void (*SPI_XferCallback_t)(struct _SPI_TRANSACTION *xfer, void *arg);
+
+// Chip-select framed sequence of segments, owned by the driver until the callback
+typedef struct _SPI_TRANSACTION {
+  const SPI_SEGMENT    *seg;            // Segment array
+  uint8_t               count;          // Number of segments, up to SPI_XFER_MAX_SEGMENTS
+  int8_t                cs_port;        // Chip select GPIO port, -1 when not driven by the queue
+  uint8_t               cs_pin;         // Chip select GPIO pin index
+  uint8_t               flags;          // SPI_XFER_xxx
+  SPI_XferCallback_t    callback;       // Completion callback, may be NULL
+  void                 *arg;            // Callback argument
+  volatile int32_t      status;         // ARM_DRIVER_ERROR_BUSY while queued, then the result
+} SPI_TRANSACTION;
+
+// Position inside the running transaction
+typedef struct _SPI_XFER_POS {
+  uint8_t               seg;            // Segment index
+  uint16_t              off;            // Frame offset inside the segment
+} SPI_XFER_POS;
+
+// RX chunk that crosses a segment boundary, scattered by the CPU at the end of the pass
+typedef struct _SPI_XFER_SPLIT {
+  SPI_XFER_POS          pos;            // Transaction position of the first frame
+  uint32_t              data[SPI_XFER_CHUNK_SIZE / 4];          // DMA target, word aligned
+} SPI_XFER_SPLIT;
+
+// Transaction queue run-time state
+typedef struct _SPI_XFER_QUEUE {
+  SPI_TRANSACTION      *req[SPI_XFER_QUEUE_DEPTH];              // Pending transactions, req[tail] is running
+  SPI_XFER_POS          pos;            // Start of the running pass
+  uint32_t              left;           // Frames of req[tail] not yet moved
+  uint32_t              pass;           // Frames in the running pass
+  uint8_t               splits;         // Entries of split[] used by the running pass
+  SPI_XFER_SPLIT        split[SPI_XFER_MAX_SEGMENTS];
+  uint32_t              discard[SPI_XFER_CHUNK_SIZE / 4];       // Target of chunks received into NULL rx_buf
+  volatile uint8_t      head;           // Free running enqueue count
+  volatile uint8_t      tail;           // Free running completion count
+  volatile uint8_t      active;         // Queue owns the DMA channels
+  uint8_t               kept;           // Chip select below left asserted by SPI_XFER_CS_KEEP
+  int8_t                kept_port;
+  uint8_t               kept_pin;
+  uint8_t               kept_flags;
+} SPI_XFER_QUEUE;
+
 // SPI information (Run-time)
 typedef struct _SPI_INFO {
     ARM_SPI_SignalEvent_t cb_event;     // event callback
@@ -113,6 +192,7 @@ typedef struct _SPI_INFO {
     uint32_t              bus_speed;    // SPI bus speed
     uint8_t               data_width;   // SPI data bits select in unit of byte
     SPI_TransferTypeDef   transfer_type;
+    SPI_XFER_QUEUE        xq;           // Queued transactions
 } SPI_INFO;
 
 
@@ -328,6 +408,37 @@ int32_t HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *spi, uint8_t *pTxData, uint16_t
  *******************************************************************/
 int32_t HAL_SPI_Receive_DMA(SPI_HandleTypeDef *spi, uint8_t *pRxData, uint16_t size);
 
+/*!******************************************************************
+ * \fn int32_t HAL_SPI_TransactionSubmit(SPI_HandleTypeDef *spi, SPI_TRANSACTION *xfer)
+ * \brief Queues a transaction. Each instance runs its queue back to back from
+ *        the DMA ISR: the chip select of the next transaction is asserted as
+ *        soon as the previous one is released, and all segments of a
+ *        transaction are chained TX/RX descriptors, so the bus keeps clocking
+ *        across segment boundaries without the CPU. Transactions longer than
+ *        SPI_XFER_RX_DESC_NUM * 4 frames are split in passes, re-armed from the
+ *        ISR. Callbacks run in interrupt context and may submit again.
+ *        Requires the instance in DMA_MODE and configured as master.
+ *
+ * \param[in]  SPI_HandleTypeDef *spi     spi handle.
+ * \param[in]  SPI_TRANSACTION *xfer      Transaction, must stay valid until the callback.
+ * \param[out] none
+ *
+ * \retval ARM_DRIVER_OK, ARM_DRIVER_ERROR_BUSY when the queue is full or a
+ *         single transfer is running, ARM_DRIVER_ERROR_PARAMETER.
+ *******************************************************************/
+int32_t HAL_SPI_TransactionSubmit(SPI_HandleTypeDef *spi, SPI_TRANSACTION *xfer);
+
+/*!******************************************************************
+ * \fn uint32_t HAL_SPI_TransactionPending(SPI_HandleTypeDef *spi)
+ * \brief Number of transactions queued, including the running one.
+ *
+ * \param[in]  SPI_HandleTypeDef *spi     spi handle.
+ * \param[out] none
+ *
+ * \retval Pending transactions.
+ *******************************************************************/
+uint32_t HAL_SPI_TransactionPending(SPI_HandleTypeDef *spi);
+
 /*!******************************************************************
  * \fn int32_t HAL_SPI_TransmitReceive_IT(SPI_HandleTypeDef *spi, uint8_t *pTxData, uint8_t *pRxData, uint16_t size)
  * \brief SPI transmit/receive in IRQn mode.
@@ -23,6 +23,11 @@
 
 #define SPI_RX_FIFO_TRIG_LVL      (4)
 
+// Spins for the frames below the trigger level at the end of a pass, far above a few frames at the slowest clock
+#define SPI_XFER_TAIL_SPINS       (100000)
+
+extern void DMA_ChannelLoadDescriptorAndRun(uint32_t channel, void* descriptorAddress);
+
 #define ARM_SPI_DRV_VERSION    ARM_DRIVER_VERSION_MAJOR_MINOR(2, 0) // driver version
 
 #if ((!RTE_SPI0) && (!RTE_SPI1))
@@ -191,6 +196,7 @@ static PIN SPI0_pin_miso  = {RTE_SPI0_MISO_PAD_ID,   RTE_SPI0_MISO_FUNC};
 #if (RTE_SPI0_IO_MODE == DMA_MODE)
 
 static dma_descriptor_t __ALIGNED(16) SPI0_DMA_RxDescriptor;
+static dma_descriptor_t __ALIGNED(16) SPI0_DMA_XferDescriptor[SPI_XFER_DESC_NUM];
 
 static SPI_DMA SPI0_DMA = {
                             -1,
@@ -199,7 +205,8 @@ static SPI_DMA SPI0_DMA = {
                             -1,
                             RTE_SPI0_DMA_RX_REQID,
                             HAL_SPI0_DmaRxEvent,
-                            &SPI0_DMA_RxDescriptor
+                            &SPI0_DMA_RxDescriptor,
+                            SPI0_DMA_XferDescriptor
                           };
 #endif
 
@@ -245,6 +252,7 @@ static PIN SPI1_pin_miso  = {RTE_SPI1_MISO_PAD_ID,   RTE_SPI1_MISO_FUNC};
 #if (RTE_SPI1_IO_MODE == DMA_MODE)
 
 static dma_descriptor_t __ALIGNED(16) SPI1_DMA_RxDescriptor;
+static dma_descriptor_t __ALIGNED(16) SPI1_DMA_XferDescriptor[SPI_XFER_DESC_NUM];
 
 static SPI_DMA SPI1_DMA = {
                             -1,
@@ -253,7 +261,8 @@ static SPI_DMA SPI1_DMA = {
                             -1,
                             RTE_SPI1_DMA_RX_REQID,
                             HAL_SPI1_DmaRxEvent,
-                            &SPI1_DMA_RxDescriptor
+                            &SPI1_DMA_RxDescriptor,
+                            SPI1_DMA_XferDescriptor
                           };
 #endif
 
@@ -414,6 +423,137 @@ static void SPI_Write1ByteFifo(SPI_HandleTypeDef *spi);
  *******************************************************************/
 static void SPI_ClearPendingIrq(SPI_HandleTypeDef *spi);
 
+/*!******************************************************************
+ * \fn static void SPI_XferAdvance(const SPI_TRANSACTION *xfer, SPI_XFER_POS *pos, uint32_t frames)
+ * \brief Moves a transaction position forward, across segment boundaries.
+ *
+ * \param[in] const SPI_TRANSACTION *xfer      Transaction.
+ * \param[in] uint32_t frames                  Frames to skip.
+ * \param[inout] SPI_XFER_POS *pos             Position to move.
+ *
+ * \retval none
+ *******************************************************************/
+static void SPI_XferAdvance(const SPI_TRANSACTION *xfer, SPI_XFER_POS *pos, uint32_t frames);
+
+/*!******************************************************************
+ * \fn static void SPI_XferScatter(SPI_HandleTypeDef *spi, const SPI_TRANSACTION *xfer, SPI_XFER_POS pos, const uint8_t *src, uint32_t frames)
+ * \brief Copies received frames to the rx_buf of the segments they belong to,
+ *        frames of segments without rx_buf are dropped.
+ *
+ * \param[in] SPI_HandleTypeDef *spi        SPI handle.
+ * \param[in] const SPI_TRANSACTION *xfer   Transaction.
+ * \param[in] SPI_XFER_POS pos              Position of the first frame.
+ * \param[in] const uint8_t *src            Received frames.
+ * \param[in] uint32_t frames               Number of frames.
+ * \param[out] none
+ *
+ * \retval none
+ *******************************************************************/
+static void SPI_XferScatter(SPI_HandleTypeDef *spi, const SPI_TRANSACTION *xfer, SPI_XFER_POS pos, const uint8_t *src, uint32_t frames);
+
+/*!******************************************************************
+ * \fn static void SPI_XferChipSelect(const SPI_TRANSACTION *xfer, bool assert)
+ * \brief Drives the transaction chip select.
+ *
+ * \param[in] const SPI_TRANSACTION *xfer   Transaction.
+ * \param[in] bool assert                   true to select the device.
+ * \param[out] none
+ *
+ * \retval none
+ *******************************************************************/
+static void SPI_XferChipSelect(const SPI_TRANSACTION *xfer, bool assert);
+
+/*!******************************************************************
+ * \fn static void SPI_XferKeptRelease(SPI_XFER_QUEUE *xq)
+ * \brief Releases the chip select left asserted by SPI_XFER_CS_KEEP, if any.
+ *
+ * \param[in] SPI_XFER_QUEUE *xq             Transaction queue.
+ * \param[out] none
+ *
+ * \retval none
+ *******************************************************************/
+static void SPI_XferKeptRelease(SPI_XFER_QUEUE *xq);
+
+/*!******************************************************************
+ * \fn static void SPI_XferBuildPass(SPI_HandleTypeDef *spi)
+ * \brief Builds and starts the descriptor chains of the next pass of the
+ *        running transaction. TX gets one descriptor per segment, RX one per
+ *        RX FIFO trigger level (the DMA burst is larger than the trigger level,
+ *        see SPI_DMARxConfig), chained without stops so no CPU is needed until
+ *        the pass ends. RX chunks crossing a segment boundary land in a split
+ *        buffer and frames after the last full chunk are read by the CPU, both
+ *        are scattered in SPI_XferPassDone.
+ *
+ * \param[in] SPI_HandleTypeDef *spi        SPI handle.
+ * \param[out] none
+ *
+ * \retval none
+ *******************************************************************/
+static void SPI_XferBuildPass(SPI_HandleTypeDef *spi);
+
+/*!******************************************************************
+ * \fn static void SPI_XferStart(SPI_HandleTypeDef *spi)
+ * \brief Asserts the chip select of req[tail] and starts its first pass.
+ *
+ * \param[in] SPI_HandleTypeDef *spi        SPI handle.
+ * \param[out] none
+ *
+ * \retval none
+ *******************************************************************/
+static void SPI_XferStart(SPI_HandleTypeDef *spi);
+
+/*!******************************************************************
+ * \fn static void SPI_XferFinish(SPI_HandleTypeDef *spi, int32_t status)
+ * \brief Completes req[tail]: releases the chip select, starts the next
+ *        transaction and then calls the callback.
+ *
+ * \param[in] SPI_HandleTypeDef *spi        SPI handle.
+ * \param[in] int32_t status                Transaction result.
+ * \param[out] none
+ *
+ * \retval none
+ *******************************************************************/
+static void SPI_XferFinish(SPI_HandleTypeDef *spi, int32_t status);
+
+/*!******************************************************************
+ * \fn static void SPI_XferPassDone(SPI_HandleTypeDef *spi)
+ * \brief End of pass: scatters split chunks, reads the frames below the
+ *        trigger level and either starts the next pass or finishes. If
+ *        those frames do not arrive within SPI_XFER_TAIL_SPINS the
+ *        transaction fails with ARM_DRIVER_ERROR_TIMEOUT.
+ *
+ * \param[in] SPI_HandleTypeDef *spi        SPI handle.
+ * \param[out] none
+ *
+ * \retval none
+ *******************************************************************/
+static void SPI_XferPassDone(SPI_HandleTypeDef *spi);
+
+/*!******************************************************************
+ * \fn static void SPI_XferDmaEvent(uint32_t event, SPI_HandleTypeDef *spi)
+ * \brief TX/RX DMA events while the transaction queue owns the channels.
+ *
+ * \param[in] uint32_t event                DMA event.
+ * \param[in] SPI_HandleTypeDef *spi        SPI handle.
+ * \param[out] none
+ *
+ * \retval none
+ *******************************************************************/
+static void SPI_XferDmaEvent(uint32_t event, SPI_HandleTypeDef *spi);
+
+/*!******************************************************************
+ * \fn static void SPI_XferFlush(SPI_HandleTypeDef *spi)
+ * \brief Drops every queued transaction (status ARM_DRIVER_ERROR, no
+ *        callback) and releases a kept chip select, used on abort and
+ *        power off.
+ *
+ * \param[in] SPI_HandleTypeDef *spi        SPI handle.
+ * \param[out] none
+ *
+ * \retval none
+ *******************************************************************/
+static void SPI_XferFlush(SPI_HandleTypeDef *spi);
+
 /* ---------------------------------------------------------------------------------------*/
 
 static uint32_t HAL_SPI_GetInstanceNumber(SPI_HandleTypeDef *spi) {
@@ -653,6 +793,8 @@ int32_t HAL_SPI_PowerControl(ARM_POWER_STATE state, SPI_HandleTypeDef *spi) {
             if(spi->dma) {
                 DMA_StopChannel(spi->dma->tx_ch, true);
                 DMA_StopChannel(spi->dma->rx_ch, true);
+
+                SPI_XferFlush(spi);
             }
 
             // Reset register values
@@ -1003,6 +1145,392 @@ int32_t HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *spi, uint8_t *pTxData, ui
     return ARM_DRIVER_OK;
 }
 
+static void SPI_XferAdvance(const SPI_TRANSACTION *xfer, SPI_XFER_POS *pos, uint32_t frames) {
+    uint32_t n;
+
+    while(frames) {
+        n = MIN(frames, (uint32_t)(xfer->seg[pos->seg].size - pos->off));
+
+        pos->off += n;
+        frames -= n;
+
+        if(pos->off == xfer->seg[pos->seg].size) {
+            pos->seg++;
+            pos->off = 0;
+        }
+    }
+}
+
+static void SPI_XferScatter(SPI_HandleTypeDef *spi, const SPI_TRANSACTION *xfer, SPI_XFER_POS pos, const uint8_t *src, uint32_t frames) {
+    const SPI_SEGMENT *seg;
+    uint32_t width = spi->info->data_width;
+    uint32_t n;
+
+    while(frames) {
+        seg = &xfer->seg[pos.seg];
+        n = MIN(frames, (uint32_t)(seg->size - pos.off));
+
+        if(seg->rx_buf)
+            memcpy(seg->rx_buf + pos.off * width, src, n * width);
+
+        src += n * width;
+        SPI_XferAdvance(xfer, &pos, n);
+        frames -= n;
+    }
+}
+
+static void SPI_XferChipSelect(const SPI_TRANSACTION *xfer, bool assert) {
+    uint16_t level = (((xfer->flags & SPI_XFER_CS_ACTIVE_HIGH) != 0) == assert) ? 1 : 0;
+
+    GPIO_PinWrite(xfer->cs_port, 1 << xfer->cs_pin, level << xfer->cs_pin);
+}
+
+static void SPI_XferKeptRelease(SPI_XFER_QUEUE *xq) {
+    uint16_t level = (xq->kept_flags & SPI_XFER_CS_ACTIVE_HIGH) ? 0 : 1;
+
+    if(xq->kept) {
+        GPIO_PinWrite(xq->kept_port, 1 << xq->kept_pin, level << xq->kept_pin);
+        xq->kept = 0;
+    }
+}
+
+static void SPI_XferBuildPass(SPI_HandleTypeDef *spi) {
+    SPI_XFER_QUEUE *xq = &spi->info->xq;
+    const SPI_TRANSACTION *xfer = xq->req[xq->tail & (SPI_XFER_QUEUE_DEPTH - 1)];
+    dma_descriptor_t *tx_desc = spi->dma->xfer_desc;
+    dma_descriptor_t *rx_desc = spi->dma->xfer_desc + SPI_XFER_MAX_SEGMENTS;
+    const SPI_SEGMENT *seg;
+    dma_transfer_config dmaConfig;
+    dma_extra_config extraConfig;
+    SPI_XFER_POS pos;
+    uint32_t width = spi->info->data_width;
+    uint32_t chunks, left, n, i;
+
+    xq->pass   = MIN(xq->left, (uint32_t)(SPI_XFER_RX_DESC_NUM * SPI_RX_FIFO_TRIG_LVL));
+    xq->splits = 0;
+    chunks     = xq->pass / SPI_RX_FIFO_TRIG_LVL;
+
+    extraConfig.enableStartInterrupt = false;
+
+    // RX, one chunk of trigger level per descriptor, only the last one interrupts
+    dmaConfig.burstSize        = DMA_Burst8Bytes;
+    dmaConfig.dataWidth        = (dma_data_width_t)width;
+    dmaConfig.flowControl      = DMA_FlowControlSource;
+    dmaConfig.addressIncrement = DMA_AddressIncrementTarget;
+    dmaConfig.sourceAddress    = (void *)&(spi->reg->DR);
+    dmaConfig.totalLength      = SPI_RX_FIFO_TRIG_LVL * width;
+
+    pos = xq->pos;
+
+    for(i = 0; i < chunks; i++) {
+        seg = &xfer->seg[pos.seg];
+
+        if((uint32_t)(seg->size - pos.off) >= SPI_RX_FIFO_TRIG_LVL) {
+            dmaConfig.targetAddress = seg->rx_buf ? (void *)(seg->rx_buf + pos.off * width) : (void *)xq->discard;
+        } else {
+            xq->split[xq->splits].pos = pos;
+            dmaConfig.targetAddress = (void *)xq->split[xq->splits].data;
+            xq->splits++;
+        }
+
+        extraConfig.stopDecriptorFetch  = (i == chunks - 1);
+        extraConfig.enableEndInterrupt  = (i == chunks - 1);
+        extraConfig.nextDesriptorAddress = extraConfig.stopDecriptorFetch ? rx_desc : &rx_desc[i + 1];
+
+        DMA_BuildDescriptor(&rx_desc[i], &dmaConfig, &extraConfig);
+
+        SPI_XferAdvance(xfer, &pos, SPI_RX_FIFO_TRIG_LVL);
+    }
+
+    // TX, one descriptor per segment piece, interrupts only when there is no RX chunk to wait for
+    dmaConfig.flowControl   = DMA_FlowControlTarget;
+    dmaConfig.targetAddress = (void *)&(spi->reg->DR);
+
+    pos  = xq->pos;
+    left = xq->pass;
+
+    for(i = 0; left; i++) {
+        seg = &xfer->seg[pos.seg];
+        n = MIN(left, (uint32_t)(seg->size - pos.off));
+
+        if(seg->tx_buf) {
+            dmaConfig.sourceAddress    = (void *)(seg->tx_buf + pos.off * width);
+            dmaConfig.addressIncrement = DMA_AddressIncrementSource;
+        } else {
+            dmaConfig.sourceAddress    = (void *)&(spi->info->xfer.def_val);
+            dmaConfig.addressIncrement = DMA_AddressIncrementNone;
+        }
+
+        dmaConfig.totalLength = n * width;
+        left -= n;
+
+        extraConfig.stopDecriptorFetch   = (left == 0);
+        extraConfig.enableEndInterrupt   = (left == 0) && (chunks == 0);
+        extraConfig.nextDesriptorAddress = extraConfig.stopDecriptorFetch ? tx_desc : &tx_desc[i + 1];
+
+        DMA_BuildDescriptor(&tx_desc[i], &dmaConfig, &extraConfig);
+
+        SPI_XferAdvance(xfer, &pos, n);
+    }
+
+    // RX first, so it is waiting for the FIFO before the first TX frame
+    if(chunks)
+        DMA_ChannelLoadDescriptorAndRun(spi->dma->rx_ch, rx_desc);
+
+    DMA_ChannelLoadDescriptorAndRun(spi->dma->tx_ch, tx_desc);
+
+    spi->reg->DMACR |= (SPI_DMACR_TXDMAE_Msk | SPI_DMACR_RXDMAE_Msk);
+}
+
+static void SPI_XferStart(SPI_HandleTypeDef *spi) {
+    SPI_XFER_QUEUE *xq = &spi->info->xq;
+    const SPI_TRANSACTION *xfer = xq->req[xq->tail & (SPI_XFER_QUEUE_DEPTH - 1)];
+    uint32_t i;
+
+    xq->pos.seg = 0;
+    xq->pos.off = 0;
+    xq->left    = 0;
+
+    for(i = 0; i < xfer->count; i++)
+        xq->left += xfer->seg[i].size;
+
+    // A chip select kept by the previous transaction passes to this one if on the same pin
+    if(xq->kept && ((xfer->cs_port != xq->kept_port) || (xfer->cs_pin != xq->kept_pin)))
+        SPI_XferKeptRelease(xq);
+
+    xq->kept = 0;
+
+    if(xfer->cs_port >= 0)
+        SPI_XferChipSelect(xfer, true);
+
+    SPI_XferBuildPass(spi);
+}
+
+static void SPI_XferFinish(SPI_HandleTypeDef *spi, int32_t status) {
+#ifdef PM_FEATURE_ENABLE
+    uint32_t instance = HAL_SPI_GetInstanceNumber(spi);
+#endif
+    SPI_XFER_QUEUE *xq = &spi->info->xq;
+    SPI_TRANSACTION *xfer = xq->req[xq->tail & (SPI_XFER_QUEUE_DEPTH - 1)];
+
+    spi->reg->DMACR &= ~(SPI_DMACR_TXDMAE_Msk | SPI_DMACR_RXDMAE_Msk);
+
+    // Receive overrun, the frames of this transaction are not trustworthy
+    if(spi->reg->RIS & SPI_RIS_RORRIS_Msk) {
+        spi->reg->ICR = SPI_ICR_RORIC_Msk;
+        spi->info->status.data_lost = 1;
+
+        if(status == ARM_DRIVER_OK)
+            status = ARM_DRIVER_ERROR;
+    }
+
+    if(xfer->cs_port >= 0) {
+        if(xfer->flags & SPI_XFER_CS_KEEP) {
+            xq->kept       = 1;
+            xq->kept_port  = xfer->cs_port;
+            xq->kept_pin   = xfer->cs_pin;
+            xq->kept_flags = xfer->flags;
+        } else {
+            SPI_XferChipSelect(xfer, false);
+        }
+    }
+
+    xfer->status = status;
+    xq->tail++;
+
+    // Next transaction goes on the bus before the callback runs
+    if(xq->head != xq->tail) {
+        SPI_XferStart(spi);
+    } else {
+        xq->active = 0;
+        spi->info->status.busy = 0;
+
+#ifdef PM_FEATURE_ENABLE
+        CHECK_TO_UNLOCK_SLEEP(instance);
+#endif
+    }
+
+    if(xfer->callback)
+        xfer->callback(xfer, xfer->arg);
+}
+
+static void SPI_XferPassDone(SPI_HandleTypeDef *spi) {
+    SPI_XFER_QUEUE *xq = &spi->info->xq;
+    const SPI_TRANSACTION *xfer = xq->req[xq->tail & (SPI_XFER_QUEUE_DEPTH - 1)];
+    uint32_t tail = xq->pass % SPI_RX_FIFO_TRIG_LVL;
+    uint16_t data[SPI_RX_FIFO_TRIG_LVL];
+    SPI_XFER_POS pos;
+    uint32_t i, spins;
+
+    for(i = 0; i < xq->splits; i++)
+        SPI_XferScatter(spi, xfer, xq->split[i].pos, (const uint8_t *)xq->split[i].data, SPI_RX_FIFO_TRIG_LVL);
+
+    // Frames below the trigger level never raise a DMA request, TX already queued them
+    if(tail) {
+        for(i = 0, spins = SPI_XFER_TAIL_SPINS; i < tail; ) {
+            if(spi->reg->SR & SPI_SR_RNE_Msk) {
+                if(spi->info->data_width == 2)
+                    data[i] = (uint16_t)spi->reg->DR;
+                else
+                    ((uint8_t *)data)[i] = (uint8_t)spi->reg->DR;
+                i++;
+            } else if(--spins == 0) {
+                // Frames never came back, do not let the next transaction read them
+                while(spi->reg->SR & SPI_SR_RNE_Msk)
+                    (void)spi->reg->DR;
+
+                spi->info->status.data_lost = 1;
+                SPI_XferFinish(spi, ARM_DRIVER_ERROR_TIMEOUT);
+                return;
+            }
+        }
+
+        pos = xq->pos;
+        SPI_XferAdvance(xfer, &pos, xq->pass - tail);
+        SPI_XferScatter(spi, xfer, pos, (const uint8_t *)data, tail);
+    }
+
+    SPI_XferAdvance(xfer, &xq->pos, xq->pass);
+    xq->left -= xq->pass;
+
+    if(xq->left)
+        SPI_XferBuildPass(spi);
+    else
+        SPI_XferFinish(spi, ARM_DRIVER_OK);
+}
+
+static void SPI_XferDmaEvent(uint32_t event, SPI_HandleTypeDef *spi) {
+    switch(event) {
+        case DMA_EVENT_END:
+            // Only the descriptor closing the pass has its end interrupt enabled
+            SPI_XferPassDone(spi);
+            break;
+
+        case DMA_EVENT_ERROR:
+            DMA_StopChannel(spi->dma->tx_ch, true);
+            DMA_StopChannel(spi->dma->rx_ch, true);
+
+            HAL_SPI_CleanRxFifo(spi);
+            SPI_XferFinish(spi, ARM_DRIVER_ERROR);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void SPI_XferFlush(SPI_HandleTypeDef *spi) {
+#ifdef PM_FEATURE_ENABLE
+    uint32_t instance = HAL_SPI_GetInstanceNumber(spi);
+#endif
+    SPI_XFER_QUEUE *xq = &spi->info->xq;
+    SPI_TRANSACTION *xfer;
+    uint32_t mask;
+
+    mask = SaveAndSetIRQMask();
+
+    if(xq->active) {
+        xfer = xq->req[xq->tail & (SPI_XFER_QUEUE_DEPTH - 1)];
+
+        if(xfer->cs_port >= 0)
+            SPI_XferChipSelect(xfer, false);
+
+        while(xq->tail != xq->head) {
+            xq->req[xq->tail & (SPI_XFER_QUEUE_DEPTH - 1)]->status = ARM_DRIVER_ERROR;
+            xq->tail++;
+        }
+
+        xq->active = 0;
+        spi->info->status.busy = 0;
+
+#ifdef PM_FEATURE_ENABLE
+        CHECK_TO_UNLOCK_SLEEP(instance);
+#endif
+    }
+
+    SPI_XferKeptRelease(xq);
+
+    RestoreIRQMask(mask);
+}
+
+int32_t HAL_SPI_TransactionSubmit(SPI_HandleTypeDef *spi, SPI_TRANSACTION *xfer) {
+#ifdef PM_FEATURE_ENABLE
+    uint32_t instance = HAL_SPI_GetInstanceNumber(spi);
+#endif
+    SPI_XFER_QUEUE *xq = &spi->info->xq;
+    uint32_t mask, i;
+
+    if((xfer == NULL) || (xfer->seg == NULL) || (xfer->count == 0) || (xfer->count > SPI_XFER_MAX_SEGMENTS))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    for(i = 0; i < xfer->count; i++) {
+        if(xfer->seg[i].size == 0)
+            return ARM_DRIVER_ERROR_PARAMETER;
+    }
+
+    if((spi->dma == NULL) || !(spi->info->flags & SPI_FLAG_CONFIGURED))
+        return ARM_DRIVER_ERROR;
+
+    if((spi->info->mode & ARM_SPI_CONTROL_Msk) != ARM_SPI_MODE_MASTER)
+        return ARM_DRIVER_ERROR;
+
+    mask = SaveAndSetIRQMask();
+
+    // A single transfer started through the legacy API owns the channels
+    if((!xq->active && spi->info->status.busy) || ((uint8_t)(xq->head - xq->tail) >= SPI_XFER_QUEUE_DEPTH)) {
+        RestoreIRQMask(mask);
+        return ARM_DRIVER_ERROR_BUSY;
+    }
+
+    xfer->status = ARM_DRIVER_ERROR_BUSY;
+    xq->req[xq->head & (SPI_XFER_QUEUE_DEPTH - 1)] = xfer;
+    xq->head++;
+
+    if(xq->active) {
+        RestoreIRQMask(mask);
+        return ARM_DRIVER_OK;
+    }
+
+    // Claim the queue, later submits only enqueue while the bus settles
+    xq->active = 1;
+
+    spi->info->status.busy       = 1U;
+    spi->info->status.data_lost  = 0;
+    spi->info->status.mode_fault = 0;
+
+#ifdef PM_FEATURE_ENABLE
+    LOCK_SLEEP(instance);
+#endif
+
+    RestoreIRQMask(mask);
+
+    // Stale frames would shift every RX chunk of the queue. Nothing of the queue runs yet, so wait with IRQs on
+    while(spi->reg->SR & SPI_SR_BSY_Msk);
+
+    while(spi->reg->SR & SPI_SR_RNE_Msk)
+        (void)spi->reg->DR;
+
+    mask = SaveAndSetIRQMask();
+
+    // SPI_XferFlush may have dropped the queue meanwhile
+    if(xq->active && (xq->head != xq->tail)) {
+        spi->reg->ICR = (SPI_ICR_RTIC_Msk | SPI_ICR_RORIC_Msk);
+
+        DMA_ResetChannel(spi->dma->tx_ch);
+        DMA_ResetChannel(spi->dma->rx_ch);
+
+        SPI_XferStart(spi);
+    }
+
+    RestoreIRQMask(mask);
+
+    return ARM_DRIVER_OK;
+}
+
+uint32_t HAL_SPI_TransactionPending(SPI_HandleTypeDef *spi) {
+    return (uint8_t)(spi->info->xq.head - spi->info->xq.tail);
+}
+
 int32_t HAL_SPI_Receive_IT(SPI_HandleTypeDef *spi, uint8_t *pData, uint16_t size) {
     if ((pData == NULL) || (size == 0))
         return ARM_DRIVER_ERROR_PARAMETER;
@@ -1362,6 +1890,9 @@ int32_t HAL_SPI_Control(uint32_t control, uint32_t arg, SPI_HandleTypeDef *spi)
             if(spi->dma) {
                 DMA_StopChannel(spi->dma->tx_ch, true);
                 DMA_StopChannel(spi->dma->rx_ch, true);
+                spi->reg->DMACR = 0;
+
+                SPI_XferFlush(spi);
             }
         }
 
@@ -1623,6 +2154,11 @@ void SPI_IRQHandler(SPI_HandleTypeDef *spi) {
 
 void HAL_SPI_DmaTxEvent(uint32_t event, SPI_HandleTypeDef *spi) {
 
+    if(spi->info->xq.active) {
+        SPI_XferDmaEvent(event, spi);
+        return;
+    }
+
     switch (event) {
         case DMA_EVENT_END:
            
@@ -1650,6 +2186,11 @@ void HAL_SPI_DmaRxEvent(uint32_t event, SPI_HandleTypeDef *spi) {
 #endif
     uint32_t dma_rx_channel, remained_cnt;
 
+    if(spi->info->xq.active) {
+        SPI_XferDmaEvent(event, spi);
+        return;
+    }
+
     switch(event) {
         case DMA_EVENT_END:
             dma_rx_channel = spi->dma->rx_ch;
@@ -1663,7 +2204,6 @@ void HAL_SPI_DmaRxEvent(uint32_t event, SPI_HandleTypeDef *spi) {
                 spi->dma->descriptor->TAR =  (spi->info->xfer.rx_buf == NULL)? ((uint32_t)&spi->info->xfer.dump_val) : (uint32_t)(spi->info->xfer.rx_buf + spi->info->xfer.rx_cnt);
 
                 // load descriptor and start DMA transfer
-                extern void DMA_ChannelLoadDescriptorAndRun(uint32_t channel, void* descriptorAddress);
                 DMA_ChannelLoadDescriptorAndRun(dma_rx_channel, spi->dma->descriptor);
             
             } else if(remained_cnt == 0) {
@@ -117,6 +117,44 @@
 #define USART1_TX_TRIG_LVL   TX_FIFO_TRIG_LVL_0BYTE
 #define USART2_TX_TRIG_LVL   TX_FIFO_TRIG_LVL_0BYTE
 
+// Asynchronous print (printf -> RAM ring -> USART TX DMA)
+#define USART_PRINT_OVF_DROP     0    // Drop a write that does not fit in the ring
+#define USART_PRINT_OVF_BLOCK    1    // Wait for the DMA to free space (thread context only)
+
+#ifndef USART_PRINT_ASYNC_ENABLE
+#define USART_PRINT_ASYNC_ENABLE 0
+#endif
+
+#ifndef USART_PRINT_RING_SIZE
+#define USART_PRINT_RING_SIZE    1024
+#endif
+
+#ifndef USART_PRINT_OVF_POLICY
+#define USART_PRINT_OVF_POLICY   USART_PRINT_OVF_DROP
+#endif
+
+#ifndef USART_PRINT_TIMEOUT_MS
+#define USART_PRINT_TIMEOUT_MS   50   // Slack over a chunk's wire time before its completion counts as lost
+#endif
+
+// The ring indexes with a mask and reports its size and peak in 16 bits
+#if (USART_PRINT_RING_SIZE == 0) || (USART_PRINT_RING_SIZE & (USART_PRINT_RING_SIZE - 1)) != 0 || (USART_PRINT_RING_SIZE > 32768)
+#error "USART_PRINT_RING_SIZE must be a power of two, at most 32768!"
+#endif
+
+// Interrupt-driven transmit queue (HAL_USART_Transmit_IT / HAL_USART_TransmitQueue_IT)
+#ifndef USART_TX_QUEUE_DEPTH
+#define USART_TX_QUEUE_DEPTH     4    // Buffers pending per instance, power of two
+#endif
+
+#if (USART_TX_QUEUE_DEPTH & (USART_TX_QUEUE_DEPTH - 1)) != 0 || (USART_TX_QUEUE_DEPTH > 128)
+#error "USART_TX_QUEUE_DEPTH must be a power of two up to 128!"
+#endif
+
+// Continuous RX stream (USART RX DMA ping-pong over a caller ring)
+#define USART_RX_STREAM_MIN_SIZE (4 * UART_DMA_BURST_SIZE)   // Two halves of at least two DMA bursts
+#define USART_RX_STREAM_MAX_SIZE 8192                        // Two halves of at most 4 KB (descriptor length field)
+
 /* Typedefs  ------------------------------------------------------------------*/
 
 // USART IRQ
@@ -140,6 +178,59 @@ typedef struct _USART_RX_DMA {
   void                  (*callback)(uint32_t event);            //  Rx callback
 } USART_RX_DMA;
 
+// Asynchronous print statistics
+typedef struct _USART_PrintStats {
+  uint32_t              written;                                //  Bytes accepted into the ring
+  uint32_t              dropped;                                //  Bytes discarded on overflow
+  uint32_t              overflows;                              //  Writes that hit a full ring
+  uint32_t              dma_errors;                             //  DMA kicks refused by the driver
+  uint32_t              dma_timeouts;                           //  Chunks aborted and re-sent after a lost completion
+  uint16_t              peak_used;                              //  Ring high-water mark in bytes
+  uint16_t              ring_size;                              //  Ring capacity in bytes
+} USART_PrintStats;
+
+// Continuous RX stream statistics
+typedef struct _USART_RxStreamStats {
+  uint32_t              received;                               //  Bytes published to the consumer
+  uint32_t              lost;                                   //  Bytes discarded because the consumer fell behind
+  uint32_t              ring_overruns;                          //  Times the consumer fell more than a half behind
+  uint32_t              fifo_overruns;                          //  Hardware RX FIFO overruns
+  uint32_t              line_errors;                            //  Framing, parity and break conditions
+  uint32_t              idle_events;                            //  Idle-line (RX timeout) notifications
+  uint32_t              half_events;                            //  Ring halves filled by the DMA
+  uint16_t              peak_used;                              //  Ring high-water mark in bytes
+  uint16_t              ring_size;                              //  Ring capacity in bytes
+} USART_RxStreamStats;
+
+// Interrupt-driven transmit: called from the USART ISR once the whole buffer is in the TX FIFO
+typedef void (*USART_TxCallback_t)(const uint8_t *pTxBuff, uint32_t size, void *arg);
+
+typedef struct _USART_TX_REQUEST {
+  const uint8_t        *buf;                                    //  Caller buffer, owned by the driver until the callback
+  uint32_t              size;                                   //  Buffer size
+  USART_TxCallback_t    callback;                               //  Per-buffer completion, may be NULL
+  void                 *arg;                                    //  Callback argument
+} USART_TX_REQUEST;
+
+// Interrupt-driven transmit run-time state
+typedef struct _USART_TX_QUEUE {
+  USART_TX_REQUEST      req[USART_TX_QUEUE_DEPTH];              //  Pending buffers, req[tail] is being sent
+  const uint8_t        *ptr;                                    //  Next byte of req[tail]
+  uint32_t              left;                                   //  Bytes of req[tail] not yet in the FIFO
+  volatile uint8_t      head;                                   //  Free running enqueue count
+  volatile uint8_t      tail;                                   //  Free running completion count
+} USART_TX_QUEUE;
+
+// Continuous RX stream run-time state
+typedef struct _USART_RX_STREAM {
+  uint8_t              *ring;                                   //  Caller ring, two DMA halves
+  uint32_t              size;                                   //  Ring size, power of two
+  volatile uint32_t     head;                                   //  Free running write count (ISR only)
+  volatile uint32_t     tail;                                   //  Free running read count (consumer only)
+  volatile uint8_t      active;                                 //  Stream mode running
+  USART_RxStreamStats   stats;                                  //  Counters
+} USART_RX_STREAM;
+
 // USART PINS
 typedef const struct _USART_PIN {
   const PIN               *pin_tx;                                //  TX Pin identifier
@@ -177,6 +268,10 @@ typedef struct _USART_INFO {
   uint8_t                 flags;               // Current USART flags
   uint32_t                mode;                // Current USART mode
   uint32_t                baudrate;            // Baudrate
+  USART_RX_STREAM         rx_stream;           // Continuous RX stream state
+  USART_TX_QUEUE          tx_queue;            // Interrupt-driven transmit queue
+  volatile uint8_t        dma_tx_end;          // TX DMA done, the IRQ handler completes the last byte
+  volatile uint8_t        dma_rx_end;          // RX DMA burst done, the IRQ handler drains the FIFO tail
 } USART_INFO;
 
 // USART Resources definition
@@ -364,17 +459,50 @@ void HAL_USART_InitPrint(USART_HandleTypeDef *huart, clock_select_t uartClkSel,
 int32_t HAL_USART_Send(USART_HandleTypeDef *huart, uint8_t *data, uint32_t size);
 
 /*!******************************************************************
- * \fn void HAL_USART_Transmit_IT(USART_HandleTypeDef *huart, uint8_t *pTxBuff, uint32_t size)
+ * \fn int32_t HAL_USART_Transmit_IT(USART_HandleTypeDef *huart, uint8_t *pTxBuff, uint32_t size)
  * \brief Transmit a buffer through USART peripheral in interruption mode.
+ *        Same as HAL_USART_TransmitQueue_IT without a completion callback.
  *
  * \param[in] USART_HandleTypeDef *huart        USART handle.
  * \param[in] uint8_t *pTxBuff                  TX buffer.
  * \param[in] uint32_t size                     Size of the buffer that will be transmitted.
  * \param[out] none
  *
- * \retval none.
+ * \retval ARM Driver status.
+ *******************************************************************/
+int32_t HAL_USART_Transmit_IT(USART_HandleTypeDef *huart, uint8_t *pTxBuff, uint32_t size);
+
+/*!******************************************************************
+ * \fn int32_t HAL_USART_TransmitQueue_IT(USART_HandleTypeDef *huart, const uint8_t *pTxBuff, uint32_t size, USART_TxCallback_t callback, void *arg)
+ * \brief Queues a buffer for interrupt-driven transmission. Each instance keeps
+ *        its own queue of USART_TX_QUEUE_DEPTH buffers, so the three USARTs
+ *        transmit concurrently. The ISR moves on to the next buffer in the same
+ *        FIFO refill, without letting the line go idle, and calls the buffer
+ *        callback once its last byte is in the FIFO (the buffer may be reused
+ *        from there). Callbacks run in interrupt context and may queue again.
+ *        The instance TX must not be in DMA_MODE.
+ *
+ * \param[in] USART_HandleTypeDef *huart        USART handle.
+ * \param[in] const uint8_t *pTxBuff            TX buffer, must stay valid until the callback.
+ * \param[in] uint32_t size                     Size of the buffer that will be transmitted.
+ * \param[in] USART_TxCallback_t callback       Completion callback, may be NULL.
+ * \param[in] void *arg                         Callback argument.
+ * \param[out] none
+ *
+ * \retval ARM_DRIVER_OK, ARM_DRIVER_ERROR_BUSY when the queue is full.
  *******************************************************************/
-void HAL_USART_Transmit_IT(USART_HandleTypeDef *huart, uint8_t *pTxBuff, uint32_t size);
+int32_t HAL_USART_TransmitQueue_IT(USART_HandleTypeDef *huart, const uint8_t *pTxBuff, uint32_t size, USART_TxCallback_t callback, void *arg);
+
+/*!******************************************************************
+ * \fn uint32_t HAL_USART_TransmitQueuePending(USART_HandleTypeDef *huart)
+ * \brief Number of queued buffers not completed yet, including the one in progress.
+ *
+ * \param[in] USART_HandleTypeDef *huart        USART handle.
+ * \param[out] none
+ *
+ * \retval Pending buffers.
+ *******************************************************************/
+uint32_t HAL_USART_TransmitQueuePending(USART_HandleTypeDef *huart);
 
 /*!******************************************************************
  * \fn void HAL_USART_Receive_IT(uint8_t *pRxBuff, uint32_t size)
@@ -502,6 +630,135 @@ int32_t HAL_USART_GetTxCount(USART_HandleTypeDef *usart);
  *******************************************************************/
 ARM_USART_STATUS HAL_USART_GetStatus(USART_HandleTypeDef *usart);
 
+/*!******************************************************************
+ * \fn void HAL_USART_PrintFlush(void)
+ * \brief Blocks until every byte queued by printf has left the print USART.
+ *        When called from an ISR or with interrupts masked it falls back
+ *        to HAL_USART_PrintFlushPolling.
+ *
+ * \param[in] none
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+void HAL_USART_PrintFlush(void);
+
+/*!******************************************************************
+ * \fn void HAL_USART_PrintFlushPolling(void)
+ * \brief Fault-safe flush. Aborts the TX DMA in flight, drains the ring by
+ *        polling with interrupts masked and switches stdout back to
+ *        polling mode for good. Meant for assert and fault handlers.
+ *
+ * \param[in] none
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+void HAL_USART_PrintFlushPolling(void);
+
+/*!******************************************************************
+ * \fn void HAL_USART_PrintGetStats(USART_PrintStats *stats)
+ * \brief Copies the asynchronous print counters.
+ *
+ * \param[in] none
+ * \param[out] USART_PrintStats *stats          Output statistics.
+ *
+ * \retval none.
+ *******************************************************************/
+void HAL_USART_PrintGetStats(USART_PrintStats *stats);
+
+/*!******************************************************************
+ * \fn int32_t HAL_USART_RxStreamStart(USART_HandleTypeDef *huart, uint8_t *pRing, uint32_t size)
+ * \brief Starts continuous reception into a ring. The two RX DMA descriptors
+ *        are chained to each other, one per ring half, so the channel never
+ *        stops while bytes keep coming. The ISR only runs when a half fills
+ *        (ARM_USART_EVENT_DMA_RX_COMPLETE) and when the line goes idle
+ *        (ARM_USART_EVENT_RX_TIMEOUT), where it moves the last bytes that are
+ *        still in the FIFO to the ring. Line errors are reported as
+ *        ARM_USART_EVENT_RX_OVERFLOW / _BREAK / _FRAMING_ERROR / _PARITY_ERROR.
+ *        The consumer may lag by at most one half; beyond that the pending
+ *        bytes are dropped and counted (see HAL_USART_RxStreamGetStats).
+ *        The USART sleep vote stays active until HAL_USART_RxStreamStop.
+ *        Requires the instance RX in DMA_MODE.
+ *
+ * \param[in] USART_HandleTypeDef *huart        USART handle.
+ * \param[in] uint8_t *pRing                    Ring buffer, must stay valid until HAL_USART_RxStreamStop.
+ * \param[in] uint32_t size                     Ring size, power of two, USART_RX_STREAM_MIN_SIZE..USART_RX_STREAM_MAX_SIZE.
+ * \param[out] none
+ *
+ * \retval ARM Driver status.
+ *******************************************************************/
+int32_t HAL_USART_RxStreamStart(USART_HandleTypeDef *huart, uint8_t *pRing, uint32_t size);
+
+/*!******************************************************************
+ * \fn int32_t HAL_USART_RxStreamStop(USART_HandleTypeDef *huart)
+ * \brief Stops the RX stream. Bytes already published stay readable.
+ *
+ * \param[in] USART_HandleTypeDef *huart        USART handle.
+ * \param[out] none
+ *
+ * \retval ARM Driver status.
+ *******************************************************************/
+int32_t HAL_USART_RxStreamStop(USART_HandleTypeDef *huart);
+
+/*!******************************************************************
+ * \fn uint32_t HAL_USART_RxStreamAvailable(USART_HandleTypeDef *huart)
+ * \brief Number of bytes ready to be read. Lock-free, single consumer.
+ *
+ * \param[in] USART_HandleTypeDef *huart        USART handle.
+ * \param[out] none
+ *
+ * \retval Bytes available.
+ *******************************************************************/
+uint32_t HAL_USART_RxStreamAvailable(USART_HandleTypeDef *huart);
+
+/*!******************************************************************
+ * \fn uint32_t HAL_USART_RxStreamRead(USART_HandleTypeDef *huart, uint8_t *pData, uint32_t size)
+ * \brief Copies up to size bytes out of the ring. Lock-free, single consumer.
+ *
+ * \param[in] USART_HandleTypeDef *huart        USART handle.
+ * \param[in] uint32_t size                     Output buffer size.
+ * \param[out] uint8_t *pData                   Output buffer.
+ *
+ * \retval Bytes copied.
+ *******************************************************************/
+uint32_t HAL_USART_RxStreamRead(USART_HandleTypeDef *huart, uint8_t *pData, uint32_t size);
+
+/*!******************************************************************
+ * \fn uint32_t HAL_USART_RxStreamPeek(USART_HandleTypeDef *huart, const uint8_t **ppData)
+ * \brief Zero-copy access to the oldest contiguous chunk of the ring. Call
+ *        HAL_USART_RxStreamConsume once the chunk has been parsed.
+ *
+ * \param[in] USART_HandleTypeDef *huart        USART handle.
+ * \param[out] const uint8_t **ppData           Start of the chunk inside the ring.
+ *
+ * \retval Chunk length in bytes (0 when empty).
+ *******************************************************************/
+uint32_t HAL_USART_RxStreamPeek(USART_HandleTypeDef *huart, const uint8_t **ppData);
+
+/*!******************************************************************
+ * \fn void HAL_USART_RxStreamConsume(USART_HandleTypeDef *huart, uint32_t size)
+ * \brief Releases bytes returned by HAL_USART_RxStreamPeek.
+ *
+ * \param[in] USART_HandleTypeDef *huart        USART handle.
+ * \param[in] uint32_t size                     Bytes to release.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+void HAL_USART_RxStreamConsume(USART_HandleTypeDef *huart, uint32_t size);
+
+/*!******************************************************************
+ * \fn void HAL_USART_RxStreamGetStats(USART_HandleTypeDef *huart, USART_RxStreamStats *stats)
+ * \brief Copies the RX stream counters.
+ *
+ * \param[in] USART_HandleTypeDef *huart        USART handle.
+ * \param[out] USART_RxStreamStats *stats       Output statistics.
+ *
+ * \retval none.
+ *******************************************************************/
+void HAL_USART_RxStreamGetStats(USART_HandleTypeDef *huart, USART_RxStreamStats *stats);
+
 /*!******************************************************************
  * \fn void HT_USART_Callback(uint32_t event)
  * \brief USART interruption callback.
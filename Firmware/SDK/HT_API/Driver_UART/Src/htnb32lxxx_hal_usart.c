@@ -17,6 +17,9 @@
 #include "slpman_qcx212.h"
 #include "HT_Peripheral_Config.h"
 #include "HT_usart_unilog.h"
+#if (USART_PRINT_ASYNC_ENABLE == 1)
+#include "cmsis_os2.h"
+#endif
 
 /* Function prototypes  ------------------------------------------------------------------*/
 
@@ -66,6 +69,21 @@ static int32_t HAL_USART_SetBaudrate (uint32_t baudrate, USART_HandleTypeDef *us
  *******************************************************************/
 static void HAL_USART_DmaRxConfig(USART_HandleTypeDef *usart);
 
+/*!******************************************************************
+ * \fn static void HAL_USART_DmaRxBuildDescriptors(USART_HandleTypeDef *usart, uint8_t *ring, uint32_t size)
+ * \brief Builds the two RX descriptors. Without a ring they form the one-shot
+ *        chain used by HAL_USART_Receive_DMA (descriptor[1] stops the fetch);
+ *        with a ring each one covers a half and points to the other.
+ *
+ * \param[in] USART_HandleTypeDef *usart           USART handle.
+ * \param[in] uint8_t *ring                        Stream ring, NULL for one-shot.
+ * \param[in] uint32_t size                        Stream ring size.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void HAL_USART_DmaRxBuildDescriptors(USART_HandleTypeDef *usart, uint8_t *ring, uint32_t size);
+
 /*!******************************************************************
  * \fn PLAT_CODE_IN_RAM static void HAL_USART_DmaUpdateRxConfig(USART_HandleTypeDef *usart, uint32_t targetAddress, uint32_t num)
  * \brief Updates the USART RX in DMA mode.
@@ -146,6 +164,81 @@ static void HAL_USART_Transmit_IRQn(USART_HandleTypeDef *huart);
  *******************************************************************/
 static void HAL_USART_Receive_IRQn(USART_HandleTypeDef *huart);
 
+/*!******************************************************************
+ * \fn PLAT_CODE_IN_RAM static void HAL_USART_RxStreamArm(USART_HandleTypeDef *usart, uint32_t index)
+ * \brief Restarts the stream DMA at a ring index. The descriptor of the half
+ *        holding index is shortened to end at the half boundary, the other one
+ *        is restored to a full half.
+ *
+ * \param[in] USART_HandleTypeDef *usart           USART handle.
+ * \param[in] uint32_t index                       Ring index of the next byte.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+PLAT_CODE_IN_RAM static void HAL_USART_RxStreamArm(USART_HandleTypeDef *usart, uint32_t index);
+
+/*!******************************************************************
+ * \fn PLAT_CODE_IN_RAM static void HAL_USART_RxStreamPublish(USART_RX_STREAM *stream, uint32_t index)
+ * \brief Moves the stream head up to a ring index written by the DMA/ISR.
+ *
+ * \param[in] USART_RX_STREAM *stream              Stream state.
+ * \param[in] uint32_t index                       Ring index of the next byte.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+PLAT_CODE_IN_RAM static void HAL_USART_RxStreamPublish(USART_RX_STREAM *stream, uint32_t index);
+
+/*!******************************************************************
+ * \fn PLAT_CODE_IN_RAM static void HAL_USART_RxStreamIdle(USART_HandleTypeDef *usart)
+ * \brief Idle line: parks the channel, moves the FIFO tail (less than a DMA
+ *        burst) to the ring, publishes it and restarts the DMA right after it.
+ *
+ * \param[in] USART_HandleTypeDef *usart           USART handle.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+PLAT_CODE_IN_RAM static void HAL_USART_RxStreamIdle(USART_HandleTypeDef *usart);
+
+/*!******************************************************************
+ * \fn PLAT_CODE_IN_RAM static void HAL_USART_RxStreamIRQn(USART_HandleTypeDef *usart)
+ * \brief Handles the USART RX interrupts (RX timeout, line status) in stream mode.
+ *
+ * \param[in] USART_HandleTypeDef *usart           USART handle.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+PLAT_CODE_IN_RAM static void HAL_USART_RxStreamIRQn(USART_HandleTypeDef *usart);
+
+/*!******************************************************************
+ * \fn PLAT_CODE_IN_RAM static void HAL_USART_RxStreamDmaEvent(uint32_t event, USART_HandleTypeDef *usart)
+ * \brief Stream DMA event: a half is full and the channel already runs on the
+ *        other one.
+ *
+ * \param[in] uint32_t event                       Event that triggered the DMA callback.
+ * \param[in] USART_HandleTypeDef *usart           USART handle.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+PLAT_CODE_IN_RAM static void HAL_USART_RxStreamDmaEvent(uint32_t event, USART_HandleTypeDef *usart);
+
+/*!******************************************************************
+ * \fn static uint32_t HAL_USART_RxStreamPending(USART_RX_STREAM *stream)
+ * \brief Bytes readable by the consumer. If the consumer is more than a half
+ *        behind, the DMA is already writing over the oldest bytes: everything
+ *        pending is dropped and counted.
+ *
+ * \param[in] USART_RX_STREAM *stream              Stream state.
+ * \param[out] none
+ *
+ * \retval Bytes readable.
+ *******************************************************************/
+static uint32_t HAL_USART_RxStreamPending(USART_RX_STREAM *stream);
+
 #if (RTE_UART0)
 
 /*!******************************************************************
@@ -215,6 +308,47 @@ void HAL_USART_DmaTxEvent(uint32_t event, USART_HandleTypeDef *usart);
  *******************************************************************/
 void HAL_USART_DmaRxEvent(uint32_t event, USART_HandleTypeDef *usart);
 
+#if (USART_PRINT_ASYNC_ENABLE == 1)
+
+/*!******************************************************************
+ * \fn static void HAL_USART_PrintKick(void)
+ * \brief Starts a TX DMA for the oldest contiguous chunk of the print ring
+ *        if the ring is not empty and no transfer is in flight.
+ *
+ * \param[in] none
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void HAL_USART_PrintKick(void);
+
+/*!******************************************************************
+ * \fn static void HAL_USART_PrintCallback(uint32_t event)
+ * \brief Print USART event callback. Releases the chunk that has just been
+ *        sent, starts the next one and forwards the event to HT_USART_Callback.
+ *
+ * \param[in] uint32_t event                       USART event.
+ * \param[out] none
+ *
+ * \retval none.
+ *******************************************************************/
+static void HAL_USART_PrintCallback(uint32_t event);
+
+/*!******************************************************************
+ * \fn static int HAL_USART_PrintWrite(const uint8_t *data, uint32_t len)
+ * \brief Copies a _write() request into the print ring following
+ *        USART_PRINT_OVF_POLICY and kicks the DMA.
+ *
+ * \param[in] const uint8_t *data                  Data to be printed.
+ * \param[in] uint32_t len                         Data length.
+ * \param[out] none
+ *
+ * \retval Number of bytes consumed (always len, dropped bytes are counted in the stats).
+ *******************************************************************/
+static int HAL_USART_PrintWrite(const uint8_t *data, uint32_t len);
+
+#endif
+
 /* ---------------------------------------------------------------------------------------*/
 
 #ifdef PM_FEATURE_ENABLE
@@ -454,7 +588,7 @@ static USART_RX_DMA USART0_DMA_Rx = {
 
 #endif
 
-#if (RTE_UART0_TX_IO_MODE == IRQ_MODE) || (RTE_UART0_RX_IO_MODE == IRQ_MODE) || (RTE_UART0_RX_IO_MODE == DMA_MODE)
+#if (RTE_UART0_TX_IO_MODE == IRQ_MODE) || (RTE_UART0_TX_IO_MODE == DMA_MODE) || (RTE_UART0_RX_IO_MODE == IRQ_MODE) || (RTE_UART0_RX_IO_MODE == DMA_MODE)
 static USART_IRQ USART0_IRQ = {
                                 PXIC_Uart0_IRQn,
                                 HAL_USART0_IRQHandler
@@ -490,7 +624,7 @@ const USART_HandleTypeDef huart0 = {
 #else
     NULL,
 #endif
-#if (RTE_UART0_TX_IO_MODE == IRQ_MODE) || (RTE_UART0_RX_IO_MODE == IRQ_MODE) || (RTE_UART0_RX_IO_MODE == DMA_MODE)
+#if (RTE_UART0_TX_IO_MODE == IRQ_MODE) || (RTE_UART0_TX_IO_MODE == DMA_MODE) || (RTE_UART0_RX_IO_MODE == IRQ_MODE) || (RTE_UART0_RX_IO_MODE == DMA_MODE)
     &USART0_IRQ,
 #else
     NULL,
@@ -551,7 +685,7 @@ static USART_RX_DMA USART1_DMA_Rx = {
 
 #endif
 
-#if (RTE_UART1_TX_IO_MODE == IRQ_MODE) || (RTE_UART1_RX_IO_MODE == IRQ_MODE) || (RTE_UART1_RX_IO_MODE == DMA_MODE)
+#if (RTE_UART1_TX_IO_MODE == IRQ_MODE) || (RTE_UART1_TX_IO_MODE == DMA_MODE) || (RTE_UART1_RX_IO_MODE == IRQ_MODE) || (RTE_UART1_RX_IO_MODE == DMA_MODE)
 static USART_IRQ USART1_IRQ = {
                                 PXIC_Uart1_IRQn,
                                 HAL_USART1_IRQHandler
@@ -586,7 +720,7 @@ const USART_HandleTypeDef huart1 = {
 #else
     NULL,
 #endif
-#if (RTE_UART1_TX_IO_MODE == IRQ_MODE) || (RTE_UART1_RX_IO_MODE == IRQ_MODE) || (RTE_UART1_RX_IO_MODE == DMA_MODE)
+#if (RTE_UART1_TX_IO_MODE == IRQ_MODE) || (RTE_UART1_TX_IO_MODE == DMA_MODE) || (RTE_UART1_RX_IO_MODE == IRQ_MODE) || (RTE_UART1_RX_IO_MODE == DMA_MODE)
     &USART1_IRQ,
 #else
     NULL,
@@ -646,7 +780,7 @@ static USART_RX_DMA USART2_DMA_Rx = {
 
 #endif
 
-#if (RTE_UART2_TX_IO_MODE == IRQ_MODE) || (RTE_UART2_RX_IO_MODE == IRQ_MODE) || (RTE_UART2_RX_IO_MODE == DMA_MODE)
+#if (RTE_UART2_TX_IO_MODE == IRQ_MODE) || (RTE_UART2_TX_IO_MODE == DMA_MODE) || (RTE_UART2_RX_IO_MODE == IRQ_MODE) || (RTE_UART2_RX_IO_MODE == DMA_MODE)
 static USART_IRQ USART2_IRQ = {
                                 PXIC_Uart2_IRQn,
                                 HAL_USART2_IRQHandler
@@ -681,7 +815,7 @@ const USART_HandleTypeDef huart2 = {
 #else
     NULL,
 #endif
-#if (RTE_UART2_TX_IO_MODE == IRQ_MODE) || (RTE_UART2_RX_IO_MODE == IRQ_MODE) || (RTE_UART2_RX_IO_MODE == DMA_MODE)
+#if (RTE_UART2_TX_IO_MODE == IRQ_MODE) || (RTE_UART2_TX_IO_MODE == DMA_MODE) || (RTE_UART2_RX_IO_MODE == IRQ_MODE) || (RTE_UART2_RX_IO_MODE == DMA_MODE)
     &USART2_IRQ,
 #else
     NULL,
@@ -704,14 +838,24 @@ static dma_transfer_config dmaTxConfig = {NULL, NULL,
 
 /* Variable Declarations  ----------------------------------------------------------------*/
 
-uint8_t *usart_tx_buffer = NULL;
 uint8_t *usart_rx_buffer = NULL;
-volatile uint32_t usart_tx_buffer_size = 0;
 volatile uint32_t usart_rx_buffer_size = 0;
-volatile USART_DMA_TypeDef dma_event = USART_DMA_NONE_EVENT;
 
 ARM_DRIVER_USART *UsartPrintHandle = NULL;
 
+#if (USART_PRINT_ASYNC_ENABLE == 1)
+/* Print ring. head/tail are free-running, the DMA owns [tail, tail + inflight). */
+static uint8_t usart_print_ring[USART_PRINT_RING_SIZE];
+static volatile uint32_t usart_print_head = 0;
+static volatile uint32_t usart_print_tail = 0;
+static volatile uint32_t usart_print_inflight = 0;
+static uint32_t usart_print_kick_tick = 0;
+static uint32_t usart_print_timeout = 0;
+static volatile uint8_t usart_print_async = 0;
+static USART_HandleTypeDef *usart_print_huart = NULL;
+static USART_PrintStats usart_print_stats = {0};
+#endif
+
 /* ---------------------------------------------------------------------------------------*/
 
 ARM_DRIVER_VERSION ARM_USART_GetVersion(void) {
@@ -800,7 +944,7 @@ uint32_t HAL_USART_GetBaudRate(USART_HandleTypeDef *usart) {
     return usart->info->baudrate;
 }
 
-static void HAL_USART_DmaRxConfig(USART_HandleTypeDef *usart) {
+static void HAL_USART_DmaRxBuildDescriptors(USART_HandleTypeDef *usart, uint8_t *ring, uint32_t size) {
 
     dma_transfer_config dmaConfig;
     dma_extra_config extraConfig;
@@ -810,8 +954,8 @@ static void HAL_USART_DmaRxConfig(USART_HandleTypeDef *usart) {
     dmaConfig.dataWidth                     = DMA_DataWidthOneByte;
     dmaConfig.flowControl                   = DMA_FlowControlSource;
     dmaConfig.sourceAddress                 = (void*)&(usart->reg->RBR);
-    dmaConfig.targetAddress                 = NULL;
-    dmaConfig.totalLength                   = UART_DMA_BURST_SIZE;
+    dmaConfig.targetAddress                 = ring;
+    dmaConfig.totalLength                   = ring ? (size >> 1) : UART_DMA_BURST_SIZE;
 
     extraConfig.stopDecriptorFetch          = false;
     extraConfig.enableStartInterrupt        = false;
@@ -820,10 +964,19 @@ static void HAL_USART_DmaRxConfig(USART_HandleTypeDef *usart) {
 
     DMA_BuildDescriptor(&usart->dma_rx->descriptor[0], &dmaConfig, &extraConfig);
 
-    extraConfig.stopDecriptorFetch          = true;
+    // One-shot receive stops after descriptor[1], the stream loops back to descriptor[0]
+    extraConfig.stopDecriptorFetch          = (ring == NULL);
     extraConfig.nextDesriptorAddress        = &usart->dma_rx->descriptor[0];
 
+    if(ring)
+        dmaConfig.targetAddress             = ring + (size >> 1);
+
     DMA_BuildDescriptor(&usart->dma_rx->descriptor[1], &dmaConfig, &extraConfig);
+}
+
+static void HAL_USART_DmaRxConfig(USART_HandleTypeDef *usart) {
+
+    HAL_USART_DmaRxBuildDescriptors(usart, NULL, 0);
 
     DMA_ResetChannel(usart->dma_rx->channel);
 
@@ -983,8 +1136,9 @@ int32_t HAL_USART_PowerControl(ARM_POWER_STATE state, USART_HandleTypeDef *usart
             GPR_ClockDisable(g_uartClocks[instance*2]);
             GPR_ClockDisable(g_uartClocks[instance*2+1]);
 
-            // Clear driver variables
+            // Clear driver variables, queued TX buffers are dropped without callback
             memset(&(usart->info->rx_status), 0, sizeof(USART_STATUS));
+            memset(&(usart->info->tx_queue), 0, sizeof(USART_TX_QUEUE));
             usart->info->mode             = 0U;
             usart->info->xfer.send_active = 0U;
 
@@ -1310,7 +1464,7 @@ void HAL_USART_IRQnDisable(USART_HandleTypeDef *huart, uint32_t intMask) {
 }
 
 void HAL_USART_IRQnEnable(USART_HandleTypeDef *huart, uint32_t intMask) {
-    huart->reg->IER = intMask;
+    huart->reg->IER |= intMask;
 }
 
 static void HAL_USART_SendByte(USART_HandleTypeDef *huart, uint8_t data) {
@@ -1414,7 +1568,9 @@ int32_t HAL_USART_Transmit_DMA(USART_HandleTypeDef *huart, uint8_t *pTxBuff, uin
 
     if(size == 1) {
         mask = SaveAndSetIRQMask();
-    
+
+        // No DMA for a single byte, let the TX_DATA_REQ branch of the IRQ handler complete it
+        huart->info->dma_tx_end = 1U;
         huart->reg->IER |= USART_IER_TX_DATA_REQ_Msk;
         huart->reg->THR = huart->info->xfer.tx_buf[0];
     
@@ -1434,34 +1590,109 @@ int32_t HAL_USART_Transmit_DMA(USART_HandleTypeDef *huart, uint8_t *pTxBuff, uin
     return ARM_DRIVER_OK;
 }
 
-void HAL_USART_Transmit_IT(USART_HandleTypeDef *huart, uint8_t *pTxBuff, uint32_t size) {
-    usart_tx_buffer = pTxBuff;
-    usart_tx_buffer_size = size;
+int32_t HAL_USART_Transmit_IT(USART_HandleTypeDef *huart, uint8_t *pTxBuff, uint32_t size) {
+    return HAL_USART_TransmitQueue_IT(huart, pTxBuff, size, NULL, NULL);
+}
 
-    HAL_USART_IRQnDisable(huart, USART_IER_TX_DATA_REQ_Msk);
+int32_t HAL_USART_TransmitQueue_IT(USART_HandleTypeDef *huart, const uint8_t *pTxBuff, uint32_t size, USART_TxCallback_t callback, void *arg) {
+    USART_TX_QUEUE *queue = &huart->info->tx_queue;
+    USART_TX_REQUEST *req;
+    uint32_t mask;
 
-	/* Fill FIFO until full or until TX buffer is empty */
-	while ((HAL_USART_ReadLineStatus(huart) & USART_LSR_TX_DATA_REQ_Msk) && (usart_tx_buffer_size > 0)) {
-		HAL_USART_SendByte(huart, *usart_tx_buffer);
-        usart_tx_buffer++;
-        usart_tx_buffer_size--;
-	}
+#ifdef PM_FEATURE_ENABLE
+    uint32_t instance = HAL_USART_GetInstanceNumber(huart);
+#endif
+
+    if((pTxBuff == NULL) || (size == 0U))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    mask = SaveAndSetIRQMask();
+
+    if((uint8_t)(queue->head - queue->tail) == USART_TX_QUEUE_DEPTH) {
+        RestoreIRQMask(mask);
+        return ARM_DRIVER_ERROR_BUSY;
+    }
+
+    req = &queue->req[queue->head & (USART_TX_QUEUE_DEPTH - 1)];
+    req->buf = pTxBuff;
+    req->size = size;
+    req->callback = callback;
+    req->arg = arg;
+
+    // Idle queue: this buffer is next, the TX interrupt fires as soon as it is enabled
+    if(queue->head == queue->tail) {
+        queue->ptr = pTxBuff;
+        queue->left = size;
+        huart->info->xfer.send_active = 1U;
+
+#ifdef PM_FEATURE_ENABLE
+        LOCK_SLEEP(instance, 1, 0);
+#endif
+    }
+
+    queue->head++;
 
     HAL_USART_IRQnEnable(huart, USART_IER_TX_DATA_REQ_Msk);
+
+    RestoreIRQMask(mask);
+
+    return ARM_DRIVER_OK;
+}
+
+uint32_t HAL_USART_TransmitQueuePending(USART_HandleTypeDef *huart) {
+    return (uint8_t)(huart->info->tx_queue.head - huart->info->tx_queue.tail);
 }
 
 static void HAL_USART_Transmit_IRQn(USART_HandleTypeDef *huart) {
+    USART_TX_QUEUE *queue = &huart->info->tx_queue;
+    USART_TX_REQUEST *req;
+    uint32_t done = 0;
+
+#ifdef PM_FEATURE_ENABLE
+    uint32_t instance = HAL_USART_GetInstanceNumber(huart);
+#endif
+
+    while(queue->head != queue->tail) {
+        req = &queue->req[queue->tail & (USART_TX_QUEUE_DEPTH - 1)];
+
+        /* Fill FIFO until full or until TX buffer is empty */
+        while((queue->left > 0) && (HAL_USART_ReadLineStatus(huart) & USART_LSR_TX_DATA_REQ_Msk)) {
+            HAL_USART_SendByte(huart, *queue->ptr);
+            queue->ptr++;
+            queue->left--;
+        }
+
+        // FIFO full, carry on at the next interrupt
+        if(queue->left > 0)
+            return;
+
+        // Chain the next buffer before the callback, which may queue again
+        queue->tail++;
+        done++;
+
+        if(queue->head != queue->tail) {
+            queue->ptr = queue->req[queue->tail & (USART_TX_QUEUE_DEPTH - 1)].buf;
+            queue->left = queue->req[queue->tail & (USART_TX_QUEUE_DEPTH - 1)].size;
+        }
+
+        if(req->callback)
+            req->callback(req->buf, req->size, req->arg);
+    }
 
     HAL_USART_IRQnDisable(huart, USART_IER_TX_DATA_REQ_Msk);
 
-	/* Fill FIFO until full or until TX buffer is empty */
-	while ((HAL_USART_ReadLineStatus(huart) & USART_LSR_TX_DATA_REQ_Msk) && (usart_tx_buffer_size > 0)) {
-		HAL_USART_SendByte(huart, *usart_tx_buffer);
-        usart_tx_buffer++;
-        usart_tx_buffer_size--;
-	}
+    // A TX request with the queue already empty finished no buffer, the last one already signalled
+    if(done == 0)
+        return;
 
-    HAL_USART_IRQnEnable(huart, USART_IER_TX_DATA_REQ_Msk);
+    huart->info->xfer.send_active = 0U;
+
+#ifdef PM_FEATURE_ENABLE
+    CHECK_TO_UNLOCK_SLEEP(instance, 1, 0);
+#endif
+
+    if(huart->info->cb_event)
+        huart->info->cb_event(ARM_USART_EVENT_TX_COMPLETE);
 }
 
 int32_t HAL_USART_Receive_DMA(USART_HandleTypeDef *huart, uint8_t *pRxBuff, uint32_t size) {
@@ -1500,6 +1731,271 @@ void HAL_USART_Receive_IT(uint8_t *pRxBuff, uint32_t size) {
     usart_rx_buffer_size = size;
 }
 
+PLAT_CODE_IN_RAM static void HAL_USART_RxStreamArm(USART_HandleTypeDef *usart, uint32_t index) {
+    USART_RX_STREAM *stream = &usart->info->rx_stream;
+    uint32_t half = stream->size >> 1;
+    uint32_t cur = index / half;
+    uint32_t other = cur ^ 1U;
+
+    usart->dma_rx->descriptor[other].TAR = (uint32_t)stream->ring + other * half;
+    usart->dma_rx->descriptor[other].CMDR = DMA_SetDescriptorTransferLen(usart->dma_rx->descriptor[other].CMDR, half);
+
+    usart->dma_rx->descriptor[cur].TAR = (uint32_t)stream->ring + index;
+    usart->dma_rx->descriptor[cur].CMDR = DMA_SetDescriptorTransferLen(usart->dma_rx->descriptor[cur].CMDR, (cur + 1U) * half - index);
+
+    DMA_ChannelLoadDescriptorAndRun(usart->dma_rx->channel, &usart->dma_rx->descriptor[cur]);
+}
+
+PLAT_CODE_IN_RAM static void HAL_USART_RxStreamPublish(USART_RX_STREAM *stream, uint32_t index) {
+    uint32_t head = stream->head;
+    uint32_t used;
+
+    // index never gets a full ring ahead of head: there is an event at least every half
+    head += (index - head) & (stream->size - 1U);
+    used = head - stream->tail;
+
+    stream->stats.received += head - stream->head;
+    if(used > stream->stats.peak_used)
+        stream->stats.peak_used = MIN(used, stream->size);
+
+    stream->head = head;
+}
+
+PLAT_CODE_IN_RAM static void HAL_USART_RxStreamIdle(USART_HandleTypeDef *usart) {
+    USART_RX_STREAM *stream = &usart->info->rx_stream;
+    uint32_t mask = stream->size - 1U;
+    uint32_t index, bytes_in_fifo;
+
+    // Let the burst in flight land, then park the channel so the FIFO tail can be read by the CPU
+    (void)DMA_ChannelGetCurrentTargetAddress(usart->dma_rx->channel, true);
+    DMA_StopChannelNoWait(usart->dma_rx->channel);
+    index = (DMA_ChannelGetCurrentTargetAddress(usart->dma_rx->channel, true) - (uint32_t)stream->ring) & mask;
+
+    bytes_in_fifo = usart->reg->FCNR >> USART_FCNR_RX_FIFO_NUM_Pos;
+
+    while(bytes_in_fifo--) {
+        stream->ring[index] = usart->reg->RBR;
+        index = (index + 1U) & mask;
+    }
+
+    HAL_USART_RxStreamPublish(stream, index);
+    HAL_USART_RxStreamArm(usart, index);
+
+    stream->stats.idle_events++;
+}
+
+PLAT_CODE_IN_RAM static void HAL_USART_RxStreamIRQn(USART_HandleTypeDef *usart) {
+    USART_RX_STREAM *stream = &usart->info->rx_stream;
+    uint32_t iir = usart->reg->IIR & USART_INT_TYPE_MSK;
+    uint32_t lsr, event = 0;
+
+    if(iir == USART_RLS_INT) {
+        lsr = HAL_USART_ReadLineStatus(usart);
+
+        if(lsr & USART_LSR_RX_OVERRUN_ERROR_Msk) {
+            usart->info->rx_status.rx_overflow = 1U;
+            stream->stats.fifo_overruns++;
+            event |= ARM_USART_EVENT_RX_OVERFLOW;
+        }
+
+        if(lsr & USART_LSR_RX_BREAK_Msk) {
+            usart->info->rx_status.rx_break = 1U;
+            event |= ARM_USART_EVENT_RX_BREAK;
+        }
+
+        if(lsr & USART_LSR_RX_FRAME_ERROR_Msk) {
+            usart->info->rx_status.rx_framing_error = 1U;
+            event |= ARM_USART_EVENT_RX_FRAMING_ERROR;
+        }
+
+        if(lsr & USART_LSR_RX_PARITY_ERROR_Msk) {
+            usart->info->rx_status.rx_parity_error = 1U;
+            event |= ARM_USART_EVENT_RX_PARITY_ERROR;
+        }
+
+        if(event & ~ARM_USART_EVENT_RX_OVERFLOW)
+            stream->stats.line_errors++;
+
+    } else if(iir == USART_CTI_INT) {
+        HAL_USART_RxStreamIdle(usart);
+        event = ARM_USART_EVENT_RX_TIMEOUT;
+    }
+
+    if(event && usart->info->cb_event)
+        usart->info->cb_event(event);
+}
+
+PLAT_CODE_IN_RAM static void HAL_USART_RxStreamDmaEvent(uint32_t event, USART_HandleTypeDef *usart) {
+    USART_RX_STREAM *stream = &usart->info->rx_stream;
+    uint32_t half = stream->size >> 1;
+    uint32_t index, other;
+
+    switch (event) {
+        case DMA_EVENT_END:
+            index = (DMA_ChannelGetCurrentTargetAddress(usart->dma_rx->channel, true) - (uint32_t)stream->ring) & (stream->size - 1U);
+
+            // The channel runs on the half holding index, the other one may have been shortened by HAL_USART_RxStreamArm
+            other = (index / half) ^ 1U;
+            usart->dma_rx->descriptor[other].TAR = (uint32_t)stream->ring + other * half;
+            usart->dma_rx->descriptor[other].CMDR = DMA_SetDescriptorTransferLen(usart->dma_rx->descriptor[other].CMDR, half);
+
+            HAL_USART_RxStreamPublish(stream, index);
+            stream->stats.half_events++;
+
+            if(usart->info->cb_event)
+                usart->info->cb_event(ARM_USART_EVENT_DMA_RX_COMPLETE);
+
+            break;
+        case DMA_EVENT_ERROR:
+        default:
+            break;
+    }
+}
+
+static uint32_t HAL_USART_RxStreamPending(USART_RX_STREAM *stream) {
+    uint32_t mask, head, used;
+
+    // The ISR moves head and updates stats, resync against a consistent snapshot
+    mask = SaveAndSetIRQMask();
+
+    head = stream->head;
+    used = head - stream->tail;
+
+    if(used > (stream->size >> 1)) {
+        stream->stats.lost += used;
+        stream->stats.ring_overruns++;
+        stream->tail = head;
+        used = 0;
+    }
+
+    RestoreIRQMask(mask);
+
+    return used;
+}
+
+int32_t HAL_USART_RxStreamStart(USART_HandleTypeDef *huart, uint8_t *pRing, uint32_t size) {
+    USART_RX_STREAM *stream = &huart->info->rx_stream;
+    uint32_t mask;
+
+#ifdef PM_FEATURE_ENABLE
+    uint32_t instance = HAL_USART_GetInstanceNumber(huart);
+#endif
+
+    if(!huart->dma_rx)
+        return ARM_DRIVER_ERROR_UNSUPPORTED;
+
+    if((pRing == NULL) || (size < USART_RX_STREAM_MIN_SIZE) || (size > USART_RX_STREAM_MAX_SIZE) || (size & (size - 1U)))
+        return ARM_DRIVER_ERROR_PARAMETER;
+
+    if(stream->active)
+        return ARM_DRIVER_ERROR_BUSY;
+
+    // Drop any one-shot receive still armed
+    DMA_StopChannel(huart->dma_rx->channel, true);
+
+    mask = SaveAndSetIRQMask();
+
+    memset(stream, 0, sizeof(USART_RX_STREAM));
+    stream->ring = pRing;
+    stream->size = size;
+    stream->stats.ring_size = size;
+
+    HAL_USART_DmaRxBuildDescriptors(huart, pRing, size);
+
+    huart->info->rx_status.rx_dma_triggered = 0;
+    stream->active = 1U;
+
+    // The DMA runs for the whole stream, stay awake until HAL_USART_RxStreamStop
+#ifdef PM_FEATURE_ENABLE
+    LOCK_SLEEP(instance, 0, 1);
+#endif
+
+    huart->reg->IER |= USART_IER_RX_TIMEOUT_Msk | USART_IER_RX_LINE_STATUS_Msk;
+    DMA_ChannelLoadDescriptorAndRun(huart->dma_rx->channel, &huart->dma_rx->descriptor[0]);
+
+    RestoreIRQMask(mask);
+
+    return ARM_DRIVER_OK;
+}
+
+int32_t HAL_USART_RxStreamStop(USART_HandleTypeDef *huart) {
+    USART_RX_STREAM *stream = &huart->info->rx_stream;
+    uint32_t mask, index;
+
+#ifdef PM_FEATURE_ENABLE
+    uint32_t instance = HAL_USART_GetInstanceNumber(huart);
+#endif
+
+    if(!huart->dma_rx || !stream->active)
+        return ARM_DRIVER_OK;
+
+    mask = SaveAndSetIRQMask();
+
+    huart->reg->IER &= ~(USART_IER_RX_TIMEOUT_Msk | USART_IER_RX_LINE_STATUS_Msk);
+    DMA_StopChannel(huart->dma_rx->channel, true);
+
+    index = (DMA_ChannelGetCurrentTargetAddress(huart->dma_rx->channel, true) - (uint32_t)stream->ring) & (stream->size - 1U);
+    HAL_USART_RxStreamPublish(stream, index);
+    stream->active = 0;
+
+    // Back to the one-shot chain expected by HAL_USART_Receive_DMA
+    HAL_USART_DmaRxBuildDescriptors(huart, NULL, 0);
+
+#ifdef PM_FEATURE_ENABLE
+    CHECK_TO_UNLOCK_SLEEP(instance, 0, 1);
+#endif
+
+    RestoreIRQMask(mask);
+
+    return ARM_DRIVER_OK;
+}
+
+uint32_t HAL_USART_RxStreamAvailable(USART_HandleTypeDef *huart) {
+    return HAL_USART_RxStreamPending(&huart->info->rx_stream);
+}
+
+uint32_t HAL_USART_RxStreamRead(USART_HandleTypeDef *huart, uint8_t *pData, uint32_t size) {
+    USART_RX_STREAM *stream = &huart->info->rx_stream;
+    uint32_t tail, offset, first, n;
+
+    n = MIN(size, HAL_USART_RxStreamPending(stream));
+    if(n == 0)
+        return 0;
+
+    tail = stream->tail;
+    offset = tail & (stream->size - 1U);
+    first = MIN(n, stream->size - offset);
+
+    memcpy(pData, &stream->ring[offset], first);
+    memcpy(pData + first, stream->ring, n - first);
+
+    stream->tail = tail + n;
+
+    return n;
+}
+
+uint32_t HAL_USART_RxStreamPeek(USART_HandleTypeDef *huart, const uint8_t **ppData) {
+    USART_RX_STREAM *stream = &huart->info->rx_stream;
+    uint32_t used = HAL_USART_RxStreamPending(stream);
+    uint32_t offset = stream->tail & (stream->size - 1U);
+
+    *ppData = &stream->ring[offset];
+
+    return MIN(used, stream->size - offset);
+}
+
+void HAL_USART_RxStreamConsume(USART_HandleTypeDef *huart, uint32_t size) {
+    USART_RX_STREAM *stream = &huart->info->rx_stream;
+
+    stream->tail += MIN(size, stream->head - stream->tail);
+}
+
+void HAL_USART_RxStreamGetStats(USART_HandleTypeDef *huart, USART_RxStreamStats *stats) {
+    uint32_t mask = SaveAndSetIRQMask();
+    *stats = huart->info->rx_stream.stats;
+    RestoreIRQMask(mask);
+}
+
 __attribute__((weak)) void HT_USART_Callback(uint32_t event) {
     __NOP();
 }
@@ -1531,11 +2027,239 @@ void HAL_USART_InitPrint(USART_HandleTypeDef *huart, clock_select_t uartClkSel,
     HT_GPR_ClockEnable(GPR_UART1FuncClk);
 #endif
 
+#if (USART_PRINT_ASYNC_ENABLE == 1)
+    if(huart->dma_tx) {
+        HAL_USART_Initialize(HAL_USART_PrintCallback, huart);
+        HAL_USART_PowerControl(ARM_POWER_FULL, huart);
+        HAL_USART_Control(control, baudrate, huart);
+
+        usart_print_huart = huart;
+        usart_print_stats.ring_size = USART_PRINT_RING_SIZE;
+        usart_print_async = 1;
+        return;
+    }
+#endif
+
     HAL_USART_Initialize(HT_USART_Callback, huart);
     HAL_USART_PowerControl(ARM_POWER_FULL, huart);
     HAL_USART_Control(control, baudrate, huart);
 }
 
+#if (USART_PRINT_ASYNC_ENABLE == 1)
+
+/* Stops the chunk in flight and retires the bytes that already left. IRQs must be masked. */
+static void HAL_USART_PrintAbort(void) {
+    uint32_t sent;
+#ifdef PM_FEATURE_ENABLE
+    uint32_t instance;
+#endif
+
+    DMA_StopChannel(usart_print_huart->dma_tx->channel, true);
+
+    // Once DMA_EVENT_END ran every byte of the chunk is already in the FIFO
+    if(usart_print_huart->info->dma_tx_end)
+        sent = usart_print_inflight;
+    else
+        sent = DMA_ChannelGetCount(usart_print_huart->dma_tx->channel);
+
+    usart_print_huart->reg->IER &= ~USART_IER_TX_DATA_REQ_Msk;
+    usart_print_huart->info->xfer.send_active = 0U;
+    usart_print_huart->info->dma_tx_end = 0U;
+
+#ifdef PM_FEATURE_ENABLE
+    instance = HAL_USART_GetInstanceNumber(usart_print_huart);
+    CHECK_TO_UNLOCK_SLEEP(instance, 1, 0);
+#endif
+
+    usart_print_tail += MIN(sent, usart_print_inflight);
+    usart_print_inflight = 0;
+}
+
+static void HAL_USART_PrintKick(void) {
+    uint32_t mask;
+    uint32_t start, len, ms;
+
+    mask = SaveAndSetIRQMask();
+
+    if(!usart_print_async) {
+        RestoreIRQMask(mask);
+        return;
+    }
+
+    // A completion that never came would hold the ring forever, re-send from where the DMA stopped
+    if(usart_print_inflight != 0) {
+        if(osKernelGetTickCount() - usart_print_kick_tick <= usart_print_timeout) {
+            RestoreIRQMask(mask);
+            return;
+        }
+
+        HAL_USART_PrintAbort();
+        usart_print_stats.dma_timeouts++;
+    }
+
+    if(usart_print_head == usart_print_tail) {
+        RestoreIRQMask(mask);
+        return;
+    }
+
+    // One DMA per contiguous chunk, the wrapped part goes on the next completion
+    start = usart_print_tail & (USART_PRINT_RING_SIZE - 1);
+    len = MIN(usart_print_head - usart_print_tail, USART_PRINT_RING_SIZE - start);
+    usart_print_inflight = len;
+
+    // Wire time at 10 bits per byte plus slack, the tick does not run before the scheduler
+    ms = (len * 10000U) / usart_print_huart->info->baudrate + 1 + USART_PRINT_TIMEOUT_MS;
+    usart_print_timeout = (ms * osKernelGetTickFreq() + 999) / 1000;
+    usart_print_kick_tick = osKernelGetTickCount();
+
+    RestoreIRQMask(mask);
+
+    if(HAL_USART_Transmit_DMA(usart_print_huart, &usart_print_ring[start], len) != ARM_DRIVER_OK) {
+        mask = SaveAndSetIRQMask();
+        usart_print_inflight = 0;
+        usart_print_stats.dma_errors++;
+        RestoreIRQMask(mask);
+    }
+}
+
+static void HAL_USART_PrintCallback(uint32_t event) {
+
+    // SEND_COMPLETE is what Transmit_DMA reports while auto-baud is pending
+    if(event & (ARM_USART_EVENT_DMA_TX_COMPLETE | ARM_USART_EVENT_SEND_COMPLETE)) {
+        usart_print_tail += usart_print_inflight;
+        usart_print_inflight = 0;
+        HAL_USART_PrintKick();
+    }
+
+    HT_USART_Callback(event);
+}
+
+static int HAL_USART_PrintWrite(const uint8_t *data, uint32_t len) {
+    uint32_t mask;
+    uint32_t used, start, first;
+    uint32_t copied = 0;
+    uint32_t chunk;
+
+    while(copied < len) {
+        mask = SaveAndSetIRQMask();
+
+        chunk = MIN(USART_PRINT_RING_SIZE - (usart_print_head - usart_print_tail), len - copied);
+
+#if (USART_PRINT_OVF_POLICY == USART_PRINT_OVF_DROP)
+        // Keep writes atomic: a line either fits whole or is dropped
+        if(copied == 0 && chunk < len)
+            chunk = 0;
+#endif
+
+        if(chunk) {
+            start = usart_print_head & (USART_PRINT_RING_SIZE - 1);
+            first = MIN(chunk, USART_PRINT_RING_SIZE - start);
+
+            memcpy(&usart_print_ring[start], &data[copied], first);
+            memcpy(usart_print_ring, &data[copied + first], chunk - first);
+
+            usart_print_head += chunk;
+            copied += chunk;
+            usart_print_stats.written += chunk;
+
+            used = usart_print_head - usart_print_tail;
+            if(used > usart_print_stats.peak_used)
+                usart_print_stats.peak_used = used;
+        }
+
+        RestoreIRQMask(mask);
+
+        if(copied == len)
+            break;
+
+#if (USART_PRINT_OVF_POLICY == USART_PRINT_OVF_BLOCK)
+        // Only threads may wait for the DMA; an ISR or a masked section would spin forever
+        if(__get_IPSR() == 0 && __get_PRIMASK() == 0) {
+            HAL_USART_PrintKick();
+            continue;
+        }
+#endif
+
+        mask = SaveAndSetIRQMask();
+        usart_print_stats.dropped += len - copied;
+        usart_print_stats.overflows++;
+        RestoreIRQMask(mask);
+        break;
+    }
+
+    HAL_USART_PrintKick();
+
+    return len;
+}
+
+void HAL_USART_PrintFlush(void) {
+
+    if(!usart_print_async)
+        return;
+
+    if(__get_IPSR() != 0 || __get_PRIMASK() != 0) {
+        HAL_USART_PrintFlushPolling();
+        return;
+    }
+
+    while(usart_print_head != usart_print_tail)
+        HAL_USART_PrintKick();
+
+    // Last chunk is out of the FIFO, wait for the shifter too
+    while((usart_print_huart->reg->LSR & USART_LSR_TX_EMPTY_Msk) == 0);
+}
+
+void HAL_USART_PrintFlushPolling(void) {
+    uint32_t mask;
+    uint32_t start, len;
+
+    if(!usart_print_async)
+        return;
+
+    mask = SaveAndSetIRQMask();
+
+    usart_print_async = 0;
+
+    if(usart_print_inflight)
+        HAL_USART_PrintAbort();
+
+    while(usart_print_head != usart_print_tail) {
+        start = usart_print_tail & (USART_PRINT_RING_SIZE - 1);
+        len = MIN(usart_print_head - usart_print_tail, USART_PRINT_RING_SIZE - start);
+
+        HAL_USART_SendPolling(usart_print_huart, &usart_print_ring[start], len);
+        usart_print_tail += len;
+    }
+
+    while((usart_print_huart->reg->LSR & USART_LSR_TX_EMPTY_Msk) == 0);
+
+    RestoreIRQMask(mask);
+}
+
+void HAL_USART_PrintGetStats(USART_PrintStats *stats) {
+    uint32_t mask;
+
+    mask = SaveAndSetIRQMask();
+    *stats = usart_print_stats;
+    RestoreIRQMask(mask);
+}
+
+#else
+
+void HAL_USART_PrintFlush(void) {
+    __NOP();
+}
+
+void HAL_USART_PrintFlushPolling(void) {
+    __NOP();
+}
+
+void HAL_USART_PrintGetStats(USART_PrintStats *stats) {
+    memset(stats, 0, sizeof(USART_PrintStats));
+}
+
+#endif
+
 void HAL_USART_SetUARTLogClk(clock_select_t uartClkSel) {
 
 #if USART_UNILOG_SELECT == HAL_USART0_SELECT
@@ -1623,6 +2347,7 @@ int fgetc(FILE *f) {
 
 __attribute__((weak,noreturn))
 void __aeabi_assert (const char *expr, const char *file, int line) {
+  HAL_USART_PrintFlushPolling();
   printf("Assert, expr:%s, file: %s, line: %d\r\n", expr, file, line);
   while(1);
 }
@@ -1631,6 +2356,11 @@ int _write(int file, char *ptr, int len) {
 	//extern int io_putchar(int ch);
     int DataIdx;
 
+#if (USART_PRINT_ASYNC_ENABLE == 1)
+    if(usart_print_async)
+        return HAL_USART_PrintWrite((const uint8_t *)ptr, len);
+#endif
+
     for (DataIdx = 0; DataIdx < len; DataIdx++) {
 		io_putchar(*ptr++);
     }
@@ -1645,19 +2375,21 @@ PLAT_CODE_IN_RAM void USART_IRQHandler(USART_HandleTypeDef *usart) {
     uint32_t instance = HAL_USART_GetInstanceNumber(usart);;
 #endif
 
-    if(!usart->dma_rx && !usart->dma_tx) {
-        /* Handle transmit interrupt if enabled */
-        if(usart->reg->IER & USART_IER_TX_DATA_REQ_Msk) {
-            HAL_USART_Transmit_IRQn(usart);
-            usart->info->cb_event(ARM_USART_EVENT_TX_COMPLETE);
-        }
+    // Stream RX owns the RX interrupts, TX below still shares the line
+    if(usart->dma_rx && usart->info->rx_stream.active)
+        HAL_USART_RxStreamIRQn(usart);
+
+    /* Handle transmit interrupt if enabled, the TX queue is independent of the RX mode */
+    if(!usart->dma_tx && (usart->reg->IER & USART_IER_TX_DATA_REQ_Msk))
+        HAL_USART_Transmit_IRQn(usart);
 
+    if(!usart->dma_rx && !usart->dma_tx) {
         if(usart->reg->IER & USART_IER_RX_DATA_REQ_Msk) {
             HAL_USART_Receive_IRQn(usart);
             usart->info->cb_event(ARM_USART_EVENT_RECEIVE_COMPLETE);
         }
     
-    } else if(usart->dma_rx && dma_event == USART_DMA_RX_EVENT) {
+    } else if(usart->dma_rx && usart->info->dma_rx_end) {
         usart->info->rx_status.rx_busy = 1U;
 
         current_cnt = usart->info->xfer.rx_cnt;
@@ -1708,19 +2440,21 @@ PLAT_CODE_IN_RAM void USART_IRQHandler(USART_HandleTypeDef *usart) {
                     DMA_ChannelLoadDescriptorAndRun(usart->dma_rx->channel, &usart->dma_rx->descriptor[0]);
                 }
 
-                dma_event = USART_DMA_NONE_EVENT;
+                usart->info->dma_rx_end = 0U;
                 usart->info->cb_event(ARM_USART_EVENT_RX_TIMEOUT);
             }
         }
         usart->info->rx_status.rx_busy = 0U;
-    
-    } else if(usart->dma_tx && dma_event == USART_DMA_TX_EVENT) {
+    }
+
+    // TX and RX DMA flags are separate, a pending RX tail must not hide the TX completion
+    if(usart->dma_tx && usart->info->dma_tx_end) {
 
         if(((usart->reg->IER & USART_IER_TX_DATA_REQ_Msk) && ((usart->reg->FCNR & USART_FCNR_TX_FIFO_NUM_Msk) == 0))) {
             usart->info->xfer.tx_cnt = usart->info->xfer.tx_num;
             usart->info->xfer.send_active = 0U;
             usart->reg->IER &= ~USART_IER_TX_DATA_REQ_Msk;
-            dma_event = USART_DMA_NONE_EVENT;
+            usart->info->dma_tx_end = 0U;
             usart->info->cb_event(ARM_USART_EVENT_DMA_TX_COMPLETE);
 
 #ifdef PM_FEATURE_ENABLE
@@ -1737,7 +2471,7 @@ void HAL_USART_DmaTxEvent(uint32_t event, USART_HandleTypeDef *usart) {
     {
         case DMA_EVENT_END:
 
-            dma_event = USART_DMA_TX_EVENT;
+            usart->info->dma_tx_end = 1U;
 
             // TXFIFO may still have data not sent out
             usart->reg->IER |= USART_IER_TX_DATA_REQ_Msk;
@@ -1756,12 +2490,19 @@ void HAL_USART_DmaRxEvent(uint32_t event, USART_HandleTypeDef *usart) {
     uint32_t instance = HAL_USART_GetInstanceNumber(usart);
 #endif
 
-    uint32_t dmaCurrentTargetAddress = DMA_ChannelGetCurrentTargetAddress(usart->dma_rx->channel, false);
+    uint32_t dmaCurrentTargetAddress;
+
+    if(usart->info->rx_stream.active) {
+        HAL_USART_RxStreamDmaEvent(event, usart);
+        return;
+    }
+
+    dmaCurrentTargetAddress = DMA_ChannelGetCurrentTargetAddress(usart->dma_rx->channel, false);
 
     switch (event) {
         case DMA_EVENT_END:
 
-            dma_event = USART_DMA_RX_EVENT;
+            usart->info->dma_rx_end = 1U;
 
 #if USART_DEBUG
             HT_TRACE(UNILOG_PLA_DRIVER, USART_DmaRxEvent_0, P_SIG, 2, "uart dma rx event, fcnr:%x, cnt:%d", usart->reg->FCNR, dmaCurrentTargetAddress - (uint32_t)usart->info->xfer.rx_buf);
@@ -30,6 +30,9 @@
 #define FLASH_FOTA_REGION_LEN           0x80000
 #define FLASH_FOTA_REGION_END           0x320000
 
+#define FLASH_CFG_REGION_OFFSET         0x320000                   // application config image (corehub_config.py)
+#define FLASH_CFG_REGION_SIZE           0x1000
+
 /////////////////////////////////////////////////
 
 ////////////////FS AREA//////////////////////////
@@ -61,6 +61,11 @@ void _exit(int val)
     while(1);
 }
 
+/* newlib heap accounting, read through sbrk_get_usage() */
+static unsigned int sbrk_used;
+static unsigned int sbrk_peak;
+static unsigned int sbrk_failures;
+
 caddr_t _sbrk(int incr)
 {
     extern char _heap_memory_start, _heap_memory_end; /* Defined by the linker */
@@ -79,14 +84,30 @@ caddr_t _sbrk(int incr)
         out of memory errors, so do not abort here.  */
 
         //errno = ENOMEM;
+        sbrk_failures++;
         return (caddr_t) - 1;
     }
 
     heap_end += incr;
 
+    sbrk_used = heap_end - (char *)&_heap_memory_start;
+    if (sbrk_used > sbrk_peak) {
+        sbrk_peak = sbrk_used;
+    }
+
     return (caddr_t) prev_heap_end;
 }
 
+/*
+ * * sbrk_get_usage -- bytes handed to newlib now and at most, and refused requests.
+ * */
+void sbrk_get_usage(unsigned int *used, unsigned int *peak, unsigned int *failures)
+{
+    *used = sbrk_used;
+    *peak = sbrk_peak;
+    *failures = sbrk_failures;
+}
+
 
 
 // int _write(int file, char *ptr, int len)
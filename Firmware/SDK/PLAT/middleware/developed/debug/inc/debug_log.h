@@ -885,6 +885,16 @@ typedef enum
 	UNILOG_MQTT_cycle_11,
 	UNILOG_MQTT_MQTTYield_3,
 	UNILOG_MQTT_MQTTPublish_14,
+	UNILOG_MQTT_mqttTlsBench0,
+	UNILOG_MQTT_mqttTlsBench1,
+	UNILOG_MQTT_mqttTlsBenchFail,
+	UNILOG_MQTT_mqttTlsHeap0,
+	UNILOG_MQTT_mqttTlsHeap1,
+	UNILOG_MQTT_mqttTlsVerify,
+	UNILOG_MQTT_mqttTlsNoCa,
+	UNILOG_MQTT_mqttTlsCaMissing,
+	UNILOG_MQTT_mqttTlsSetupFail,
+	UNILOG_MQTT_mqttTlsHandshakeFail,
 	UNILOG_MQTT_INVALID_ID
 }UNILOG_MQTT_Tag;
 
@@ -10650,5 +10660,85 @@ typedef enum
 	UNILOG_CTLWM2M_INVALID_ID
 }UNILOG_CTLWM2M_Tag;
 
+typedef enum
+{
+	UNILOG_COREHUB_START = UNILOG_COREHUB << 19,
+	UNILOG_COREHUB_watchdog_stuck,
+	UNILOG_COREHUB_health,
+	UNILOG_COREHUB_publish_fail,
+	UNILOG_COREHUB_publish_fail_topic,
+	UNILOG_COREHUB_msg_too_big,
+	UNILOG_COREHUB_amb_corrupt,
+	UNILOG_COREHUB_watchdog_reset,
+	UNILOG_COREHUB_temp_high,
+	UNILOG_COREHUB_temp_low,
+	UNILOG_COREHUB_ac_on,
+	UNILOG_COREHUB_ac_off_door,
+	UNILOG_COREHUB_ac_off_light,
+	UNILOG_COREHUB_alarm_on,
+	UNILOG_COREHUB_alarm_overflow,
+	UNILOG_COREHUB_buzzer_on,
+	UNILOG_COREHUB_buzzer_off,
+	UNILOG_COREHUB_alarm_off,
+	UNILOG_COREHUB_start,
+	UNILOG_COREHUB_connecting,
+	UNILOG_COREHUB_connected,
+	UNILOG_COREHUB_subscribed,
+	UNILOG_COREHUB_fsm_reset,
+	UNILOG_COREHUB_conn_lost,
+	UNILOG_COREHUB_disconnecting,
+	UNILOG_COREHUB_connect_fail,
+	UNILOG_COREHUB_reconn_wait,
+	UNILOG_COREHUB_mqtt_connect_start,
+	UNILOG_COREHUB_mqtt_connect_cfg,
+	UNILOG_COREHUB_mqtt_net_init,
+	UNILOG_COREHUB_mqtt_client_init,
+	UNILOG_COREHUB_mqtt_tls_connect,
+	UNILOG_COREHUB_mqtt_tls_fail,
+	UNILOG_COREHUB_mqtt_set_timeout,
+	UNILOG_COREHUB_mqtt_set_timeout_fail,
+	UNILOG_COREHUB_mqtt_net_connect,
+	UNILOG_COREHUB_mqtt_net_fail,
+	UNILOG_COREHUB_mqtt_broker_connect,
+	UNILOG_COREHUB_mqtt_broker_fail,
+	UNILOG_COREHUB_mqtt_connected,
+	UNILOG_COREHUB_mqtt_connected_port,
+	UNILOG_COREHUB_mqtt_rx_topic,
+	UNILOG_COREHUB_mqtt_rx_payload,
+	UNILOG_COREHUB_mqtt_sub_fail,
+	UNILOG_COREHUB_mqtt_sub_fail_topic,
+	UNILOG_COREHUB_mqtt_sub_ok,
+	UNILOG_COREHUB_mqtt_disc_fail,
+	UNILOG_COREHUB_mqtt_disc_ok,
+	UNILOG_COREHUB_mqtt_unsub_fail,
+	UNILOG_COREHUB_mqtt_unsub_fail_topic,
+	UNILOG_COREHUB_mqtt_unsub_ok,
+	UNILOG_COREHUB_main_set_band,
+	UNILOG_COREHUB_main_sim_ready,
+	UNILOG_COREHUB_main_banner,
+	UNILOG_COREHUB_main_wait_sim,
+	UNILOG_COREHUB_main_start,
+	UNILOG_COREHUB_main_nw_ready,
+	UNILOG_COREHUB_main_sys_start,
+	UNILOG_COREHUB_main_nw_ok,
+	UNILOG_COREHUB_main_ip,
+	UNILOG_COREHUB_main_cell,
+	UNILOG_COREHUB_main_single_client,
+	UNILOG_COREHUB_main_started,
+	UNILOG_COREHUB_health_heap,
+	UNILOG_COREHUB_mqtt_hib_arm_fail,
+	UNILOG_COREHUB_mqtt_hib_armed,
+	UNILOG_COREHUB_mqtt_resume_fail,
+	UNILOG_COREHUB_mqtt_resumed,
+	UNILOG_COREHUB_resumed,
+	UNILOG_COREHUB_state_restored,
+	UNILOG_COREHUB_state_alarm_restored,
+	UNILOG_COREHUB_main_config,
+	UNILOG_COREHUB_main_config_amb,
+	UNILOG_COREHUB_history_sent,
+	UNILOG_COREHUB_main_tls_no_ca,
+	UNILOG_COREHUB_mqtt_tls_bench,
+	UNILOG_COREHUB_INVALID_ID
+}UNILOG_COREHUB_Tag;
 
 #endif //_DEBUG_LOG_H
@@ -175,6 +175,7 @@ typedef enum
 
     UNILOG_AZURE,
     UNILOG_QCFILEOP,
+    UNILOG_COREHUB,         //Core_Hub application and HT_MQTT_Api
     UNILOG_ID_END = 1023
 } UniLogModuleIdType;
 
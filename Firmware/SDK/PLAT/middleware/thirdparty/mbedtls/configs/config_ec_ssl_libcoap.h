@@ -15,9 +15,19 @@
 #define MBEDTLS_HAVE_ASM
 #define MBEDTLS_PLATFORM_MEMORY
 #if defined(MBEDTLS_OS_FREERTOS)
+#if defined(FEATURE_MQTT_ENABLE)
+/* Wrappers around calloc/free for every mbedtls user. They count only the
+ * blocks allocated inside an MQTT TLS call, see HT_MQTT_TLSGetHeapStats() */
+#include <stddef.h>
+void *HT_MQTT_TLSCalloc(size_t n, size_t size);
+void HT_MQTT_TLSFree(void *ptr);
+#define MBEDTLS_PLATFORM_CALLOC_MACRO HT_MQTT_TLSCalloc
+#define MBEDTLS_PLATFORM_FREE_MACRO	HT_MQTT_TLSFree
+#else
 #define MBEDTLS_PLATFORM_CALLOC_MACRO calloc //mbedtls_calloc //
 #define MBEDTLS_PLATFORM_FREE_MACRO	free //mbedtls_free //
 #endif
+#endif
 
 /* mbed TLS feature support */
 #define MBEDTLS_CIPHER_MODE_CBC
@@ -65,6 +75,7 @@
 //#define MBEDTLS_SSL_SERVER_NAME_INDICATION
 #define MBEDTLS_SSL_ALPN
 #define MBEDTLS_KEY_EXCHANGE_PSK_ENABLED
+#define MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED
 #define MBEDTLS_USE_RAND_API_ENTROPY
 
 //#define MBEDTLS_NO_PLATFORM_ENTROPY
@@ -84,9 +95,19 @@
 //#endif
 #define MBEDTLS_SSL_COOKIE_C
 
-#define MBEDTLS_SSL_MAX_CONTENT_LEN         (4*1024)   /**< Size of the input / output buffer */
+#define MBEDTLS_SSL_MAX_CONTENT_LEN         (4*1024)   /**< Upper bound, the I/O buffers are sized below */
 
-//#define MBEDTLS_SSL_MAX_OUT_CONTENT_LEN     (512)   /**< Size of the input / output buffer */
+/* Asymmetric record buffers. The input side must hold the broker's whole
+ * Certificate message during the handshake; the output side only carries
+ * MQTT packets (HT_COREHUB_MQTT_BUFFER_SIZE) and our own certificate.
+ * With MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH both shrink to the negotiated
+ * max fragment length once the handshake is over. */
+#ifndef MBEDTLS_SSL_IN_CONTENT_LEN
+#define MBEDTLS_SSL_IN_CONTENT_LEN          (4*1024)   /**< Size of the input buffer */
+#endif
+#ifndef MBEDTLS_SSL_OUT_CONTENT_LEN
+#define MBEDTLS_SSL_OUT_CONTENT_LEN         (2*1024)   /**< Size of the output buffer */
+#endif
 /**
  * \def MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH
  *
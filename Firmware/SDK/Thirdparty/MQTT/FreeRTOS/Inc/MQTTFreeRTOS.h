@@ -22,6 +22,9 @@
 // #include "FreeRTOS_IP.h"
 #include "semphr.h"
 #include "task.h"
+#include "cms_sock_mgr.h"
+
+#define NETWORK_HIB_RX_SIZE 1024   ///<Downlink buffered for mqttread while sockmgr owns the socket
 
 ///MQTT client results
 typedef enum {
@@ -50,12 +53,40 @@ typedef struct Timer
 
 typedef struct Network Network;
 
+/* Socket I/O counters of one connection, reset by NetworkInit() */
+typedef struct NetworkStats
+{
+	uint32_t bytes_in;          ///<Bytes returned by recv
+	uint32_t bytes_out;         ///<Bytes accepted by send
+	uint32_t read_calls;        ///<mqttread invocations (readPacket does 2..5 per packet)
+	uint32_t write_calls;       ///<mqttwrite invocations
+	uint32_t recv_syscalls;     ///<recv calls issued
+	uint32_t send_syscalls;     ///<send calls issued
+	uint32_t partial_writes;    ///<send calls that accepted less than asked
+	uint32_t read_timeouts;     ///<mqttread calls that returned short without error
+	uint32_t write_timeouts;    ///<mqttwrite calls that returned short without error
+	uint32_t read_errors;       ///<mqttread calls that failed
+	uint32_t write_errors;      ///<mqttwrite calls that failed
+	uint32_t recv_blocked_ms;   ///<Time spent inside recv
+	uint32_t send_blocked_ms;   ///<Time spent inside send
+} NetworkStats;
+
+/* TCP connect counters since boot, kept apart because every reconnect calls NetworkInit() */
+typedef struct NetworkConnectStats
+{
+	uint32_t connects;          ///<TCP connects attempted
+	uint32_t connect_last_ms;   ///<Duration of the last TCP connect
+	uint32_t connect_total_ms;  ///<Sum of TCP connect durations
+} NetworkConnectStats;
+
 struct Network
 {
 	xSocket_t my_socket;
 	int (*mqttread) (Network*, unsigned char*, int, int);
 	int (*mqttwrite) (Network*, unsigned char*, int, int);
 	int (*disconnect) (Network*);
+	NetworkStats stats;
+	void* hib;                  ///<sockmgr context while the socket is kept across hibernation, NULL otherwise
 };
 
 void TimerInit(Timer*);
@@ -90,4 +121,20 @@ int NetworkSetConnTimeout(Network* n, int send_timeout, int recv_timeout);
 
 int TLSNetworkConnect(Network* n, char* addr, int port, int timeout_ms);
 
+void NetworkGetStats(Network* n, NetworkStats* stats);
+void NetworkGetConnectStats(NetworkConnectStats* stats);
+int NetworkStatsFormat(Network* n, char* buf, int len);
+
+/* Hibernation: the connected TCP socket is handed to sockmgr, which keeps the
+   PCB across sleep2/hibernate and rebuilds the same fd on wake. Downlink then
+   arrives through sockmgr and is buffered for mqttread, in a ring of
+   NETWORK_HIB_RX_SIZE that drops the session when it overflows, so enable it
+   right before a deep sleep and disable it on wake. NetworkDisableHib fails
+   while the ring holds data. One connection only (TCP_HIB_SLEEP2_PCB_MAX_NUM).
+   All return 0 on success, -1 otherwise. */
+int NetworkEnableHib(Network* n);
+int NetworkDisableHib(Network* n);
+int NetworkGetHibContext(Network* n, CmsSockMgrConnHibContext* hib);
+int NetworkResume(Network* n, CmsSockMgrConnHibContext* hib);
+
 #endif
@@ -17,6 +17,36 @@
 
 #include "MQTTFreeRTOS.h"
 #include "debug_log.h"
+#include <stdio.h>
+#include <string.h>
+
+static NetworkConnectStats network_connect_stats;
+
+#if PS_ENABLE_TCPIP_HIB_SLEEP2_MODE
+/* Remote end of the connection, kept by sockmgr in the hib private context (IPv4 only, as NetworkConnect) */
+typedef struct NetworkHibPeer
+{
+    UINT32 remoteIp4;
+    UINT16 remotePort;
+    UINT16 rsvd;
+} NetworkHibPeer;
+
+typedef char NetworkHibPeerFits[(sizeof(NetworkHibPeer) <= CMS_SOCK_MGR_HIB_PRIVATE_CONTEXT_MAX_LENGTH) ? 1 : -1];
+
+/* Single instance: lwIP keeps at most TCP_HIB_SLEEP2_PCB_MAX_NUM (1) PCB */
+static struct
+{
+    BOOL registered;
+    SemaphoreHandle_t rx_sem;               /* given on every DL/status/error event */
+    volatile UINT16 head;                   /* written by the sockmgr task */
+    volatile UINT16 tail;                   /* written by mqttread */
+    volatile BOOL closed;                   /* peer closed, error or ring overflow */
+    CmsSockMgrContext* recovered;           /* set by NetworkHibRecover */
+    UINT8 rx[NETWORK_HIB_RX_SIZE];
+} network_hib;
+
+static int NetworkHibRead(Network* n, unsigned char* buffer, int len, TickType_t xTicksToWait);
+#endif
 
 int ThreadStart(Thread* thread, void (*fn)(void*), void* arg)
 {
@@ -90,22 +120,58 @@ int FreeRTOS_read(Network* n, unsigned char* buffer, int len, int timeout_ms)
     TimeOut_t xTimeOut;
     int recvLen = 0;
 
+    n->stats.read_calls++;
+
+#if PS_ENABLE_TCPIP_HIB_SLEEP2_MODE
+    /* sockmgr reads the socket itself, the data is waiting in the ring */
+    if (n->hib != NULL)
+    {
+        recvLen = NetworkHibRead(n, buffer, len, xTicksToWait);
+        goto done;
+    }
+
+    /* Queued by sockmgr while NetworkDisableHib took the socket back, it comes first */
+    if (network_hib.head != network_hib.tail)
+    {
+        recvLen = NetworkHibRead(n, buffer, len, 0);
+        if (recvLen < 0 || recvLen == len)
+            goto done;
+    }
+#endif
+
     vTaskSetTimeOutState(&xTimeOut); /* Record the time at which this function was entered. */
     do
     {
         int rc = 0;
+        TickType_t xStart;
 
         FreeRTOS_setsockopt(n->my_socket, 0, FREERTOS_SO_RCVTIMEO, &xTicksToWait, sizeof(xTicksToWait));
+        xStart = xTaskGetTickCount();
         rc = FreeRTOS_recv(n->my_socket, buffer + recvLen, len - recvLen, 0);
+        n->stats.recv_blocked_ms += (xTaskGetTickCount() - xStart) * portTICK_PERIOD_MS;
+        n->stats.recv_syscalls++;
         if (rc > 0)
+        {
             recvLen += rc;
+            n->stats.bytes_in += rc;
+        }
         else if (rc < 0)
         {
-            recvLen = rc;
+            /* SO_RCVTIMEO expiring is a timeout, not a broken connection */
+            if (sock_get_errno(n->my_socket) != EAGAIN)
+                recvLen = rc;
             break;
         }
     } while (recvLen < len && xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE);
 
+#if PS_ENABLE_TCPIP_HIB_SLEEP2_MODE
+done:
+#endif
+    if (recvLen < 0)
+        n->stats.read_errors++;
+    else if (recvLen < len)
+        n->stats.read_timeouts++;
+
     return recvLen;
 }
 
@@ -116,15 +182,26 @@ int FreeRTOS_write(Network* n, unsigned char* buffer, int len, int timeout_ms)
     TimeOut_t xTimeOut;
     int sentLen = 0;
 
+    n->stats.write_calls++;
+
     vTaskSetTimeOutState(&xTimeOut); /* Record the time at which this function was entered. */
     do
     {
         int rc = 0;
+        TickType_t xStart;
 
-        FreeRTOS_setsockopt(n->my_socket, 0, FREERTOS_SO_RCVTIMEO, &xTicksToWait, sizeof(xTicksToWait));
+        FreeRTOS_setsockopt(n->my_socket, 0, FRERRTOS_SO_SNDTIMEO, &xTicksToWait, sizeof(xTicksToWait));
+        xStart = xTaskGetTickCount();
         rc = FreeRTOS_send(n->my_socket, buffer + sentLen, len - sentLen, 0);
+        n->stats.send_blocked_ms += (xTaskGetTickCount() - xStart) * portTICK_PERIOD_MS;
+        n->stats.send_syscalls++;
         if (rc > 0)
+        {
+            if (rc < len - sentLen)
+                n->stats.partial_writes++;
             sentLen += rc;
+            n->stats.bytes_out += rc;
+        }
         else if (rc < 0)
         {
             sentLen = rc;
@@ -132,6 +209,11 @@ int FreeRTOS_write(Network* n, unsigned char* buffer, int len, int timeout_ms)
         }
     } while (sentLen < len && xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE);
 
+    if (sentLen < 0)
+        n->stats.write_errors++;
+    else if (sentLen < len)
+        n->stats.write_timeouts++;
+
     return sentLen;
 }
 
@@ -139,6 +221,13 @@ int FreeRTOS_write(Network* n, unsigned char* buffer, int len, int timeout_ms)
 int FreeRTOS_disconnect(Network* n)
 {
     int ret;
+#if PS_ENABLE_TCPIP_HIB_SLEEP2_MODE
+    if (n->hib != NULL)
+    {
+        cmsSockMgrRemoveContext((CmsSockMgrContext*)n->hib);
+        n->hib = NULL;
+    }
+#endif
     ret = FreeRTOS_closesocket(n->my_socket);
     return ret;
 }
@@ -193,6 +282,58 @@ void NetworkInit(Network* n) {
     n->mqttread = FreeRTOS_read;
     n->mqttwrite = FreeRTOS_write;
     n->disconnect = FreeRTOS_disconnect;
+    memset(&n->stats, 0, sizeof(n->stats));
+    n->hib = NULL;
+}
+
+void NetworkGetStats(Network* n, NetworkStats* stats)
+{
+    taskENTER_CRITICAL();
+    memcpy(stats, &n->stats, sizeof(NetworkStats));
+    taskEXIT_CRITICAL();
+}
+
+void NetworkGetConnectStats(NetworkConnectStats* stats)
+{
+    taskENTER_CRITICAL();
+    memcpy(stats, &network_connect_stats, sizeof(NetworkConnectStats));
+    taskEXIT_CRITICAL();
+}
+
+/* Compact JSON status line. Syscalls per call are reported x100 to stay integer.
+   The I/O counters cover the current connection, the connect counters every one since boot. */
+int NetworkStatsFormat(Network* n, char* buf, int len)
+{
+    NetworkStats s;
+    NetworkConnectStats c;
+
+    NetworkGetStats(n, &s);
+    NetworkGetConnectStats(&c);
+
+    return snprintf(buf, len,
+        "{\"rx\":%lu,\"tx\":%lu,\"rc\":%lu,\"wc\":%lu,\"rsc\":%lu,\"wsc\":%lu,\"pw\":%lu,"
+        "\"rto\":%lu,\"wto\":%lu,\"rer\":%lu,\"wer\":%lu,\"rms\":%lu,\"wms\":%lu,\"cn\":%lu,\"cms\":%lu,\"cavg\":%lu}",
+        (unsigned long)s.bytes_in, (unsigned long)s.bytes_out,
+        (unsigned long)s.read_calls, (unsigned long)s.write_calls,
+        (unsigned long)(s.read_calls ? (s.recv_syscalls * 100) / s.read_calls : 0),
+        (unsigned long)(s.write_calls ? (s.send_syscalls * 100) / s.write_calls : 0),
+        (unsigned long)s.partial_writes,
+        (unsigned long)s.read_timeouts, (unsigned long)s.write_timeouts,
+        (unsigned long)s.read_errors, (unsigned long)s.write_errors,
+        (unsigned long)s.recv_blocked_ms, (unsigned long)s.send_blocked_ms,
+        (unsigned long)c.connects, (unsigned long)c.connect_last_ms,
+        (unsigned long)(c.connects ? c.connect_total_ms / c.connects : 0));
+}
+
+static void NetworkStatsConnectDone(TickType_t xStart)
+{
+    uint32_t elapsed = (xTaskGetTickCount() - xStart) * portTICK_PERIOD_MS;
+
+    taskENTER_CRITICAL();
+    network_connect_stats.connects++;
+    network_connect_stats.connect_last_ms = elapsed;
+    network_connect_stats.connect_total_ms += elapsed;
+    taskEXIT_CRITICAL();
 }
 
 int TLSNetworkConnect(Network* n, char* addr, int port, int timeout_ms)
@@ -202,6 +343,7 @@ int TLSNetworkConnect(Network* n, char* addr, int port, int timeout_ms)
     ip_addr_t ipAddress;
     INT32 errCode;
     INT32 flags = 0;
+    TickType_t xStart = xTaskGetTickCount();
 
     if ((FreeRTOS_gethostbyname(addr, &ipAddress)) != 0)
         goto exit;
@@ -218,7 +360,8 @@ int TLSNetworkConnect(Network* n, char* addr, int port, int timeout_ms)
         {
             ////HT_TRACE(UNILOG_MQTT, TLSNetworkConnect_0, P_ERROR, 0, "TLSConnectSocket connect is ongoing");
 
-            retVal = FreeRTOSConnectTimeout(n->my_socket, (UINT32 )timeout_ms); //for bearer suspend timeout is 25s
+            /* select() takes seconds, the caller passes ms */
+            retVal = FreeRTOSConnectTimeout(n->my_socket, (UINT32 )(timeout_ms > 1000 ? timeout_ms / 1000 : 1)); //for bearer suspend timeout is 25s
             if(retVal == 0)
             {
               //  //HT_TRACE(UNILOG_MQTT, TLSNetworkConnect_1, P_INFO, 0, "TLSConnectSocket connect success");
@@ -250,6 +393,7 @@ int TLSNetworkConnect(Network* n, char* addr, int port, int timeout_ms)
     fcntl(n->my_socket, F_SETFL, flags&~O_NONBLOCK); 
 
 exit:
+    NetworkStatsConnectDone(xStart);
     return retVal;
 }
 
@@ -260,6 +404,7 @@ int NetworkConnect(Network* n, char* addr, int port)
     ip_addr_t ipAddress;
     INT32 errCode;
     INT32 flags = 0;
+    TickType_t xStart = xTaskGetTickCount();
 
     if ((FreeRTOS_gethostbyname(addr, &ipAddress)) != 0) {
         goto exit;
@@ -306,6 +451,7 @@ int NetworkConnect(Network* n, char* addr, int port)
     fcntl(n->my_socket, F_SETFL, flags&~O_NONBLOCK); 
 
 exit:
+    NetworkStatsConnectDone(xStart);
     return retVal;
 }
 int NetworkSetConnTimeout(Network* n, int send_timeout, int recv_timeout)
@@ -350,3 +496,311 @@ int NetworkSetConnTimeout(Network* n, int send_timeout, int recv_timeout)
     
     return 0;
 }
+
+
+#if PS_ENABLE_TCPIP_HIB_SLEEP2_MODE
+static void NetworkHibRxReset(void)
+{
+    taskENTER_CRITICAL();
+    network_hib.head = 0;
+    network_hib.tail = 0;
+    network_hib.closed = FALSE;
+    taskEXIT_CRITICAL();
+    if (network_hib.rx_sem != NULL)
+        xSemaphoreTake(network_hib.rx_sem, 0);
+}
+
+/* sockmgr task context */
+static void NetworkHibEvent(CmsSockMgrContext* ctx, CmsSockMgrEventType type, void* arg)
+{
+    (void)ctx;
+
+    switch (type)
+    {
+    case SOCK_EVENT_CONN_DL:
+    {
+        CmsSockMgrDataContext* data = ((CmsSockMgrConnDlArg*)arg)->dataContext;
+        UINT16 head = network_hib.head;
+        UINT16 i;
+
+        for (i = 0; i < data->Length; i++)
+        {
+            UINT16 next = (head + 1) % NETWORK_HIB_RX_SIZE;
+
+            /* A hole in the stream can't be resynchronised, drop the session.
+               The ring only serves the wait before a deep sleep, see NetworkDisableHib */
+            if (next == network_hib.tail)
+            {
+                network_hib.closed = TRUE;
+                break;
+            }
+            network_hib.rx[head] = data->data[i];
+            head = next;
+        }
+        network_hib.head = head;
+        break;
+    }
+    case SOCK_EVENT_CONN_STATUS:
+        if (((CmsSockMgrConnStatusArg*)arg)->newStatus == SOCK_CONN_STATUS_CLOSED)
+            network_hib.closed = TRUE;
+        break;
+    case SOCK_EVENT_CONN_ERROR:
+        network_hib.closed = TRUE;
+        break;
+    default:
+        return;
+    }
+
+    xSemaphoreGive(network_hib.rx_sem);
+}
+
+static int NetworkHibRead(Network* n, unsigned char* buffer, int len, TickType_t xTicksToWait)
+{
+    TimeOut_t xTimeOut;
+    int recvLen = 0;
+
+    vTaskSetTimeOutState(&xTimeOut);
+    for (;;)
+    {
+        TickType_t xStart;
+
+        while (recvLen < len && network_hib.tail != network_hib.head)
+        {
+            buffer[recvLen++] = network_hib.rx[network_hib.tail];
+            network_hib.tail = (network_hib.tail + 1) % NETWORK_HIB_RX_SIZE;
+        }
+        if (recvLen == len)
+            break;
+        if (network_hib.closed)
+        {
+            if (recvLen == 0)
+                recvLen = -1;
+            break;
+        }
+        if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            break;
+
+        xStart = xTaskGetTickCount();
+        xSemaphoreTake(network_hib.rx_sem, xTicksToWait);
+        n->stats.recv_blocked_ms += (xTaskGetTickCount() - xStart) * portTICK_PERIOD_MS;
+        n->stats.recv_syscalls++;
+    }
+
+    if (recvLen > 0)
+        n->stats.bytes_in += recvLen;
+
+    return recvLen;
+}
+
+/* Called by sockmgr before sleep2/hibernate: unread downlink would be lost */
+static BOOL NetworkHibCheck(CmsSockMgrContext* ctx)
+{
+    (void)ctx;
+
+    return network_hib.head == network_hib.tail && !network_hib.closed;
+}
+
+static void NetworkHibStore(CmsSockMgrContext* ctx, CmsSockMgrConnHibContext* hib)
+{
+    hib->magic = CMS_SOCK_MGR_TCP_CONTEXT_MAGIC;
+    hib->source = ctx->source;
+    hib->type = ctx->type;
+    hib->sockId = ctx->sockId;
+    hib->status = ctx->status;
+    hib->domain = ctx->domain;
+    hib->localPort = ctx->localPort;
+    hib->localAddr = ctx->localAddr;
+    hib->eventCallback = ctx->eventCallback;
+    memcpy(hib->priContext, ctx->priContext, sizeof(NetworkHibPeer));
+}
+
+/* Called through cmsSockMgrRecoverHibCallback() from NetworkResume() */
+static void NetworkHibRecover(CmsSockMgrConnHibContext* hib)
+{
+    NetworkHibPeer peer;
+    ip_addr_t localAddr = hib->localAddr;
+    ip_addr_t remoteAddr;
+    UINT16 localPort = hib->localPort;
+    UINT16 remotePort;
+    CmsSockMgrContext* ctx;
+
+    memcpy(&peer, hib->priContext, sizeof(peer));
+    ip_addr_set_ip4_u32(&remoteAddr, peer.remoteIp4);
+    remotePort = peer.remotePort;
+
+    if (cmsSockMgrRebuildSocket(hib->sockId, &localAddr, &remoteAddr, &localPort, &remotePort,
+                                SOCK_CONN_TYPE_TCP) != SOCK_CONN_STATUS_CONNECTED)
+        return;
+
+    if ((ctx = cmsSockMgrGetFreeMgrContext(sizeof(NetworkHibPeer))) == NULL)
+    {
+        cmsSockMgrCloseSocket(hib->sockId);
+        return;
+    }
+
+    ctx->sockId = hib->sockId;
+    ctx->source = hib->source;
+    ctx->type = hib->type;
+    ctx->status = SOCK_CONN_STATUS_CONNECTED;
+    ctx->bServer = FALSE;
+    ctx->domain = hib->domain;
+    ctx->localPort = localPort;
+    ctx->localAddr = localAddr;
+    ctx->eventCallback = (void*)NetworkHibEvent;
+    memcpy(ctx->priContext, &peer, sizeof(peer));
+    network_hib.recovered = ctx;
+}
+
+static void NetworkHibRegister(void)
+{
+    static CmsSockMgrHandleDefine handle =
+    {
+        SOCK_SOURCE_SDKAPI, NULL, NetworkHibCheck, NetworkHibStore, NetworkHibRecover, NULL
+    };
+
+    if (network_hib.rx_sem == NULL)
+        network_hib.rx_sem = xSemaphoreCreateBinary();
+    if (!network_hib.registered)
+        network_hib.registered = cmsSockMgrRegisterHandleDefine(&handle);
+}
+
+int NetworkEnableHib(Network* n)
+{
+    struct sockaddr_in local, remote;
+    socklen_t addrLen;
+    NetworkHibPeer* peer;
+    CmsSockMgrContext* ctx;
+
+    if (n->my_socket < 0 || n->hib != NULL)
+        return -1;
+
+    NetworkHibRegister();
+    if (!network_hib.registered || network_hib.rx_sem == NULL)
+        return -1;
+
+    /* Left over from the last NetworkDisableHib, not read yet */
+    if (network_hib.head != network_hib.tail)
+        return -1;
+
+    addrLen = sizeof(local);
+    if (getsockname(n->my_socket, (struct sockaddr*)&local, &addrLen) != 0)
+        return -1;
+    addrLen = sizeof(remote);
+    if (getpeername(n->my_socket, (struct sockaddr*)&remote, &addrLen) != 0)
+        return -1;
+
+    NetworkHibRxReset();
+    if ((ctx = cmsSockMgrGetFreeMgrContext(sizeof(NetworkHibPeer))) == NULL)
+        return -1;
+
+    ctx->sockId = n->my_socket;
+    ctx->source = SOCK_SOURCE_SDKAPI;
+    ctx->type = SOCK_CONN_TYPE_TCP;
+    ctx->status = SOCK_CONN_STATUS_CONNECTED;
+    ctx->bServer = FALSE;
+    ctx->domain = AF_INET;
+    ctx->localPort = FreeRTOS_ntohs(local.sin_port);
+    ip_addr_set_ip4_u32(&ctx->localAddr, local.sin_addr.s_addr);
+    ctx->eventCallback = (void*)NetworkHibEvent;
+
+    peer = (NetworkHibPeer*)ctx->priContext;
+    peer->remoteIp4 = remote.sin_addr.s_addr;
+    peer->remotePort = FreeRTOS_ntohs(remote.sin_port);
+
+    /* From here on sockmgr owns the reads */
+    n->hib = ctx;
+    if (!cmsSockMgrEnableHibMode(ctx))
+    {
+        cmsSockMgrRemoveContext(ctx);
+        n->hib = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+int NetworkDisableHib(Network* n)
+{
+    if (n->hib == NULL)
+        return 0;
+
+    /* Unread downlink only exists in the ring, leave it to mqttread first */
+    if (network_hib.head != network_hib.tail || network_hib.closed)
+        return -1;
+
+    /* Reads go back to the socket, as after a failed NetworkEnableHib */
+    cmsSockMgrRemoveContext((CmsSockMgrContext*)n->hib);
+    n->hib = NULL;
+    return 0;
+}
+
+int NetworkGetHibContext(Network* n, CmsSockMgrConnHibContext* hib)
+{
+    if (n->hib == NULL)
+        return -1;
+
+    NetworkHibStore((CmsSockMgrContext*)n->hib, hib);
+    return 0;
+}
+
+int NetworkResume(Network* n, CmsSockMgrConnHibContext* hib)
+{
+    CmsSockMgrHibContext ctx;
+
+    if (hib->magic != CMS_SOCK_MGR_TCP_CONTEXT_MAGIC || hib->source != SOCK_SOURCE_SDKAPI ||
+        hib->type != SOCK_CONN_TYPE_TCP)
+        return -1;
+
+    NetworkHibRegister();
+    if (!network_hib.registered || network_hib.rx_sem == NULL)
+        return -1;
+
+    NetworkHibRxReset();
+    network_hib.recovered = NULL;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.magic = CMS_SOCK_MGR_CONTEXT_MAGIC;
+    ctx.tcpContext = *hib;
+    cmsSockMgrRecoverHibCallback(&ctx);     /* dispatches to NetworkHibRecover by source */
+
+    if (network_hib.recovered == NULL)
+        return -1;
+
+    n->my_socket = network_hib.recovered->sockId;
+    n->hib = network_hib.recovered;
+    network_hib.recovered = NULL;
+
+    /* Armed again for the next hibernation */
+    if (!cmsSockMgrEnableHibMode((CmsSockMgrContext*)n->hib))
+    {
+        FreeRTOS_disconnect(n);
+        return -1;
+    }
+
+    return 0;
+}
+#else
+int NetworkEnableHib(Network* n)
+{
+    (void)n;
+    return -1;
+}
+
+int NetworkDisableHib(Network* n)
+{
+    (void)n;
+    return 0;
+}
+
+int NetworkGetHibContext(Network* n, CmsSockMgrConnHibContext* hib)
+{
+    (void)n; (void)hib;
+    return -1;
+}
+
+int NetworkResume(Network* n, CmsSockMgrConnHibContext* hib)
+{
+    (void)n; (void)hib;
+    return -1;
+}
+#endif
@@ -51,6 +51,36 @@
 #define HT_MQTT_TX_BUF_LEN 1024
 #define HT_MQTT_RX_BUF_LEN 1024
 
+#define HT_MQTT_TLS_MAX_FRAG_LEN        MBEDTLS_SSL_MAX_FRAG_LEN_1024   /**</ Max fragment length asked to the broker when the context leaves it at 0. */
+#ifndef HT_MQTT_TLS_HEAP_REPORT
+#define HT_MQTT_TLS_HEAP_REPORT         0                   /**</ 1 = log the TLS heap usage (unilog, P_INFO) after every handshake. */
+#endif
+
+/* HT_MQTT_TLSConnect() error codes */
+#define HT_MQTT_TLS_ERR_SETUP           (-1)                /**</ DRBG, credential parsing or SSL config failed. */
+#define HT_MQTT_TLS_ERR_SOCKET          (-2)                /**</ Socket could not be created. */
+#define HT_MQTT_TLS_ERR_DNS             (-3)                /**</ Broker address could not be resolved. */
+#define HT_MQTT_TLS_ERR_TCP             (-4)                /**</ TCP connection refused or reset. */
+#define HT_MQTT_TLS_ERR_TCP_TIMEOUT     (-5)                /**</ TCP connection timed out. */
+#define HT_MQTT_TLS_ERR_HANDSHAKE       (-6)                /**</ TLS handshake failed. */
+#define HT_MQTT_TLS_ERR_VERIFY          (-7)                /**</ Broker certificate rejected. */
+
+#define HT_MQTT_TLS_SESSION_MAX_LEN     512                 /**</ Largest serialized session (ID + master secret + ticket) kept for resumption. */
+#define HT_MQTT_TLS_SESSION_PERSIST     1                   /**</ 1 = also keep the session in littlefs so it survives deep sleep/reset. */
+#define HT_MQTT_TLS_SESSION_FILE        "mqtt_tls.ses"      /**</ littlefs file holding the serialized session. */
+
+/**
+ * \enum HT_MQTT_TLSProfile
+ * \brief Key exchange / cipher suite set used for the handshake.
+ */
+typedef enum {
+    HT_MQTT_TLS_PROFILE_CERT = 0,       /**</ ECDHE/RSA with certificates (default mbedtls suites), needs the broker CA. */
+    HT_MQTT_TLS_PROFILE_PSK,            /**</ Plain PSK, TLS_PSK_WITH_AES_128_CCM_8: no public-key math at all. */
+    HT_MQTT_TLS_PROFILE_ECDHE_PSK,      /**</ ECDHE-PSK on secp256r1: PSK auth with forward secrecy. */
+    HT_MQTT_TLS_PROFILE_CERT_NO_VERIFY, /**</ Certificate suites without checking the broker: test benches only. */
+    HT_MQTT_TLS_PROFILE_NUM
+} HT_MQTT_TLSProfile;
+
 typedef struct MqttClientSslTag {
     mbedtls_ssl_context sslContext;
     mbedtls_net_context netContext;
@@ -87,10 +117,153 @@ typedef struct MqttClientContextTag {
     int32_t clientPkLen;
     char *host;
     uint32_t timeout_ms;
+    uint8_t maxFragLen;                 /**</ MBEDTLS_SSL_MAX_FRAG_LEN_xxx, 0 = HT_MQTT_TLS_MAX_FRAG_LEN. */
+    uint8_t profile;                    /**</ HT_MQTT_TLSProfile. */
+    const unsigned char *psk;           /**</ Pre-shared key (PSK profiles). */
+    int32_t pskLen;                     /**</ Pre-shared key length. */
+    const char *pskIdentity;            /**</ PSK identity sent to the broker. */
 } MqttClientContext;
 
+/**
+ * \struct HT_MQTT_TLSHandshakeStats_t
+ * \brief Cost of the last handshake, for comparing profiles.
+ */
+typedef struct {
+    uint8_t profile;                    /**</ HT_MQTT_TLSProfile used. */
+    uint8_t resumed;                    /**</ 1 = abbreviated handshake. */
+    uint32_t cycles;                    /**</ CPU cycles between socket calls (DWT), network waits excluded. Saturates at UINT32_MAX. */
+    uint32_t cpu_ms;                    /**</ Same CPU time in ms at SystemCoreClock. */
+    uint32_t time_ms;                   /**</ Wall-clock handshake time from the tick count, includes network RTTs. */
+    uint32_t bytes_tx;                  /**</ Bytes written to the socket during the handshake. */
+    uint32_t bytes_rx;                  /**</ Bytes read from the socket during the handshake. */
+    uint32_t heap_peak;                 /**</ Peak mbedtls heap during the handshake. */
+} HT_MQTT_TLSHandshakeStats_t;
+
+/**
+ * \struct HT_MQTT_TLSSessionStats_t
+ * \brief TLS handshake counters, kept since boot.
+ */
+typedef struct {
+    uint32_t full_handshakes;           /**</ Handshakes that ran the full ECDHE/certificate exchange. */
+    uint32_t resumed_handshakes;        /**</ Handshakes that resumed a cached session (ticket or session ID). */
+    uint32_t resume_rejected;           /**</ Cached session offered but the server asked for a full handshake. */
+    uint32_t persist_writes;            /**</ Times the session was written to flash. */
+} HT_MQTT_TLSSessionStats_t;
+
+/**
+ * \struct HT_MQTT_TLSHeapStats_t
+ * \brief Heap used by mbedtls on behalf of the MQTT connection, measured
+ *        through its calloc/free hooks. Blocks other mbedtls users
+ *        allocate are not counted.
+ */
+typedef struct {
+    uint32_t current;                   /**</ Bytes held by mbedtls right now. */
+    uint32_t peak;                      /**</ Highest value of current since boot. */
+    uint32_t handshake_peak;            /**</ Peak during the last handshake. */
+    uint32_t steady;                    /**</ Held right after the last handshake (buffers already shrunk). */
+    uint32_t steady_peak;               /**</ Peak since the last handshake finished. */
+    uint32_t alloc_failures;            /**</ calloc calls that returned NULL. */
+    uint32_t sys_free_min;              /**</ Lowest free system heap seen at the end of a handshake. */
+    uint16_t in_frag_len;               /**</ Negotiated incoming record size. */
+    uint16_t out_frag_len;              /**</ Negotiated outgoing record size. */
+} HT_MQTT_TLSHeapStats_t;
+
+/*!******************************************************************
+ * \fn int32_t HT_MQTT_TLSConnect(MqttClientContext *context, Network *network)
+ * \brief Open the TCP connection and run the TLS handshake. The SSL
+ *        context is static; credentials are parsed on the first call and
+ *        reused until different certificate/key buffers are passed in.
+ *        On failure the socket is already closed.
+ *
+ * \param[in] MqttClientContext *context        Host, port, timeouts (s) and credentials.
+ * \param[in] Network *network                  Network handle, its read/write/disconnect
+ *                                              are switched to the TLS versions.
+ *
+ * \retval 0 on success, HT_MQTT_TLS_ERR_* otherwise.
+ *******************************************************************/
 int32_t HT_MQTT_TLSConnect(MqttClientContext *context, Network *network);
 
+/*!******************************************************************
+ * \fn int32_t HT_MQTT_TLSSessionSave(uint8_t *buf, size_t len, size_t *olen)
+ * \brief Copy the cached TLS session in its serialized form, e.g. to keep
+ *        it in some other non-volatile storage.
+ *
+ * \param[out] uint8_t *buf                     Destination buffer.
+ * \param[in]  size_t len                       Size of buf.
+ * \param[out] size_t *olen                     Bytes written.
+ *
+ * \retval 0 on success, -1 if there is no cached session or buf is too small.
+ *******************************************************************/
+int32_t HT_MQTT_TLSSessionSave(uint8_t *buf, size_t len, size_t *olen);
+
+/*!******************************************************************
+ * \fn int32_t HT_MQTT_TLSSessionLoad(const uint8_t *buf, size_t len)
+ * \brief Restore a session previously returned by HT_MQTT_TLSSessionSave().
+ *        The next HT_MQTT_TLSConnect() will try to resume it.
+ *
+ * \param[in] const uint8_t *buf                Serialized session.
+ * \param[in] size_t len                        Length of buf.
+ *
+ * \retval 0 on success, -1 if the data is not a valid session.
+ *******************************************************************/
+int32_t HT_MQTT_TLSSessionLoad(const uint8_t *buf, size_t len);
+
+/*!******************************************************************
+ * \fn void HT_MQTT_TLSSessionClear(void)
+ * \brief Forget the cached session (RAM and flash). Use when the broker
+ *        or its credentials change.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_MQTT_TLSSessionClear(void);
+
+/*!******************************************************************
+ * \fn void HT_MQTT_TLSSessionGetStats(HT_MQTT_TLSSessionStats_t *stats)
+ * \brief Copy the handshake counters.
+ *
+ * \param[out] HT_MQTT_TLSSessionStats_t *stats Destination.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_MQTT_TLSSessionGetStats(HT_MQTT_TLSSessionStats_t *stats);
+
+/*!******************************************************************
+ * \fn void HT_MQTT_TLSGetHeapStats(HT_MQTT_TLSHeapStats_t *stats)
+ * \brief Copy the mbedtls heap counters. steady_peak keeps growing
+ *        until the next handshake, so read it just before reconnecting
+ *        to get the steady-state figure.
+ *
+ * \param[out] HT_MQTT_TLSHeapStats_t *stats    Destination.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_MQTT_TLSGetHeapStats(HT_MQTT_TLSHeapStats_t *stats);
+
+/*!******************************************************************
+ * \fn void HT_MQTT_TLSGetHandshakeStats(HT_MQTT_TLSHandshakeStats_t *stats)
+ * \brief Copy the cost of the last successful handshake.
+ *
+ * \param[out] HT_MQTT_TLSHandshakeStats_t *stats   Destination.
+ *
+ * \retval none
+ *******************************************************************/
+void HT_MQTT_TLSGetHandshakeStats(HT_MQTT_TLSHandshakeStats_t *stats);
+
+/*!******************************************************************
+ * \fn int32_t HT_MQTT_TLSBenchmark(MqttClientContext *context, Network *network, HT_MQTT_TLSHandshakeStats_t *results)
+ * \brief Run one full handshake per profile against context->host and
+ *        log/store its cost. The session cache is bypassed so every
+ *        handshake is a full one. Profiles without credentials in the
+ *        context (no PSK, no CA) are skipped and left zeroed.
+ *
+ * \param[in]  MqttClientContext *context       Host, port, timeouts and credentials of every profile.
+ * \param[in]  Network *network                 Network handle, disconnected on return.
+ * \param[out] HT_MQTT_TLSHandshakeStats_t *results  Array of HT_MQTT_TLS_PROFILE_NUM entries.
+ *
+ * \retval Number of profiles that completed the handshake.
+ *******************************************************************/
+int32_t HT_MQTT_TLSBenchmark(MqttClientContext *context, Network *network, HT_MQTT_TLSHandshakeStats_t *results);
+
 #endif /*__HT_MQTT_H__*/
 
 /************************ HT Micron Semicondutores S.A *****END OF FILE****/
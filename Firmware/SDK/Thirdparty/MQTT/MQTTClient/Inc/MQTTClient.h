@@ -274,6 +274,14 @@ DLLExport int MQTTDisconnect(MQTTClient* client);
  */
 DLLExport int MQTTYield(MQTTClient* client, int time);
 
+/** MQTT WaitPacket - run one cycle: block until a packet arrives and is handled or the time runs out,
+ *  then service the keepalive. Unlike MQTTYield it returns as soon as a packet was handled.
+ *  @param client - the client object to use
+ *  @param time - the longest time, in milliseconds, to wait for a packet
+ *  @return success code
+ */
+DLLExport int MQTTWaitPacket(MQTTClient* client, int time);
+
 /** MQTT isConnected
  *  @param client - the client object to use
  *  @return truth value indicating whether the client is connected to the server
@@ -1,24 +1,349 @@
 
 #include "HT_MQTT_Tls.h"
+#include "qcx212.h"
+#include "debug_log.h"
+#if HT_MQTT_TLS_SESSION_PERSIST == 1
+#include "lfs_port.h"
+#endif
 
-MqttClientSsl *ssl;
+/* One TLS connection at a time: the context, parsed credentials and DRBG
+ * live for the whole process and are reused by every reconnect. */
+static MqttClientSsl tls_ssl;
+MqttClientSsl *ssl = &tls_ssl;
+
+static uint8_t tls_ready = 0;
+static const char *tls_ca_src = NULL;
+static const char *tls_cert_src = NULL;
+static const char *tls_pk_src = NULL;
+static const unsigned char *tls_psk_src = NULL;
+static int32_t tls_psk_len_src = 0;
+static const char *tls_psk_id_src = NULL;
+static uint8_t tls_profile_src = HT_MQTT_TLS_PROFILE_CERT;
+
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED)
+static const int tls_psk_suites[] = {
+	MBEDTLS_TLS_PSK_WITH_AES_128_CCM_8,
+	MBEDTLS_TLS_PSK_WITH_AES_128_CCM,
+	0
+};
+#endif
 
-static int HT_MQTT_MyCertVerify(void * data, mbedtls_x509_crt * crt, int depth, uint32_t * flags) {
-	char buf[4096];
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED)
+static const int tls_ecdhe_psk_suites[] = {
+	MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256,
+	0
+};
+
+/* One curve only: keeps the ClientHello short and the ECP tables small */
+static const mbedtls_ecp_group_id tls_ecdhe_psk_curves[] = {
+	MBEDTLS_ECP_DP_SECP256R1,
+	MBEDTLS_ECP_DP_NONE
+};
+#endif
+
+/* Handshake cost accounting */
+static HT_MQTT_TLSHandshakeStats_t tls_hs_stats;
+static uint32_t tls_wire_tx = 0;
+static uint32_t tls_wire_rx = 0;
+static uint8_t tls_session_bypass = 0;
+
+/* CPU time of the handshake: DWT cycles between socket calls only. Blocking
+ * on the network is left out, and every stretch is far below the ~21 s in
+ * which the 32-bit counter wraps, so the unsigned difference stays exact. */
+static uint8_t tls_cpu_on = 0;
+static uint32_t tls_cpu_mark;
+static uint64_t tls_cpu_cycles;
+
+static void HT_MQTT_TLSCpuPause(void) {
+	if (tls_cpu_on)
+		tls_cpu_cycles += DWT->CYCCNT - tls_cpu_mark;
+}
+
+static void HT_MQTT_TLSCpuResume(void) {
+	tls_cpu_mark = DWT->CYCCNT;
+}
+
+/* Last negotiated session, serialized. Kept as a flat blob so no mbedtls
+ * heap (ticket copy) stays allocated between connections. */
+static uint8_t tls_session_buf[HT_MQTT_TLS_SESSION_MAX_LEN];
+static size_t tls_session_len = 0;
+static uint8_t tls_session_loaded = 0;
+static HT_MQTT_TLSSessionStats_t tls_session_stats;
+
+static HT_MQTT_TLSHeapStats_t tls_heap_stats;
+
+/* Task inside an MQTT TLS call, only its allocations are counted. The hooks
+ * see every mbedtls user (e.g. the prebuilt http client), they stay in place
+ * for the whole process because blocks outlive the call that made them. */
+static TaskHandle_t tls_heap_task = NULL;
+static uint8_t tls_heap_depth = 0;
+
+/* Header in front of every mbedtls block, keeps 8-byte alignment */
+typedef union {
+	struct {
+		uint32_t size;
+		uint32_t counted;
+	} blk;
+	uint64_t align;
+} HT_MQTT_TLSHeapHdr;
+
+static void HT_MQTT_TLSHeapEnter(void) {
+	if (tls_heap_depth++ == 0)
+		tls_heap_task = xTaskGetCurrentTaskHandle();
+}
+
+static void HT_MQTT_TLSHeapExit(void) {
+	if (--tls_heap_depth == 0)
+		tls_heap_task = NULL;
+}
+
+void *HT_MQTT_TLSCalloc(size_t n, size_t size) {
+	HT_MQTT_TLSHeapHdr *hdr;
+	size_t total;
+	uint8_t counted = tls_heap_task != NULL && xTaskGetCurrentTaskHandle() == tls_heap_task;
+
+	if (n != 0 && size > ((size_t)-1 - sizeof(HT_MQTT_TLSHeapHdr)) / n)
+		return NULL;
+
+	total = n * size;
+	hdr = calloc(1, sizeof(HT_MQTT_TLSHeapHdr) + total);
+
+	if (!counted) {
+		if (hdr == NULL)
+			return NULL;
+		hdr->blk.size = total;
+		hdr->blk.counted = 0;
+		return (void *)(hdr + 1);
+	}
+
+	taskENTER_CRITICAL();
+	if (hdr == NULL) {
+		tls_heap_stats.alloc_failures++;
+	} else {
+		hdr->blk.size = total;
+		hdr->blk.counted = 1;
+		tls_heap_stats.current += total;
+		if (tls_heap_stats.current > tls_heap_stats.peak)
+			tls_heap_stats.peak = tls_heap_stats.current;
+		if (tls_heap_stats.current > tls_heap_stats.steady_peak)
+			tls_heap_stats.steady_peak = tls_heap_stats.current;
+	}
+	taskEXIT_CRITICAL();
+
+	return hdr != NULL ? (void *)(hdr + 1) : NULL;
+}
+
+void HT_MQTT_TLSFree(void *ptr) {
+	HT_MQTT_TLSHeapHdr *hdr;
+
+	if (ptr == NULL)
+		return;
+
+	hdr = (HT_MQTT_TLSHeapHdr *)ptr - 1;
+
+	if (hdr->blk.counted) {
+		taskENTER_CRITICAL();
+		tls_heap_stats.current -= hdr->blk.size;
+		taskEXIT_CRITICAL();
+	}
+
+	free(hdr);
+}
+
+void HT_MQTT_TLSGetHeapStats(HT_MQTT_TLSHeapStats_t *stats) {
+	if (stats == NULL)
+		return;
+
+	taskENTER_CRITICAL();
+	memcpy(stats, &tls_heap_stats, sizeof(tls_heap_stats));
+	taskEXIT_CRITICAL();
+}
+
+/* steady_peak doubles as the phase peak: restarted when a phase begins */
+static void HT_MQTT_TLSHeapPhaseStart(void) {
+	taskENTER_CRITICAL();
+	tls_heap_stats.steady_peak = tls_heap_stats.current;
+	taskEXIT_CRITICAL();
+}
+
+static void HT_MQTT_TLSHeapHandshakeDone(mbedtls_ssl_context *ssl_ctx) {
+	size_t sys_free = xPortGetFreeHeapSize();
+
+	taskENTER_CRITICAL();
+	tls_heap_stats.handshake_peak = tls_heap_stats.steady_peak;
+	tls_heap_stats.steady = tls_heap_stats.current;
+	tls_heap_stats.steady_peak = tls_heap_stats.current;
+	if (tls_heap_stats.sys_free_min == 0 || sys_free < tls_heap_stats.sys_free_min)
+		tls_heap_stats.sys_free_min = sys_free;
+	taskEXIT_CRITICAL();
+
+	tls_heap_stats.in_frag_len = (uint16_t)mbedtls_ssl_get_input_max_frag_len(ssl_ctx);
+	tls_heap_stats.out_frag_len = (uint16_t)mbedtls_ssl_get_output_max_frag_len(ssl_ctx);
+
+#if HT_MQTT_TLS_HEAP_REPORT == 1
+	HT_TRACE(UNILOG_MQTT, mqttTlsHeap0, P_INFO, 3, "TLS heap handshake peak %u, steady %u, system free %u",
+		tls_heap_stats.handshake_peak, tls_heap_stats.steady, sys_free);
+	HT_TRACE(UNILOG_MQTT, mqttTlsHeap1, P_INFO, 2, "TLS records in/out %u/%u",
+		tls_heap_stats.in_frag_len, tls_heap_stats.out_frag_len);
+#endif
+}
+
+#if HT_MQTT_TLS_SESSION_PERSIST == 1
+static void HT_MQTT_TLSSessionRead(void) {
+	lfs_file_t file;
+	lfs_ssize_t len;
+
+	if (LFS_FileOpen(&file, HT_MQTT_TLS_SESSION_FILE, LFS_O_RDONLY) != 0)
+		return;
+
+	len = LFS_FileRead(&file, tls_session_buf, sizeof(tls_session_buf));
+	tls_session_len = len > 0 ? (size_t)len : 0;
+
+	LFS_FileClose(&file);
+}
+
+static void HT_MQTT_TLSSessionWrite(void) {
+	lfs_file_t file;
+
+	if (tls_session_len == 0) {
+		LFS_Remove(HT_MQTT_TLS_SESSION_FILE);
+		return;
+	}
+
+	if (LFS_FileOpen(&file, HT_MQTT_TLS_SESSION_FILE, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) != 0)
+		return;
+
+	if (LFS_FileWrite(&file, tls_session_buf, tls_session_len) == (lfs_ssize_t)tls_session_len)
+		tls_session_stats.persist_writes++;
+
+	LFS_FileClose(&file);
+}
+#endif
+
+/* Offer the cached session to the server. Returns 1 if one was offered. */
+static uint8_t HT_MQTT_TLSSessionOffer(mbedtls_ssl_context *ssl_ctx, unsigned char *id, size_t *id_len) {
+	mbedtls_ssl_session session;
+	uint8_t offered = 0;
+
+#if HT_MQTT_TLS_SESSION_PERSIST == 1
+	if (!tls_session_loaded) {
+		HT_MQTT_TLSSessionRead();
+		tls_session_loaded = 1;
+	}
+#endif
+
+	*id_len = 0;
+	if (tls_session_len == 0)
+		return 0;
+
+	mbedtls_ssl_session_init(&session);
+	if (mbedtls_ssl_session_load(&session, tls_session_buf, tls_session_len) == 0 &&
+		mbedtls_ssl_set_session(ssl_ctx, &session) == 0) {
+		/* With tickets the client picks a fresh random ID at ClientHello
+		 * time, so the caller compares against what was actually sent */
+		offered = 1;
+	} else {
+		/* Unusable (e.g. mbedtls config changed since it was stored) */
+		tls_session_len = 0;
+	}
+	mbedtls_ssl_session_free(&session);
+
+	return offered;
+}
+
+/* Store the session negotiated by the handshake if it differs from the cached one */
+static void HT_MQTT_TLSSessionUpdate(mbedtls_ssl_context *ssl_ctx) {
+	static uint8_t tmp[HT_MQTT_TLS_SESSION_MAX_LEN];
+	const mbedtls_ssl_session *session = mbedtls_ssl_get_session_pointer(ssl_ctx);
+	size_t len = 0;
+
+	if (session == NULL || mbedtls_ssl_session_save(session, tmp, sizeof(tmp), &len) != 0)
+		return;
+
+	if (len == tls_session_len && memcmp(tmp, tls_session_buf, len) == 0)
+		return;
+
+	memcpy(tls_session_buf, tmp, len);
+	tls_session_len = len;
+
+#if HT_MQTT_TLS_SESSION_PERSIST == 1
+	/* Only full handshakes and ticket renewals get here, so flash wear follows
+	 * the server's ticket lifetime rather than the reconnect rate */
+	HT_MQTT_TLSSessionWrite();
+#endif
+}
+
+int32_t HT_MQTT_TLSSessionSave(uint8_t *buf, size_t len, size_t *olen) {
+	if (tls_session_len == 0 || buf == NULL || len < tls_session_len)
+		return -1;
+
+	memcpy(buf, tls_session_buf, tls_session_len);
+	if (olen != NULL)
+		*olen = tls_session_len;
+
+	return 0;
+}
+
+int32_t HT_MQTT_TLSSessionLoad(const uint8_t *buf, size_t len) {
+	mbedtls_ssl_session session;
+	int32_t ret;
+
+	if (buf == NULL || len == 0 || len > sizeof(tls_session_buf))
+		return -1;
+
+	/* Validate before accepting it */
+	HT_MQTT_TLSHeapEnter();
+	mbedtls_ssl_session_init(&session);
+	ret = mbedtls_ssl_session_load(&session, buf, len);
+	mbedtls_ssl_session_free(&session);
+	HT_MQTT_TLSHeapExit();
+
+	if (ret != 0)
+		return -1;
+
+	memcpy(tls_session_buf, buf, len);
+	tls_session_len = len;
+	tls_session_loaded = 1;
+
+	return 0;
+}
+
+void HT_MQTT_TLSSessionClear(void) {
+	tls_session_len = 0;
+	tls_session_loaded = 1;
 
+#if HT_MQTT_TLS_SESSION_PERSIST == 1
+	HT_MQTT_TLSSessionWrite();
+#endif
+}
+
+void HT_MQTT_TLSSessionGetStats(HT_MQTT_TLSSessionStats_t *stats) {
+	if (stats != NULL)
+		memcpy(stats, &tls_session_stats, sizeof(tls_session_stats));
+}
+
+static int HT_MQTT_MyCertVerify(void * data, mbedtls_x509_crt * crt, int depth, uint32_t * flags) {
 	((void) data);
-	mbedtls_x509_crt_info(buf, sizeof(buf) - 1, "", crt);
+	((void) crt);
+
+	if (*flags != 0)
+		HT_TRACE(UNILOG_MQTT, mqttTlsVerify, P_WARNING, 2, "TLS certificate at depth %d failed verification (0x%08x)", depth, *flags);
+
 	return (0);
 }
 
 static int HT_MQTT_TLSDisconnect(Network * network) {
 	int ret = 0;
 
+	HT_MQTT_TLSHeapEnter();
 	do {
 		ret = mbedtls_ssl_close_notify(&(ssl->sslContext));
 	} while(ret == MBEDTLS_ERR_SSL_WANT_WRITE);
 
+	/* Closes the socket; the SSL context is kept and reset on the next connect */
 	mbedtls_net_free(&(ssl->netContext));
+	network->my_socket = -1;
+	HT_MQTT_TLSHeapExit();
 
 	return 0;
 }
@@ -28,60 +353,139 @@ static int HT_MQTT_TLSWrite(Network * network, unsigned char *buffer, int len, i
 	int written;
 	int frags;
 
+	HT_MQTT_TLSHeapEnter();
 	for (written = 0, frags = 0; written < len; written += ret, frags++) {
 		while ((ret = mbedtls_ssl_write(&(ssl->sslContext), buffer + written, len - written)) <= 0) {
 			if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+				HT_MQTT_TLSHeapExit();
 				return ret;
 			}
 		}
 	}
+	HT_MQTT_TLSHeapExit();
 
 	return written;
 }
 
+/* Timeout for the socket wait of the current HT_MQTT_TLSRead() call, 0 = use
+ * the config read_timeout (handshake). Saves a conf_read_timeout per read. */
+static uint32_t tls_recv_timeout_ms = 0;
+
+static int HT_MQTT_TLSRecvTimeout(void *ctx, unsigned char *buf, size_t len, uint32_t timeout) {
+	int ret;
+
+	HT_MQTT_TLSCpuPause();
+	ret = mbedtls_net_recv_timeout(ctx, buf, len, tls_recv_timeout_ms != 0 ? tls_recv_timeout_ms : timeout);
+	HT_MQTT_TLSCpuResume();
+
+	if (ret > 0)
+		tls_wire_rx += ret;
+
+	return ret;
+}
+
+/* Used by mbedtls when no read timeout is configured */
+static int HT_MQTT_TLSRecv(void *ctx, unsigned char *buf, size_t len) {
+	int ret;
+
+	HT_MQTT_TLSCpuPause();
+	ret = mbedtls_net_recv(ctx, buf, len);
+	HT_MQTT_TLSCpuResume();
+
+	if (ret > 0)
+		tls_wire_rx += ret;
+
+	return ret;
+}
+
+static int HT_MQTT_TLSSend(void *ctx, const unsigned char *buf, size_t len) {
+	int ret;
+
+	HT_MQTT_TLSCpuPause();
+	ret = mbedtls_net_send(ctx, buf, len);
+	HT_MQTT_TLSCpuResume();
+
+	if (ret > 0)
+		tls_wire_tx += ret;
+
+	return ret;
+}
+
+/* Returns the bytes read: len on success, less (possibly 0) on timeout,
+ * -1 when the broker closed the session or the connection broke. */
 static int HT_MQTT_TLSRead(Network * network, unsigned char *buffer, int len, int timeout_ms) {
+	TickType_t xTicksToWait = timeout_ms > 0 ? pdMS_TO_TICKS(timeout_ms) : 0;
+	TimeOut_t xTimeOut;
 	int rxLen = 0;
-	int ret_val = -1;
-	bool isErrorFlag = false;
-	bool isCompleteFlag = false;
+	int ret;
 
-	if (timeout_ms != 0)
-		mbedtls_ssl_conf_read_timeout(&(ssl->sslConfig), timeout_ms);
+	network->stats.read_calls++;
+	HT_MQTT_TLSHeapEnter();
 
-	do {
-		ret_val = mbedtls_ssl_read(&(ssl->sslContext), buffer, len);
+	vTaskSetTimeOutState(&xTimeOut);
+	while (rxLen < len) {
+		/* Never 0: mbedtls_net_recv_timeout() treats 0 as "wait forever" */
+		tls_recv_timeout_ms = xTicksToWait > 0 ? xTicksToWait * portTICK_PERIOD_MS : 1;
 
-		if (ret_val > 0) {
-			rxLen += ret_val;
-		}
-		else if (ret_val == MBEDTLS_ERR_SSL_TIMEOUT) {
-			ret_val = 0;
-			return ret_val;
-		}
-		else if (ret_val == MBEDTLS_ERR_SSL_WANT_READ) {
-			isErrorFlag = true;
-		}
-		else if (ret_val == 0) {
-			ret_val = 100; //To Handle Mbedtls EOF case
-			return ret_val;
+		ret = mbedtls_ssl_read(&(ssl->sslContext), buffer + rxLen, len - rxLen);
+
+		if (ret > 0) {
+			rxLen += ret;
+			/* The next call returns the rest of the decrypted record before it reads the socket */
+			continue;
 		}
 
-		if (rxLen >= len) {
-			isCompleteFlag = true;
+		if (ret == 0 || ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY || 
+			(ret != MBEDTLS_ERR_SSL_TIMEOUT && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)) {
+			/* EOF, close_notify or a real error: the session is gone */
+			network->stats.read_errors++;
+			rxLen = -1;
+			break;
 		}
-	
-	} while( (!isErrorFlag) && (!isCompleteFlag) );
 
-	return ret_val;
+		if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+			break;
+	}
+
+	tls_recv_timeout_ms = 0;
+	HT_MQTT_TLSHeapExit();
+
+	if (rxLen > 0)
+		network->stats.bytes_in += rxLen;
+	if (rxLen >= 0 && rxLen < len)
+		network->stats.read_timeouts++;
+
+	return rxLen;
 }
 
-int32_t HT_MQTT_TLSConnect(MqttClientContext *context, Network *network) {
+static void HT_MQTT_TLSRelease(void) {
+	mbedtls_ssl_free(&ssl->sslContext);
+	mbedtls_ssl_config_free(&ssl->sslConfig);
+	mbedtls_x509_crt_free(&ssl->caCert);
+	mbedtls_x509_crt_free(&ssl->clientCert);
+	mbedtls_pk_free(&ssl->pkContext);
+	mbedtls_ctr_drbg_free(&ssl->ctrDrbgContext);
+	mbedtls_entropy_free(&ssl->entropyContext);
+
+	tls_ready = 0;
+}
+
+/* Seed the DRBG, parse the credentials and build the SSL config/context.
+ * Done once; only repeated if the application hands over other credentials. */
+static int32_t HT_MQTT_TLSSetup(MqttClientContext *context) {
 	int32_t ret = 0;
 	const char *custom = "SSLs";
-    int32_t authmode = MBEDTLS_SSL_VERIFY_NONE;
+	int32_t authmode = MBEDTLS_SSL_VERIFY_NONE;
+	uint8_t use_psk = (context->profile == HT_MQTT_TLS_PROFILE_PSK || context->profile == HT_MQTT_TLS_PROFILE_ECDHE_PSK);
 
-	context->ssl = malloc(sizeof(MqttClientSsl));
-    ssl = context->ssl;
+	if (tls_ready) {
+		if (tls_profile_src == context->profile && tls_psk_src == context->psk &&
+			tls_psk_len_src == context->pskLen && tls_psk_id_src == context->pskIdentity &&
+			tls_ca_src == context->caCert && tls_cert_src == context->clientCert && tls_pk_src == context->clientPk)
+			return 0;
+
+		HT_MQTT_TLSRelease();
+	}
 
 	/*
 	 * 0. Initialize the RNG and the session data
@@ -97,60 +501,52 @@ int32_t HT_MQTT_TLSConnect(MqttClientContext *context, Network *network) {
     mbedtls_entropy_init(&ssl->entropyContext);
 
 	if ((ret =
-		 mbedtls_ctr_drbg_seed(& (ssl->ctrDrbgContext), mbedtls_entropy_func, &(ssl->entropyContext), (const unsigned char *) custom, strlen(custom))) !=0) {			
-		return ret;
+		 mbedtls_ctr_drbg_seed(& (ssl->ctrDrbgContext), mbedtls_entropy_func, &(ssl->entropyContext), (const unsigned char *) custom, strlen(custom))) !=0) {
+		goto fail;
 	}
 
 	/*
-	 * Initialize server ca root 
+	 * 1. Initialize server ca root (certificate profile only, PSK has no certificates)
 	 */
-
-	if (context->clientCert != NULL && context->clientPk != NULL) {
+	if (use_psk) {
+		if (context->psk == NULL || context->pskLen <= 0 || context->pskIdentity == NULL) {
+			ret = MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+			goto fail;
+		}
+	} else if (context->profile == HT_MQTT_TLS_PROFILE_CERT_NO_VERIFY) {
+		HT_TRACE(UNILOG_MQTT, mqttTlsNoCa, P_WARNING, 0, "TLS without CA certificate, broker identity is NOT verified");
+	} else if (context->caCert != NULL) {
 		authmode = MBEDTLS_SSL_VERIFY_REQUIRED;
 		ret = mbedtls_x509_crt_parse(& (ssl->caCert), (const unsigned char *)context->caCert, context->caCertLen);
-
 		if (ret < 0) {
-			return -1;
+			goto fail;
 		}
-	} 
+	} else {
+		/* No CA and no explicit opt-out: refuse rather than talk to any broker */
+		HT_TRACE(UNILOG_MQTT, mqttTlsCaMissing, P_ERROR, 0, "TLS certificate profile without CA certificate, refusing to connect");
+		ret = MBEDTLS_ERR_SSL_CA_CHAIN_REQUIRED;
+		goto fail;
+	}
 
 	//2. START OF CLIENT CERT INIT AND PARSING - device_ec_cert.pem
-    if (context->clientCert != NULL && context->clientPk != NULL) {
+    if (!use_psk && context->clientCert != NULL && context->clientPk != NULL) {
         ret = mbedtls_x509_crt_parse(&(ssl->clientCert), (const unsigned char *) context->clientCert, context->clientCertLen);
         if (ret != 0) {
-            return -1;
+            goto fail;
         }
 
         ret = mbedtls_pk_parse_key(&ssl->pkContext, (const unsigned char *) context->clientPk, context->clientPkLen, NULL, 0);
         if (ret != 0) {
-            return -1;
+            goto fail;
         }
     }
 
-	// 5. Setup the network parameters
-	network->mqttread = HT_MQTT_TLSRead;
-	network->mqttwrite = HT_MQTT_TLSWrite;
-	network->disconnect = HT_MQTT_TLSDisconnect;
-
-	// 4. Start the TLS connection
-	ret = NetworkSetConnTimeout(network, 5000, 5000); 	// Add send_timeout , recieve_timeout in TLSConnectParams 
-    if(ret != 0) {
-        return -1;
-    }
-
-	// Step 4.2: Do NetworkConnect // hostname and port
-	ret = TLSNetworkConnect(network, context->host, context->port, context->timeout_ms);
-    if(ret != 0) {
-        return -1;
-    }
-    ssl->netContext.fd = network->my_socket;
-
-	// step 4.4 Moving to setup SSL structure.
+	// 3. Setup SSL structure.
 	if ((ret = mbedtls_ssl_config_defaults(&(ssl->sslConfig), 
 		MBEDTLS_SSL_IS_CLIENT, 
 		MBEDTLS_SSL_TRANSPORT_STREAM, 
 		MBEDTLS_SSL_PRESET_DEFAULT)) != 0) {
-		return ret;
+		goto fail;
 	}
 
 	mbedtls_ssl_conf_max_version(&ssl->sslConfig, MBEDTLS_SSL_MAJOR_VERSION_3, MBEDTLS_SSL_MINOR_VERSION_3);
@@ -159,30 +555,103 @@ int32_t HT_MQTT_TLSConnect(MqttClientContext *context, Network *network) {
 	mbedtls_ssl_conf_verify(&ssl->sslConfig, HT_MQTT_MyCertVerify, NULL);
 	mbedtls_ssl_conf_authmode(&(ssl->sslConfig), authmode);
 
-#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
-    if ((ret = mbedtls_ssl_conf_max_frag_len(&(ssl->sslConfig), MBEDTLS_SSL_MAX_FRAG_LEN_1024)) != 0) {
-        return -1;
-    }
+	// 3.1 Key exchange profile. Certificate profile keeps the mbedtls default suites.
+	switch (context->profile) {
+		case HT_MQTT_TLS_PROFILE_CERT:
+		case HT_MQTT_TLS_PROFILE_CERT_NO_VERIFY:
+			break;
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED)
+		case HT_MQTT_TLS_PROFILE_PSK:
+			mbedtls_ssl_conf_ciphersuites(&(ssl->sslConfig), tls_psk_suites);
+			break;
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED)
+		case HT_MQTT_TLS_PROFILE_ECDHE_PSK:
+			mbedtls_ssl_conf_ciphersuites(&(ssl->sslConfig), tls_ecdhe_psk_suites);
+			mbedtls_ssl_conf_curves(&(ssl->sslConfig), tls_ecdhe_psk_curves);
+			break;
+#endif
+		default:
+			ret = MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE;
+			goto fail;
+	}
+
+	if (use_psk) {
+		if ((ret = mbedtls_ssl_conf_psk(&(ssl->sslConfig), context->psk, context->pskLen,
+				(const unsigned char *)context->pskIdentity, strlen(context->pskIdentity))) != 0) {
+			goto fail;
+		}
+	}
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+	mbedtls_ssl_conf_session_tickets(&(ssl->sslConfig), MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
 #endif
 
-	// Step 4.5 SSL conf check for CA chain.
+	// 4. SSL conf check for CA chain.
 #if defined(MBEDTLS_X509_CRT_PARSE_C) 
-    
+    ssl->crtProfile = mbedtls_x509_crt_profile_default;
     mbedtls_ssl_conf_cert_profile(&ssl->sslConfig, &ssl->crtProfile);
 	mbedtls_ssl_conf_ca_chain(&(ssl->sslConfig), &(ssl->caCert), NULL);
 
-	if(context->clientCert) {
+	if (!use_psk && context->clientCert != NULL && context->clientPk != NULL) {
         if ((ret = mbedtls_ssl_conf_own_cert(&(ssl->sslConfig), &(ssl->clientCert), &(ssl->pkContext))) != 0) {
-            return -1;
+            goto fail;
         }
     }
-
 #endif
 	
-	// Step 4.7 Random number generator	
+	// 5. Random number generator
 	mbedtls_ssl_conf_rng(&(ssl->sslConfig), mbedtls_ctr_drbg_random, &(ssl->ctrDrbgContext));	
 
-	//mbedtls_ssl_conf_dbg(&(ssl->conf), sslDebug, NULL);
+	if ((ret = mbedtls_ssl_setup(&(ssl->sslContext), &(ssl->sslConfig))) != 0) {
+        goto fail;
+    }
+
+    mbedtls_ssl_set_bio(&(ssl->sslContext), &(ssl->netContext), HT_MQTT_TLSSend, HT_MQTT_TLSRecv, HT_MQTT_TLSRecvTimeout);
+
+	/* Cycle counter for the handshake cost figures */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	tls_profile_src = context->profile;
+	tls_psk_src = context->psk;
+	tls_psk_len_src = context->pskLen;
+	tls_psk_id_src = context->pskIdentity;
+	tls_ca_src = context->caCert;
+	tls_cert_src = context->clientCert;
+	tls_pk_src = context->clientPk;
+	tls_ready = 1;
+
+	return 0;
+
+fail:
+	HT_TRACE(UNILOG_MQTT, mqttTlsSetupFail, P_ERROR, 1, "TLS setup failed (-0x%04x)", -ret);
+	HT_MQTT_TLSRelease();
+	return HT_MQTT_TLS_ERR_SETUP;
+}
+
+static int32_t HT_MQTT_TLSOpen(MqttClientContext *context, Network *network) {
+	int32_t ret = 0;
+	uint8_t offered = 0;
+	unsigned char offered_id[32];
+	size_t offered_id_len = 0;
+	uint32_t hs_tx, hs_rx;
+	TickType_t hs_start;
+
+	context->ssl = ssl;
+
+	if (HT_MQTT_TLSSetup(context) != 0)
+		return HT_MQTT_TLS_ERR_SETUP;
+
+	// Drop whatever the previous connection left in the context
+	if (mbedtls_ssl_session_reset(&(ssl->sslContext)) != 0)
+		return HT_MQTT_TLS_ERR_SETUP;
+
+	if (ssl->sslContext.hostname == NULL || strcmp(ssl->sslContext.hostname, context->host) != 0) {
+		if (mbedtls_ssl_set_hostname(&(ssl->sslContext), context->host) != 0)
+			return HT_MQTT_TLS_ERR_SETUP;
+	}
+
 	if (context->timeout_r > 0) {
 		uint32_t recvTimeout;
 
@@ -190,28 +659,168 @@ int32_t HT_MQTT_TLSConnect(MqttClientContext *context, Network *network) {
         mbedtls_ssl_conf_read_timeout(&(ssl->sslConfig), recvTimeout);
 	}
 
-	if ((ret = mbedtls_ssl_setup(&(ssl->sslContext), &(ssl->sslConfig))) != 0) {
-        return -1;
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+	/* Only a config field, read when the ClientHello is written: can change
+	 * between connections. The record buffers grow back to their full size
+	 * for the handshake and shrink to the negotiated length afterwards. */
+	if (mbedtls_ssl_conf_max_frag_len(&(ssl->sslConfig), context->maxFragLen != 0 ? context->maxFragLen : HT_MQTT_TLS_MAX_FRAG_LEN) != 0)
+		return HT_MQTT_TLS_ERR_SETUP;
+#endif
+
+	// 6. Setup the network parameters
+	network->mqttread = HT_MQTT_TLSRead;
+	network->mqttwrite = HT_MQTT_TLSWrite;
+	network->disconnect = HT_MQTT_TLSDisconnect;
+
+	// 7. Start the TCP connection
+	ret = NetworkSetConnTimeout(network, context->timeout_s * 1000, context->timeout_r * 1000);
+    if(ret != 0) {
+        if(network->my_socket >= 0)
+            FreeRTOS_disconnect(network);
+        network->my_socket = -1;
+        return HT_MQTT_TLS_ERR_SOCKET;
     }
 
-	//	  params->pDestinationURL = hostname;
-	mbedtls_ssl_set_hostname(&(ssl->sslContext), context->host);
-    mbedtls_ssl_set_bio(&(ssl->sslContext), &(ssl->netContext), mbedtls_net_send, mbedtls_net_recv, mbedtls_net_recv_timeout);
+	ret = TLSNetworkConnect(network, context->host, context->port, context->timeout_ms);
+    if(ret != 0) {
+        FreeRTOS_disconnect(network);
+        network->my_socket = -1;
+
+        if(ret < 0)
+            return HT_MQTT_TLS_ERR_DNS;
+        else if(ret == MQTT_TIMEOUT)
+            return HT_MQTT_TLS_ERR_TCP_TIMEOUT;
+        return HT_MQTT_TLS_ERR_TCP;
+    }
+    ssl->netContext.fd = network->my_socket;
+
+	HT_MQTT_TLSHeapPhaseStart();
+
+	// 8. Offer the cached session, if any, for an abbreviated handshake
+	if (!tls_session_bypass)
+		offered = HT_MQTT_TLSSessionOffer(&(ssl->sslContext), offered_id, &offered_id_len);
+
+	hs_start = xTaskGetTickCount();
+	hs_tx = tls_wire_tx;
+	hs_rx = tls_wire_rx;
+	tls_cpu_cycles = 0;
+	tls_cpu_on = 1;
+	HT_MQTT_TLSCpuResume();
 	
-	// Step 4.12 TLS HANDSHAKE process on
-    while ((ret = mbedtls_ssl_handshake(&(ssl->sslContext))) != 0) {
-        if ((ret != MBEDTLS_ERR_SSL_WANT_READ) && (ret != MBEDTLS_ERR_SSL_WANT_WRITE)) {
-            return -1;
+	// 9. TLS HANDSHAKE process on
+    while ((ret = mbedtls_ssl_handshake_step(&(ssl->sslContext))) == 0 || ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+        /* Remember the ID sent in ClientHello: the server echoes it back only when it resumes */
+        if (ret == 0 && offered && ssl->sslContext.state == MBEDTLS_SSL_SERVER_HELLO) {
+            offered_id_len = ssl->sslContext.session_negotiate->id_len;
+            memcpy(offered_id, ssl->sslContext.session_negotiate->id, offered_id_len);
+        }
+
+        if (ssl->sslContext.state == MBEDTLS_SSL_HANDSHAKE_OVER) {
+            ret = 0;
+            break;
         }
     }
 
+    HT_MQTT_TLSCpuPause();
+    tls_cpu_on = 0;
+
+    if (ret != 0) {
+        HT_TRACE(UNILOG_MQTT, mqttTlsHandshakeFail, P_ERROR, 1, "TLS handshake failed (-0x%04x)", -ret);
+        mbedtls_net_free(&(ssl->netContext));
+        network->my_socket = -1;
+
+        /* A stale or rejected session must not keep breaking the handshake */
+        if (offered)
+            HT_MQTT_TLSSessionClear();
+        return HT_MQTT_TLS_ERR_HANDSHAKE;
+    }
+
+    tls_hs_stats.cycles = tls_cpu_cycles > UINT32_MAX ? UINT32_MAX : (uint32_t)tls_cpu_cycles;
+    tls_hs_stats.cpu_ms = (uint32_t)(tls_cpu_cycles / (SystemCoreClock / 1000));
+    tls_hs_stats.time_ms = (xTaskGetTickCount() - hs_start) * portTICK_PERIOD_MS;
+    tls_hs_stats.bytes_tx = tls_wire_tx - hs_tx;
+    tls_hs_stats.bytes_rx = tls_wire_rx - hs_rx;
+    tls_hs_stats.profile = context->profile;
+
+    HT_MQTT_TLSHeapHandshakeDone(&(ssl->sslContext));
+    tls_hs_stats.heap_peak = tls_heap_stats.handshake_peak;
+
+    if (offered && offered_id_len > 0 &&
+        ssl->sslContext.session->id_len == offered_id_len &&
+        memcmp(ssl->sslContext.session->id, offered_id, offered_id_len) == 0) {
+        tls_session_stats.resumed_handshakes++;
+        tls_hs_stats.resumed = 1;
+    } else {
+        tls_hs_stats.resumed = 0;
+        tls_session_stats.full_handshakes++;
+        if (offered)
+            tls_session_stats.resume_rejected++;
+    }
+
     /*
-     * 4. Verify the server certificate
+     * 10. Verify the server certificate
      */
     ret = mbedtls_ssl_get_verify_result(&(ssl->sslContext));
     if (ret != 0) {
-        return -1;
+        HT_MQTT_TLSDisconnect(network);
+        HT_MQTT_TLSSessionClear();
+        return HT_MQTT_TLS_ERR_VERIFY;
     }
 
+    if (!tls_session_bypass)
+        HT_MQTT_TLSSessionUpdate(&(ssl->sslContext));
+
+    return 0;
+}
+
+int32_t HT_MQTT_TLSConnect(MqttClientContext *context, Network *network) {
+	int32_t ret;
+
+	HT_MQTT_TLSHeapEnter();
+	ret = HT_MQTT_TLSOpen(context, network);
+	HT_MQTT_TLSHeapExit();
+
 	return ret;
 }
+
+void HT_MQTT_TLSGetHandshakeStats(HT_MQTT_TLSHandshakeStats_t *stats) {
+	if (stats != NULL)
+		memcpy(stats, &tls_hs_stats, sizeof(tls_hs_stats));
+}
+
+int32_t HT_MQTT_TLSBenchmark(MqttClientContext *context, Network *network, HT_MQTT_TLSHandshakeStats_t *results) {
+	uint8_t saved_profile = context->profile;
+	int32_t done = 0;
+	uint8_t profile;
+
+	memset(results, 0, HT_MQTT_TLS_PROFILE_NUM * sizeof(HT_MQTT_TLSHandshakeStats_t));
+
+	/* Full handshakes only, and leave the cached session untouched */
+	tls_session_bypass = 1;
+
+	for (profile = 0; profile < HT_MQTT_TLS_PROFILE_NUM; profile++) {
+		if (profile == HT_MQTT_TLS_PROFILE_CERT_NO_VERIFY ||
+			(profile == HT_MQTT_TLS_PROFILE_CERT ? context->caCert == NULL : context->psk == NULL))
+			continue;
+
+		context->profile = profile;
+		if (HT_MQTT_TLSConnect(context, network) != 0) {
+			HT_TRACE(UNILOG_MQTT, mqttTlsBenchFail, P_WARNING, 1, "TLS bench profile %u: handshake failed", profile);
+			continue;
+		}
+
+		HT_MQTT_TLSGetHandshakeStats(&results[profile]);
+		network->disconnect(network);
+		done++;
+
+		HT_TRACE(UNILOG_MQTT, mqttTlsBench0, P_SIG, 4, "TLS bench profile %u: cpu %u cycles (%u ms), wall %u ms",
+			profile, results[profile].cycles, results[profile].cpu_ms, results[profile].time_ms);
+		HT_TRACE(UNILOG_MQTT, mqttTlsBench1, P_SIG, 4, "TLS bench profile %u: tx %u B, rx %u B, heap peak %u B",
+			profile, results[profile].bytes_tx, results[profile].bytes_rx, results[profile].heap_peak);
+	}
+
+	tls_session_bypass = 0;
+	context->profile = saved_profile;
+
+	return done;
+}
@@ -187,13 +187,11 @@ int mqtt_keepalive_retry_count = 0;
 // }
 // #endif
 
+/* Messages that match no subscription are dropped. The payload already
+ * sits in readbuf, so there is nothing to copy or allocate here. */
 void mqttDefMessageArrived(MessageData* data)
 {
-    char *bufTemp = NULL;
-    bufTemp = malloc(data->message->payloadlen+1);
-    memset(bufTemp, 0, data->message->payloadlen+1);
-    memcpy(bufTemp, data->message->payload, data->message->payloadlen);
-    free(bufTemp);
+    (void)data;
 }
 
 static void NewMessageData(MessageData* md, MQTTString* aTopicName, MQTTMessage* aMessage) {
@@ -504,12 +502,6 @@ int cycle(MQTTClient* c, Timer* timer)
             /* no more data to read, unrecoverable. Or read packet fails due to unexpected network error */
             rc = packet_type;
             goto exit;
-#if MQTT_TLS_ENABLE == 1
-	case 100: //to handle Mbedtls EOF
-	    /* no more data to read, unrecoverable. Or read packet fails due to unexpected network error */
-	    rc = -1;
-	    goto exit;
-#endif
 
         case 0: /* timed out reading packet */
             break;
@@ -576,35 +568,18 @@ int cycle(MQTTClient* c, Timer* timer)
 
     if (keepalive(c) != SUCCESS) {
         int socket_stat = 0;
-        mqttSendMsg mqttMsg;
         //check only keepalive FAILURE status so that previous FAILURE status can be considered as FAULT
         rc = FAILURE;
         socket_stat = sock_get_errno(c->ipstack->my_socket);
-        if((socket_stat == MQTT_ERR_ABRT)||(socket_stat == MQTT_ERR_RST)||(socket_stat == MQTT_ERR_CLSD)||(socket_stat == MQTT_ERR_BADE))
-        {
-            /* send  reconnect msg to send task */
-            memset(&mqttMsg, 0, sizeof(mqttMsg));
-            mqttMsg.cmdType = MQTT_DEMO_MSG_RECONNECT;
-
-            xQueueSend(mqttSendMsgHandle, &mqttMsg, MQTT_MSG_TIMEOUT);
-        }
+        /* A dead socket cannot be pinged back to life: leave the session closed so the
+           application sees !isconnected and classifies the loss from the socket errno */
+        if (!socket_error_is_fatal(socket_stat) && ++mqtt_keepalive_retry_count <= 3)
+            keepaliveRetry(c);
         else
-        {
-            if(mqtt_keepalive_retry_count>3)
-            {
-                mqtt_keepalive_retry_count = 0;
-                /* send  reconnect msg to send task */
-                memset(&mqttMsg, 0, sizeof(mqttMsg));
-                mqttMsg.cmdType = MQTT_DEMO_MSG_RECONNECT;
-
-                xQueueSend(mqttSendMsgHandle, &mqttMsg, MQTT_MSG_TIMEOUT);
-            }
-            else
-            {
-                keepaliveRetry(c);
-            }
-        }
+            mqtt_keepalive_retry_count = 0;
     }
+    else
+        mqtt_keepalive_retry_count = 0;
 
 exit:
     if (rc == SUCCESS)
@@ -640,6 +615,16 @@ int MQTTYield(MQTTClient* c, int timeout_ms)
     return rc;
 }
 
+int MQTTWaitPacket(MQTTClient* c, int timeout_ms)
+{
+    Timer timer;
+
+    TimerInit(&timer);
+    TimerCountdownMS(&timer, timeout_ms);
+
+    return (cycle(c, &timer) < 0) ? FAILURE : SUCCESS;
+}
+
 // int MQTTIsConnected(MQTTClient* client)
 // {
 //   return client->isconnected;